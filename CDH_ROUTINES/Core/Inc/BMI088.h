@@ -24,6 +24,10 @@
 #define	BMI_INT3_INT4_IO_CONF	0x16
 #define BMI_INT3_INT4_IO_MAP	0x18
 
+/* Leitura em polling (chamada na interrupção do TIM6): limite por transferência.
+ * Conta no HAL_GetTick, que só anda ali porque o SysTick tem prioridade acima do TIM6 */
+#define BMI_SPI_TIMEOUT_MS		2
+
 typedef struct {
 
 	/* SPI */
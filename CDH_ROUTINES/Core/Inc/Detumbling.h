@@ -7,6 +7,15 @@
  * Descrição: Algoritmo de estabilização (Detumbling) baseado na taxa
  * de variação da luminosidade (LDRs). O objetivo é reduzir a velocidade
  * angular do satélite antes de iniciar o apontamento fino.
+ *
+ * Detumble_Gyro: amortecimento de taxa pelo giroscópio (3 eixos), com a
+ * roda de reação (eixo Z) como atuador:
+ *   aceleração pedida ao corpo = -K * w          (w = giroscópio sem bias)
+ *   aceleração da roda         = razão de inércia * aceleração em Z
+ *   K = aceleração máx. da roda / (razão * |w|), limitado a [K_min, K_max]
+ * Rotação rápida: a roda acelera no limite (desaceleração linear do corpo).
+ * Rotação lenta: K_max (decaimento exponencial, constante 1/K_max). Assim o
+ * tempo até estabilizar é limitado, em vez do decaimento lento de ganho fixo.
  */
 
 #ifndef INC_DETUMBLING_H_
@@ -18,6 +27,14 @@
 #define DETUMBLE_MAX_TORQUE 100.0f
 #define DETUMBLE_MIN_TORQUE -100.0f
 
+// Amortecimento pelo giroscópio
+#define DETUMBLE_WHEEL_ACCEL_MAX  50.0f    // Aceleração máxima da roda (rad/s²)
+#define DETUMBLE_GAIN_MIN         0.05f    // Faixa do ganho agendado (1/s)
+#define DETUMBLE_GAIN_MAX         1.0f
+#define DETUMBLE_INERTIA_RATIO    100.0f   // Inércia do corpo em Z / inércia da roda
+#define DETUMBLE_RATE_DONE        0.0087f  // |w_z| abaixo disso = estável (rad/s, 0.5 deg/s)
+#define DETUMBLE_HOLD_MS          2000     // Tempo abaixo do limiar para declarar estável
+
 // Estrutura de Controle do Detumbling
 typedef struct {
     // Parâmetro de Ajuste
@@ -30,6 +47,24 @@ typedef struct {
     uint8_t is_stable;     // Flag: 1 se estiver estável, 0 se estiver girando
 } Detumble_t;
 
+// Amortecimento pelo giroscópio
+typedef struct {
+    // Saídas (telemetria)
+    float gain;                 // Ganho agendado atual (1/s)
+    float accel_cmd[3];         // Aceleração pedida ao corpo por eixo (rad/s²); só Z é atuado
+    float rate_norm;            // |w| nos 3 eixos (rad/s)
+    uint8_t momentum_limited;   // A roda não tem folga para absorver a rotação em Z
+    uint8_t converged;          // |w_z| ficou abaixo de DETUMBLE_RATE_DONE por DETUMBLE_HOLD_MS
+
+    // Tempos (HAL_GetTick)
+    uint32_t start_ms;          // Entrada no modo
+    uint32_t converge_ms;       // Tempo até estabilizar (válido com converged)
+
+    // Estado Interno
+    uint8_t below;
+    uint32_t below_since_ms;
+} Detumble_Gyro_t;
+
 // --- Protótipos ---
 
 // Inicializa o sistema de Detumbling com o ganho desejado
@@ -38,4 +73,11 @@ void Detumble_Init(Detumble_t *detumble, float kd_gain);
 // Processa os dados do SolarTracker para calcular o torque de frenagem
 void Detumble_Process(Detumble_t *detumble, SolarTracker_t *solar_data);
 
+// Zera o amortecimento pelo giroscópio e marca o início (entrada no modo)
+void Detumble_Gyro_Start(Detumble_Gyro_t *detumble, uint32_t now_ms);
+
+// Uma iteração: retorna a nova velocidade da roda dentro de [wheel_min, wheel_max]
+float Detumble_Gyro_Process(Detumble_Gyro_t *detumble, const float rate[3], float wheel_speed,
+                            float wheel_min, float wheel_max, float dt, uint32_t now_ms);
+
 #endif /* INC_DETUMBLING_H_ */
\ No newline at end of file
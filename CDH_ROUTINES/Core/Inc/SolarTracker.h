@@ -16,6 +16,7 @@
 // --- Configurações ---
 #define NUM_SENSORES 8
 #define HISTERESE_FINA 3
+#define SOLAR_MIN_LUZ  20   // Soma normalizada mínima para considerar o Sol visível
 
 // --- Mapeamento dos Sensores (Índices) ---
 #define S_Y_MINUS_RIGHT 0
@@ -46,6 +47,8 @@ typedef struct {
 
     // Saídas (Telemetria e Controle)
     float angulo_solar_graus;             // Ângulo calculado 0-360
+    float vetor_solar[3];                 // Direção do Sol no corpo (unitário, Z = 0)
+    uint8_t sol_visivel;                  // 1: vetor_solar válido (luz suficiente)
     char debug_quadrante[5];              // "FR", "FL", etc.
     int32_t erro_tracker;                 // Diferença de luz
     int acao_motor;                       // -1: Esq, 0: Parado, 1: Dir
@@ -9,6 +9,21 @@
   * Serial.print("M-80")          →  ADCS_SetSpeed(-80)
   * Serial.print("M0")            →  ADCS_Stop()
   * if (lStickX >= -10 && <= 10)  →  Dead zone automática
+  *
+  * Telemetria (SimpleFOC → STM32, UART4 RX por DMA), uma linha por amostra:
+  *   motor.monitor_variables = _MON_VOLT_Q | _MON_CURR_Q | _MON_VEL;
+  *   motor.monitor();              →  "Uq\tIq\tvel\n" → ADCS_GetMotorState()
+  * Linhas fora desse formato (respostas do Commander) são descartadas.
+  *
+  * Modo binário opcional (ADCS_SetFraming), só para o setpoint de velocidade:
+  *   [0xA5] [CMD] [float32 little-endian] [CRC-8]      (7 bytes fixos)
+  * CRC-8 polinômio 0x07 (init 0x00) sobre CMD + float. O lado do SimpleFOC
+  * aceita os dois formatos ao mesmo tempo (ver ADCS_EXAMPLES.md): a
+  * configuração ("MC1") continua em ASCII.
+  *
+  * Atuador alternativo (ADCS_SetActuator): driver com entrada PWM/DIR/EN e
+  * tacômetro por captura (wheel_pwm.h). O comando é uma escrita no timer
+  * e a velocidade é lida a cada iteração, sem UART no caminho.
   ******************************************************************************
   */
 
@@ -19,6 +34,12 @@
 #include "usart.h"
 #include <stdint.h>
 #include "BMI088.h"
+#include "pid.h"
+#include "attitude.h"
+#include "mekf.h"
+#include "Detumbling.h"
+#include "autotune.h"
+#include "profile.h"
 
 /* ============================================================================
    DEFINIÇÕES DO PROTOCOLO ADCS
@@ -28,10 +49,107 @@
 #define ADCS_MIN_SPEED          -127
 #define ADCS_STOP_SPEED         0
 
+/* Supressão de comandos repetidos: a mesma velocidade só é reenviada depois
+   de ADCS_KEEPALIVE_MS (0 = nunca reenvia) */
+#define ADCS_KEEPALIVE_MS       500
+#define ADCS_TX_RING_SIZE       64      // Anel do DMA de transmissão (UART4)
+#define ADCS_RX_DMA_SIZE        256     // Buffer circular da telemetria (UART4)
+
+/* Telemetria do SimpleFOC: colunas na ordem do motor.monitor() */
+#define ADCS_MON_COL_VOLTAGE_Q  0
+#define ADCS_MON_COL_CURRENT_Q  1
+#define ADCS_MON_COL_VELOCITY   2
+#define ADCS_MON_COLUMNS        3
+#define ADCS_MON_LINE_MAX       48
+#define ADCS_TELEMETRY_TIMEOUT_MS 100   // Amostra mais velha que isso não fecha a malha
+
+/* Detecção de falhas do motor (velocidade em rad/s, mesma unidade do "M") */
+#define ADCS_VOLTAGE_LIMIT      12.0f   // motor.voltage_limit no SimpleFOC
+#define ADCS_SATURATION_RATIO   0.95f   // |Uq| acima disso = saturado
+#define ADCS_STALL_MIN_CMD      20      // Só procura travamento acima deste comando
+#define ADCS_STALL_SPEED        2.0f    // |vel| abaixo disso com comando = parado
+#define ADCS_STALL_MS           200     // Tempo parado até declarar travamento
+
+#define ADCS_FAULT_NONE         0x00
+#define ADCS_FAULT_STALL        0x01    // Roda parada com comando (trava até sair do modo)
+#define ADCS_FAULT_SATURATED    0x02    // Tensão no limite: não acompanha o comando
+#define ADCS_FAULT_NO_TELEMETRY 0x04    // Sem amostra recente
+
+/* Rampa da roda fora da malha fechada (ADCS_SetSpeedRamp e parada ao sair
+   do modo ADCS/DETUMBLING): curva S em vez de degrau no comando */
+#define ADCS_RAMP_ACCEL         20.0f   // rad/s² (0 -> 100 rad/s em ~5.2 s)
+#define ADCS_RAMP_JERK          100.0f  // rad/s³ (0 = trapezoidal)
+#define ADCS_RAMP_MAX_DT        0.1f    // Passo limitado a isso depois de uma pausa (s)
+
+/* Momento da roda e pedido de dessaturação (com histerese) */
+#define ADCS_WHEEL_INERTIA      1e-4f   // kg m² (Jzz / DETUMBLE_INERTIA_RATIO)
+#define ADCS_MOMENTUM_HIGH      0.8f    // |vel| / ADCS_MAX_SPEED acima disso: pede dessaturação
+#define ADCS_MOMENTUM_LOW       0.5f    // Abaixo disso o pedido cai
+
+/* Malha de controle a taxa fixa (interrupção do TIM6, prioridade 6; o SysTick
+ * fica em 4 para o HAL_GetTick e os timeouts de SPI andarem dentro dela) */
+#define ADCS_CONTROL_RATE_HZ    200     // Taxa padrão
+#define ADCS_CONTROL_RATE_MIN   100
+#define ADCS_CONTROL_RATE_MAX   1000
+#define ADCS_CONTROL_TICK_HZ    1000000 // Contagem do TIM6 (1 us)
+
+/* PID de atitude (giroscópio Z -> torque na roda), ganhos por segundo */
+#define ADCS_PID_KP             1.0f
+#define ADCS_PID_KI             (0.1f * ADCS_CONTROL_RATE_HZ)   // 20 /s a 200 Hz
+#define ADCS_PID_KD             (0.05f / ADCS_CONTROL_RATE_HZ)  // 0.00025 s a 200 Hz
+#define ADCS_PID_D_TAU          0.02f   // Filtro da derivada do giroscópio (~8 Hz)
+#define ADCS_PID_KT             20.0f   // Back-calculation (~Ki/Kp)
+#define ADCS_PID_SPEED_SCALE    10.0f   // Saída do PID -> variação de velocidade da roda
+
+/* Auto-tune do PID por relé (ADCS_Autotune_Start, só no modo ADCS) */
+#define ADCS_AUTOTUNE_RELAY     2.0f    // Saída do relé (x ADCS_PID_SPEED_SCALE = 20 rad/s na roda)
+#define ADCS_AUTOTUNE_HYSTERESIS 0.01f  // rad/s (~4x o ruído do giroscópio a 200 Hz)
+#define ADCS_AUTOTUNE_CYCLES    4       // Ciclos medidos (depois do descartado)
+#define ADCS_AUTOTUNE_EVAL_S    5.0f    // Janela do RMS antes e depois (s)
+#define ADCS_AUTOTUNE_TIMEOUT_S 20.0f   // Relé sem oscilar por esse tempo = falha
+#define ADCS_AUTOTUNE_DEGRADE   1.2f    // RMS novo > 1.2x o antigo = volta os ganhos
+
+/* Estimador de atitude (Mahony: giroscópio + gravidade + Sol) */
+#define ADCS_ATT_KP_ACC         1.0f    // rad/s
+#define ADCS_ATT_KP_SUN         0.5f    // rad/s
+#define ADCS_ATT_KI             0.05f   // 1/s (bias do giroscópio)
+#define ADCS_ATT_MAX_DT         0.1f    // Intervalo maior que isso: só remarca o tempo (s)
+#define ADCS_SUN_TIMEOUT_MS     500     // Vetor solar mais velho que isso é ignorado
+
+/* Estimador usado: 1 = MEKF (apontamento fino), 0 = Mahony (mais leve) */
+#define ADCS_ATT_USE_MEKF       1
+#define ADCS_MEKF_GYRO_NOISE    2.4e-4f // BMI088: 0.014 deg/s/sqrt(Hz)
+#define ADCS_MEKF_BIAS_NOISE    1e-5f   // rad/s^2/sqrt(Hz)
+#define ADCS_MEKF_ACC_NOISE     0.02f   // rad
+#define ADCS_MEKF_SUN_NOISE     0.05f   // rad (LDRs)
+#define ADCS_MEKF_ATT_SIGMA0    1.0f    // rad
+#define ADCS_MEKF_BIAS_SIGMA0   0.02f   // rad/s
+
 /* Comandos SimpleFOC */
 #define ADCS_CMD_STOP           "M0\n"      // Para o motor
 #define ADCS_CMD_SELECT_MOTOR   "MC1\n"    // Seleciona motor 1
 
+/* Protocolo binário */
+#define ADCS_BIN_SYNC           0xA5
+#define ADCS_BIN_CMD_TARGET     0x01        // Setpoint de velocidade (rad/s)
+#define ADCS_BIN_FRAME_SIZE     7
+#define ADCS_DEFAULT_FRAMING    ADCS_FRAMING_ASCII
+
+/* Atuador da roda: PWM/DIR/EN com tacômetro (wheel_pwm.h) no lugar da UART */
+#define ADCS_DEFAULT_ACTUATOR   ADCS_ACTUATOR_UART
+#define ADCS_PWM_FULL_SCALE     127.0f      // rad/s com duty 100% (escala do driver)
+
+typedef enum {
+    ADCS_ACTUATOR_UART = 0,     // SimpleFOC: comando e monitor pela UART4
+    ADCS_ACTUATOR_PWM           // TIM2_CH3 + DIR + EN, velocidade pela captura do TIM5
+} ADCS_Actuator_t;
+
+/* Modos de enquadramento dos comandos de velocidade */
+typedef enum {
+    ADCS_FRAMING_ASCII = 0,     // "M{speed}\n", inteiro de -127 a +127
+    ADCS_FRAMING_BINARY         // Frame fixo com float e CRC-8 (resolução fina)
+} ADCS_FramingMode_t;
+
 /* ============================================================================
    ESTRUTURAS DE DADOS
    ============================================================================ */
@@ -42,8 +160,32 @@ typedef struct {
     int16_t current_speed;      // Velocidade atual do motor
     uint8_t motor_active;       // Flag: motor ativo?
     uint8_t motor_initialized;  // Flag: motor inicializado?
+    float sent_speed;           // Última velocidade aceita pela UART
+    uint8_t sent_valid;         // Flag: sent_speed vale?
+    uint32_t sent_tick;         // HAL_GetTick() do último envio
 } ADCS_State_t;
 
+/* Estado medido do motor (telemetria do SimpleFOC ou tacômetro do PWM) */
+typedef struct {
+    float voltage_q;            // Tensão q aplicada (V; no PWM, duty x ADCS_VOLTAGE_LIMIT)
+    float current_q;            // Corrente q (A; no PWM, não medida)
+    float velocity;             // Velocidade da roda (rad/s)
+    uint32_t timestamp_ms;      // HAL_GetTick() da amostra
+    uint32_t timestamp_cycles;  // DWT->CYCCNT da chegada (evento do DMA ou leitura)
+    uint32_t samples;           // Linhas aceitas (no PWM, leituras do tacômetro)
+    uint32_t rejected;          // Linhas fora do formato
+    uint8_t valid;              // Flag: já recebeu alguma amostra?
+} ADCS_MotorState_t;
+
+/* Contadores dos comandos de velocidade */
+typedef struct {
+    uint32_t commands_sent;     // Comandos entregues à UART
+    uint32_t commands_skipped;  // Iguais ao último enviado (suprimidos)
+    uint32_t commands_dropped;  // Anel de transmissão cheio
+    uint32_t last_cycles;       // Custo do último ADCS_SetSpeed (ciclos DWT)
+    uint32_t max_cycles;
+} ADCS_CommandStats_t;
+
 /* Dados dos sensores para PID (estrutura para expansão futura) */
 typedef struct {
     float gyro_x;            
@@ -54,15 +196,47 @@ typedef struct {
     float accel_z;             
 } ADCS_Sensors_t;
 
-/* Parâmetros do PID */
+/* Momento da roda */
+typedef struct {
+    float wheel_speed;          // rad/s (telemetria ou último comando)
+    float momentum;             // N m s (ADCS_WHEEL_INERTIA x wheel_speed)
+    float fraction;             // |wheel_speed| / ADCS_MAX_SPEED
+    uint8_t desat_needed;       // Passou de ADCS_MOMENTUM_HIGH e não caiu abaixo de _LOW
+    uint32_t desat_events;      // Vezes que o pedido acendeu
+} ADCS_Momentum_t;
+
+/* Atitude estimada */
+typedef struct {
+    Attitude_Quat_t q;          // Corpo -> inercial
+    float roll;                 // Euler ZYX (rad)
+    float pitch;
+    float yaw;
+    float rate[3];              // Giroscópio sem o bias estimado (rad/s)
+    float gyro_bias[3];         // Bias estimado (rad/s)
+    float att_sigma[3];         // Desvio padrão da atitude (rad; 0 com Mahony)
+    uint8_t acc_used;           // Última iteração corrigiu com a gravidade?
+    uint8_t sun_used;           // Última iteração corrigiu com o Sol?
+    uint32_t updates;
+} ADCS_Attitude_t;
+
+/* Tempo da malha de controle (ciclos DWT) */
 typedef struct {
-    float Kp;                   // Ganho proporcional
-    float Ki;                   // Ganho integral
-    float Kd;                   // Ganho derivativo
-    float setpoint;             // Valor desejado
-    float error_sum;            // Soma dos erros (integral)
-    float last_error;           // Último erro (derivativo)
-} ADCS_PID_t;
+    uint32_t rate_hz;           // Taxa configurada (0 = malha parada)
+    uint32_t ticks;             // Execuções
+    uint32_t overruns;          // Execuções mais longas que o período
+    int32_t jitter_min_cycles;  // Intervalo medido - período nominal
+    int32_t jitter_max_cycles;
+    int32_t jitter_mean_cycles;
+    uint32_t exec_min_cycles;   // Tempo de execução de uma iteração
+    uint32_t exec_max_cycles;
+    uint32_t exec_mean_cycles;
+    uint32_t attitude_last_cycles;  // Custo do estimador (iteração completa)
+    uint32_t attitude_max_cycles;
+    uint32_t mekf_predict_last_cycles;
+    uint32_t mekf_predict_max_cycles;
+    uint32_t mekf_update_last_cycles;   // Gravidade + Sol
+    uint32_t mekf_update_max_cycles;
+} ADCS_TimingStats_t;
 
 /* ============================================================================
    FUNÇÕES PÚBLICAS
@@ -74,21 +248,60 @@ void ADCS_Init(UART_HandleTypeDef *huart);
 // Controle do motor
 
 void ADCS_SetSpeed(UART_HandleTypeDef *huart, int16_t speed);
+void ADCS_SetSpeedFloat(UART_HandleTypeDef *huart, float speed);
+void ADCS_SetFraming(ADCS_FramingMode_t mode);
+ADCS_FramingMode_t ADCS_GetFraming(void);
 void ADCS_Stop(UART_HandleTypeDef *huart);
+
+// Atuador (com a malha do TIM6 parada; a roda para na troca)
+HAL_StatusTypeDef ADCS_SetActuator(UART_HandleTypeDef *huart, ADCS_Actuator_t actuator);
+ADCS_Actuator_t ADCS_GetActuator(void);
+
+// Rampa sem bloqueio (fora dos modos ADCS/DETUMBLING; avança no ADCS_Process ou no TIM6)
+HAL_StatusTypeDef ADCS_SetSpeedRamp(float speed);
+uint8_t ADCS_IsRampDone(void);
+void ADCS_GetMomentum(ADCS_Momentum_t *out);
 void ADCS_SendCommand(UART_HandleTypeDef *huart, const char *cmd);
 
 void ADCS_ReadSensors(ADCS_Sensors_t *sensors);
 
-// Controle PID
-float ADCS_PID_Compute(ADCS_PID_t *pid, float current_value);
-void ADCS_PID_Reset(ADCS_PID_t *pid);
+// Atitude
+void ADCS_SetSunVector(const float sun[3], uint8_t valid);
+void ADCS_SetSunReference(const float ref[3]);
+void ADCS_GetAttitude(ADCS_Attitude_t *out);
+
+// Detumbling (tempo até estabilizar, ganho agendado, saturação de momento)
+void ADCS_GetDetumbleStatus(Detumble_Gyro_t *out);
+
+// Telemetria do motor
+void ADCS_PollTelemetry(void);
+void ADCS_GetMotorState(ADCS_MotorState_t *state);
+uint8_t ADCS_IsTelemetryFresh(void);
+uint8_t ADCS_GetMotorFaults(void);
+
+// Controle PID (troca de ganhos sem degrau na saída)
+void ADCS_SetPIDGains(float kp, float ki, float kd);
+void ADCS_GetPIDGains(float *kp, float *ki, float *kd);
+
+// Auto-tune do PID (relé, Ku/Tu, verificação e volta dos ganhos antigos)
+HAL_StatusTypeDef ADCS_Autotune_Start(void);
+void ADCS_Autotune_Abort(void);
+void ADCS_GetAutotuneStatus(Autotune_t *out);
 
 // Rotina ADCS (chamada no loop principal)
 void ADCS_Process(UART_HandleTypeDef *huart);
 
+// Malha de controle no TIM6 (substitui o ADCS_Process no loop)
+HAL_StatusTypeDef ADCS_Control_Start(UART_HandleTypeDef *huart, uint32_t rate_hz);
+void ADCS_Control_Stop(void);
+uint8_t ADCS_Control_IsRunning(void);
+void ADCS_GetTimingStats(ADCS_TimingStats_t *stats);
+void ADCS_ResetTimingStats(void);
+
 // Getters de estado
 int16_t ADCS_GetCurrentSpeed(void);
 int16_t ADCS_GetTargetSpeed(void);
+void ADCS_GetCommandStats(ADCS_CommandStats_t *stats);
 uint8_t ADCS_IsMotorActive(void);
 uint8_t ADCS_IsSensorReady(void);
 
@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    attitude.h
+  * @brief   Estimador de atitude em quatérnio (filtro complementar de Mahony)
+  *
+  * Fusão do giroscópio com até duas direções de referência:
+  *   - gravidade (acelerômetro), referência (0, 0, 1) no sistema inercial
+  *   - Sol (sensores de luz), referência ajustável em Attitude_SetSunReference
+  *
+  * Por iteração (período dt):
+  *   v_est = R(q)^T * v_ref                     (referência vista no corpo)
+  *   e     = kp_acc*(a x a_est) + kp_sun*(s x s_est)
+  *   b    -= ki*(a x a_est + s x s_est)*dt     (bias do giroscópio)
+  *   w     = gyro - b + e
+  *   q    += 0.5 * q (x) (0, w) * dt, normaliza
+  *
+  * q leva vetores do corpo para o sistema inercial. Uma medida ausente
+  * (NULL) ou inválida só deixa de corrigir: o giroscópio continua
+  * propagando. Tudo em float (FPU de precisão simples do M7, raiz pela
+  * instrução VSQRT): pode rodar na interrupção da malha de controle.
+  ******************************************************************************
+  */
+
+#ifndef __ATTITUDE_H
+#define __ATTITUDE_H
+
+#include <stdint.h>
+#include <math.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+#define ATTITUDE_GRAVITY        9.80665f    // m/s²
+#define ATTITUDE_ACC_GATE       0.1f        // Usa o acelerômetro com |a| a até 10% de g
+#define ATTITUDE_BIAS_LIMIT     0.1f        // Bias máximo estimado (rad/s, ~5.7 deg/s)
+#define ATTITUDE_SUN_MIN_NORM   0.1f        // Sol quase no eixo Z: azimute indefinido
+
+/* ============================================================================
+   ESTRUTURAS DE DADOS
+   ============================================================================ */
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} Attitude_Quat_t;
+
+typedef struct {
+    Attitude_Quat_t q;          // Corpo -> inercial
+    float bias[3];              // Bias estimado do giroscópio (rad/s)
+    float kp_acc;               // Ganho proporcional da gravidade (rad/s)
+    float kp_sun;               // Ganho proporcional do Sol (rad/s)
+    float ki;                   // Ganho integral do bias (1/s)
+    float sun_ref[3];           // Direção do Sol no sistema inercial (unitária)
+    uint8_t sun_planar;         // Sensor só mede o azimute no plano XY do corpo
+    uint8_t acc_used;           // Última iteração corrigiu com a gravidade?
+    uint8_t sun_used;           // Última iteração corrigiu com o Sol?
+    uint32_t updates;
+} Attitude_t;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+/**
+ * @brief Raiz quadrada em precisão simples
+ * @note No Cortex-M7 vira uma instrução VSQRT.F32 (sem a chamada à libm
+ *       que o sqrtf faz para tratar errno)
+ */
+static inline float Attitude_Sqrt(float x)
+{
+#if defined(__ARM_FP) && (__ARM_FP & 4)
+    float result;
+    __asm volatile ("vsqrt.f32 %0, %1" : "=t" (result) : "t" (x));
+    return result;
+#else
+    return sqrtf(x);
+#endif
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Attitude_Init(Attitude_t *att, float kp_acc, float kp_sun, float ki);
+void Attitude_Reset(Attitude_t *att);
+void Attitude_SetSunReference(Attitude_t *att, const float ref[3], uint8_t planar);
+void Attitude_Update(Attitude_t *att, const float gyro[3], const float *accel,
+                     const float *sun, float dt);
+
+// Conversões
+void Attitude_RotateToBody(const Attitude_Quat_t *q, const float v[3], float out[3]);
+void Attitude_ToEuler(const Attitude_Quat_t *q, float *roll, float *pitch, float *yaw);
+
+#endif /* __ATTITUDE_H */
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    autotune.h
+  * @brief   Auto-tune de PID por realimentação a relé (Åström-Hägglund)
+  *
+  * Fases (uma chamada de Autotune_Update por iteração da malha):
+  *   BASELINE  ganhos atuais no PID; mede o RMS do erro por eval_time
+  *   RELAY     relé com histerese no lugar do PID: u = +-d conforme o erro.
+  *             A malha oscila no período crítico; o primeiro ciclo é
+  *             descartado e os `cycles` seguintes dão a média de
+  *             Tu (período) e a (meia amplitude pico a pico da medida):
+  *               Ku = 4 d / (pi sqrt(a² - eps²))
+  *             Ganhos pela regra de Tyreus-Luyben (menos sobressinal que
+  *             Ziegler-Nichols, tolera o atraso da telemetria):
+  *               kp = Ku / 2.2    ki = kp / (2.2 Tu)    kd = kp Tu / 6.3
+  *   VERIFY    ganhos novos no PID; mede o RMS por eval_time
+  *   DONE      RMS novo <= degrade_ratio * RMS base: ganhos novos ficam
+  *   ROLLED_BACK  piorou: ganhos antigos de volta
+  *   FAILED    relé sem oscilação até relay_timeout, ou abortado
+  *
+  * O módulo não mexe no PID: Autotune_Update devolve o evento e o chamador
+  * troca os ganhos (PID_x_SetGains) na mesma iteração.
+  ******************************************************************************
+  */
+
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    float relay_amplitude;      // d (unidade da saída do PID)
+    float hysteresis;           // eps (unidade da medida), acima do ruído
+    float eval_time;            // Janela do RMS antes e depois (s)
+    float relay_timeout;        // Tempo máximo no relé (s)
+    float degrade_ratio;        // RMS novo acima de ratio * base = volta
+    uint8_t cycles;             // Ciclos medidos depois do descartado
+} Autotune_Config_t;
+
+typedef enum {
+    AUTOTUNE_IDLE = 0,
+    AUTOTUNE_BASELINE,
+    AUTOTUNE_RELAY,
+    AUTOTUNE_VERIFY,
+    AUTOTUNE_DONE,
+    AUTOTUNE_ROLLED_BACK,
+    AUTOTUNE_FAILED
+} Autotune_Phase_t;
+
+typedef enum {
+    AUTOTUNE_EVT_NONE = 0,
+    AUTOTUNE_EVT_APPLY,         // Aplicar new_kp/ki/kd (RELAY -> VERIFY)
+    AUTOTUNE_EVT_RESTORE,       // Voltar a old_kp/ki/kd (VERIFY -> ROLLED_BACK)
+    AUTOTUNE_EVT_RELEASE        // Relé terminou sem resultado: o PID volta (ganhos antigos)
+} Autotune_Event_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    Autotune_Config_t cfg;
+    Autotune_Phase_t phase;
+
+    // Ganhos
+    float old_kp, old_ki, old_kd;
+    float new_kp, new_ki, new_kd;
+
+    // Resultado
+    float ku;                   // Ganho crítico
+    float tu;                   // Período crítico (s)
+    float rms_baseline;         // RMS do erro com os ganhos antigos
+    float rms_verify;           // RMS do erro com os ganhos novos
+
+    // Interno
+    float elapsed;              // Tempo na fase atual (s)
+    float sq_sum;
+    uint32_t samples;
+    int8_t relay;               // +1 / -1
+    uint8_t rises;              // Trocas para +1 já vistas
+    float last_rise;            // Instante da última troca para +1 (s)
+    float peak_max;             // Extremos da medida no ciclo atual
+    float peak_min;
+    float period_sum;
+    float amplitude_sum;
+    uint8_t measured;           // Ciclos somados
+} Autotune_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Autotune_Init(Autotune_t *at, const Autotune_Config_t *cfg);
+
+// Começa pela medida de referência; guarda os ganhos atuais para a volta
+void Autotune_Start(Autotune_t *at, float kp, float ki, float kd);
+
+// Interrompe; retorna o evento que o chamador deve aplicar (RESTORE em VERIFY)
+Autotune_Event_t Autotune_Abort(Autotune_t *at);
+
+// Uma iteração: out recebe a saída do relé (válida em AUTOTUNE_RELAY)
+Autotune_Event_t Autotune_Update(Autotune_t *at, float setpoint, float measurement,
+                                 float dt, float *out);
+
+uint8_t Autotune_IsRunning(const Autotune_t *at);
+
+#endif /* __AUTOTUNE_H */
@@ -11,6 +11,8 @@
 #include "fdcan.h"
 #include <stdint.h>
 
+#define CAN_RX_QUEUE_SIZE   16      // Mensagens recebidas aguardando o loop
+
 /* CAN Message Structure - Fixed 8 bytes */
 typedef struct {
     uint32_t id;
@@ -20,6 +22,9 @@ typedef struct {
 /* Public Functions */
 void CAN_Init(void);
 void CAN_Transmit(CAN_Message_t *msg);
+uint8_t CAN_TxReady(void);
 uint8_t CAN_GetMessage(CAN_Message_t *msg);
+uint32_t CAN_GetLastRxCycles(void);    // DWT na chegada da última mensagem lida
+uint32_t CAN_GetRxOverruns(void);
 
 #endif /* __CAN_DRIVER_H */
@@ -24,6 +24,13 @@
 #define CAN_CDH_TELEMETRY       (CAN_ADDR_CDH_BASE + 0x00)  // 0x100 - Telemetria geral
 #define CAN_CDH_STATUS          (CAN_ADDR_CDH_BASE + 0x01)  // 0x101 - Status atual
 #define CAN_CDH_ERROR           (CAN_ADDR_CDH_BASE + 0x03)  // 0x103 - Erro reportado
+#define CAN_CDH_RESULT_INFO     (CAN_ADDR_CDH_BASE + 0x04)  // 0x104 - Cabeçalho de resultado de missão
+#define CAN_CDH_LINK_STATS      (CAN_ADDR_CDH_BASE + 0x10)  // 0x110 - Contador do enlace UART
+#define CAN_CDH_LINK_RTT        (CAN_ADDR_CDH_BASE + 0x11)  // 0x111 - Bucket do histograma de latência
+#define CAN_CDH_BRIDGE_STATS    (CAN_ADDR_CDH_BASE + 0x12)  // 0x112 - Latência da ponte CAN -> Payload
+#define CAN_CDH_DETUMBLE_STATUS (CAN_ADDR_CDH_BASE + 0x13)  // 0x113 - Progresso do detumbling
+#define CAN_CDH_AUTOTUNE_STATUS (CAN_ADDR_CDH_BASE + 0x14)  // 0x114 - Resultado do auto-tune do PID
+#define CAN_CDH_MOMENTUM_STATUS (CAN_ADDR_CDH_BASE + 0x15)  // 0x115 - Momento da roda / dessaturação
 
 /* ============================================================================
    COMANDOS EPS (0x200 - 0x2FF)
@@ -44,6 +51,24 @@
 #define CAN_COM_MODE_DETUMBLING (CAN_ADDR_COM_BASE + 0x03)  // 0x303 - Entrar em modo DETUMBLING
 #define CAN_COM_MODE_EXIT       (CAN_ADDR_COM_BASE + 0x0F)  // 0x30F - Sair do modo atual
 
+// Telemetria de enlace UART (data[0] = índice da porta, data[1] = 1 zera após o envio)
+#define CAN_COM_LINK_STATS_REQ  (CAN_ADDR_COM_BASE + 0x10)  // 0x310 - Pede contadores e histogramas
+
+// Confirmação de resultado de missão (data[0..1] = seq, big-endian)
+#define CAN_COM_RESULT_ACK      (CAN_ADDR_COM_BASE + 0x11)  // 0x311 - Resultado recebido pelo COM
+
+// Latência da ponte de comandos (data[0] = 1 zera após o envio)
+#define CAN_COM_BRIDGE_STATS_REQ (CAN_ADDR_COM_BASE + 0x12) // 0x312 - Pede a latência da ponte
+
+// Progresso do detumbling (sem dados)
+#define CAN_COM_DETUMBLE_REQ    (CAN_ADDR_COM_BASE + 0x13)  // 0x313 - Pede o estado do detumbling
+
+// Auto-tune do PID de atitude (data[0] = CAN_AUTOTUNE_CMD_*)
+#define CAN_COM_AUTOTUNE_CMD    (CAN_ADDR_COM_BASE + 0x14)  // 0x314 - Inicia/aborta o auto-tune
+
+// Momento da roda (sem dados)
+#define CAN_COM_MOMENTUM_REQ    (CAN_ADDR_COM_BASE + 0x15)  // 0x315 - Pede o momento da roda
+
 // Dados de missão
 #define CAN_COM_AIS_DATA        (CAN_ADDR_COM_BASE + 0x20)  // 0x320 - Dados AIS 
 
@@ -99,6 +124,65 @@ typedef struct {
     uint8_t packet_index;   // Índice do pacote (se fragmentado)
 } AIS_Data_t;
 
+/* Telemetria de enlace UART (resposta a CAN_COM_LINK_STATS_REQ)
+ *
+ * CAN_CDH_LINK_STATS: [porta, índice (UART_StatIndex_t), valor (4 bytes, big-endian),
+ *                      total de contadores, 0]
+ * CAN_CDH_LINK_RTT  : [porta, tipo (UART_RttKind_t), msg_id, bucket, contagem (2 bytes), 0, 0]
+ *                     Só buckets não vazios; tipo = 0xFF encerra o envio.
+ */
+#define CAN_LINK_RTT_END        0xFF
+
+/* Latência da ponte CAN -> Payload (resposta a CAN_COM_BRIDGE_STATS_REQ)
+ *
+ * CAN_CDH_BRIDGE_STATS: [tipo, a (2 bytes), b (2 bytes), c (2 bytes), 0], big-endian,
+ *                       valores saturam em 0xFFFF
+ *   tipo 0 (dispatch) / 1 (wire): a = mínimo, b = média, c = máximo (us)
+ *   tipo 2 (contadores)         : a = comandos, b = encaminhados, c = adiados
+ */
+#define CAN_BRIDGE_STATS_DISPATCH   0
+#define CAN_BRIDGE_STATS_WIRE       1
+#define CAN_BRIDGE_STATS_COUNTERS   2
+
+/* Progresso do detumbling (resposta a CAN_COM_DETUMBLE_REQ; também enviado
+ * sozinho quando estabiliza)
+ *
+ * CAN_CDH_DETUMBLE_STATUS: [flags, tempo (4 bytes, ms), |w| (2 bytes, mrad/s),
+ *                           ganho (1/s x 100)], big-endian, valores saturam
+ *   flags: bit 0 = em detumbling, bit 1 = estável, bit 2 = momento da roda limitado
+ *   tempo: até estabilizar (estável) ou desde a entrada no modo
+ */
+#define CAN_DETUMBLE_ACTIVE         0x01
+#define CAN_DETUMBLE_CONVERGED      0x02
+#define CAN_DETUMBLE_MOMENTUM_LIMIT 0x04
+
+/* Auto-tune do PID de atitude (só no modo ADCS). Toda CAN_COM_AUTOTUNE_CMD é
+ * respondida com CAN_CDH_AUTOTUNE_STATUS, que também é enviado sozinho
+ * quando o experimento termina
+ *
+ * CAN_CDH_AUTOTUNE_STATUS: [fase, Ku (2 bytes, x 100), Tu (2 bytes, ms),
+ *                           RMS antes (mrad/s), RMS depois (mrad/s), recusado],
+ *                          big-endian, valores saturam
+ *   fase: Autotune_Phase_t (0 parado, 1 referência, 2 relé, 3 verificação,
+ *         4 ganhos novos, 5 ganhos antigos de volta, 6 falhou)
+ *   recusado: 1 se o último início foi recusado (fora do modo ADCS ou em andamento)
+ */
+#define CAN_AUTOTUNE_CMD_ABORT      0
+#define CAN_AUTOTUNE_CMD_START      1
+#define CAN_AUTOTUNE_CMD_STATUS     2
+
+/* Momento da roda (resposta a CAN_COM_MOMENTUM_REQ; também enviado sozinho
+ * quando o pedido de dessaturação acende)
+ *
+ * CAN_CDH_MOMENTUM_STATUS: [flags, velocidade (2 bytes, rad/s x 100, com sinal),
+ *                           momento (2 bytes, uN m s, com sinal), carga (%),
+ *                           pedidos de dessaturação (2 bytes)], big-endian
+ *   flags: bit 0 = dessaturação pedida, bit 1 = rampa em andamento
+ *   carga: |velocidade| / ADCS_MAX_SPEED
+ */
+#define CAN_MOMENTUM_DESAT          0x01
+#define CAN_MOMENTUM_RAMP           0x02
+
 /* Getters para estado atual CDH */
 CDH_OperationMode_t CAN_GetCurrentMode(void);
 MissionType_t CAN_GetMissionType(void);
@@ -125,6 +209,19 @@ void CAN_Protocol_SendCDHStatus(void);
 void CAN_HandleModeCommand(uint32_t mode_id, uint8_t *data);
 void CAN_HandleAISData(uint8_t *data);
 
+void CAN_HandleLinkStatsRequest(uint8_t *data);
+void CAN_Protocol_SendLinkStats(void);
+
+void CAN_HandleBridgeStatsRequest(uint8_t *data);
+void CAN_Protocol_SendBridgeStats(void);
+
+void CAN_Protocol_SendDetumbleStatus(void);
+
+void CAN_HandleAutotuneCommand(uint8_t *data);
+void CAN_Protocol_SendAutotuneStatus(void);
+
+void CAN_Protocol_SendMomentumStatus(void);
+
 /* Handlers para telemetria EPS */
 void CAN_HandleEPSTelemetry(uint32_t msg_id, uint8_t *data);
 
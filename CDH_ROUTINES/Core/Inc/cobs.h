@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file    cobs.h
+  * @brief   Consistent Overhead Byte Stuffing (COBS) incremental
+  *
+  * Remove todos os bytes 0x00 do frame para que 0x00 possa ser usado como
+  * delimitador. Overhead máximo: 1 byte a cada 254 bytes de dados.
+  *
+  * O codificador escreve direto no destino, byte a byte, e aceita um buffer
+  * circular (a escrita dá a volta no fim): o frame é montado no próprio anel
+  * de TX do DMA. O decodificador também é byte a byte, para o parser montar
+  * o frame direto no buffer do pool enquanto lê o anel de RX.
+  ******************************************************************************
+  */
+
+#ifndef __COBS_H
+#define __COBS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define COBS_DELIMITER              0x00
+
+/* Bytes de código inseridos no pior caso */
+#define COBS_MAX_OVERHEAD(len)      (((len) / 254) + 1)
+
+/* Tamanho máximo do frame codificado (sem o delimitador) */
+#define COBS_ENCODED_MAX(len)       ((len) + COBS_MAX_OVERHEAD(len))
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t size;          // Tamanho do buffer (a escrita dá a volta no fim)
+    uint16_t pos;           // Próxima posição de escrita
+    uint16_t code_pos;      // Onde vai o byte de código do bloco atual
+    uint16_t count;         // Bytes escritos até aqui
+    uint8_t code;
+} COBS_Encoder_t;
+
+typedef struct {
+    uint8_t code;           // Código do bloco atual (0 = início do frame)
+    uint8_t left;           // Bytes de dados que ainda faltam no bloco
+} COBS_Decoder_t;
+
+// Codificação: Start, Put por byte bruto, Finish (fecha o bloco e põe o delimitador)
+void COBS_EncodeStart(COBS_Encoder_t *enc, uint8_t *buf, uint16_t size, uint16_t pos);
+void COBS_EncodePut(COBS_Encoder_t *enc, uint8_t byte);
+uint16_t COBS_EncodeFinish(COBS_Encoder_t *enc);
+
+// Decodificação de um frame (bytes entre delimitadores)
+void COBS_DecodeStart(COBS_Decoder_t *dec);
+uint8_t COBS_DecodePut(COBS_Decoder_t *dec, uint8_t byte, uint8_t *out);
+uint8_t COBS_DecodeValid(const COBS_Decoder_t *dec);
+
+#endif /* __COBS_H */
@@ -0,0 +1,29 @@
+/**
+  ******************************************************************************
+  * @file    crc32.h
+  * @brief   CRC-32 (IEEE 802.3, polinômio refletido 0xEDB88320) incremental
+  *
+  * Mesmo resultado do zlib/binascii.crc32:
+  *   crc = CRC32_INIT;
+  *   crc = CRC32_Update(crc, parte1, n1);
+  *   crc = CRC32_Update(crc, parte2, n2);
+  *   resultado = CRC32_Final(crc);
+  ******************************************************************************
+  */
+
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC32_INIT              0xFFFFFFFFUL
+#define CRC32_Final(crc)        ((crc) ^ 0xFFFFFFFFUL)
+
+// Acumula len bytes no CRC parcial (tabela de 16 entradas, 4 bits por passo)
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, size_t len);
+
+// CRC de um bloco completo
+uint32_t CRC32_Compute(const uint8_t *data, size_t len);
+
+#endif /* __CRC32_H */
@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    dwt.h
+  * @brief   Contador de ciclos do núcleo (DWT->CYCCNT) para medir latências
+  *
+  * Resolução de um ciclo de CPU, leitura de um registrador, pode ser usado
+  * em interrupções. Dá a volta a cada 2^32 ciclos (~10 s a 400 MHz): medir
+  * só intervalos curtos, sempre por subtração sem sinal.
+  ******************************************************************************
+  */
+
+#ifndef __DWT_H
+#define __DWT_H
+
+#include "main.h"
+#include <stdint.h>
+
+/**
+ * @brief Liga o contador de ciclos (idempotente)
+ */
+static inline void DWT_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55;              // Destrava o acesso (Cortex-M7)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+static inline uint32_t DWT_GetCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Converte um intervalo em ciclos para microssegundos
+ */
+static inline uint32_t DWT_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+#endif /* __DWT_H */
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    lzss.h
+  * @brief   Compressão LZSS em fluxo (estilo heatshrink) com RAM fixa
+  *
+  * Codificador e decodificador trabalham em pedaços de qualquer tamanho, sem
+  * malloc, e podem ficar entre um produtor e o transporte (UART, CAN, QSPI):
+  *
+  *   LZSS_EncoderReset(&enc);
+  *   while (há entrada) {
+  *       usados = LZSS_EncoderSink(&enc, in, n);     // Aceita o que couber
+  *       while ((k = LZSS_EncoderPoll(&enc, out, sizeof(out))) > 0) envia(out, k);
+  *   }
+  *   LZSS_EncoderFinish(&enc);
+  *   while ((k = LZSS_EncoderPoll(&enc, out, sizeof(out))) > 0) envia(out, k);
+  *
+  * Formato (bits MSB primeiro, último byte completado com zeros):
+  *   1 + byte(8)                                  : literal
+  *   0 + distância-1 (WINDOW_BITS) + tamanho-2 (LOOKAHEAD_BITS) : cópia
+  * Os dois lados precisam usar os mesmos WINDOW_BITS/LOOKAHEAD_BITS.
+  ******************************************************************************
+  */
+
+#ifndef __LZSS_H
+#define __LZSS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+#define LZSS_WINDOW_BITS            8       // Janela de 256 bytes
+#define LZSS_LOOKAHEAD_BITS         4       // Cópias de 2 a 17 bytes
+
+#define LZSS_WINDOW_SIZE            (1U << LZSS_WINDOW_BITS)
+#define LZSS_MIN_MATCH              2       // Cópia de 2 bytes (13 bits) já ganha de 2 literais (18 bits)
+#define LZSS_MAX_MATCH              ((1U << LZSS_LOOKAHEAD_BITS) + LZSS_MIN_MATCH - 1)
+#define LZSS_DECODER_INPUT_SIZE     32
+
+/* Pior caso: 9 bits por byte de entrada */
+#define LZSS_COMPRESSED_MAX(len)    ((len) + ((len) + 7) / 8 + 1)
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    uint8_t buf[2 * LZSS_WINDOW_SIZE];  // Histórico (até uma janela) + entrada
+    uint16_t len;                       // Bytes válidos em buf
+    uint16_t pos;                       // Próximo byte a codificar
+    uint32_t bits;                      // Acumulador de saída
+    uint8_t bit_count;
+    uint8_t finishing;
+} LZSS_Encoder_t;
+
+typedef struct {
+    uint8_t window[LZSS_WINDOW_SIZE];   // Últimos bytes produzidos
+    uint16_t head;
+    uint8_t in_buf[LZSS_DECODER_INPUT_SIZE];
+    uint8_t in_len;
+    uint8_t in_pos;
+    uint32_t bits;                      // Acumulador de entrada
+    uint8_t bit_count;
+    uint8_t copy_left;                  // Cópia interrompida por falta de saída
+    uint16_t copy_dist;
+} LZSS_Decoder_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+// Codificador
+void LZSS_EncoderReset(LZSS_Encoder_t *enc);
+size_t LZSS_EncoderSink(LZSS_Encoder_t *enc, const uint8_t *in, size_t len);
+size_t LZSS_EncoderPoll(LZSS_Encoder_t *enc, uint8_t *out, size_t size);
+void LZSS_EncoderFinish(LZSS_Encoder_t *enc);   // Sem mais entrada: esvazia no Poll
+uint8_t LZSS_EncoderIsDone(const LZSS_Encoder_t *enc);
+
+// Decodificador
+void LZSS_DecoderReset(LZSS_Decoder_t *dec);
+size_t LZSS_DecoderSink(LZSS_Decoder_t *dec, const uint8_t *in, size_t len);
+size_t LZSS_DecoderPoll(LZSS_Decoder_t *dec, uint8_t *out, size_t size);
+
+#endif /* __LZSS_H */
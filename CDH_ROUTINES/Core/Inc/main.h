@@ -46,6 +46,8 @@ extern "C" {
 
 /* Exported macro ------------------------------------------------------------*/
 /* USER CODE BEGIN EM */
+/* Variável na DTCM (sem cache, 0 wait state); não é zerada no startup */
+#define DTCM_DATA __attribute__((section(".dtcm")))
 
 /* USER CODE END EM */
 
@@ -119,6 +121,8 @@ void Error_Handler(void);
 #define SYS_SCL_GPIO_Port GPIOH
 #define SYS_SDA_Pin GPIO_PIN_8
 #define SYS_SDA_GPIO_Port GPIOH
+#define ADCS_TACH_Pin GPIO_PIN_10
+#define ADCS_TACH_GPIO_Port GPIOH
 #define PAY_SCL_Pin GPIO_PIN_11
 #define PAY_SCL_GPIO_Port GPIOH
 #define PAY_SDA_Pin GPIO_PIN_12
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    matrix.h
+  * @brief   Operações de matriz em float (linha a linha), interface no
+  *          formato do arm_mat_*_f32 do CMSIS-DSP
+  *
+  * As matrizes não alocam memória: Mat_t só aponta para um vetor do
+  * chamador com rows*cols elementos. As dimensões não são conferidas nas
+  * operações (uso com tamanhos fixos); o destino não pode ser uma das
+  * entradas, exceto em Mat_Add/Mat_Sub/Mat_Scale.
+  ******************************************************************************
+  */
+
+#ifndef __MATRIX_H
+#define __MATRIX_H
+
+#include <stdint.h>
+
+#define MAT_MAX_INVERSE     6       // Maior ordem aceita por Mat_Inverse
+
+typedef struct {
+    uint16_t rows;
+    uint16_t cols;
+    float *data;
+} Mat_t;
+
+#define MAT_AT(m, r, c)     ((m)->data[(r) * (m)->cols + (c)])
+
+void Mat_Init(Mat_t *m, uint16_t rows, uint16_t cols, float *data);
+void Mat_Identity(Mat_t *m);
+void Mat_Mult(const Mat_t *a, const Mat_t *b, Mat_t *dst);
+void Mat_MultTrans(const Mat_t *a, const Mat_t *b, Mat_t *dst);    // a * b^T
+void Mat_Trans(const Mat_t *a, Mat_t *dst);
+void Mat_Add(const Mat_t *a, const Mat_t *b, Mat_t *dst);
+void Mat_Sub(const Mat_t *a, const Mat_t *b, Mat_t *dst);
+void Mat_Scale(const Mat_t *a, float k, Mat_t *dst);
+void Mat_Symmetrize(Mat_t *m);
+
+// Inversa por Gauss-Jordan com pivotamento parcial; a é destruída
+uint8_t Mat_Inverse(Mat_t *a, Mat_t *dst);
+
+#endif /* __MATRIX_H */
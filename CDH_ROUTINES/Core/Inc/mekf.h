@@ -0,0 +1,90 @@
+/**
+  ******************************************************************************
+  * @file    mekf.h
+  * @brief   Filtro de Kalman estendido multiplicativo (MEKF) de atitude com
+  *          estimativa de bias do giroscópio
+  *
+  * Estado nominal: quatérnio q (corpo -> inercial, como em attitude.h) e
+  * bias b do giroscópio. O filtro estima o erro x = [dtheta, db] (6) no
+  * corpo, q_real = q (x) [1, dtheta/2], com covariância P 6x6:
+  *
+  *   Predict:  w = gyro - b,  q += 0.5 * q (x) (0, w) * dt
+  *             Phi = [I - [w x]dt, -I dt; 0, I]
+  *             P = Phi P Phi^T + diag(gyro_noise^2, bias_noise^2) * dt
+  *   Update:   v = R(q)^T * ref,  H = [[v x], 0]
+  *             K = P H^T (H P H^T + R)^-1,  x = K * (medida - v)
+  *             P = (I - K H) P;  q = q (x) [1, dtheta/2],  b += db
+  *
+  * Nenhuma medida corrige a rotação em torno da própria referência (v): a
+  * componente de K nessa direção é removida e P mantém a variância ali. Com
+  * um único vetor (órbita, sem gravidade) essa rotação não é observável e o
+  * desvio nela só cresce, em vez de cair pelas correlações.
+  *
+  * Sol planar (LDRs laterais): a medida é o azimute no plano XY do corpo
+  * (escalar), com desvio sun_noise / rho (rho = |Sol no plano XY|).
+  * As matrizes usam matrix.h (mesma interface do arm_mat_*_f32);
+  * todo o estado e as áreas de trabalho ficam dentro do Mekf_t, para que
+  * uma instância inteira possa ir para a DTCM.
+  ******************************************************************************
+  */
+
+#ifndef __MEKF_H
+#define __MEKF_H
+
+#include <stdint.h>
+#include "attitude.h"
+
+#define MEKF_STATES             6
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    float gyro_noise;           // Ruído branco do giroscópio (rad/s/sqrt(Hz))
+    float bias_noise;           // Passeio aleatório do bias (rad/s^2/sqrt(Hz))
+    float acc_noise;            // Desvio da direção da gravidade medida (rad)
+    float sun_noise;            // Desvio da direção/azimute do Sol medido (rad)
+    float att_sigma0;           // Incerteza inicial de atitude (rad)
+    float bias_sigma0;          // Incerteza inicial do bias (rad/s)
+} Mekf_Config_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    Mekf_Config_t cfg;
+    Attitude_Quat_t q;          // Corpo -> inercial
+    float bias[3];              // Bias estimado do giroscópio (rad/s)
+    float P[MEKF_STATES * MEKF_STATES];
+    float sun_ref[3];           // Direção do Sol no sistema inercial (unitária)
+    uint8_t sun_planar;         // Sensor só mede o azimute no plano XY do corpo
+    uint8_t acc_used;           // Última chamada de Mekf_UpdateGravity corrigiu?
+    uint8_t sun_used;           // Última chamada de Mekf_UpdateSun corrigiu?
+    uint32_t predicts;
+    uint32_t updates;
+    uint32_t rejected;          // Inovação com covariância singular
+
+    // Áreas de trabalho (mantidas aqui para ficarem na mesma memória do estado)
+    float phi[MEKF_STATES * MEKF_STATES];
+    float tmp[MEKF_STATES * MEKF_STATES];
+    float h[3 * MEKF_STATES];
+    float pht[MEKF_STATES * 3];
+    float s[3 * 3];
+    float s_inv[3 * 3];
+    float k[MEKF_STATES * 3];
+} Mekf_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Mekf_Init(Mekf_t *mekf, const Mekf_Config_t *cfg);
+void Mekf_Reset(Mekf_t *mekf);
+void Mekf_SetSunReference(Mekf_t *mekf, const float ref[3], uint8_t planar);
+void Mekf_Predict(Mekf_t *mekf, const float gyro[3], float dt);
+uint8_t Mekf_UpdateGravity(Mekf_t *mekf, const float accel[3]);
+uint8_t Mekf_UpdateSun(Mekf_t *mekf, const float sun[3]);
+
+// Desvio padrão atual (raiz da diagonal de P): atitude (rad) e bias (rad/s)
+void Mekf_GetSigma(const Mekf_t *mekf, float att_sigma[3], float bias_sigma[3]);
+
+#endif /* __MEKF_H */
@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    payload_bridge.h
+  * @brief   Ponte de comandos CAN -> Payload (UART5) com latência medida
+  *
+  * O comando de modo do COM vira frame para o Payload já no despacho do CAN
+  * (CAN_HandleModeCommand), sem esperar a próxima volta do loop: o frame sai
+  * de um template pré-montado (UART_FrameTemplate_t) e vai para o anel de
+  * DMA da porta, sem bloquear.
+  *
+  * Latência medida em ciclos do DWT a partir da interrupção de recepção do
+  * CAN até:
+  *   dispatch : frame copiado no anel de TX
+  *   wire     : último byte do frame na linha (HAL_UART_TxCpltCallback)
+  ******************************************************************************
+  */
+
+#ifndef __PAYLOAD_BRIDGE_H
+#define __PAYLOAD_BRIDGE_H
+
+#include "main.h"
+#include <stdint.h>
+
+typedef struct {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t total_us;              // Para a média (volta após ~70 min somados)
+} PayloadBridge_Latency_t;
+
+typedef struct {
+    PayloadBridge_Latency_t dispatch;
+    PayloadBridge_Latency_t wire;
+    uint32_t commands;              // Comandos de missão recebidos pela ponte
+    uint32_t forwarded;             // Viraram frame no próprio despacho
+    uint32_t deferred;              // Pipeline/janela cheios: seguem por UART_ProcessMission
+} PayloadBridge_Stats_t;
+
+/* Public Functions */
+void PayloadBridge_Init(void);
+void PayloadBridge_HandleCommand(uint32_t can_id, const uint8_t *data);
+void PayloadBridge_Poll(void);
+
+const PayloadBridge_Stats_t *PayloadBridge_GetStats(void);
+uint32_t PayloadBridge_GetAverageUs(const PayloadBridge_Latency_t *latency);
+void PayloadBridge_ResetStats(void);
+
+#endif /* __PAYLOAD_BRIDGE_H */
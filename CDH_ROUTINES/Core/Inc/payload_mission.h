@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    payload_mission.h
+  * @brief   Missões do Payload sobre o protocolo UART (porta UART5)
+  *
+  * Tabela de handlers do Payload, controle de missão pelo CAN, resultados
+  * das missões e recepção de objetos grandes (uart_bulk).
+  ******************************************************************************
+  */
+
+#ifndef __PAYLOAD_MISSION_H
+#define __PAYLOAD_MISSION_H
+
+#include "uart_protocol.h"
+#include "can_protocol.h"
+#include <stdint.h>
+
+#define UART_MISSION_TIMEOUT_MS     30000   // Tempo máximo de processamento de uma missão
+#define UART_MISSION_PIPELINE_DEPTH 2       // Missões em voo (< UART_MAX_PENDING_REQUESTS)
+
+/* Envio de AIS em lotes (MSG_DATA_AIS_BATCH) */
+#define UART_AIS_RECORD_SIZE        8
+#define UART_AIS_BATCH_MAX          ((UART_LINK_MAX_DATA - 1) / UART_AIS_RECORD_SIZE)  // 31 registros
+#define UART_AIS_QUEUE_SIZE         128     // Registros aguardando envio
+#define UART_AIS_FLUSH_MS           100     // Lote parcial sai após esse tempo
+
+/* Public Functions */
+// Inicializa a porta do Payload (handlers + enlace + DMA)
+HAL_StatusTypeDef Payload_Init(UART_HandleTypeDef *huart);
+UART_Protocol_t *Payload_GetLink(void);
+
+// Funções de controle de missão
+HAL_StatusTypeDef UART_StartMission1(void);
+HAL_StatusTypeDef UART_StartMission2(void);
+HAL_StatusTypeDef UART_SendAISData(uint8_t *ais_data);
+void UART_FlushAIS(void);
+uint16_t UART_GetAISQueued(void);
+HAL_StatusTypeDef UART_DispatchMission(MissionType_t mission);
+void UART_ProcessMission(void);
+uint8_t UART_GetMissionsInFlight(void);
+uint32_t UART_GetMissionsCompleted(void);
+uint32_t UART_GetMissionsFailed(void);
+
+// Getters para resultados das missões
+uint8_t UART_GetOilDetected(void);
+float UART_GetOilAreaPercentage(void);
+uint32_t UART_GetShipMMSI(void);
+float UART_GetShipOriginLat(void);
+float UART_GetShipOriginLon(void);
+uint8_t UART_IsMissionComplete(void);
+
+#endif /* __PAYLOAD_MISSION_H */
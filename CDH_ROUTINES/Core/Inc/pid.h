@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    pid.h
+  * @brief   PID discreto com período explícito, derivada filtrada na medida
+  *          e anti-windup por back-calculation (float e Q31)
+  *
+  * Por iteração (período dt, backward Euler):
+  *   e  = setpoint - medida
+  *   D  = a*D - b*(medida - medida_anterior)     a = tau/(tau+dt), b = kd/(tau+dt)
+  *   u  = kp*e + I + D
+  *   us = sat(u, out_min, out_max)
+  *   I += ki*dt*e + kt*dt*(us - u)               (back-calculation)
+  *
+  * I e D guardam as parcelas já multiplicadas pelos ganhos: trocar ki ou kd
+  * não causa degrau, e a troca de kp é compensada em I (PID_x_SetGains).
+  * A derivada é da medida (não do erro): degrau no setpoint não gera pico.
+  *
+  * Q31: entradas e saída normalizadas (1.0 = fundo de escala, o chamador
+  * escala). Os coeficientes são calculados em float uma vez no Init/
+  * SetGains e o Update só usa inteiros: pode rodar em ISR sem usar a FPU.
+  ******************************************************************************
+  */
+
+#ifndef __PID_H
+#define __PID_H
+
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    float kp;                   // Ganho proporcional
+    float ki;                   // Ganho integral (1/s)
+    float kd;                   // Ganho derivativo (s)
+    float tau;                  // Constante de tempo do filtro da derivada (s)
+    float kt;                   // Ganho de back-calculation (1/s); 0 = sem anti-windup
+    float dt;                   // Período de amostragem (s)
+    float out_min;              // Limites do atuador
+    float out_max;
+} PID_Config_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    PID_Config_t cfg;
+    float d_alpha;              // tau/(tau+dt)
+    float d_gain;               // kd/(tau+dt)
+    float ki_dt;
+    float kt_dt;
+    float integrator;           // Parcela integral (já com ki)
+    float deriv;                // Parcela derivativa filtrada (já com kd)
+    float last_meas;
+    float last_error;
+    uint8_t primed;             // Já tem medida anterior?
+} PID_F32_t;
+
+typedef struct {
+    PID_Config_t cfg;           // Ganhos/limites em float (limites em fundo de escala)
+    uint8_t shift;              // Ganhos Q31 valem k * 2^shift
+    int32_t kp;
+    int32_t ki_dt;
+    int32_t kt_dt;
+    int32_t d_alpha;            // Sem shift (0..1)
+    int32_t d_gain;
+    int32_t out_min;
+    int32_t out_max;
+    int32_t integrator;
+    int32_t deriv;
+    int32_t last_meas;
+    int32_t last_error;
+    uint8_t primed;
+} PID_Q31_t;
+
+/* Conversões Q31 <-> float (fundo de escala = 1.0) */
+#define PID_FLOAT_TO_Q31(x)     ((int32_t)((x) >= 1.0f ? 0x7FFFFFFF : \
+                                           (x) <= -1.0f ? (int32_t)0x80000000 : (x) * 2147483648.0f))
+#define PID_Q31_TO_FLOAT(x)     ((float)(x) / 2147483648.0f)
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+// Float
+void PID_F32_Init(PID_F32_t *pid, const PID_Config_t *cfg);
+void PID_F32_Reset(PID_F32_t *pid);
+float PID_F32_Update(PID_F32_t *pid, float setpoint, float measurement);
+void PID_F32_SetGains(PID_F32_t *pid, float kp, float ki, float kd);
+void PID_F32_SetSampleTime(PID_F32_t *pid, float dt);
+void PID_F32_SetLimits(PID_F32_t *pid, float out_min, float out_max);
+
+// Q31 (ganhos até 2^15)
+void PID_Q31_Init(PID_Q31_t *pid, const PID_Config_t *cfg);
+void PID_Q31_Reset(PID_Q31_t *pid);
+int32_t PID_Q31_Update(PID_Q31_t *pid, int32_t setpoint, int32_t measurement);
+void PID_Q31_SetGains(PID_Q31_t *pid, float kp, float ki, float kd);
+void PID_Q31_SetLimits(PID_Q31_t *pid, int32_t out_min, int32_t out_max);
+
+#endif /* __PID_H */
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    profile.h
+  * @brief   Perfil de velocidade da roda (trapezoidal ou curva S)
+  *
+  * Gerador sem bloqueio: cada Profile_Update avança dt e devolve a
+  * velocidade a comandar. A aceleração fica em +-accel_max e, com
+  * jerk_max > 0, só muda a jerk_max por segundo (curva S); com
+  * jerk_max = 0 o perfil é trapezoidal (aceleração em degrau).
+  *
+  * Frenagem: a aceleração nunca passa de sqrt(2 jerk_max |erro|), a curva
+  * que leva a aceleração a zero exatamente no alvo. O alvo pode mudar no
+  * meio do perfil; o gerador parte do estado atual (velocidade e aceleração).
+  *
+  * Duração de repouso a repouso para uma variação dv (Profile_Duration):
+  *   trapezoidal:                 |dv| / a
+  *   curva S, |dv| >= a² / j:     |dv| / a + a / j
+  *   curva S, |dv| <  a² / j:     2 sqrt(|dv| / j)    (a não chega a a_max)
+  ******************************************************************************
+  */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    float accel_max;            // Aceleração máxima (unidade/s)
+    float jerk_max;             // Variação máxima da aceleração (unidade/s², 0 = trapezoidal)
+    float speed_min;            // Faixa do alvo
+    float speed_max;
+} Profile_Config_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    Profile_Config_t cfg;
+    float speed;                // Velocidade comandada
+    float accel;                // Aceleração atual
+    float target;               // Alvo (já limitado à faixa)
+} Profile_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Profile_Init(Profile_t *p, const Profile_Config_t *cfg);
+
+// Parte de speed em repouso (sem perfil em andamento)
+void Profile_Reset(Profile_t *p, float speed);
+
+// Novo alvo, a partir do estado atual
+void Profile_SetTarget(Profile_t *p, float target);
+
+// Avança dt (s); retorna a velocidade a comandar
+float Profile_Update(Profile_t *p, float dt);
+
+// Chegou ao alvo com aceleração zero?
+uint8_t Profile_IsDone(const Profile_t *p);
+
+// Duração de repouso a repouso para a variação dv (s)
+float Profile_Duration(const Profile_Config_t *cfg, float dv);
+
+#endif /* __PROFILE_H */
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    qspi_flash.h
+  * @brief   Driver mínimo de flash NOR serial no QUADSPI (comandos JEDEC
+  *          comuns: W25Q / MT25Q / IS25LP)
+  *
+  * Endereçamento de 24 bits, setores de 4 KB e páginas de 256 bytes.
+  * Todas as funções são bloqueantes (modo indireto + auto-polling).
+  ******************************************************************************
+  */
+
+#ifndef __QSPI_FLASH_H
+#define __QSPI_FLASH_H
+
+#include "quadspi.h"
+#include <stdint.h>
+
+/* Geometria */
+#define QSPI_FLASH_PAGE_SIZE        256
+#define QSPI_FLASH_SECTOR_SIZE      4096
+#define QSPI_FLASH_ADDR_LIMIT       0x01000000UL    // 16 MB endereçáveis com 24 bits
+
+/* Comandos */
+#define QSPI_CMD_WRITE_ENABLE       0x06
+#define QSPI_CMD_READ_STATUS        0x05
+#define QSPI_CMD_READ_JEDEC_ID      0x9F
+#define QSPI_CMD_SECTOR_ERASE_4K    0x20
+#define QSPI_CMD_PAGE_PROGRAM       0x02
+#define QSPI_CMD_QUAD_OUT_READ      0x6B
+
+#define QSPI_STATUS_WIP             0x01            // Escrita/apagamento em andamento
+
+/* Timeouts (ms) */
+#define QSPI_FLASH_TIMEOUT_PROGRAM  10
+#define QSPI_FLASH_TIMEOUT_ERASE    500
+
+/* Public Functions */
+HAL_StatusTypeDef QSPI_Flash_ReadID(uint8_t id[3]);
+HAL_StatusTypeDef QSPI_Flash_EraseSector(uint32_t address);
+HAL_StatusTypeDef QSPI_Flash_Write(uint32_t address, const uint8_t *data, uint32_t length);
+HAL_StatusTypeDef QSPI_Flash_Read(uint32_t address, uint8_t *data, uint32_t length);
+
+#endif /* __QSPI_FLASH_H */
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    result_queue.h
+  * @brief   Fila de resultados das missões com confirmação do COM
+  *
+  * Cada resultado recebe um número de sequência e o instante de chegada e
+  * fica na fila até o COM confirmar com CAN_COM_RESULT_ACK. A fila fica em
+  * RAM e, quando enche, continua na flash QSPI (opcional). Resultados
+  * iguais ao anterior são descartados na entrada.
+  *
+  * Downlink de cada resultado (um frame por vez, TX FIFO de 1 elemento):
+  *   CAN_CDH_RESULT_INFO : [missão][seq(2)][timestamp ms(4)][frames de dados]
+  *   CAN_CDH_TELEMETRY   : mesmo formato de antes, com seq(2) em data[6..7]
+  * Sem confirmação em RESULT_QUEUE_ACK_TIMEOUT_MS o resultado é reenviado.
+  ******************************************************************************
+  */
+
+#ifndef __RESULT_QUEUE_H
+#define __RESULT_QUEUE_H
+
+#include "can_protocol.h"
+#include "main.h"
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+#define RESULT_QUEUE_RAM_SIZE       16      // Resultados em RAM
+#define RESULT_QUEUE_MAX_DATA       12      // Missão 2: mmsi(4) + lat(4) + lon(4)
+#define RESULT_QUEUE_ACK_TIMEOUT_MS 2000
+
+#define RESULT_QUEUE_QSPI_SPILL     1       // 0 = só RAM
+#define RESULT_QUEUE_QSPI_BASE      0x00FF0000UL
+#define RESULT_QUEUE_QSPI_SIZE      0x00010000UL    // 16 setores
+#define RESULT_QUEUE_QSPI_SLOT      32              // Bytes por resultado na flash
+
+typedef struct {
+    uint16_t seq;
+    uint8_t mission;            // MissionType_t
+    uint8_t length;
+    uint32_t timestamp_ms;      // HAL_GetTick() na chegada do resultado
+    uint8_t data[RESULT_QUEUE_MAX_DATA];    // Bytes como vieram do Payload
+} MissionResult_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void ResultQueue_Init(void);
+
+// Enfileira um resultado (HAL_BUSY se RAM e QSPI estiverem cheias)
+HAL_StatusTypeDef ResultQueue_Push(MissionType_t mission, const uint8_t *data, uint8_t length);
+
+// Downlink, retransmissão e reposição a partir da QSPI (chamada pelo CAN_Protocol)
+void ResultQueue_Poll(void);
+void ResultQueue_HandleAck(uint16_t seq);
+
+// Getters
+uint16_t ResultQueue_GetCount(void);        // Pendentes (RAM + QSPI)
+uint32_t ResultQueue_GetSuppressed(void);   // Repetidos descartados
+uint32_t ResultQueue_GetDropped(void);      // Perdidos por fila cheia
+uint32_t ResultQueue_GetRetransmissions(void);
+
+#endif /* __RESULT_QUEUE_H */
@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    uart_bulk.h
+  * @brief   Transferência de objetos grandes do Payload (imagens da Missão 1)
+  *          em blocos endereçados por offset, sobre o enlace confiável
+  *
+  * O CDH conduz a transferência, o que a torna retomável: após uma queda do
+  * enlace basta pedir de novo a partir do último offset gravado.
+  *
+  *   Payload -> CDH  MSG_BULK_OFFER : [obj_id(2)][tamanho(4)][crc32(4)]
+  *                                    opcional: [flags(1)][tamanho original(4)]
+  *   CDH -> Payload  MSG_BULK_REQ   : [obj_id(2)][offset(4)][tamanho(4)]
+  *   Payload -> CDH  MSG_BULK_CHUNK : [obj_id(2)][offset(4)][dados(N)]
+  *   CDH -> Payload  MSG_BULK_END   : [obj_id(2)][status(1)]
+  *
+  * Campos multibyte em big-endian. Um novo MSG_BULK_REQ substitui o anterior
+  * (o Payload para de enviar o trecho antigo). Os blocos são gravados no
+  * destino (sink) assim que chegam, em ordem, sem montar o objeto em RAM;
+  * o CRC-32 (crc32.h) é acumulado no caminho e conferido no último bloco.
+  *
+  * Com UART_BULK_FLAG_LZSS o objeto trafega comprimido (lzss.h): tamanho,
+  * offsets e CRC se referem aos bytes comprimidos, e o CDH descomprime no
+  * caminho para o sink, que recebe o objeto original.
+  ******************************************************************************
+  */
+
+#ifndef __UART_BULK_H
+#define __UART_BULK_H
+
+#include "uart_protocol.h"
+#include "uart_link.h"
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+#define UART_BULK_CHUNK_HEADER      6       // obj_id(2) + offset(4)
+#define UART_BULK_CHUNK_DATA        (UART_LINK_MAX_DATA - UART_BULK_CHUNK_HEADER)
+#define UART_BULK_REQ_CHUNKS        16      // Blocos por MSG_BULK_REQ
+#define UART_BULK_REQ_SPAN          (UART_BULK_REQ_CHUNKS * UART_BULK_CHUNK_DATA)
+#define UART_BULK_TIMEOUT_MS        2000    // Sem blocos novos: pede de novo do offset atual
+
+#define UART_BULK_RAM_SIZE          (128 * 1024)    // Destino em RAM_D1 (.bss)
+#define UART_BULK_QSPI_BASE         0x00000000UL    // Região da flash QSPI para objetos
+#define UART_BULK_QSPI_SIZE         0x00FF0000UL    // Últimos 64 KB: fila de resultados (result_queue.h)
+
+#define UART_BULK_DEFAULT_SINK      (&UART_BulkSink_QSPI)
+
+/* Flags do MSG_BULK_OFFER estendido */
+#define UART_BULK_OFFER_LEN         10
+#define UART_BULK_OFFER_EXT_LEN     15
+#define UART_BULK_FLAG_LZSS         0x01    // Objeto comprimido com LZSS
+
+/* Status enviado em MSG_BULK_END */
+typedef enum {
+    BULK_END_OK         = 0x00,     // CRC confere, objeto armazenado
+    BULK_END_CRC_ERROR  = 0x01,     // CRC não confere: o Payload deve oferecer de novo
+    BULK_END_REJECTED   = 0x02      // Não cabe no destino ou erro de gravação
+} UART_BulkEndStatus_t;
+
+typedef enum {
+    BULK_STATE_IDLE = 0,
+    BULK_STATE_ACTIVE,
+    BULK_STATE_COMPLETE,
+    BULK_STATE_FAILED
+} UART_BulkState_t;
+
+/* Destino dos dados: recebe os blocos em ordem crescente de offset */
+typedef struct {
+    HAL_StatusTypeDef (*open)(uint32_t size);   // Prepara o destino (HAL_ERROR se não couber)
+    HAL_StatusTypeDef (*write)(uint32_t offset, const uint8_t *data, uint16_t length);
+} UART_BulkSink_t;
+
+extern const UART_BulkSink_t UART_BulkSink_RAM;
+extern const UART_BulkSink_t UART_BulkSink_QSPI;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void UART_Bulk_Init(UART_Protocol_t *proto, const UART_BulkSink_t *sink);
+void UART_Bulk_SetSink(const UART_BulkSink_t *sink);   // Vale para o próximo objeto
+
+// Chamadas pelo despachante do protocolo (não toma posse do buffer)
+void UART_Bulk_HandleMessage(const UART_Message_t *msg);
+void UART_Bulk_Poll(void);                              // Timeouts e pedidos pendentes
+void UART_Bulk_Abort(void);
+
+// Getters
+UART_BulkState_t UART_Bulk_GetState(void);
+uint16_t UART_Bulk_GetObjectId(void);
+uint32_t UART_Bulk_GetReceived(void);
+uint32_t UART_Bulk_GetTotal(void);
+uint32_t UART_Bulk_GetStored(void);                     // Bytes entregues ao sink (após descompressão)
+uint32_t UART_Bulk_GetResumes(void);                    // Pedidos repetidos por timeout/lacuna
+const uint8_t *UART_Bulk_GetRamBuffer(void);            // Objeto recebido por UART_BulkSink_RAM
+
+#endif /* __UART_BULK_H */
@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    uart_dma.h
+  * @brief   Recepção UART por DMA circular + evento de linha ociosa (IDLE)
+  *          e transmissão por DMA a partir de um anel
+  *
+  * O DMA escreve continuamente no buffer circular e a CPU só é acordada nos
+  * eventos de meia-volta, volta completa e linha ociosa (fim de rajada).
+  * Nenhuma interrupção por byte: uma porta a mais não custa CPU em polling.
+  *
+  * O leitor (loop principal) consome os bytes no próprio buffer do DMA, sem
+  * cópia, com UART_DMA_Peek + UART_DMA_Consume.
+  *
+  * Na transmissão, UART_DMA_Write copia o frame para o anel e retorna (ou,
+  * sem cópia, UART_DMA_Reserve + UART_DMA_Commit: o frame é montado direto
+  * no anel). O DMA envia um trecho contíguo por vez e o fim de cada trecho
+  * (HAL_UART_TxCpltCallback) dispara o próximo. Uma marca (UART_DMA_WatchTx)
+  * registra em ciclos do DWT o instante em que o último byte escrito até
+  * ali saiu na linha.
+  ******************************************************************************
+  */
+
+#ifndef __UART_DMA_H
+#define __UART_DMA_H
+
+#include "usart.h"
+#include <stdint.h>
+
+#define UART_DMA_MAX_PORTS      4       // UART5, UART8, USART3, UART4
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint8_t *buf;                   // Buffer circular do DMA (RAM_D1/D2, nunca DTCM)
+    uint16_t size;
+
+    // Escritos pela ISR (HAL_UARTEx_RxEventCallback / HAL_UART_ErrorCallback)
+    volatile uint16_t dma_pos;      // Posição do DMA no último evento
+    volatile uint32_t written;      // Total de bytes recebidos
+    volatile uint8_t restart;       // Recepção abortada por erro: rearmar no loop
+    volatile uint32_t event_cycles; // DWT->CYCCNT do último evento (carimbo de chegada)
+
+    // Lado do leitor (loop principal)
+    uint16_t read_pos;
+    uint32_t consumed;
+
+    // Diagnóstico
+    uint32_t overruns;              // Leitor ficou uma volta inteira para trás
+    uint32_t errors;                // Erros de hardware (ORE/FE/NE) com rearme
+} UART_DMA_Rx_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint8_t *buf;                   // Anel de transmissão (RAM_D1/D2, nunca DTCM)
+    uint16_t size;
+
+    // Lado do escritor (loop principal)
+    uint16_t head;                  // Próxima posição livre
+    volatile uint32_t queued;       // Total de bytes escritos no anel
+
+    // Escritos pela ISR (HAL_UART_TxCpltCallback)
+    volatile uint16_t tail;         // Início do trecho em envio
+    volatile uint16_t dma_len;      // Tamanho do trecho no DMA (0 = ocioso)
+    volatile uint32_t sent;         // Total de bytes já na linha
+
+    // Marca de latência: instante em que sent alcança watch_end
+    volatile uint8_t watch;         // 0 = livre, 1 = armada, 2 = concluída
+    volatile uint32_t watch_end;
+    volatile uint32_t watch_cycles;
+
+    // Diagnóstico
+    uint32_t drops;                 // Frames recusados por falta de espaço
+    uint32_t errors;                // Trechos perdidos por erro de DMA/UART
+} UART_DMA_Tx_t;
+
+/* Public Functions */
+HAL_StatusTypeDef UART_DMA_StartRx(UART_DMA_Rx_t *rx, UART_HandleTypeDef *huart,
+                                   uint8_t *buf, uint16_t size);
+void UART_DMA_StopRx(UART_DMA_Rx_t *rx);
+
+// Bytes contíguos disponíveis a partir de *data (0 = nada novo)
+uint16_t UART_DMA_Peek(UART_DMA_Rx_t *rx, const uint8_t **data);
+void UART_DMA_Consume(UART_DMA_Rx_t *rx, uint16_t count);
+
+uint8_t UART_DMA_HasData(const UART_DMA_Rx_t *rx);
+
+// Transmissão: o frame entra inteiro no anel ou nada (HAL_BUSY)
+HAL_StatusTypeDef UART_DMA_StartTx(UART_DMA_Tx_t *tx, UART_HandleTypeDef *huart,
+                                   uint8_t *buf, uint16_t size);
+HAL_StatusTypeDef UART_DMA_Write(UART_DMA_Tx_t *tx, const uint8_t *data, uint16_t len);
+HAL_StatusTypeDef UART_DMA_Reserve(UART_DMA_Tx_t *tx, uint16_t len, uint16_t *pos);
+void UART_DMA_Commit(UART_DMA_Tx_t *tx, uint16_t len);
+uint16_t UART_DMA_TxFree(const UART_DMA_Tx_t *tx);
+uint8_t UART_DMA_TxIdle(const UART_DMA_Tx_t *tx);
+
+// Marca de latência sobre o que já foi escrito (1 = concluída, *cycles = DWT)
+void UART_DMA_WatchTx(UART_DMA_Tx_t *tx);
+uint8_t UART_DMA_WatchDone(UART_DMA_Tx_t *tx, uint32_t *cycles);
+
+#endif /* __UART_DMA_H */
@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    uart_link.h
+  * @brief   Camada de enlace confiável (janela deslizante) sobre o protocolo
+  *          UART (uma instância por porta, dentro de UART_Protocol_t)
+  *
+  * Todo frame que não seja de controle (MSG_ACK/MSG_NACK/MSG_SYNC/MSG_RESET)
+  * leva um número de sequência no primeiro byte de dados:
+  *
+  *   Start(1) + ID(1) + Len(2) + [SEQ(1) + Dados(N-1)] + Checksum(1)
+  *
+  * Nos frames de controle esse byte é o argumento. O parser o entrega em
+  * UART_Message_t.seq, separado de data[]:
+  *
+  * MSG_ACK  : seq = próxima sequência esperada (ACK cumulativo)
+  * MSG_NACK : seq = sequência faltante (retransmissão seletiva,
+  *            confirma implicitamente todas as anteriores)
+  * MSG_SYNC : seq = sequência mais antiga ainda em voo no transmissor
+  * MSG_RESET: seq = primeira sequência do transmissor depois do boot
+  *
+  * Depois de UART_LINK_MAX_RETRIES o transmissor desiste do frame e avisa
+  * o receptor com MSG_SYNC: o receptor entrega o que já tem antes dessa
+  * sequência, pula as que faltam e responde com ACK. Até esse ACK chegar o
+  * MSG_SYNC é repetido a cada RTO e UART_Link_Send devolve HAL_BUSY.
+  *
+  * Reinício de uma ponta (boot ou UART_Link_Init): ela anuncia MSG_RESET,
+  * repetido a cada RTO até o ACK, e não envia dados antes disso. A outra
+  * ponta recomeça a recepção nessa sequência, confirma e manda MSG_SYNC
+  * com a base do seu transmissor; a ponta reiniciada adota essa sequência
+  * no primeiro MSG_SYNC (até lá descarta dados sem confirmar) e os frames
+  * em voo são retransmitidos. Um MSG_SYNC fora da janela também reinicia a
+  * recepção, em vez de reconfirmar um rx_next que a outra ponta não tem.
+  ******************************************************************************
+  */
+
+#ifndef __UART_LINK_H
+#define __UART_LINK_H
+
+#include "main.h"
+#include <stdint.h>
+
+typedef struct UART_Message_s UART_Message_t;
+typedef struct UART_Protocol_s UART_Protocol_t;
+typedef struct UART_FrameTemplate_s UART_FrameTemplate_t;
+
+/* ============================================================================
+   CONFIGURAÇÃO DO ENLACE
+   ============================================================================ */
+#define UART_LINK_WINDOW_SIZE       4       // Frames em voo (potência de 2, <= 128)
+#define UART_LINK_MAX_DATA          (UART_MAX_PAYLOAD - 1)  // 1 byte vai para o SEQ
+
+#define UART_LINK_RTO_INITIAL_MS    500     // RTO antes da primeira medida de RTT
+#define UART_LINK_RTO_MIN_MS        50
+#define UART_LINK_RTO_MAX_MS        4000
+#define UART_LINK_MAX_RETRIES       5       // Tentativas antes de descartar o frame (e ressincronizar)
+
+/* ============================================================================
+   ESTADO DO ENLACE (manipulado só por uart_link.c)
+   ============================================================================ */
+// Frame aguardando confirmação
+typedef struct {
+    UART_Message_t *frame;      // Buffer do pool (frame->seq = SEQ)
+    uint16_t frame_len;         // Tamanho dos dados (sem o SEQ)
+    uint32_t sent_tick;         // Instante da última transmissão
+    uint8_t retries;            // Retransmissões já feitas
+    uint8_t in_use;
+} UART_LinkTxSlot_t;
+
+typedef struct {
+    // Lado transmissor
+    UART_LinkTxSlot_t tx_window[UART_LINK_WINDOW_SIZE];
+    uint8_t tx_base;            // Sequência mais antiga não confirmada
+    uint8_t tx_next;            // Próxima sequência a ser usada
+    uint8_t sync_pending;       // MSG_SYNC enviado, aguardando o ACK
+    uint8_t reset_pending;      // MSG_RESET enviado (boot), aguardando o ACK
+    uint32_t sync_tick;         // Instante do último MSG_SYNC/MSG_RESET
+
+    // Lado receptor: frames fora de ordem aguardando a lacuna (já sem o SEQ)
+    UART_Message_t *rx_window[UART_LINK_WINDOW_SIZE];
+    uint8_t rx_next;            // Próxima sequência esperada
+    uint8_t nack_pending_seq;
+    uint8_t nack_sent;          // Já pediu retransmissão da lacuna atual?
+    uint8_t rx_skip;            // Sequências ainda a pular (pedidas por MSG_SYNC)
+    uint8_t rx_wait_sync;       // Após o boot: sequência da outra ponta desconhecida
+
+    // Estimador de RTT (RFC 6298, em ms)
+    int32_t srtt_ms;
+    int32_t rttvar_ms;
+    uint32_t rto_ms;
+    uint8_t rtt_valid;
+
+    // Contadores
+    uint32_t retransmissions;
+    uint32_t dropped_frames;
+    uint32_t resyncs;           // MSG_SYNC iniciados (um por grupo de descartes)
+    uint32_t peer_resets;       // Recepção reiniciada (MSG_RESET ou MSG_SYNC fora da janela)
+} UART_LinkState_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+
+// Inicialização (zera janelas e estimador de RTT, anuncia MSG_RESET)
+void UART_Link_Init(UART_Protocol_t *proto);
+
+// Envio confiável: HAL_BUSY se a janela estiver cheia, HAL_ERROR se len inválido
+HAL_StatusTypeDef UART_Link_Send(UART_Protocol_t *proto, uint8_t msg_id,
+                                 const uint8_t *data, uint16_t length);
+
+// Envio confiável de um frame pré-montado (mesmos retornos de UART_Link_Send)
+HAL_StatusTypeDef UART_Link_SendTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl);
+
+// Recebe a próxima mensagem em ordem (buffer do pool, NULL = nada pendente)
+UART_Message_t *UART_Link_Receive(UART_Protocol_t *proto);
+
+// Trata timeouts de retransmissão (chamada também por UART_Link_Receive)
+void UART_Link_Poll(UART_Protocol_t *proto);
+
+// Getters de estado do enlace
+uint8_t UART_Link_GetInFlight(const UART_Protocol_t *proto);
+uint32_t UART_Link_GetRTO(const UART_Protocol_t *proto);
+uint32_t UART_Link_GetRetransmissions(const UART_Protocol_t *proto);
+uint32_t UART_Link_GetDroppedFrames(const UART_Protocol_t *proto);
+uint32_t UART_Link_GetResyncs(const UART_Protocol_t *proto);
+uint32_t UART_Link_GetPeerResets(const UART_Protocol_t *proto);
+
+#endif /* __UART_LINK_H */
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    uart_msg_pool.h
+  * @brief   Pool fixo de buffers UART_Message_t
+  *
+  * Cada buffer tem um único dono por vez. O fluxo de posse na recepção é:
+  *   parser (UART_ReadFrame) -> enlace (UART_Link_Receive)
+  *     -> motor (UART_Protocol_Process) -> handlers/callbacks da porta
+  * e quem estiver com o buffer no fim da cadeia chama UART_MsgPool_Release.
+  ******************************************************************************
+  */
+
+#ifndef __UART_MSG_POOL_H
+#define __UART_MSG_POOL_H
+
+#include "uart_protocol.h"
+#include <stdint.h>
+
+/* Compartilhado por todas as portas. Pior caso por porta: parser (1) +
+   janela RX do enlace (inclui a mensagem em despacho, que sai da janela
+   antes do handler) + janela TX. Requisições pendentes e o pipeline de
+   missões não guardam buffers: a resposta só vale durante o callback e os
+   resultados são copiados para a result_queue */
+#define UART_MSG_POOL_PER_PORT  (1 + 2 * UART_LINK_WINDOW_SIZE)
+#define UART_MSG_POOL_SIZE      (UART_PROTOCOL_MAX_PORTS * UART_MSG_POOL_PER_PORT)
+
+_Static_assert(UART_MSG_POOL_SIZE <= 255, "índices do pool são uint8_t");
+
+/* Public Functions */
+void UART_MsgPool_Init(void);
+UART_Message_t *UART_MsgPool_Acquire(void);        // NULL se o pool esgotou
+void UART_MsgPool_Release(UART_Message_t *msg);
+
+// Diagnóstico
+uint8_t UART_MsgPool_GetFree(void);
+uint8_t UART_MsgPool_GetLowWater(void);            // Menor número de livres já visto
+uint32_t UART_MsgPool_GetFailures(void);           // Acquire sem buffer disponível
+
+#endif /* __UART_MSG_POOL_H */
@@ -1,7 +1,12 @@
 /**
   ******************************************************************************
-  * @file    payload_protocol.h
-  * @brief   Payload protocol abstraction layer
+  * @file    uart_protocol.h
+  * @brief   Protocolo UART enquadrado, independente da porta
+  *
+  * Cada porta (UART5 Payload, UART8 câmera, USART3 debug, ...) tem o seu
+  * UART_Protocol_t: handle, buffer do DMA, parser, enlace confiável,
+  * tabela de handlers, requisições pendentes e estatísticas. Todas as
+  * portas registradas são atendidas pelo mesmo motor, UART_Protocol_Process.
   ******************************************************************************
   */
 
@@ -9,52 +14,267 @@
 #define __UART_PROTOCOL_H
 
 #include "usart.h"
+#include "uart_dma.h"
+#include "uart_link.h"
+#include "cobs.h"
 #include <stdint.h>
 
 #define UART_START_BYTE 0xFE
 #define UART_MAX_PAYLOAD 256
+#define UART_RX_RING_SIZE 512   // Buffer circular do DMA por porta
+#define UART_TX_RING_SIZE 1024  // Anel de TX por DMA (portas com hdmatx)
+#define UART_PROTOCOL_MAX_PORTS 3
+#define UART_RX_FRAME_TIMEOUT_MS 50     // LEGACY: frame parcial abandonado após este silêncio
 
 /*
-FORMATO: Start(1) + ID(1) + Len(2) + Data(N) + Checksum(1)
+FORMATO (LEGACY): Start(1) + ID(1) + Len(2) + Data(N) + Checksum(1)
+FORMATO (COBS)  : COBS[ ID(1) + Data(N) + Checksum(1) ] + 0x00
+
+O primeiro byte de Data é sempre do enlace (SEQ ou argumento do controle,
+ver uart_link.h): o parser o separa em UART_Message_t.seq e data[] recebe
+só o resto, sem memmove. Frame com Len = 0 é inválido.
 */
 
+/* Modos de enquadramento */
+typedef enum {
+    UART_FRAMING_LEGACY = 0,    // Byte de início 0xFE + tamanho explícito
+    UART_FRAMING_COBS           // Frames delimitados por 0x00 (ressincroniza no próximo 0x00)
+} UART_FramingMode_t;
+
+#define UART_DEFAULT_FRAMING UART_FRAMING_LEGACY
+
 /* IDs das Mensagens */ 
 typedef enum {
     MSG_CMD_START_M1    = 0x01, // CDH -> Payload: Iniciar Missão 1
     MSG_CMD_START_M2    = 0x02, // CDH -> Payload: Iniciar Missão 2
     MSG_DATA_AIS        = 0x03, // CDH -> Payload: Enviar dados AIS do barco (Telemetria)
+    MSG_DATA_AIS_BATCH  = 0x04, // CDH -> Payload: Lote de registros AIS [qtd(1)][registro(8)]...
     MSG_RES_M1_OIL      = 0x10, // Payload -> CDH: Resultado Óleo (% área)
     MSG_RES_M2_SHIP     = 0x11, // Payload -> CDH: ID do Barco encontrado + Local de origem
-    MSG_ACK             = 0xA0, // Confirmação de recebimento
+    MSG_BULK_OFFER      = 0x20, // Payload -> CDH: Objeto disponível (ver uart_bulk.h)
+    MSG_BULK_REQ        = 0x21, // CDH -> Payload: Pede trecho [offset, offset+tamanho)
+    MSG_BULK_CHUNK      = 0x22, // Payload -> CDH: Bloco do objeto
+    MSG_BULK_END        = 0x23, // CDH -> Payload: Resultado da conferência do CRC
+    MSG_PING            = 0x30, // CDH -> Payload: Teste de bancada (eco)
+    MSG_PONG            = 0x31, // Payload -> CDH: Eco do MSG_PING
+    MSG_ACK             = 0xA0, // Confirmação de recebimento (ACK cumulativo)
+    MSG_NACK            = 0xA1, // Pedido de retransmissão seletiva
+    MSG_SYNC            = 0xA2, // Ressincronização após descarte (ver uart_link.h)
+    MSG_RESET           = 0xA3, // Enlace reiniciado (boot): a outra ponta recomeça a recepção
     MSG_ERROR           = 0xEE  // Erro no processamento
 } MsgID_t;
 
 /* UART Message Structure  */
-typedef struct {
+struct UART_Message_s {
     uint8_t id;
+    uint8_t seq;                // Byte do enlace: SEQ (dados) ou argumento (ACK/NACK/SYNC/RESET)
     uint8_t data[UART_MAX_PAYLOAD];
-    uint8_t length;
-} UART_Message_t;
+    uint16_t length;            // Dados sem o byte do enlace (até UART_MAX_PAYLOAD - 1)
+};
+
+/* Frame pré-montado para comandos de baixa latência (UART_Template_Init):
+   cabeçalho, dados e checksum ficam prontos; no envio só entram o SEQ do
+   enlace e a correção do checksum por XOR */
+#define UART_TEMPLATE_MAX_DATA      16
+
+struct UART_FrameTemplate_s {
+    uint8_t msg_id;
+    uint16_t length;                            // Dados úteis (sem o SEQ)
+    uint8_t frame[UART_TEMPLATE_MAX_DATA + 6];  // START ID LEN_H LEN_L SEQ DATA CHECKSUM (SEQ = 0)
+    uint16_t frame_len;
+};
+
+/* Requisições assíncronas (comando -> resposta) */
+#define UART_MAX_PENDING_REQUESTS   4
+
+typedef enum {
+    UART_REQ_OK = 0,        // Resposta esperada recebida
+    UART_REQ_TIMEOUT,       // Sem resposta dentro do prazo
+    UART_REQ_ERROR,         // Outro lado respondeu MSG_ERROR
+    UART_REQ_CANCELLED      // Cancelada localmente (UART_CancelRequests)
+} UART_RequestStatus_t;
+
+/* Callback de conclusão: response só é válido durante a chamada (NULL se
+   não houve resposta). Chamado a partir de UART_Protocol_Process. */
+typedef void (*UART_ResponseCallback_t)(UART_RequestStatus_t status,
+                                        const UART_Message_t *response,
+                                        void *context);
+
+typedef struct {
+    uint8_t in_use;
+    uint8_t cmd_id;             // Comando enviado (chave do histograma de latência)
+    uint8_t response_id;        // ID que conclui a requisição
+    uint32_t sent_tick;
+    uint32_t timeout_ms;
+    UART_ResponseCallback_t callback;
+    void *context;
+} UART_PendingRequest_t;
+
+/* Handlers de aplicação: msg só é válido durante a chamada */
+typedef void (*UART_MessageHandler_t)(UART_Protocol_t *proto, const UART_Message_t *msg);
+
+typedef struct {
+    uint8_t msg_id;
+    UART_MessageHandler_t handler;
+} UART_Handler_t;
+
+typedef struct {
+    const UART_Handler_t *handlers;     // Tabela de handlers (pode ser NULL)
+    uint8_t handler_count;
+    void (*poll)(UART_Protocol_t *proto);   // Opcional: chamado a cada passada do motor
+} UART_ProtocolConfig_t;
+
+/* Histograma de latência em escala log2 (ms):
+   bucket 0 = 0 ms, bucket b = [2^(b-1), 2^b) ms, o último acumula o resto */
+#define UART_STATS_RTT_BUCKETS      16
+#define UART_STATS_RTT_IDS          8       // IDs acompanhados por porta e tipo
+
+typedef enum {
+    UART_RTT_LINK = 0,          // Envio do frame -> ACK (só frames não retransmitidos)
+    UART_RTT_REQUEST,           // UART_SendRequest -> resposta esperada
+    UART_RTT_KINDS
+} UART_RttKind_t;
+
+typedef struct {
+    uint8_t in_use;
+    uint8_t msg_id;             // Frame enviado (LINK) ou comando (REQUEST)
+    uint16_t buckets[UART_STATS_RTT_BUCKETS];   // Saturam em 0xFFFF
+} UART_RttHistogram_t;
+
+/* Estatísticas por porta */
+typedef struct {
+    uint32_t rx_bytes;
+    uint32_t rx_frames;             // Frames válidos (inclui ACK/NACK/SYNC)
+    uint32_t tx_bytes;
+    uint32_t tx_frames;
+    uint32_t checksum_errors;
+    uint32_t framing_errors;        // Tamanho inválido ou COBS inválido
+    uint32_t resyncs;               // Trechos de lixo descartados até o próximo frame
+    uint32_t pool_drops;            // Frame válido descartado por falta de buffer
+    uint32_t unhandled;             // Mensagem sem handler na tabela
+    uint32_t req_timeouts;          // Requisições encerradas sem resposta
+    uint32_t req_errors;            // Requisições respondidas com MSG_ERROR
+    uint32_t rtt_untracked;         // Amostras sem entrada livre no histograma
+    UART_RttHistogram_t rtt[UART_RTT_KINDS][UART_STATS_RTT_IDS];
+} UART_ProtocolStats_t;
+
+/* Índices dos contadores exportados (ordem fixa: usada na telemetria CAN) */
+typedef enum {
+    UART_STAT_RX_BYTES = 0,
+    UART_STAT_RX_FRAMES,
+    UART_STAT_TX_BYTES,
+    UART_STAT_TX_FRAMES,
+    UART_STAT_CHECKSUM_ERRORS,
+    UART_STAT_FRAMING_ERRORS,
+    UART_STAT_RESYNCS,
+    UART_STAT_POOL_DROPS,
+    UART_STAT_UNHANDLED,
+    UART_STAT_REQ_TIMEOUTS,
+    UART_STAT_REQ_ERRORS,
+    UART_STAT_RETRANSMISSIONS,
+    UART_STAT_LINK_DROPS,
+    UART_STAT_DMA_OVERRUNS,
+    UART_STAT_DMA_ERRORS,
+    UART_STAT_SRTT_MS,
+    UART_STAT_RTO_MS,
+    UART_STAT_TX_DROPS,             // Frames recusados pelo anel de TX cheio
+    UART_STAT_TX_DMA_ERRORS,
+    UART_STAT_LINK_RESYNCS,         // MSG_SYNC enviados após descarte de frames
+    UART_STAT_PEER_RESETS,          // Recepção reiniciada (MSG_RESET ou MSG_SYNC fora da janela)
+    UART_STAT_COUNT
+} UART_StatIndex_t;
+
+/* Máquina de estados do parser de frames */
+typedef enum {
+    RX_STATE_START = 0,
+    RX_STATE_ID,
+    RX_STATE_LEN_H,
+    RX_STATE_LEN_L,
+    RX_STATE_SEQ,
+    RX_STATE_DATA,
+    RX_STATE_CHECKSUM
+} UART_RxState_t;
+
+/* Contexto de uma porta (deve ficar em RAM acessível ao DMA: .bss/RAM_D1) */
+struct UART_Protocol_s {
+    UART_HandleTypeDef *huart;
+    UART_FramingMode_t framing;
+    const UART_ProtocolConfig_t *config;
+
+    // Recepção por DMA circular (ver uart_dma.h)
+    UART_DMA_Rx_t rx;
+    uint8_t rx_dma_buf[UART_RX_RING_SIZE];
+
+    // Parser LEGACY
+    UART_RxState_t rx_state;
+    UART_Message_t *rx_frame;       // Buffer do pool sendo preenchido (LEGACY e COBS)
+    uint16_t rx_frame_length;
+    uint16_t rx_frame_index;
+    uint8_t rx_checksum;            // XOR acumulado dos bytes do frame
+    uint8_t rx_hunting;             // Descartando bytes até o próximo início
+    uint32_t rx_last_tick;          // Última leitura com bytes novos (timeout do frame parcial)
+
+    // Parser COBS: decodifica byte a byte direto no buffer do pool
+    COBS_Decoder_t rx_cobs;
+    uint16_t rx_cobs_count;         // Bytes decodificados no frame atual
+    uint8_t rx_cobs_held;           // Último byte decodificado (checksum se vier o 0x00)
+    uint8_t rx_cobs_discard;        // Descartando até o próximo delimitador
+
+    // Frame montado nas portas sem DMA de TX (nas demais, direto no anel)
+    uint8_t tx_buffer[COBS_ENCODED_MAX(UART_MAX_PAYLOAD + 2) + 1];
+
+    // Transmissão por DMA (só se a UART tiver hdmatx; senão bloqueante)
+    UART_DMA_Tx_t tx;
+    uint8_t tx_dma_buf[UART_TX_RING_SIZE];
+
+    UART_LinkState_t link;
+    UART_PendingRequest_t requests[UART_MAX_PENDING_REQUESTS];
+    UART_ProtocolStats_t stats;
+};
 
 /* Public Functions */
+// Inicialização da porta (DMA + enlace) e registro no motor
+HAL_StatusTypeDef UART_Protocol_Init(UART_Protocol_t *proto, UART_HandleTypeDef *huart,
+                                     const UART_ProtocolConfig_t *config);
+
+// Motor único: atende todas as portas registradas (não bloqueia)
+void UART_Protocol_Process(void);
+
+// Seleção do enquadramento (deve ser igual nos dois lados do enlace)
+void UART_SetFramingMode(UART_Protocol_t *proto, UART_FramingMode_t mode);
+UART_FramingMode_t UART_GetFramingMode(const UART_Protocol_t *proto);
+
 // Funções básicas de comunicação
-void UART_Transmit(UART_HandleTypeDef *huart, UART_Message_t *msg, uint16_t size);
-UART_Message_t UART_Receive(UART_HandleTypeDef *huart);
+void UART_Transmit(UART_Protocol_t *proto, UART_Message_t *msg, uint16_t size);
+UART_Message_t *UART_ReadFrame(UART_Protocol_t *proto);    // Buffer do pool (ver uart_msg_pool.h)
 uint8_t CalculateChecksum(uint8_t msg_id, uint16_t length, uint8_t *data);
-void Check_Payload_Response(void);
-
-// Funções de controle de missão
-void UART_StartMission1(void);
-void UART_StartMission2(void);
-void UART_SendAISData(uint8_t *ais_data);
-void UART_ProcessMission(void);
-
-// Getters para resultados das missões
-uint8_t UART_GetOilDetected(void);
-float UART_GetOilAreaPercentage(void);
-uint32_t UART_GetShipMMSI(void);
-float UART_GetShipOriginLat(void);
-float UART_GetShipOriginLon(void);
-uint8_t UART_IsMissionComplete(void);
+
+// Frames pré-montados (comandos de baixa latência)
+HAL_StatusTypeDef UART_Template_Init(UART_FrameTemplate_t *tpl, uint8_t msg_id,
+                                     const uint8_t *data, uint16_t length);
+void UART_TransmitTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl, uint8_t seq);
+
+// Requisição assíncrona: envia o comando e chama callback na resposta/timeout
+HAL_StatusTypeDef UART_SendRequest(UART_Protocol_t *proto, uint8_t cmd_id,
+                                   const uint8_t *data, uint16_t length,
+                                   uint8_t response_id, uint32_t timeout_ms,
+                                   UART_ResponseCallback_t callback, void *context);
+HAL_StatusTypeDef UART_SendRequestTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl,
+                                           uint8_t response_id, uint32_t timeout_ms,
+                                           UART_ResponseCallback_t callback, void *context);
+void UART_CancelRequests(UART_Protocol_t *proto);
+uint8_t UART_IsRequestPending(const UART_Protocol_t *proto, uint8_t response_id);
+
+// Estatísticas da porta
+const UART_ProtocolStats_t *UART_Protocol_GetStats(const UART_Protocol_t *proto);
+uint32_t UART_Protocol_GetStat(const UART_Protocol_t *proto, UART_StatIndex_t index);
+void UART_Protocol_ResetStats(UART_Protocol_t *proto);
+void UART_Stats_RecordRtt(UART_Protocol_t *proto, UART_RttKind_t kind,
+                          uint8_t msg_id, uint32_t elapsed_ms);
+uint8_t UART_Stats_RttBucket(uint32_t elapsed_ms);
+
+// Portas registradas no motor (telemetria)
+uint8_t UART_Protocol_GetPortCount(void);
+UART_Protocol_t *UART_Protocol_GetPort(uint8_t index);
 
 #endif /* __UART_PROTOCOL_H */
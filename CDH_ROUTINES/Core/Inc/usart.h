@@ -41,6 +41,12 @@ extern UART_HandleTypeDef huart8; /* CAM_TX CAM_RX (COMMUNICATIN WITH PAYLOD SUB
 extern UART_HandleTypeDef huart3; /* PAY_TX PAY_RX (PC104)*/
 
 /* USER CODE BEGIN Private defines */
+extern DMA_HandleTypeDef hdma_uart5_rx;
+extern DMA_HandleTypeDef hdma_uart8_rx;
+extern DMA_HandleTypeDef hdma_usart3_rx;
+extern DMA_HandleTypeDef hdma_uart5_tx;
+extern DMA_HandleTypeDef hdma_uart4_tx;
+extern DMA_HandleTypeDef hdma_uart4_rx;
 
 /* USER CODE END Private defines */
 
@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    wheel_pwm.h
+  * @brief   Roda de reação por PWM/DIR/EN com tacômetro por captura
+  *
+  * Driver de motor com entrada de velocidade por PWM (controle de
+  * velocidade no próprio driver), sem UART no caminho do comando:
+  *   ADCS_PWM (PA2, TIM2_CH3)  duty = |comando| / fundo de escala
+  *   ADCS_DIR (PH2)            sentido (alto = negativo)
+  *   ADCS_EN  (PH3)            alto = driver ligado; baixo = parada por hardware
+  *   ADCS_TACH (PH10, TIM5_CH1) saída FG do driver, WHEEL_TACH_PULSES_PER_REV
+  *                             pulsos por volta
+  *
+  * Um comando é uma escrita no CCR (o duty vale no próximo período do PWM).
+  *
+  * Tacômetro: o TIM5 (32 bits) conta a 1 MHz e a captura de cada borda de
+  * subida entra num anel na interrupção. A velocidade vem do intervalo da
+  * última volta (WHEEL_TACH_PULSES_PER_REV pulsos), o que cancela a
+  * assimetria entre os sensores Hall. Sem pulso novo há mais que um
+  * período, o intervalo desde o último pulso é o limite da velocidade
+  * (a leitura cai junto com a roda); depois de WHEEL_TACH_TIMEOUT_MS, zero.
+  *
+  * O FG não tem sentido: o sinal é o do último DIR, e só muda depois que a
+  * leitura passa abaixo de WHEEL_TACH_REVERSE_SPEED (a roda ainda gira no
+  * sentido antigo logo depois da inversão do DIR).
+  ******************************************************************************
+  */
+
+#ifndef __WHEEL_PWM_H
+#define __WHEEL_PWM_H
+
+#include "tim.h"
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+#define WHEEL_PWM_FREQ_HZ           20000       // Acima da faixa audível
+#define WHEEL_TACH_TICK_HZ          1000000     // Contagem do TIM5 (1 us)
+#define WHEEL_TACH_PULSES_PER_REV   6           // Pulsos do FG por volta
+#define WHEEL_TACH_TIMEOUT_MS       500         // Sem pulso: roda parada (~2 rad/s com 6 pulsos)
+#define WHEEL_TACH_REVERSE_SPEED    5.0f        // rad/s: abaixo disso o sinal segue o DIR
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    float duty;                 // Último duty com sinal (-1 a 1)
+    uint8_t enabled;            // EN alto?
+    int8_t direction;           // Sentido assumido da rotação (+1 / -1)
+    uint32_t edges;             // Pulsos capturados desde o WheelPWM_Init
+    float speed;                // Última leitura (rad/s, com sinal)
+} WheelPWM_Status_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+// Configura os timers pelo clock do APB1 e liga PWM (duty 0, EN baixo) e captura
+HAL_StatusTypeDef WheelPWM_Init(TIM_HandleTypeDef *htim_pwm, uint32_t pwm_ch,
+                                TIM_HandleTypeDef *htim_tach, uint32_t tach_ch);
+
+// Duty com sinal (-1 a 1); com duty diferente de zero liga o EN
+void WheelPWM_SetDuty(float duty);
+
+// Parada imediata: EN baixo e duty 0 (pode ser chamada em interrupção)
+void WheelPWM_Stop(void);
+
+// Velocidade pelo tacômetro (rad/s, com sinal)
+float WheelPWM_GetSpeed(void);
+
+void WheelPWM_GetStatus(WheelPWM_Status_t *status);
+
+#endif /* __WHEEL_PWM_H */
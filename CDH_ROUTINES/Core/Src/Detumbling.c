@@ -20,8 +20,8 @@ void Detumble_Process(Detumble_t *detumble, SolarTracker_t *solar_data) {
     
     // 1. Obter a diferença de luz atual (Esquerda vs Direita)
     // Reutilizamos o cálculo já feito no SolarTracker para consistência
-    // erro_luz_direcional = (Luz Direita) - (Luz Esquerda)
-    float current_diff = solar_data->erro_luz_direcional;
+    // erro_tracker = diferença de luz entre os dois sensores da quina iluminada
+    float current_diff = (float)solar_data->erro_tracker;
 
     // 2. Calcular a Taxa de Variação (Derivada)
     // Se rate > 0: A luz está indo para a direita (Sol "passando" rápido)
@@ -37,7 +37,7 @@ void Detumble_Process(Detumble_t *detumble, SolarTracker_t *solar_data) {
     float torque_calc = -1.0f * detumble->Kd * rate_of_change;
 
     // 5. Verificação de Estabilidade (Zona Morta)
-    if (fabs(rate_of_change) < detumble->Deadzone) {
+    if (fabsf(rate_of_change) < detumble->Deadzone) {
         // Se a mudança for muito pequena, consideramos estável
         torque_calc = 0.0f;
         detumble->is_stable = 1;
@@ -51,4 +51,62 @@ void Detumble_Process(Detumble_t *detumble, SolarTracker_t *solar_data) {
 
     // Salva na estrutura
     detumble->output_torque = torque_calc;
-}
\ No newline at end of file
+}
+
+// --- Amortecimento pelo giroscópio ---
+
+void Detumble_Gyro_Start(Detumble_Gyro_t *detumble, uint32_t now_ms) {
+    memset(detumble, 0, sizeof(Detumble_Gyro_t));
+    detumble->gain = DETUMBLE_GAIN_MAX;
+    detumble->start_ms = now_ms;
+}
+
+float Detumble_Gyro_Process(Detumble_Gyro_t *detumble, const float rate[3], float wheel_speed,
+                            float wheel_min, float wheel_max, float dt, uint32_t now_ms) {
+
+    // 1. Agendamento do ganho pela taxa de rotação (3 eixos)
+    detumble->rate_norm = sqrtf(rate[0] * rate[0] + rate[1] * rate[1] + rate[2] * rate[2]);
+
+    float gain = DETUMBLE_GAIN_MAX;
+    if (detumble->rate_norm > 0.0f) {
+        gain = DETUMBLE_WHEEL_ACCEL_MAX / (DETUMBLE_INERTIA_RATIO * detumble->rate_norm);
+    }
+    if (gain > DETUMBLE_GAIN_MAX) gain = DETUMBLE_GAIN_MAX;
+    if (gain < DETUMBLE_GAIN_MIN) gain = DETUMBLE_GAIN_MIN;
+    detumble->gain = gain;
+
+    // 2. Lei de amortecimento: aceleração oposta à rotação em cada eixo
+    for (int i = 0; i < 3; i++) {
+        detumble->accel_cmd[i] = -gain * rate[i];
+    }
+
+    // 3. Roda (eixo Z), mesmo sinal do PID do modo ADCS
+    float wheel_accel = DETUMBLE_INERTIA_RATIO * detumble->accel_cmd[2];
+    if (wheel_accel > DETUMBLE_WHEEL_ACCEL_MAX) wheel_accel = DETUMBLE_WHEEL_ACCEL_MAX;
+    if (wheel_accel < -DETUMBLE_WHEEL_ACCEL_MAX) wheel_accel = -DETUMBLE_WHEEL_ACCEL_MAX;
+
+    float new_speed = wheel_speed + wheel_accel * dt;
+
+    // 4. Saturação de momento: velocidade para absorver toda a rotação em Z
+    float needed = wheel_speed - DETUMBLE_INERTIA_RATIO * rate[2];
+    detumble->momentum_limited = (needed > wheel_max || needed < wheel_min);
+
+    if (new_speed > wheel_max) new_speed = wheel_max;
+    if (new_speed < wheel_min) new_speed = wheel_min;
+
+    // 5. Convergência (só Z é controlável com uma roda)
+    if (fabsf(rate[2]) < DETUMBLE_RATE_DONE) {
+        if (!detumble->below) {
+            detumble->below = 1;
+            detumble->below_since_ms = now_ms;
+        }
+        if (!detumble->converged && (now_ms - detumble->below_since_ms) >= DETUMBLE_HOLD_MS) {
+            detumble->converged = 1;
+            detumble->converge_ms = detumble->below_since_ms - detumble->start_ms;
+        }
+    } else {
+        detumble->below = 0;
+    }
+
+    return new_speed;
+}
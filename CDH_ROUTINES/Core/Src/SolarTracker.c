@@ -50,6 +50,16 @@ void Solar_Process(SolarTracker_t *tracker) {
     tracker->angulo_solar_graus = ang_rad * (180.0f / 3.141592f);
     if (tracker->angulo_solar_graus < 0) tracker->angulo_solar_graus += 360.0f;
 
+    // Vetor solar para o estimador de atitude (LDRs laterais: só azimute)
+    float luz_total = sum_frente + sum_tras + sum_dir + sum_esq;
+    float modulo = sqrtf(vect_x * vect_x + vect_y * vect_y);
+    tracker->sol_visivel = (luz_total >= SOLAR_MIN_LUZ && modulo > HISTERESE_FINA);
+    if (tracker->sol_visivel) {
+        tracker->vetor_solar[0] = vect_x / modulo;
+        tracker->vetor_solar[1] = vect_y / modulo;
+        tracker->vetor_solar[2] = 0.0f;
+    }
+
     // 3. Lógica de Rastreio (Quina/Diagonal)
 
     // Somas das quinas
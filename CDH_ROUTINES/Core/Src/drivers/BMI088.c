@@ -210,10 +210,13 @@ uint8_t BMI088_ReadAccelerometer(BMI088 *imu) {
     uint8_t rxBuf[8];
 
     HAL_GPIO_WritePin(imu->csAccPinBank, imu->csAccPin, GPIO_PIN_RESET);
-    HAL_Delay(1);
-    HAL_StatusTypeDef  status = HAL_SPI_TransmitReceive(imu->spiHandle, txBuf, rxBuf, 8, HAL_MAX_DELAY);
+    HAL_StatusTypeDef  status = HAL_SPI_TransmitReceive(imu->spiHandle, txBuf, rxBuf, 8, BMI_SPI_TIMEOUT_MS);
     HAL_GPIO_WritePin(imu->csAccPinBank, imu->csAccPin, GPIO_PIN_SET);
 
+    if (status != HAL_OK) {
+        return status;  /* Mantém a última leitura válida */
+    }
+
     int16_t accX = (int16_t) ((rxBuf[3] << 8) | rxBuf[2]);
     int16_t accY = (int16_t) ((rxBuf[5] << 8) | rxBuf[4]);
     int16_t accZ = (int16_t) ((rxBuf[7] << 8) | rxBuf[6]);
@@ -234,10 +237,13 @@ uint8_t BMI088_ReadGyroscope(BMI088 *imu) {
 	uint8_t rxBuf[7] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}; /* Register addr, 6 bytes data */
 
 	HAL_GPIO_WritePin(imu->csGyrPinBank, imu->csGyrPin, GPIO_PIN_RESET);
-	HAL_Delay(1);
-	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(imu->spiHandle, txBuf, rxBuf, 7, 2* HAL_MAX_DELAY);
+	HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(imu->spiHandle, txBuf, rxBuf, 7, BMI_SPI_TIMEOUT_MS);
 	HAL_GPIO_WritePin(imu->csGyrPinBank, imu->csGyrPin, GPIO_PIN_SET);
 
+	if (status != HAL_OK) {
+		return status;  /* Mantém a última leitura válida */
+	}
+
 	/* Form signed 16-bit integers */
 	int16_t gyrX = (int16_t) ((rxBuf[2] << 8) | rxBuf[1]);
 	int16_t gyrY = (int16_t) ((rxBuf[4] << 8) | rxBuf[3]);
@@ -11,7 +11,10 @@
 #include "spi.h"
 #include "gpio.h"
 #include "main.h"
-#include <stdio.h>
+#include "uart_dma.h"
+#include "tim.h"
+#include "wheel_pwm.h"
+#include "dwt.h"
 #include <string.h>
 #include <math.h>
 
@@ -32,14 +35,120 @@ static ADCS_State_t adcs_state = {
 
 static ADCS_Sensors_t sensors = {0};
 
-static ADCS_PID_t pid_controller = {
-    .Kp = 1.0f,
-    .Ki = 0.1f,
-    .Kd = 0.05f,
-    .setpoint = 0.0f,
-    .error_sum = 0.0f,
-    .last_error = 0.0f
+static ADCS_CommandStats_t cmd_stats = {0};
+static ADCS_FramingMode_t adcs_framing = ADCS_DEFAULT_FRAMING;
+
+// Transmissão por DMA (quando a UART tem hdmatx); senão, envio bloqueante
+static UART_DMA_Tx_t adcs_tx;
+static uint8_t adcs_tx_buf[ADCS_TX_RING_SIZE];
+
+// Telemetria do SimpleFOC (UART4 RX por DMA circular)
+static UART_DMA_Rx_t adcs_rx;
+static uint8_t adcs_rx_buf[ADCS_RX_DMA_SIZE];
+static char mon_line[ADCS_MON_LINE_MAX];
+static uint8_t mon_len = 0;
+static uint8_t mon_overflow = 0;        // Linha longa demais: descarta até o '\n'
+
+// Atuador da roda: o controle só fala com estas operações
+typedef struct {
+    HAL_StatusTypeDef (*init)(UART_HandleTypeDef *huart);
+    void (*send)(UART_HandleTypeDef *huart, float speed);  // Já com dead zone e limites
+    void (*stop)(UART_HandleTypeDef *huart);               // Parada imediata
+    void (*poll)(void);                                    // Velocidade medida -> motor_state
+} ADCS_ActuatorOps_t;
+
+static HAL_StatusTypeDef ADCS_UartInit(UART_HandleTypeDef *huart);
+static void ADCS_UartSend(UART_HandleTypeDef *huart, float speed);
+static void ADCS_UartStop(UART_HandleTypeDef *huart);
+static void ADCS_UartPoll(void);
+static HAL_StatusTypeDef ADCS_PwmInit(UART_HandleTypeDef *huart);
+static void ADCS_PwmSend(UART_HandleTypeDef *huart, float speed);
+static void ADCS_PwmStop(UART_HandleTypeDef *huart);
+static void ADCS_PwmPoll(void);
+
+static const ADCS_ActuatorOps_t actuator_ops[] = {
+    [ADCS_ACTUATOR_UART] = {ADCS_UartInit, ADCS_UartSend, ADCS_UartStop, ADCS_UartPoll},
+    [ADCS_ACTUATOR_PWM] = {ADCS_PwmInit, ADCS_PwmSend, ADCS_PwmStop, ADCS_PwmPoll}
+};
+static ADCS_Actuator_t adcs_actuator = ADCS_DEFAULT_ACTUATOR;
+
+static ADCS_MotorState_t motor_state = {0};
+static uint8_t motor_faults = ADCS_FAULT_NONE;
+static uint8_t stall_timing = 0;
+static uint32_t stall_since = 0;
+
+// Ganhos por segundo: na taxa padrão equivalem aos antigos ganhos por amostra
+static const PID_Config_t pid_config = {
+    .kp = ADCS_PID_KP,
+    .ki = ADCS_PID_KI,
+    .kd = ADCS_PID_KD,
+    .tau = ADCS_PID_D_TAU,
+    .kt = ADCS_PID_KT,
+    .dt = 1.0f / ADCS_CONTROL_RATE_HZ,
+    .out_min = ADCS_MIN_SPEED / ADCS_PID_SPEED_SCALE,
+    .out_max = ADCS_MAX_SPEED / ADCS_PID_SPEED_SCALE
 };
+static PID_F32_t pid_controller;
+
+// Auto-tune do PID (relé no lugar do PID durante o experimento)
+static const Autotune_Config_t autotune_config = {
+    .relay_amplitude = ADCS_AUTOTUNE_RELAY,
+    .hysteresis = ADCS_AUTOTUNE_HYSTERESIS,
+    .eval_time = ADCS_AUTOTUNE_EVAL_S,
+    .relay_timeout = ADCS_AUTOTUNE_TIMEOUT_S,
+    .degrade_ratio = ADCS_AUTOTUNE_DEGRADE,
+    .cycles = ADCS_AUTOTUNE_CYCLES
+};
+static Autotune_t autotune;
+
+// Rampa da roda fora da malha fechada
+static const Profile_Config_t ramp_config = {
+    .accel_max = ADCS_RAMP_ACCEL,
+    .jerk_max = ADCS_RAMP_JERK,
+    .speed_min = ADCS_MIN_SPEED,
+    .speed_max = ADCS_MAX_SPEED
+};
+static Profile_t ramp;
+static uint8_t ramp_active = 0;
+static uint32_t ramp_last_cycles = 0;
+static ADCS_Momentum_t momentum = {0};
+
+// Estimador de atitude (roda a cada iteração do controle)
+#if ADCS_ATT_USE_MEKF
+static const Mekf_Config_t mekf_config = {
+    .gyro_noise = ADCS_MEKF_GYRO_NOISE,
+    .bias_noise = ADCS_MEKF_BIAS_NOISE,
+    .acc_noise = ADCS_MEKF_ACC_NOISE,
+    .sun_noise = ADCS_MEKF_SUN_NOISE,
+    .att_sigma0 = ADCS_MEKF_ATT_SIGMA0,
+    .bias_sigma0 = ADCS_MEKF_BIAS_SIGMA0
+};
+static Mekf_t mekf DTCM_DATA;           // P e áreas de trabalho: acesso a cada iteração
+#else
+static Attitude_t attitude;
+#endif
+static const float sun_ref_default[3] = {1.0f, 0.0f, 0.0f};   // Sol no eixo X inercial
+static uint32_t attitude_last_cycles = 0;
+static uint8_t attitude_primed = 0;
+static float attitude_dt = 0.0f;        // Período da última iteração (0 = não propagou)
+static float sun_body[3];               // Vetor solar do SolarTracker (loop principal)
+static uint8_t sun_valid = 0;
+static uint32_t sun_tick = 0;
+static uint8_t sun_pending = 0;         // Amostra nova ainda não usada pela MEKF
+
+// Detumbling pelo giroscópio
+static Detumble_Gyro_t detumble;
+static float detumble_speed = 0.0f;     // Comando integrado da roda (atravessa a dead zone)
+static CDH_OperationMode_t last_mode = CDH_MODE_IDLE;
+
+// Malha de controle no TIM6
+static UART_HandleTypeDef *control_huart = NULL;
+static volatile uint8_t control_running = 0;
+static uint32_t control_period_cycles = 0;
+static uint32_t control_last_cycles = 0;
+static ADCS_TimingStats_t timing = {0};
+static int64_t jitter_sum = 0;
+static uint64_t exec_sum = 0;
 
 /* ============================================================================
    INICIALIZAÇÃO
@@ -54,9 +163,32 @@ void ADCS_Init(UART_HandleTypeDef *huart)
     adcs_state.current_speed = 0;
     adcs_state.motor_active = 0;
     adcs_state.motor_initialized = 0;
+    adcs_state.sent_valid = 0;
+    
+    if (huart->hdmatx != NULL && adcs_tx.huart != huart) {
+        UART_DMA_StartTx(&adcs_tx, huart, adcs_tx_buf, sizeof(adcs_tx_buf));
+    }
+    if (huart->hdmarx != NULL && adcs_rx.huart != huart) {
+        mon_len = 0;
+        mon_overflow = 0;
+        UART_DMA_StartRx(&adcs_rx, huart, adcs_rx_buf, sizeof(adcs_rx_buf));
+    }
     
     // Reseta PID
-    ADCS_PID_Reset(&pid_controller);
+    PID_F32_Init(&pid_controller, &pid_config);
+    Autotune_Init(&autotune, &autotune_config);
+    Profile_Init(&ramp, &ramp_config);
+    ramp_active = 0;
+    
+    // Estimador de atitude; o SolarTracker só mede o azimute (plano XY)
+#if ADCS_ATT_USE_MEKF
+    Mekf_Init(&mekf, &mekf_config);
+    Mekf_SetSunReference(&mekf, sun_ref_default, 1);
+#else
+    Attitude_Init(&attitude, ADCS_ATT_KP_ACC, ADCS_ATT_KP_SUN, ADCS_ATT_KI);
+    Attitude_SetSunReference(&attitude, sun_ref_default, 1);
+#endif
+    attitude_primed = 0;
     
     // ===== INICIALIZA BMI088 (Sensor IMU) =====
     // SPI4: Acelerômetro CS = OBC_CS_ACC (GPIOE), Giroscópio CS = OBC_CS_GYR (GPIOI)
@@ -69,7 +201,8 @@ void ADCS_Init(UART_HandleTypeDef *huart)
                                           OBC_CS_ACC_GPIO_Port, OBC_CS_ACC_Pin,
                                           OBC_CS_GYR_GPIO_Port, OBC_CS_GYR_Pin);
         
-        if (imu_status == HAL_OK) {
+        // BMI088_Init soma as transferências bem-sucedidas (não é HAL_StatusTypeDef)
+        if (imu_status != 0) {
             bmi088_initialized = 1;
             // Debug: Sensor inicializado com sucesso
         } else {
@@ -83,9 +216,7 @@ void ADCS_Init(UART_HandleTypeDef *huart)
     // Pequeno delay para estabilizar UART
     HAL_Delay(100);
     
-    // Envia comando de seleção de motor (equivalente ao Serial.print("MC1\\n"))
-    ADCS_SendCommand(huart, ADCS_CMD_SELECT_MOTOR);
-    HAL_Delay(50);
+    actuator_ops[adcs_actuator].init(huart);
     
     adcs_state.motor_initialized = 1;
 }
@@ -93,13 +224,164 @@ void ADCS_Init(UART_HandleTypeDef *huart)
 /* ============================================================================
    COMUNICAÇÃO COM SIMPLEFOC
    ============================================================================ */
+/**
+ * @brief Entrega bytes à UART: anel do DMA se disponível, senão bloqueante
+ * @return HAL_BUSY se o anel estiver cheio (nada é enviado)
+ */
+static HAL_StatusTypeDef ADCS_Write(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+    if (adcs_tx.huart == huart) {
+        return UART_DMA_Write(&adcs_tx, data, len);
+    }
+    return HAL_UART_Transmit(huart, (uint8_t*)data, len, HAL_MAX_DELAY);
+}
+
+/**
+ * @brief Monta "{prefix}{value}\\n" sem snprintf
+ * @param dst Pelo menos 14 bytes (prefixo, sinal, 10 dígitos e '\\n')
+ * @return Tamanho do comando (sem terminador)
+ */
+static uint8_t ADCS_FormatCommand(char *dst, char prefix, int32_t value)
+{
+    char digits[10];
+    uint8_t n = 0;
+    uint8_t len = 0;
+    uint32_t mag = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    do {
+        digits[n++] = (char)('0' + mag % 10U);
+        mag /= 10U;
+    } while (mag > 0);
+
+    dst[len++] = prefix;
+    if (value < 0) {
+        dst[len++] = '-';
+    }
+    while (n > 0) {
+        dst[len++] = digits[--n];
+    }
+    dst[len++] = '\n';
+
+    return len;
+}
+
+/**
+ * @brief CRC-8 (polinômio 0x07, init 0x00) do frame binário
+ */
+static uint8_t ADCS_CRC8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0x00;
+
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Monta o frame binário [SYNC][CMD][float LE][CRC-8]
+ * @return ADCS_BIN_FRAME_SIZE
+ */
+static uint8_t ADCS_FormatBinary(uint8_t *dst, uint8_t cmd, float value)
+{
+    uint32_t raw;
+
+    memcpy(&raw, &value, sizeof(raw));
+    dst[0] = ADCS_BIN_SYNC;
+    dst[1] = cmd;
+    dst[2] = raw & 0xFF;
+    dst[3] = (raw >> 8) & 0xFF;
+    dst[4] = (raw >> 16) & 0xFF;
+    dst[5] = (raw >> 24) & 0xFF;
+    dst[6] = ADCS_CRC8(&dst[1], 5);
+
+    return ADCS_BIN_FRAME_SIZE;
+}
+
+/**
+ * @brief Seleciona o motor no SimpleFOC (equivalente ao Serial.print("MC1\\n"))
+ */
+static HAL_StatusTypeDef ADCS_UartInit(UART_HandleTypeDef *huart)
+{
+    ADCS_SendCommand(huart, ADCS_CMD_SELECT_MOTOR);
+    HAL_Delay(50);
+    return HAL_OK;
+}
+
+/**
+ * @brief Envia um comando de velocidade, suprimindo repetições
+ * @note A mesma velocidade só sai de novo após ADCS_KEEPALIVE_MS, para o
+ *       SimpleFOC não ficar sem comando se um byte se perder na linha.
+ *       Em ASCII a comparação é feita já arredondada para inteiro.
+ */
+static void ADCS_UartSend(UART_HandleTypeDef *huart, float speed)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (adcs_framing == ADCS_FRAMING_ASCII) {
+        speed = (float)(int16_t)(speed + ((speed >= 0.0f) ? 0.5f : -0.5f));
+    }
+
+    if (adcs_state.sent_valid && adcs_state.sent_speed == speed &&
+        (ADCS_KEEPALIVE_MS == 0 || (now - adcs_state.sent_tick) < ADCS_KEEPALIVE_MS)) {
+        cmd_stats.commands_skipped++;
+    } else {
+        uint8_t cmd[16];
+        uint8_t len;
+
+        if (adcs_framing == ADCS_FRAMING_BINARY) {
+            len = ADCS_FormatBinary(cmd, ADCS_BIN_CMD_TARGET, speed);
+        } else {
+            len = ADCS_FormatCommand((char*)cmd, 'M', (int32_t)speed);
+        }
+
+        if (ADCS_Write(huart, cmd, len) == HAL_OK) {
+            adcs_state.sent_speed = speed;
+            adcs_state.sent_valid = 1;
+            adcs_state.sent_tick = now;
+            cmd_stats.commands_sent++;
+        } else {
+            // Não aceito: a próxima chamada tenta de novo mesmo sem mudança
+            adcs_state.sent_valid = 0;
+            cmd_stats.commands_dropped++;
+        }
+    }
+}
+
+static void ADCS_UartStop(UART_HandleTypeDef *huart)
+{
+    ADCS_UartSend(huart, 0.0f);
+}
+
+/**
+ * @brief Custo do comando no atuador (ciclos DWT desde start)
+ */
+static void ADCS_CommandCycles(uint32_t start)
+{
+    cmd_stats.last_cycles = DWT_GetCycles() - start;
+    if (cmd_stats.last_cycles > cmd_stats.max_cycles) {
+        cmd_stats.max_cycles = cmd_stats.last_cycles;
+    }
+}
+
+static void ADCS_SendSpeed(UART_HandleTypeDef *huart, float speed)
+{
+    uint32_t start = DWT_GetCycles();
+    actuator_ops[adcs_actuator].send(huart, speed);
+    ADCS_CommandCycles(start);
+}
+
 /**
  * @brief Envia comando genérico para o motor SimpleFOC
  * @param cmd String de comando (ex: "M0\\n", "MC1\\n")
  */
 void ADCS_SendCommand(UART_HandleTypeDef *huart, const char *cmd)
 {
-    HAL_UART_Transmit(huart, (uint8_t*)cmd, strlen(cmd), HAL_MAX_DELAY);
+    ADCS_Write(huart, (const uint8_t*)cmd, strlen(cmd));
 }
 
 /**
@@ -107,6 +389,17 @@ void ADCS_SendCommand(UART_HandleTypeDef *huart, const char *cmd)
  * @param speed Velocidade desejada (negativo = esquerda, positivo = direita)
  */
 void ADCS_SetSpeed(UART_HandleTypeDef *huart, int16_t speed)
+{
+    ADCS_SetSpeedFloat(huart, (float)speed);
+}
+
+/**
+ * @brief Define velocidade do motor com resolução fracionária
+ * @param speed Velocidade desejada (-127.0 a +127.0)
+ * @note A fração só chega ao motor no modo binário (ou no PWM); em ASCII
+ *       é arredondada
+ */
+void ADCS_SetSpeedFloat(UART_HandleTypeDef *huart, float speed)
 {
     // Aplica dead zone
     if (speed >= -ADCS_DEAD_ZONE && speed <= ADCS_DEAD_ZONE) {
@@ -117,36 +410,325 @@ void ADCS_SetSpeed(UART_HandleTypeDef *huart, int16_t speed)
     if (speed > ADCS_MAX_SPEED) speed = ADCS_MAX_SPEED;
     if (speed < ADCS_MIN_SPEED) speed = ADCS_MIN_SPEED;
     
-    adcs_state.target_speed = speed;
-    
-    // Monta comando no formato "M{speed}\\n" (ex: "M-125\\n" ou "M125\\n")
-    char cmd_buffer[16];
-    snprintf(cmd_buffer, sizeof(cmd_buffer), "M%d\n", speed);
+    int16_t rounded = (int16_t)(speed + ((speed >= 0.0f) ? 0.5f : -0.5f));
+    adcs_state.target_speed = rounded;
     
-    // Envia via UART
-    ADCS_SendCommand(huart, cmd_buffer);
+    // ASCII: "M{speed}\\n" (ex: "M-125\\n"); binário: frame com o float
+    ADCS_SendSpeed(huart, speed);
     
     // Atualiza flags
-    if (speed == 0) {
+    if (speed == 0.0f) {
         adcs_state.motor_active = 0;
     } else {
         adcs_state.motor_active = 1;
     }
     
-    adcs_state.current_speed = speed;
+    // Sem telemetria, a velocidade atual é o próprio comando
+    if (!ADCS_IsTelemetryFresh()) {
+        adcs_state.current_speed = rounded;
+    }
+}
+
+/**
+ * @brief Seleciona o formato dos comandos de velocidade
+ * @note O próximo comando sai no novo formato mesmo sem mudança de velocidade
+ */
+void ADCS_SetFraming(ADCS_FramingMode_t mode)
+{
+    adcs_framing = mode;
+    adcs_state.sent_valid = 0;
+}
+
+ADCS_FramingMode_t ADCS_GetFraming(void)
+{
+    return adcs_framing;
 }
 
 /**
  * @brief Para o motor imediatamente
+ * @note No atuador PWM é o EN baixo: o driver corta a ponte por hardware
  */
 void ADCS_Stop(UART_HandleTypeDef *huart)
 {
-    ADCS_SendCommand(huart, ADCS_CMD_STOP);
+    uint32_t start = DWT_GetCycles();
+    actuator_ops[adcs_actuator].stop(huart);
+    ADCS_CommandCycles(start);
+
     adcs_state.target_speed = 0;
-    adcs_state.current_speed = 0;
     adcs_state.motor_active = 0;
+    if (!ADCS_IsTelemetryFresh()) {
+        adcs_state.current_speed = 0;
+    }
 }
 
+/* ============================================================================
+   TELEMETRIA DO SIMPLEFOC
+   ============================================================================ */
+/**
+ * @brief Converte um campo decimal ("-12.3456") sem strtof
+ * @return 1 se o campo inteiro for um número válido
+ * @note Aceita só o que o Serial.print(float) do Arduino produz: sinal,
+ *       dígitos e fração opcional (sem expoente, nan ou inf)
+ */
+static uint8_t ADCS_ParseFloat(const char *s, uint8_t len, float *out)
+{
+    uint8_t i = 0;
+    uint8_t digits = 0;
+    uint8_t neg = 0;
+    uint32_t int_part = 0;
+    uint32_t frac_part = 0;
+    float frac_scale = 1.0f;
+
+    if (i < len && (s[i] == '-' || s[i] == '+')) {
+        neg = (s[i] == '-');
+        i++;
+    }
+
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+        if (++digits > 9) {
+            return 0;       // Fora da faixa de qualquer grandeza do motor
+        }
+        int_part = int_part * 10U + (uint32_t)(s[i] - '0');
+    }
+
+    if (i < len && s[i] == '.') {
+        for (i++; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+            if (frac_scale < 1e6f) {     // Além de 6 casas não muda o float
+                frac_part = frac_part * 10U + (uint32_t)(s[i] - '0');
+                frac_scale *= 10.0f;
+            }
+            digits++;
+        }
+    }
+
+    if (digits == 0 || i != len) {
+        return 0;
+    }
+
+    float value = (float)int_part + (float)frac_part / frac_scale;
+    *out = neg ? -value : value;
+    return 1;
+}
+
+/**
+ * @brief Atualiza as falhas com a amostra recém-chegada
+ * @note Avaliado a cada amostra, então uma falha aparece dentro do período
+ *       de monitor do SimpleFOC (e o travamento após ADCS_STALL_MS)
+ */
+static void ADCS_UpdateFaults(uint32_t now)
+{
+    if (fabsf(motor_state.voltage_q) >= ADCS_VOLTAGE_LIMIT * ADCS_SATURATION_RATIO) {
+        motor_faults |= ADCS_FAULT_SATURATED;
+    } else {
+        motor_faults &= ~ADCS_FAULT_SATURATED;
+    }
+
+    int16_t cmd = adcs_state.target_speed;
+    if ((cmd >= ADCS_STALL_MIN_CMD || cmd <= -ADCS_STALL_MIN_CMD) &&
+        fabsf(motor_state.velocity) < ADCS_STALL_SPEED) {
+        if (!stall_timing) {
+            stall_timing = 1;
+            stall_since = now;
+        } else if ((now - stall_since) >= ADCS_STALL_MS) {
+            motor_faults |= ADCS_FAULT_STALL;
+        }
+    } else {
+        stall_timing = 0;
+    }
+}
+
+/**
+ * @brief Fecha uma amostra nova de motor_state (velocidade já preenchida)
+ */
+static void ADCS_AcceptSample(uint32_t now)
+{
+    motor_state.timestamp_ms = now;
+    motor_state.samples++;
+    motor_state.valid = 1;
+
+    float rounded = motor_state.velocity + ((motor_state.velocity >= 0.0f) ? 0.5f : -0.5f);
+    if (rounded > 32767.0f) rounded = 32767.0f;
+    if (rounded < -32768.0f) rounded = -32768.0f;
+    adcs_state.current_speed = (int16_t)rounded;
+
+    ADCS_UpdateFaults(now);
+}
+
+/**
+ * @brief Interpreta uma linha do motor.monitor() ("Uq\tIq\tvel")
+ */
+static void ADCS_ParseMonitorLine(void)
+{
+    float values[ADCS_MON_COLUMNS];
+    uint8_t col = 0;
+    uint8_t start = 0;
+
+    if (mon_len > 0 && mon_line[mon_len - 1] == '\r') {
+        mon_len--;
+    }
+
+    for (uint8_t i = 0; i <= mon_len; i++) {
+        if (i < mon_len && mon_line[i] != '\t') {
+            continue;
+        }
+        if (col >= ADCS_MON_COLUMNS ||
+            !ADCS_ParseFloat(&mon_line[start], i - start, &values[col])) {
+            motor_state.rejected++;
+            return;
+        }
+        col++;
+        start = i + 1;
+    }
+
+    if (col != ADCS_MON_COLUMNS) {
+        motor_state.rejected++;
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+
+    motor_state.voltage_q = values[ADCS_MON_COL_VOLTAGE_Q];
+    motor_state.current_q = values[ADCS_MON_COL_CURRENT_Q];
+    motor_state.velocity = values[ADCS_MON_COL_VELOCITY];
+    motor_state.timestamp_cycles = adcs_rx.event_cycles;
+    ADCS_AcceptSample(now);
+}
+
+/**
+ * @brief Consome a telemetria recebida pelo DMA (não bloqueante)
+ * @note Lê direto do buffer circular; só as linhas completas são
+ *       interpretadas, o resto fica em mon_line para a próxima chamada
+ */
+static void ADCS_UartPoll(void)
+{
+    const uint8_t *data;
+    uint16_t available;
+
+    if (adcs_rx.huart == NULL) {
+        return;
+    }
+
+    while ((available = UART_DMA_Peek(&adcs_rx, &data)) > 0) {
+        for (uint16_t i = 0; i < available; i++) {
+            char c = (char)data[i];
+
+            if (c == '\n') {
+                if (!mon_overflow && mon_len > 0) {
+                    ADCS_ParseMonitorLine();
+                }
+                mon_len = 0;
+                mon_overflow = 0;
+            } else if (mon_len < sizeof(mon_line)) {
+                mon_line[mon_len++] = c;
+            } else if (!mon_overflow) {
+                mon_overflow = 1;
+                motor_state.rejected++;
+            }
+        }
+
+        UART_DMA_Consume(&adcs_rx, available);
+    }
+}
+
+/**
+ * @brief Velocidade medida pelo atuador (telemetria do SimpleFOC ou tacômetro)
+ */
+void ADCS_PollTelemetry(void)
+{
+    actuator_ops[adcs_actuator].poll();
+
+    if (ADCS_IsTelemetryFresh()) {
+        motor_faults &= ~ADCS_FAULT_NO_TELEMETRY;
+    } else {
+        motor_faults |= ADCS_FAULT_NO_TELEMETRY;
+    }
+}
+
+/* ============================================================================
+   ATUADOR PWM (TIM2_CH3 + DIR + EN, TACÔMETRO NO TIM5_CH1)
+   ============================================================================ */
+static HAL_StatusTypeDef ADCS_PwmInit(UART_HandleTypeDef *huart)
+{
+    return WheelPWM_Init(&htim2, TIM_CHANNEL_3, &htim5, TIM_CHANNEL_1);
+}
+
+/**
+ * @brief Comando direto no CCR: sem supressão de repetidos nem fila
+ */
+static void ADCS_PwmSend(UART_HandleTypeDef *huart, float speed)
+{
+    WheelPWM_SetDuty(speed / ADCS_PWM_FULL_SCALE);
+    cmd_stats.commands_sent++;
+}
+
+static void ADCS_PwmStop(UART_HandleTypeDef *huart)
+{
+    WheelPWM_Stop();
+    cmd_stats.commands_sent++;
+}
+
+/**
+ * @brief Lê o tacômetro a cada iteração (amostra sempre nova)
+ * @note O duty faz o papel da tensão q: duty no limite = saturado
+ */
+static void ADCS_PwmPoll(void)
+{
+    WheelPWM_Status_t wheel;
+
+    motor_state.velocity = WheelPWM_GetSpeed();
+    WheelPWM_GetStatus(&wheel);
+    motor_state.voltage_q = wheel.duty * ADCS_VOLTAGE_LIMIT;
+    motor_state.current_q = 0.0f;
+    motor_state.timestamp_cycles = DWT_GetCycles();
+    ADCS_AcceptSample(HAL_GetTick());
+}
+
+/* ============================================================================
+   SELEÇÃO DO ATUADOR
+   ============================================================================ */
+/**
+ * @brief Troca o atuador da roda
+ * @return HAL_ERROR com a malha do TIM6 ligada, atuador inválido ou se o
+ *         novo não iniciar (fica o antigo, parado)
+ * @note Antes do ADCS_Init só registra a escolha. A roda para no atuador
+ *       antigo; o novo parte sem amostra (ADCS_FAULT_NO_TELEMETRY até a
+ *       primeira leitura).
+ */
+HAL_StatusTypeDef ADCS_SetActuator(UART_HandleTypeDef *huart, ADCS_Actuator_t actuator)
+{
+    if (control_running || actuator > ADCS_ACTUATOR_PWM) {
+        return HAL_ERROR;
+    }
+    if (!adcs_state.motor_initialized) {
+        adcs_actuator = actuator;
+        return HAL_OK;
+    }
+    if (actuator == adcs_actuator) {
+        return HAL_OK;
+    }
+
+    ADCS_Stop(huart);
+    ramp_active = 0;
+    if (actuator_ops[actuator].init(huart) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    adcs_actuator = actuator;
+    adcs_state.sent_valid = 0;
+    memset(&motor_state, 0, sizeof(motor_state));
+    motor_faults = ADCS_FAULT_NONE;
+    stall_timing = 0;
+
+    return HAL_OK;
+}
+
+ADCS_Actuator_t ADCS_GetActuator(void)
+{
+    return adcs_actuator;
+}
+
+
+
 /* ============================================================================
    LEITURA DE SENSORES (TODO: Implementar com I2C/SPI)
    ============================================================================ */
@@ -189,120 +771,648 @@ void ADCS_ReadSensors(ADCS_Sensors_t *sensors)
     }
 }
 
+/* ============================================================================
+   ESTIMADOR DE ATITUDE
+   ============================================================================ */
+/**
+ * @brief Bias do giroscópio estimado pelo filtro em uso
+ */
+static inline const float *ADCS_GyroBias(void)
+{
+#if ADCS_ATT_USE_MEKF
+    return mekf.bias;
+#else
+    return attitude.bias;
+#endif
+}
+
+/**
+ * @brief Uma iteração do estimador com a última leitura do BMI088
+ * @note dt medido pelo DWT entre chamadas (vale com ou sem o TIM6). A
+ *       primeira chamada, ou uma depois de pausa longa, só marca o tempo.
+ */
+static void ADCS_UpdateAttitude(void)
+{
+    if (!bmi088_initialized) {
+        attitude_dt = 0.0f;
+        return;
+    }
+
+    uint32_t start = DWT_GetCycles();
+    float dt = (float)(start - attitude_last_cycles) / (float)SystemCoreClock;
+    attitude_last_cycles = start;
+
+    if (!attitude_primed || dt > ADCS_ATT_MAX_DT) {
+        attitude_primed = 1;
+        attitude_dt = 0.0f;
+        return;
+    }
+    attitude_dt = dt;
+
+    const float gyro[3] = {sensors.gyro_x, sensors.gyro_y, sensors.gyro_z};
+    const float accel[3] = {sensors.accel_x, sensors.accel_y, sensors.accel_z};
+    uint8_t sun_fresh = sun_valid && (HAL_GetTick() - sun_tick) < ADCS_SUN_TIMEOUT_MS;
+
+#if ADCS_ATT_USE_MEKF
+    Mekf_Predict(&mekf, gyro, dt);
+    uint32_t predicted = DWT_GetCycles();
+    Mekf_UpdateGravity(&mekf, accel);
+    if (sun_fresh && sun_pending) {
+        Mekf_UpdateSun(&mekf, sun_body);
+        sun_pending = 0;
+    } else {
+        mekf.sun_used = 0;
+    }
+    uint32_t end = DWT_GetCycles();
+
+    timing.mekf_predict_last_cycles = predicted - start;
+    if (timing.mekf_predict_last_cycles > timing.mekf_predict_max_cycles) {
+        timing.mekf_predict_max_cycles = timing.mekf_predict_last_cycles;
+    }
+    timing.mekf_update_last_cycles = end - predicted;
+    if (timing.mekf_update_last_cycles > timing.mekf_update_max_cycles) {
+        timing.mekf_update_max_cycles = timing.mekf_update_last_cycles;
+    }
+#else
+    Attitude_Update(&attitude, gyro, accel, sun_fresh ? sun_body : NULL, dt);
+#endif
+
+    uint32_t cycles = DWT_GetCycles() - start;
+    timing.attitude_last_cycles = cycles;
+    if (cycles > timing.attitude_max_cycles) {
+        timing.attitude_max_cycles = cycles;
+    }
+}
+
+/**
+ * @brief Entrega o vetor solar do SolarTracker ao estimador
+ * @param sun Direção do Sol no corpo (vetor_solar)
+ * @param valid sol_visivel; 0 = eclipse ou luz insuficiente
+ * @note Chamar do loop principal a cada Solar_Process
+ */
+void ADCS_SetSunVector(const float sun[3], uint8_t valid)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    sun_body[0] = sun[0];
+    sun_body[1] = sun[1];
+    sun_body[2] = sun[2];
+    sun_valid = valid;
+    sun_tick = HAL_GetTick();
+    sun_pending = 1;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Direção do Sol no sistema inercial (padrão: eixo X)
+ * @note Medida tratada como planar (LDRs laterais do SolarTracker)
+ */
+void ADCS_SetSunReference(const float ref[3])
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#if ADCS_ATT_USE_MEKF
+    Mekf_SetSunReference(&mekf, ref, 1);
+#else
+    Attitude_SetSunReference(&attitude, ref, 1);
+#endif
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Copia a atitude estimada (Euler calculado aqui, fora da malha)
+ */
+void ADCS_GetAttitude(ADCS_Attitude_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#if ADCS_ATT_USE_MEKF
+    float bias_sigma[3];
+    out->q = mekf.q;
+    Mekf_GetSigma(&mekf, out->att_sigma, bias_sigma);
+    out->acc_used = mekf.acc_used;
+    out->sun_used = mekf.sun_used;
+    out->updates = mekf.predicts;
+#else
+    out->q = attitude.q;
+    out->att_sigma[0] = out->att_sigma[1] = out->att_sigma[2] = 0.0f;
+    out->acc_used = attitude.acc_used;
+    out->sun_used = attitude.sun_used;
+    out->updates = attitude.updates;
+#endif
+    const float *bias = ADCS_GyroBias();
+    for (uint8_t i = 0; i < 3; i++) {
+        out->gyro_bias[i] = bias[i];
+    }
+    out->rate[0] = sensors.gyro_x - bias[0];
+    out->rate[1] = sensors.gyro_y - bias[1];
+    out->rate[2] = sensors.gyro_z - bias[2];
+    __set_PRIMASK(primask);
+
+    Attitude_ToEuler(&out->q, &out->roll, &out->pitch, &out->yaw);
+}
+
+/**
+ * @brief Copia o estado do detumbling (válido desde a última entrada no modo)
+ */
+void ADCS_GetDetumbleStatus(Detumble_Gyro_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = detumble;
+    __set_PRIMASK(primask);
+}
+
 /* ============================================================================
    CONTROLE PID
    ============================================================================ */
 /**
- * @brief Calcula saída do controlador PID
- * @param pid Ponteiro para estrutura PID
- * @param current_value Valor atual medido
- * @return Saída do controlador PID
+ * @brief Troca os ganhos do PID de atitude sem degrau no comando
+ * @note Pode ser chamada com a malha rodando (interrupção desligada
+ *       durante a troca)
  */
-float ADCS_PID_Compute(ADCS_PID_t *pid, float current_value)
+void ADCS_SetPIDGains(float kp, float ki, float kd)
 {
-    // Calcula erro
-    float error = pid->setpoint - current_value;
-    
-    // Termo Proporcional
-    float P = pid->Kp * error;
-    
-    // Termo Integral (com anti-windup simples)
-    pid->error_sum += error;
-    if (pid->error_sum > 100.0f) pid->error_sum = 100.0f;
-    if (pid->error_sum < -100.0f) pid->error_sum = -100.0f;
-    float I = pid->Ki * pid->error_sum;
-    
-    // Termo Derivativo
-    float derivative = error - pid->last_error;
-    float D = pid->Kd * derivative;
-    
-    // Atualiza último erro
-    pid->last_error = error;
-    
-    // Saída PID
-    float output = P + I + D;
-    
-    return output;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    PID_F32_SetGains(&pid_controller, kp, ki, kd);
+    __set_PRIMASK(primask);
 }
 
+void ADCS_GetPIDGains(float *kp, float *ki, float *kd)
+{
+    *kp = pid_controller.cfg.kp;
+    *ki = pid_controller.cfg.ki;
+    *kd = pid_controller.cfg.kd;
+}
+
+/* ============================================================================
+   AUTO-TUNE DO PID
+   ============================================================================ */
 /**
- * @brief Reseta o controlador PID
- * @param pid Ponteiro para estrutura PID
+ * @brief Aplica no PID o evento do auto-tune (mesma iteração da troca de fase)
  */
-void ADCS_PID_Reset(ADCS_PID_t *pid)
+static void ADCS_AutotuneApply(Autotune_Event_t event)
 {
-    pid->error_sum = 0.0f;
-    pid->last_error = 0.0f;
+    switch (event) {
+        case AUTOTUNE_EVT_APPLY:
+            // Saída do relé não tem relação com o integrador: parte do zero
+            PID_F32_SetGains(&pid_controller, autotune.new_kp, autotune.new_ki, autotune.new_kd);
+            PID_F32_Reset(&pid_controller);
+            break;
+        case AUTOTUNE_EVT_RESTORE:
+            PID_F32_SetGains(&pid_controller, autotune.old_kp, autotune.old_ki, autotune.old_kd);
+            break;
+        case AUTOTUNE_EVT_RELEASE:
+            PID_F32_Reset(&pid_controller);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Começa o auto-tune com os ganhos atuais como referência
+ * @return HAL_ERROR fora do modo ADCS ou com a roda travada, HAL_BUSY se
+ *         já houver um experimento em andamento
+ */
+HAL_StatusTypeDef ADCS_Autotune_Start(void)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (CAN_GetCurrentMode() != CDH_MODE_ADCS || (motor_faults & ADCS_FAULT_STALL)) {
+        return HAL_ERROR;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (Autotune_IsRunning(&autotune)) {
+        status = HAL_BUSY;
+    } else {
+        Autotune_Start(&autotune, pid_controller.cfg.kp, pid_controller.cfg.ki,
+                       pid_controller.cfg.kd);
+    }
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+/**
+ * @brief Interrompe o auto-tune (em verificação, os ganhos antigos voltam)
+ */
+void ADCS_Autotune_Abort(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ADCS_AutotuneApply(Autotune_Abort(&autotune));
+    __set_PRIMASK(primask);
+}
+
+void ADCS_GetAutotuneStatus(Autotune_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = autotune;
+    __set_PRIMASK(primask);
+}
+
+/* ============================================================================
+   RAMPA E MOMENTO DA RODA
+   ============================================================================ */
+/**
+ * @brief Velocidade da roda medida (sem telemetria recente, o último comando)
+ */
+static float ADCS_WheelSpeed(void)
+{
+    return ADCS_IsTelemetryFresh() ? motor_state.velocity : (float)adcs_state.target_speed;
+}
+
+/**
+ * @brief Momento da roda e pedido de dessaturação
+ * @note Sem torque externo a bordo (só a roda em Z), o pedido só é
+ *       reportado: descarregar a roda fica com quem recebe o aviso
+ */
+static void ADCS_UpdateMomentum(void)
+{
+    momentum.wheel_speed = ADCS_WheelSpeed();
+    momentum.momentum = ADCS_WHEEL_INERTIA * momentum.wheel_speed;
+    momentum.fraction = fabsf(momentum.wheel_speed) / (float)ADCS_MAX_SPEED;
+
+    if (!momentum.desat_needed && momentum.fraction >= ADCS_MOMENTUM_HIGH) {
+        momentum.desat_needed = 1;
+        momentum.desat_events++;
+    } else if (momentum.desat_needed && momentum.fraction <= ADCS_MOMENTUM_LOW) {
+        momentum.desat_needed = 0;
+    }
+}
+
+/**
+ * @brief Novo alvo da rampa; sem rampa em andamento, parte da velocidade medida
+ */
+static void ADCS_RampStart(float speed)
+{
+    if (!ramp_active) {
+        Profile_Reset(&ramp, ADCS_WheelSpeed());
+        ramp_last_cycles = DWT_GetCycles();
+        ramp_active = 1;
+    }
+    Profile_SetTarget(&ramp, speed);
+}
+
+/**
+ * @brief Avança a rampa pelo tempo desde a última chamada e comanda a roda
+ * @note Chegando a zero, o motor é desligado e a rampa termina
+ */
+static void ADCS_RampStep(UART_HandleTypeDef *huart)
+{
+    uint32_t now = DWT_GetCycles();
+    float dt = (float)(now - ramp_last_cycles) / (float)SystemCoreClock;
+    ramp_last_cycles = now;
+    if (dt > ADCS_RAMP_MAX_DT) {
+        dt = ADCS_RAMP_MAX_DT;
+    }
+
+    float speed = Profile_Update(&ramp, dt);
+    if (speed == 0.0f && Profile_IsDone(&ramp)) {
+        ramp_active = 0;
+        ADCS_Stop(huart);
+    } else {
+        ADCS_SetSpeedFloat(huart, speed);
+    }
+}
+
+/**
+ * @brief Leva a roda a speed em curva S, sem bloquear
+ * @return HAL_ERROR nos modos ADCS/DETUMBLING (a malha fechada comanda a
+ *         roda) ou antes do ADCS_Init
+ * @note Quem avança a rampa é o ADCS_Process (ou a malha no TIM6)
+ */
+HAL_StatusTypeDef ADCS_SetSpeedRamp(float speed)
+{
+    CDH_OperationMode_t mode = CAN_GetCurrentMode();
+
+    if (mode == CDH_MODE_ADCS || mode == CDH_MODE_DETUMBLING || !adcs_state.motor_initialized) {
+        return HAL_ERROR;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ADCS_RampStart(speed);
+    __set_PRIMASK(primask);
+
+    return HAL_OK;
+}
+
+uint8_t ADCS_IsRampDone(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t done = !ramp_active || Profile_IsDone(&ramp);
+    __set_PRIMASK(primask);
+    return done;
+}
+
+void ADCS_GetMomentum(ADCS_Momentum_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = momentum;
+    __set_PRIMASK(primask);
 }
 
 /* ============================================================================
    ROTINA PRINCIPAL ADCS
    ============================================================================ */
 /**
- * @brief Processa rotina ADCS (chamada no loop principal)
- * @note Implementa controle baseado em sensores ou comandos CAN
+ * @brief Velocidades da roda permitidas a partir de wheel_speed
+ * @note Tensão no limite (ADCS_FAULT_SATURATED): não adianta pedir mais
+ *       velocidade no mesmo sentido
  */
-void ADCS_Process(UART_HandleTypeDef *huart)
+static void ADCS_WheelLimits(float wheel_speed, float *wheel_min, float *wheel_max)
 {
-    // Verifica se motor está inicializado
-    if (!adcs_state.motor_initialized) {
-        ADCS_Init(huart);
-        return;
+    *wheel_min = ADCS_MIN_SPEED;
+    *wheel_max = ADCS_MAX_SPEED;
+    
+    if (motor_faults & ADCS_FAULT_SATURATED) {
+        if (wheel_speed > 0.0f) *wheel_max = wheel_speed;
+        if (wheel_speed < 0.0f) *wheel_min = wheel_speed;
     }
+}
+
+/**
+ * @brief Uma iteração do controle: telemetria, sensores, PID e comando
+ * @note Chamada pela interrupção do TIM6 (ADCS_Control_Start) ou, sem a
+ *       malha, pelo ADCS_Process no loop principal
+ * @note Na interrupção: as leituras do BMI088 são SPI em polling (bloqueiam
+ *       até BMI_SPI_TIMEOUT_MS cada) e nada aqui pode chamar HAL_Delay. O
+ *       HAL_GetTick lido pelo Detumble_Gyro_*, pelo Sol e pelo timeout da
+ *       telemetria só anda porque o SysTick (prioridade 4) preempta o TIM6
+ *       (prioridade 6); com o SysTick abaixo do TIM6 ele congela ali dentro
+ */
+static void ADCS_ControlStep(UART_HandleTypeDef *huart)
+{
+    ADCS_PollTelemetry();
+    
+    // Lê sensores e propaga a atitude em qualquer modo
+    ADCS_ReadSensors(&sensors);
+    ADCS_UpdateAttitude();
+    ADCS_UpdateMomentum();
     
     // Verifica modo atual do CAN
     CDH_OperationMode_t mode = CAN_GetCurrentMode();
+    CDH_OperationMode_t previous_mode = last_mode;
+    last_mode = mode;
+    
+    // Auto-tune só vale no modo ADCS com a roda livre
+    if (mode != CDH_MODE_ADCS || (motor_faults & ADCS_FAULT_STALL)) {
+        ADCS_AutotuneApply(Autotune_Abort(&autotune));
+    }
     
     // Só processa se estiver em modo ADCS ou DETUMBLING
     if (mode != CDH_MODE_ADCS && mode != CDH_MODE_DETUMBLING) {
-        // Se não está em modo ADCS, para o motor
-        if (adcs_state.motor_active) {
+        // Saída da malha fechada: a roda desacelera em rampa, sem degrau
+        if ((previous_mode == CDH_MODE_ADCS || previous_mode == CDH_MODE_DETUMBLING) &&
+            adcs_state.motor_active) {
+            ADCS_RampStart(0.0f);
+        }
+        
+        if (ramp_active) {
+            ADCS_RampStep(huart);
+        } else if (adcs_state.motor_active) {
+            // Sem rampa pedida, fora do modo ADCS o motor fica parado
             ADCS_Stop(huart);
         }
+        // Motor parado: o travamento pode ser tentado de novo no próximo modo
+        motor_faults &= ~ADCS_FAULT_STALL;
+        stall_timing = 0;
         return;
     }
     
-    // Lê sensores
-    ADCS_ReadSensors(&sensors);
+    // A malha fechada assume a roda a partir da velocidade atual
+    ramp_active = 0;
+    
+    // Roda travada: mantém o motor desligado enquanto estiver no modo
+    if (motor_faults & ADCS_FAULT_STALL) {
+        if (adcs_state.motor_active) {
+            ADCS_Stop(huart);
+        }
+        return;
+    }
     
     // ===== MODO ADCS: Controle PID baseado em giroscópio =====
     if (mode == CDH_MODE_ADCS) {
-        // Define setpoint (velocidade angular desejada)
-        pid_controller.setpoint = 0.0f;  // 0 deg/s = estável
+        // A saída do PID é torque na roda: vira variação sobre a velocidade
+        // medida (sem telemetria recente, sobre o último comando)
+        float wheel_speed = ADCS_WheelSpeed();
         
-        // Calcula controle PID baseado no giroscópio Z
-        float pid_output = ADCS_PID_Compute(&pid_controller, sensors.gyro_z);
+        // Limites do atuador vistos pelo PID (back-calculation usa estes)
+        float wheel_min, wheel_max;
+        ADCS_WheelLimits(wheel_speed, &wheel_min, &wheel_max);
+        PID_F32_SetLimits(&pid_controller, (wheel_min - wheel_speed) / ADCS_PID_SPEED_SCALE,
+                          (wheel_max - wheel_speed) / ADCS_PID_SPEED_SCALE);
         
-        // Converte saída PID para velocidade do motor (-127 a +127)
-        int16_t motor_speed = (int16_t)(pid_output * 10.0f);  // Ajuste de escala
+        // Setpoint 0 rad/s = estável; giroscópio Z sem o bias estimado
+        float rate_z = sensors.gyro_z - ADCS_GyroBias()[2];
+        float relay_output;
+        ADCS_AutotuneApply(Autotune_Update(&autotune, 0.0f, rate_z, attitude_dt, &relay_output));
         
-        // Envia comando para motor
-        ADCS_SetSpeed(huart, motor_speed);
+        float pid_output;
+        if (autotune.phase == AUTOTUNE_RELAY) {
+            // Relé no lugar do PID, dentro dos mesmos limites do atuador
+            pid_output = fminf(fmaxf(relay_output, pid_controller.cfg.out_min),
+                               pid_controller.cfg.out_max);
+        } else {
+            pid_output = PID_F32_Update(&pid_controller, 0.0f, rate_z);
+        }
+        
+        // Envia comando para motor (dead zone em ADCS_SetSpeedFloat)
+        ADCS_SetSpeedFloat(huart, wheel_speed + pid_output * ADCS_PID_SPEED_SCALE);
     }
     
-    // ===== MODO DETUMBLING: Amortecimento de rotação =====
+    // ===== MODO DETUMBLING: Amortecimento de rotação (3 eixos, roda em Z) =====
     else if (mode == CDH_MODE_DETUMBLING) {
-        /*
+        // Entrada no modo: começa a contar o tempo até estabilizar
+        if (previous_mode != CDH_MODE_DETUMBLING) {
+            Detumble_Gyro_Start(&detumble, HAL_GetTick());
+            detumble_speed = ADCS_WheelSpeed();
+        }
+        
+        // Sem período medido (primeira leitura ou pausa longa) não integra
+        if (attitude_dt > 0.0f) {
+            const float *bias = ADCS_GyroBias();
+            const float rate[3] = {sensors.gyro_x - bias[0],
+                                   sensors.gyro_y - bias[1],
+                                   sensors.gyro_z - bias[2]};
+            float wheel_min, wheel_max;
+            ADCS_WheelLimits(detumble_speed, &wheel_min, &wheel_max);
+            
+            detumble_speed = Detumble_Gyro_Process(&detumble, rate, detumble_speed,
+                                                   wheel_min, wheel_max, attitude_dt,
+                                                   HAL_GetTick());
+            
+            // Estável: a roda mantém a velocidade (parar devolveria o momento ao corpo)
+            ADCS_SetSpeedFloat(huart, detumble_speed);
+        }
+    }
+}
 
-                    TO DO!
+/**
+ * @brief Processa rotina ADCS (chamada no loop principal)
+ * @note Implementa controle baseado em sensores ou comandos CAN. Com a
+ *       malha do TIM6 ligada só cuida da inicialização.
+ */
+void ADCS_Process(UART_HandleTypeDef *huart)
+{
+    // Verifica se motor está inicializado
+    if (!adcs_state.motor_initialized) {
+        ADCS_Init(huart);
+        return;
+    }
+    
+    if (control_running) {
+        return;
+    }
+    
+    ADCS_ControlStep(huart);
+}
 
-        */
-        // Lógica de detumbling: aplicar torque oposto à rotação
-        // Quanto maior a velocidade angular, maior o torque de frenagem
-        
-        float angular_velocity = sensors.gyro_z;
-        int16_t brake_speed = (int16_t)(-angular_velocity * 5.0f);  // Ganho negativo
-        
-        // Limita velocidade de frenagem
-        if (brake_speed > 50) brake_speed = 50;
-        if (brake_speed < -50) brake_speed = -50;
-        
-        ADCS_SetSpeed(huart, brake_speed);
-        
-        // Se velocidade angular está muito baixa, considera destumbling completo
-        if (fabs(angular_velocity) < 0.5f) {  // < 0.5 deg/s
-            ADCS_Stop(huart);
+/* ============================================================================
+   MALHA DE CONTROLE A TAXA FIXA (TIM6)
+   ============================================================================ */
+/**
+ * @brief Liga a malha de controle na interrupção do TIM6
+ * @param huart UART do SimpleFOC
+ * @param rate_hz ADCS_CONTROL_RATE_MIN a ADCS_CONTROL_RATE_MAX
+ * @return HAL_ERROR com taxa fora da faixa ou ADCS não inicializado
+ * @note O ADCS_Init usa HAL_Delay e não pode rodar na interrupção: chamar
+ *       depois dele. Daqui em diante só a malha comanda o motor.
+ * @note Exige TICK_INT_PRIORITY numericamente menor que a do TIM6_DAC (ver
+ *       ADCS_ControlStep): senão o tick para dentro da malha.
+ */
+HAL_StatusTypeDef ADCS_Control_Start(UART_HandleTypeDef *huart, uint32_t rate_hz)
+{
+    if (rate_hz < ADCS_CONTROL_RATE_MIN || rate_hz > ADCS_CONTROL_RATE_MAX ||
+        !adcs_state.motor_initialized) {
+        return HAL_ERROR;
+    }
+
+    ADCS_Control_Stop();
+
+    // TIM6 contando em 1 us; o período vale a partir do evento de update
+    __HAL_TIM_SET_PRESCALER(&htim6, TIM_GetAPB1TimerClock() / ADCS_CONTROL_TICK_HZ - 1);
+    __HAL_TIM_SET_AUTORELOAD(&htim6, ADCS_CONTROL_TICK_HZ / rate_hz - 1);
+    __HAL_TIM_SET_COUNTER(&htim6, 0);
+    htim6.Instance->EGR = TIM_EGR_UG;
+    __HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE);
+
+    PID_F32_SetSampleTime(&pid_controller, 1.0f / (float)rate_hz);
+    PID_F32_Reset(&pid_controller);
+
+    control_huart = huart;
+    control_period_cycles = SystemCoreClock / rate_hz;
+    ADCS_ResetTimingStats();
+    timing.rate_hz = rate_hz;
+    control_running = 1;
+
+    if (HAL_TIM_Base_Start_IT(&htim6) != HAL_OK) {
+        control_running = 0;
+        timing.rate_hz = 0;
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Desliga a malha (o ADCS_Process volta a controlar pelo loop)
+ */
+void ADCS_Control_Stop(void)
+{
+    HAL_TIM_Base_Stop_IT(&htim6);
+    control_running = 0;
+    timing.rate_hz = 0;
+}
+
+uint8_t ADCS_Control_IsRunning(void)
+{
+    return control_running;
+}
+
+/**
+ * @brief Iteração da malha com medida de jitter e tempo de execução
+ * @note Jitter = intervalo entre duas entradas - período nominal. A
+ *       primeira iteração só marca o instante de referência.
+ */
+static void ADCS_ControlTick(void)
+{
+    uint32_t start = DWT_GetCycles();
+
+    if (timing.ticks > 0) {
+        int32_t jitter = (int32_t)(start - control_last_cycles - control_period_cycles);
+        if (timing.ticks == 1 || jitter < timing.jitter_min_cycles) {
+            timing.jitter_min_cycles = jitter;
         }
+        if (timing.ticks == 1 || jitter > timing.jitter_max_cycles) {
+            timing.jitter_max_cycles = jitter;
+        }
+        jitter_sum += jitter;
+    }
+    control_last_cycles = start;
+
+    ADCS_ControlStep(control_huart);
+
+    uint32_t exec = DWT_GetCycles() - start;
+    if (timing.ticks == 0 || exec < timing.exec_min_cycles) {
+        timing.exec_min_cycles = exec;
+    }
+    if (exec > timing.exec_max_cycles) {
+        timing.exec_max_cycles = exec;
+    }
+    if (exec > control_period_cycles) {
+        timing.overruns++;
+    }
+    exec_sum += exec;
+    timing.ticks++;
+}
+
+/**
+ * @brief Copia as estatísticas de tempo da malha (médias calculadas aqui)
+ */
+void ADCS_GetTimingStats(ADCS_TimingStats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = timing;
+    int64_t jsum = jitter_sum;
+    uint64_t esum = exec_sum;
+    __set_PRIMASK(primask);
+
+    stats->jitter_mean_cycles = (stats->ticks > 1) ? (int32_t)(jsum / (int64_t)(stats->ticks - 1)) : 0;
+    stats->exec_mean_cycles = (stats->ticks > 0) ? (uint32_t)(esum / stats->ticks) : 0;
+}
+
+/**
+ * @brief Zera as estatísticas de tempo (mantém a taxa)
+ */
+void ADCS_ResetTimingStats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t rate_hz = timing.rate_hz;
+    memset(&timing, 0, sizeof(timing));
+    timing.rate_hz = rate_hz;
+    jitter_sum = 0;
+    exec_sum = 0;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Período do TIM6: uma iteração da malha
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM6 && control_running) {
+        ADCS_ControlTick();
     }
 }
 
@@ -310,7 +1420,7 @@ void ADCS_Process(UART_HandleTypeDef *huart)
    GETTERS
    ============================================================================ */
 /**
- * @brief Retorna velocidade atual do motor
+ * @brief Retorna velocidade atual do motor (medida; sem telemetria, o comando)
  */
 int16_t ADCS_GetCurrentSpeed(void)
 {
@@ -325,6 +1435,39 @@ int16_t ADCS_GetTargetSpeed(void)
     return adcs_state.target_speed;
 }
 
+/**
+ * @brief Copia o último estado medido do motor
+ */
+void ADCS_GetMotorState(ADCS_MotorState_t *state)
+{
+    *state = motor_state;
+}
+
+/**
+ * @brief Verifica se a última amostra de telemetria ainda vale para controle
+ */
+uint8_t ADCS_IsTelemetryFresh(void)
+{
+    return motor_state.valid &&
+           (HAL_GetTick() - motor_state.timestamp_ms) < ADCS_TELEMETRY_TIMEOUT_MS;
+}
+
+/**
+ * @brief Retorna as falhas do motor (ADCS_FAULT_*)
+ */
+uint8_t ADCS_GetMotorFaults(void)
+{
+    return motor_faults;
+}
+
+/**
+ * @brief Copia os contadores dos comandos de velocidade
+ */
+void ADCS_GetCommandStats(ADCS_CommandStats_t *stats)
+{
+    *stats = cmd_stats;
+}
+
 /**
  * @brief Retorna se motor está ativo
  */
@@ -7,15 +7,25 @@
 
 #include "can_driver.h"
 #include "main.h"
+#include "dwt.h"
 
 /* Private variables */
-static FDCAN_RxHeaderTypeDef RxHeader;
-static volatile uint8_t RxBuffer[8];  // ← volatile para evitar otimização
-static volatile uint8_t msg_received = 0;
+// Fila de recepção: a ISR escreve em rx_head, o loop lê em rx_tail
+static CAN_Message_t rx_queue[CAN_RX_QUEUE_SIZE];
+static uint32_t rx_cycles[CAN_RX_QUEUE_SIZE];   // DWT->CYCCNT na chegada
+static volatile uint8_t rx_head = 0;
+static volatile uint8_t rx_tail = 0;
+static volatile uint32_t rx_overruns = 0;
+static uint32_t last_rx_cycles = 0;
 
 /* CAN Initialization */
 void CAN_Init(void)
 {
+    DWT_Init();
+    rx_head = 0;
+    rx_tail = 0;
+    rx_overruns = 0;
+
     if (HAL_FDCAN_Start(&hfdcan1) != HAL_OK) {
         Error_Handler();
     }
@@ -45,47 +55,75 @@ void CAN_Transmit(CAN_Message_t *msg)
     }
 }
 
-/* Get received message - Always 8 bytes */
+/* TX FIFO com espaço livre (CAN_Transmit não bloqueia) */
+uint8_t CAN_TxReady(void)
+{
+    return HAL_FDCAN_GetTxFifoFreeLevel(&hfdcan1) > 0;
+}
+
+/* Get received message - Always 8 bytes (mais antiga da fila) */
 uint8_t CAN_GetMessage(CAN_Message_t *msg)
 {
-    if (!msg_received) {
+    uint8_t tail = rx_tail;
+
+    if (tail == rx_head) {
         return 0;
     }
     
-    // Desabilita interrupções durante cópia (proteção de seção crítica)
-    __disable_irq();
-    
-    // Copia o ID recebido
-    msg->id = RxHeader.Identifier;
-    
-    // Copia todos os 8 bytes
-    for (uint8_t i = 0; i < 8; i++) {
-        msg->data[i] = RxBuffer[i];
-    }
-    
-    // Limpa flag ANTES de retornar (importante!)
-    msg_received = 0;
+    // A ISR só escreve em rx_head: a entrada em rx_tail já está completa
+    *msg = rx_queue[tail];
+    last_rx_cycles = rx_cycles[tail];
     
-    __enable_irq();
+    // Libera a entrada só depois da cópia
+    rx_tail = (tail + 1) % CAN_RX_QUEUE_SIZE;
     
     return 1;
 }
 
+/* Instante de chegada (DWT) da última mensagem entregue por CAN_GetMessage */
+uint32_t CAN_GetLastRxCycles(void)
+{
+    return last_rx_cycles;
+}
+
+/* Mensagens perdidas com a fila cheia */
+uint32_t CAN_GetRxOverruns(void)
+{
+    return rx_overruns;
+}
+
 /* CAN RX Callback */
 void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef *hfdcan, uint32_t RxFifo0ITs)
 {
-    if ((RxFifo0ITs & FDCAN_IT_RX_FIFO0_NEW_MESSAGE) != RESET) {
-        // Lê mensagem diretamente para buffer temporário
-        uint8_t tempBuffer[8];
+    FDCAN_RxHeaderTypeDef RxHeader;
+    uint8_t tempBuffer[8];
+
+    if ((RxFifo0ITs & FDCAN_IT_RX_FIFO0_NEW_MESSAGE) == RESET) {
+        return;
+    }
+    
+    // Esvazia a FIFO de hardware: um comando não sobrescreve o anterior
+    while (HAL_FDCAN_GetRxFifoFillLevel(hfdcan, FDCAN_RX_FIFO0) > 0) {
+        uint32_t stamp = DWT_GetCycles();
         
-        if (HAL_FDCAN_GetRxMessage(hfdcan, FDCAN_RX_FIFO0, &RxHeader, tempBuffer) == HAL_OK) {
-            // Copia para buffer volátil
-            for (uint8_t i = 0; i < 8; i++) {
-                RxBuffer[i] = tempBuffer[i];
-            }
-            
-            // Seta flag por último
-            msg_received = 1;
+        if (HAL_FDCAN_GetRxMessage(hfdcan, FDCAN_RX_FIFO0, &RxHeader, tempBuffer) != HAL_OK) {
+            break;
         }
+        
+        uint8_t head = rx_head;
+        uint8_t next = (head + 1) % CAN_RX_QUEUE_SIZE;
+        if (next == rx_tail) {
+            rx_overruns++;  // Fila cheia: descarta a mais nova
+            continue;
+        }
+        
+        rx_queue[head].id = RxHeader.Identifier;
+        for (uint8_t i = 0; i < 8; i++) {
+            rx_queue[head].data[i] = tempBuffer[i];
+        }
+        rx_cycles[head] = stamp;
+        
+        // Publica por último
+        rx_head = next;
     }
 }
@@ -7,6 +7,11 @@
 
 #include "can_protocol.h"
 #include "can_driver.h"
+#include "uart_protocol.h"
+#include "payload_mission.h"
+#include "result_queue.h"
+#include "payload_bridge.h"
+#include "adcs.h"
 #include "main.h"
 #include <string.h>
 
@@ -22,6 +27,37 @@ static CDH_Status_t cdh_status = {
 static EPS_Telemetry_t eps_telemetry = {0};
 static AIS_Data_t ais_buffer = {0};
 
+// Envio da telemetria de enlace, um frame por vez (TX FIFO tem 1 elemento)
+static struct {
+    uint8_t active;
+    uint8_t port;
+    uint8_t reset_after;
+    uint8_t stat_index;
+    uint8_t kind;
+    uint8_t slot;
+    uint8_t bucket;
+} link_dump = {0};
+
+// Envio da latência da ponte CAN -> Payload
+static struct {
+    uint8_t active;
+    uint8_t reset_after;
+    uint8_t next;               // Próximo tipo (CAN_BRIDGE_STATS_*)
+} bridge_dump = {0};
+
+// Estado do detumbling: pedido pelo COM ou na estabilização
+static uint8_t detumble_requested = 0;
+static uint8_t detumble_reported = 0;   // Estabilização já avisada
+
+// Auto-tune do PID: resposta ao comando ou aviso do fim do experimento
+static uint8_t autotune_requested = 0;
+static uint8_t autotune_refused = 0;    // Último início recusado pelo ADCS
+static uint8_t autotune_reported = 0;   // Fim do experimento já avisado
+
+// Momento da roda: pedido pelo COM ou quando a dessaturação é pedida
+static uint8_t momentum_requested = 0;
+static uint8_t momentum_reported = 0;   // Pedido de dessaturação já avisado
+
 /* ============================================================================
    INICIALIZAÇÃO
    ============================================================================ */
@@ -46,7 +82,8 @@ void CAN_Protocol_ProcessMessages(void)
 {
     CAN_Message_t rx_msg;
     
-    if (CAN_GetMessage(&rx_msg)) {
+    // Esvazia a fila de recepção: comandos em rajada não esperam uma volta cada
+    while (CAN_GetMessage(&rx_msg)) {
         
         /* ========== COMANDOS DE MODO (COM) ========== */
         if (rx_msg.id == CAN_COM_MODE_IDLE) {
@@ -65,6 +102,28 @@ void CAN_Protocol_ProcessMessages(void)
             CAN_HandleModeCommand(CAN_COM_MODE_EXIT, rx_msg.data);
         }
         
+        /* ========== CONFIRMAÇÃO DE RESULTADO (COM) ========== */
+        else if (rx_msg.id == CAN_COM_RESULT_ACK) {
+            ResultQueue_HandleAck(((uint16_t)rx_msg.data[0] << 8) | rx_msg.data[1]);
+        }
+        
+        /* ========== TELEMETRIA DE ENLACE UART ========== */
+        else if (rx_msg.id == CAN_COM_LINK_STATS_REQ) {
+            CAN_HandleLinkStatsRequest(rx_msg.data);
+        }
+        else if (rx_msg.id == CAN_COM_BRIDGE_STATS_REQ) {
+            CAN_HandleBridgeStatsRequest(rx_msg.data);
+        }
+        else if (rx_msg.id == CAN_COM_DETUMBLE_REQ) {
+            detumble_requested = 1;
+        }
+        else if (rx_msg.id == CAN_COM_AUTOTUNE_CMD) {
+            CAN_HandleAutotuneCommand(rx_msg.data);
+        }
+        else if (rx_msg.id == CAN_COM_MOMENTUM_REQ) {
+            momentum_requested = 1;
+        }
+        
         /* ========== DADOS AIS (MISSÃO 2) ========== */
         else if (rx_msg.id == CAN_COM_AIS_DATA) {
             CAN_HandleAISData(rx_msg.data);
@@ -76,6 +135,14 @@ void CAN_Protocol_ProcessMessages(void)
         }
         
     }
+    
+    // Downlink dos resultados de missão e telemetria de enlace em andamento
+    ResultQueue_Poll();
+    CAN_Protocol_SendLinkStats();
+    CAN_Protocol_SendBridgeStats();
+    CAN_Protocol_SendDetumbleStatus();
+    CAN_Protocol_SendAutotuneStatus();
+    CAN_Protocol_SendMomentumStatus();
 }
 
 /* ============================================================================
@@ -105,6 +172,10 @@ void CAN_HandleModeCommand(uint32_t mode_id, uint8_t *data)
                 if (data[0] == 2) {
                     // Copia primeiros dados AIS que vieram junto
                     memcpy(ais_buffer.data, &data[1], 7);  // 7 bytes de AIS (data[1] a data[7])
+                    ais_buffer.data[7] = 0;
+                    
+                    // Vai na fila do Payload: segue logo atrás do comando da missão
+                    UART_SendAISData(ais_buffer.data);
                 }
             } else {
                 // Missão inválida
@@ -138,6 +209,9 @@ void CAN_HandleModeCommand(uint32_t mode_id, uint8_t *data)
     
     if (success) {
         cdh_status.current_mode = new_mode;
+        
+        // Comando de missão vai ao Payload já aqui, antes do status ao COM
+        PayloadBridge_HandleCommand(mode_id, data);
     }
     
     // Envia status atualizado
@@ -149,11 +223,332 @@ void CAN_HandleModeCommand(uint32_t mode_id, uint8_t *data)
    ============================================================================ */
 void CAN_HandleAISData(uint8_t *data)
 {
-    // Só processa se estiver em Missão 2
-    if (cdh_status.mission_type != MISSION_2) {
-    	memcpy(ais_buffer.data, data, 8);
+    memcpy(ais_buffer.data, data, 8);
+    
+    // Só repassa ao Payload em Missão 2 (vai em lotes, ver UART_SendAISData)
+    if (cdh_status.mission_type == MISSION_2) {
+        UART_SendAISData(data);
+    }
+}
+
+/* ============================================================================
+   TELEMETRIA DE ENLACE UART
+   ============================================================================ */
+/**
+ * @brief Inicia o envio dos contadores e histogramas de uma porta UART
+ * @param data [0] = índice da porta, [1] = 1 para zerar os contadores ao final
+ */
+void CAN_HandleLinkStatsRequest(uint8_t *data)
+{
+    if (UART_Protocol_GetPort(data[0]) == NULL) {
+        return;  // Porta inexistente
+    }
+    
+    memset(&link_dump, 0, sizeof(link_dump));
+    link_dump.port = data[0];
+    link_dump.reset_after = (data[1] == 1);
+    link_dump.active = 1;
+}
+
+/**
+ * @brief Monta o próximo frame da telemetria de enlace
+ * @return 0 quando não há mais frames (o marcador de fim já foi montado antes)
+ */
+static uint8_t CAN_NextLinkStatsFrame(UART_Protocol_t *proto, CAN_Message_t *msg)
+{
+    memset(msg->data, 0, sizeof(msg->data));
+    msg->data[0] = link_dump.port;
+    
+    // Primeiro os contadores, um por frame
+    if (link_dump.stat_index < UART_STAT_COUNT) {
+        uint32_t value = UART_Protocol_GetStat(proto, (UART_StatIndex_t)link_dump.stat_index);
+        
+        msg->id = CAN_CDH_LINK_STATS;
+        msg->data[1] = link_dump.stat_index++;
+        msg->data[2] = (value >> 24) & 0xFF;
+        msg->data[3] = (value >> 16) & 0xFF;
+        msg->data[4] = (value >> 8) & 0xFF;
+        msg->data[5] = value & 0xFF;
+        msg->data[6] = UART_STAT_COUNT;
+        return 1;
+    }
+    
+    // Depois os buckets não vazios dos histogramas
+    const UART_ProtocolStats_t *stats = UART_Protocol_GetStats(proto);
+    msg->id = CAN_CDH_LINK_RTT;
+    
+    while (link_dump.kind < UART_RTT_KINDS) {
+        const UART_RttHistogram_t *hist = &stats->rtt[link_dump.kind][link_dump.slot];
+        uint8_t kind = link_dump.kind;
+        uint8_t bucket = link_dump.bucket;
+        
+        if (hist->in_use && ++link_dump.bucket < UART_STATS_RTT_BUCKETS) {
+            // Continua no mesmo histograma
+        } else {
+            link_dump.bucket = 0;
+            if (++link_dump.slot >= UART_STATS_RTT_IDS) {
+                link_dump.slot = 0;
+                link_dump.kind++;
+            }
+        }
+        
+        if (hist->in_use && hist->buckets[bucket] != 0) {
+            msg->data[1] = kind;
+            msg->data[2] = hist->msg_id;
+            msg->data[3] = bucket;
+            msg->data[4] = (hist->buckets[bucket] >> 8) & 0xFF;
+            msg->data[5] = hist->buckets[bucket] & 0xFF;
+            return 1;
+        }
+    }
+    
+    // Marcador de fim
+    if (link_dump.kind == UART_RTT_KINDS) {
+        link_dump.kind++;
+        msg->data[1] = CAN_LINK_RTT_END;
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Envia a telemetria de enlace pendente enquanto houver espaço no TX FIFO
+ * @note Não bloqueia; chamada a cada CAN_Protocol_ProcessMessages
+ */
+void CAN_Protocol_SendLinkStats(void)
+{
+    CAN_Message_t msg;
+    
+    while (link_dump.active && CAN_TxReady()) {
+        UART_Protocol_t *proto = UART_Protocol_GetPort(link_dump.port);
+        
+        if (proto == NULL || !CAN_NextLinkStatsFrame(proto, &msg)) {
+            if (proto != NULL && link_dump.reset_after) {
+                UART_Protocol_ResetStats(proto);
+            }
+            link_dump.active = 0;
+            break;
+        }
+        
+        CAN_Transmit(&msg);
+    }
+}
+
+/* ============================================================================
+   LATÊNCIA DA PONTE CAN -> PAYLOAD
+   ============================================================================ */
+/**
+ * @brief Inicia o envio da latência da ponte
+ * @param data [0] = 1 para zerar as estatísticas ao final
+ */
+void CAN_HandleBridgeStatsRequest(uint8_t *data)
+{
+    bridge_dump.active = 1;
+    bridge_dump.reset_after = (data[0] == 1);
+    bridge_dump.next = CAN_BRIDGE_STATS_DISPATCH;
+}
+
+static void CAN_PutU16Sat(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF) {
+        value = 0xFFFF;
+    }
+    dst[0] = (value >> 8) & 0xFF;
+    dst[1] = value & 0xFF;
+}
+
+/**
+ * @brief Envia os frames da ponte enquanto houver espaço no TX FIFO
+ */
+void CAN_Protocol_SendBridgeStats(void)
+{
+    CAN_Message_t msg;
+    const PayloadBridge_Stats_t *stats = PayloadBridge_GetStats();
+    
+    while (bridge_dump.active && CAN_TxReady()) {
+        const PayloadBridge_Latency_t *latency = NULL;
+        
+        memset(msg.data, 0, sizeof(msg.data));
+        msg.id = CAN_CDH_BRIDGE_STATS;
+        msg.data[0] = bridge_dump.next;
+        
+        switch (bridge_dump.next) {
+            case CAN_BRIDGE_STATS_DISPATCH:
+                latency = &stats->dispatch;
+                break;
+            case CAN_BRIDGE_STATS_WIRE:
+                latency = &stats->wire;
+                break;
+            default:
+                CAN_PutU16Sat(&msg.data[1], stats->commands);
+                CAN_PutU16Sat(&msg.data[3], stats->forwarded);
+                CAN_PutU16Sat(&msg.data[5], stats->deferred);
+                break;
+        }
+        
+        if (latency != NULL) {
+            CAN_PutU16Sat(&msg.data[1], latency->min_us);
+            CAN_PutU16Sat(&msg.data[3], PayloadBridge_GetAverageUs(latency));
+            CAN_PutU16Sat(&msg.data[5], latency->max_us);
+        }
+        
+        CAN_Transmit(&msg);
+        
+        if (++bridge_dump.next > CAN_BRIDGE_STATS_COUNTERS) {
+            if (bridge_dump.reset_after) {
+                PayloadBridge_ResetStats();
+            }
+            bridge_dump.active = 0;
+        }
+    }
+}
+
+/* ============================================================================
+   PROGRESSO DO DETUMBLING
+   ============================================================================ */
+/**
+ * @brief Envia o estado do detumbling quando pedido ou ao estabilizar
+ */
+void CAN_Protocol_SendDetumbleStatus(void)
+{
+    Detumble_Gyro_t detumble;
+    CAN_Message_t msg;
+    
+    ADCS_GetDetumbleStatus(&detumble);
+    
+    uint8_t active = (cdh_status.current_mode == CDH_MODE_DETUMBLING);
+    uint8_t newly_converged = active && detumble.converged && !detumble_reported;
+    if (!active) {
+        detumble_reported = 0;
+    }
+    
+    if ((!detumble_requested && !newly_converged) || !CAN_TxReady()) {
         return;
     }
+    
+    uint32_t time_ms = detumble.converged ? detumble.converge_ms
+                                          : (HAL_GetTick() - detumble.start_ms);
+    
+    memset(msg.data, 0, sizeof(msg.data));
+    msg.id = CAN_CDH_DETUMBLE_STATUS;
+    msg.data[0] = (active ? CAN_DETUMBLE_ACTIVE : 0) |
+                  (detumble.converged ? CAN_DETUMBLE_CONVERGED : 0) |
+                  (detumble.momentum_limited ? CAN_DETUMBLE_MOMENTUM_LIMIT : 0);
+    msg.data[1] = (time_ms >> 24) & 0xFF;
+    msg.data[2] = (time_ms >> 16) & 0xFF;
+    msg.data[3] = (time_ms >> 8) & 0xFF;
+    msg.data[4] = time_ms & 0xFF;
+    CAN_PutU16Sat(&msg.data[5], (uint32_t)(detumble.rate_norm * 1000.0f));
+    msg.data[7] = (detumble.gain * 100.0f > 255.0f) ? 255 : (uint8_t)(detumble.gain * 100.0f);
+    
+    CAN_Transmit(&msg);
+    
+    detumble_requested = 0;
+    if (newly_converged) {
+        detumble_reported = 1;
+    }
+}
+
+/* ============================================================================
+   AUTO-TUNE DO PID DE ATITUDE
+   ============================================================================ */
+/**
+ * @brief Inicia ou aborta o auto-tune; sempre responde com o estado
+ * @param data [0] = CAN_AUTOTUNE_CMD_*
+ */
+void CAN_HandleAutotuneCommand(uint8_t *data)
+{
+    if (data[0] == CAN_AUTOTUNE_CMD_START) {
+        autotune_refused = (ADCS_Autotune_Start() != HAL_OK);
+    } else if (data[0] == CAN_AUTOTUNE_CMD_ABORT) {
+        ADCS_Autotune_Abort();
+    }
+    autotune_requested = 1;
+}
+
+/**
+ * @brief Envia o estado do auto-tune quando pedido ou ao terminar
+ */
+void CAN_Protocol_SendAutotuneStatus(void)
+{
+    Autotune_t autotune;
+    CAN_Message_t msg;
+    
+    ADCS_GetAutotuneStatus(&autotune);
+    
+    uint8_t finished = !Autotune_IsRunning(&autotune) && autotune.phase != AUTOTUNE_IDLE;
+    if (!finished) {
+        autotune_reported = 0;
+    }
+    
+    if ((!autotune_requested && (!finished || autotune_reported)) || !CAN_TxReady()) {
+        return;
+    }
+    
+    memset(msg.data, 0, sizeof(msg.data));
+    msg.id = CAN_CDH_AUTOTUNE_STATUS;
+    msg.data[0] = (uint8_t)autotune.phase;
+    CAN_PutU16Sat(&msg.data[1], (uint32_t)(autotune.ku * 100.0f));
+    CAN_PutU16Sat(&msg.data[3], (uint32_t)(autotune.tu * 1000.0f));
+    msg.data[5] = (autotune.rms_baseline * 1000.0f > 255.0f) ? 255
+                                                             : (uint8_t)(autotune.rms_baseline * 1000.0f);
+    msg.data[6] = (autotune.rms_verify * 1000.0f > 255.0f) ? 255
+                                                           : (uint8_t)(autotune.rms_verify * 1000.0f);
+    msg.data[7] = autotune_refused;
+    
+    CAN_Transmit(&msg);
+    
+    autotune_requested = 0;
+    if (finished) {
+        autotune_reported = 1;
+    }
+}
+
+/* ============================================================================
+   MOMENTO DA RODA
+   ============================================================================ */
+static void CAN_PutS16Sat(uint8_t *dst, float value)
+{
+    int32_t v = (value > 32767.0f) ? 32767 : ((value < -32768.0f) ? -32768 : (int32_t)value);
+    dst[0] = ((uint16_t)v >> 8) & 0xFF;
+    dst[1] = (uint16_t)v & 0xFF;
+}
+
+/**
+ * @brief Envia o momento da roda quando pedido ou quando a dessaturação acende
+ */
+void CAN_Protocol_SendMomentumStatus(void)
+{
+    ADCS_Momentum_t m;
+    CAN_Message_t msg;
+    
+    ADCS_GetMomentum(&m);
+    
+    uint8_t newly_saturated = m.desat_needed && !momentum_reported;
+    if (!m.desat_needed) {
+        momentum_reported = 0;
+    }
+    
+    if ((!momentum_requested && !newly_saturated) || !CAN_TxReady()) {
+        return;
+    }
+    
+    memset(msg.data, 0, sizeof(msg.data));
+    msg.id = CAN_CDH_MOMENTUM_STATUS;
+    msg.data[0] = (m.desat_needed ? CAN_MOMENTUM_DESAT : 0) |
+                  (ADCS_IsRampDone() ? 0 : CAN_MOMENTUM_RAMP);
+    CAN_PutS16Sat(&msg.data[1], m.wheel_speed * 100.0f);
+    CAN_PutS16Sat(&msg.data[3], m.momentum * 1e6f);
+    msg.data[5] = (m.fraction * 100.0f > 255.0f) ? 255 : (uint8_t)(m.fraction * 100.0f);
+    CAN_PutU16Sat(&msg.data[6], m.desat_events);
+    
+    CAN_Transmit(&msg);
+    
+    momentum_requested = 0;
+    if (newly_saturated) {
+        momentum_reported = 1;
+    }
 }
 
 /* ============================================================================
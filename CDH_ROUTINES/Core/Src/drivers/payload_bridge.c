@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    payload_bridge.c
+  * @brief   Ponte de comandos CAN -> Payload e medição de latência
+  ******************************************************************************
+  */
+
+#include "payload_bridge.h"
+#include "payload_mission.h"
+#include "can_driver.h"
+#include "dwt.h"
+#include <string.h>
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+static PayloadBridge_Stats_t stats;
+
+// Comando aguardando o fim do envio (medida "wire")
+static uint8_t wire_pending = 0;
+static uint32_t wire_rx_cycles = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Bridge_Record(PayloadBridge_Latency_t *latency, uint32_t cycles)
+{
+    uint32_t us = DWT_CyclesToUs(cycles);
+
+    if (latency->count == 0 || us < latency->min_us) {
+        latency->min_us = us;
+    }
+    if (us > latency->max_us) {
+        latency->max_us = us;
+    }
+    latency->last_us = us;
+    latency->total_us += us;
+    latency->count++;
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Zera as estatísticas (os templates ficam em payload_mission.c)
+ */
+void PayloadBridge_Init(void)
+{
+    DWT_Init();
+    PayloadBridge_ResetStats();
+}
+
+/**
+ * @brief Chamado pelo despacho do CAN depois de o estado do CDH ser atualizado
+ * @param can_id ID do comando recebido
+ * @param data Dados do comando (8 bytes)
+ * @note Só CAN_COM_MODE_NOMINAL com missão 1 ou 2 vira frame aqui; o
+ *       restante do pipeline (segunda execução, retentativas) continua com
+ *       UART_ProcessMission no loop. Deve rodar no contexto do loop, como
+ *       CAN_Protocol_ProcessMessages (o enlace UART não é reentrante).
+ */
+void PayloadBridge_HandleCommand(uint32_t can_id, const uint8_t *data)
+{
+    if (can_id != CAN_COM_MODE_NOMINAL || (data[0] != MISSION_1 && data[0] != MISSION_2)) {
+        return;
+    }
+
+    uint32_t rx_cycles = CAN_GetLastRxCycles();
+    stats.commands++;
+
+    if (UART_DispatchMission((MissionType_t)data[0]) != HAL_OK) {
+        stats.deferred++;
+        return;
+    }
+
+    stats.forwarded++;
+    Bridge_Record(&stats.dispatch, DWT_GetCycles() - rx_cycles);
+
+    UART_Protocol_t *proto = Payload_GetLink();
+    if (proto->tx.huart == NULL) {
+        // Sem DMA de TX o envio foi bloqueante: o frame já saiu
+        Bridge_Record(&stats.wire, DWT_GetCycles() - rx_cycles);
+        return;
+    }
+
+    UART_DMA_WatchTx(&proto->tx);
+    wire_rx_cycles = rx_cycles;
+    wire_pending = 1;
+}
+
+/**
+ * @brief Coleta a medida "wire" quando o DMA termina o frame do comando
+ * @note Chamada pelo hook de polling da porta do Payload
+ */
+void PayloadBridge_Poll(void)
+{
+    uint32_t done_cycles;
+
+    if (wire_pending && UART_DMA_WatchDone(&Payload_GetLink()->tx, &done_cycles)) {
+        Bridge_Record(&stats.wire, done_cycles - wire_rx_cycles);
+        wire_pending = 0;
+    }
+}
+
+/* ============================================================================
+   GETTERS
+   ============================================================================ */
+const PayloadBridge_Stats_t *PayloadBridge_GetStats(void)
+{
+    return &stats;
+}
+
+uint32_t PayloadBridge_GetAverageUs(const PayloadBridge_Latency_t *latency)
+{
+    return (latency->count > 0) ? latency->total_us / latency->count : 0;
+}
+
+void PayloadBridge_ResetStats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    wire_pending = 0;
+}
@@ -0,0 +1,471 @@
+/**
+  ******************************************************************************
+  * @file    payload_mission.c
+  * @brief   Missões do Payload: comandos, resultados e encaminhamento ao COM
+  ******************************************************************************
+  */
+
+#include "payload_mission.h"
+#include "uart_bulk.h"
+#include "result_queue.h"
+#include "payload_bridge.h"
+#include "can_protocol.h"  // Para acessar missão atual
+#include "main.h"
+#include <string.h>
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+// Porta do Payload (o DMA de recepção escreve dentro do contexto)
+static UART_Protocol_t payload_link;
+
+// Armazenamento dos resultados das missões
+typedef struct {
+    uint8_t oil_detected;        // Missão 1: Há derramamento? (0=não, 1=sim)
+    float oil_area_percentage;   // Missão 1: Área do óleo (%)
+    uint32_t ship_mmsi;          // Missão 2: ID do barco (MMSI)
+    float ship_origin_lat;       // Missão 2: Latitude origem
+    float ship_origin_lon;       // Missão 2: Longitude origem
+    uint8_t mission_complete;    // Flag indicando que missão terminou
+} MissionResults_t;
+
+static MissionResults_t mission_results = {0};
+
+// Pipeline de missões (UART_ProcessMission)
+static uint8_t missions_in_flight = 0;  // Requisições de missão sem resposta
+static uint32_t missions_completed = 0;
+static uint32_t missions_failed = 0;
+
+// Comandos de missão pré-montados (sem dados: só o SEQ muda a cada envio)
+static UART_FrameTemplate_t start_m1_template;
+static UART_FrameTemplate_t start_m2_template;
+
+// Registros AIS aguardando o próximo lote (fila circular)
+static uint8_t ais_queue[UART_AIS_QUEUE_SIZE][UART_AIS_RECORD_SIZE];
+static uint16_t ais_head = 0;           // Registro mais antigo
+static uint16_t ais_count = 0;
+static uint32_t ais_oldest_tick = 0;    // Chegada do registro mais antigo
+static uint8_t ais_flush_requested = 0;
+
+/* ============================================================================
+   HANDLERS DE MENSAGENS DO PAYLOAD
+   ============================================================================ */
+/**
+ * @brief Resposta da Missão 1: Detecção de óleo
+ *        Formato: [oil_detected(1)] [area_percentage(4 bytes float)]
+ */
+static void Payload_HandleOilResult(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    if (msg->length < 5) {
+        return;
+    }
+
+    mission_results.oil_detected = msg->data[0];
+    
+    // Extrai float (4 bytes, little-endian)
+    uint32_t temp;
+    memcpy(&temp, &msg->data[1], 4);
+    memcpy(&mission_results.oil_area_percentage, &temp, 4);
+    
+    mission_results.mission_complete = 1;
+}
+
+/**
+ * @brief Resposta da Missão 2: Identificação do barco
+ *        Formato: [mmsi(4)] [lat(4 float)] [lon(4 float)]
+ */
+static void Payload_HandleShipResult(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    if (msg->length < 12) {
+        return;
+    }
+
+    // MMSI (4 bytes)
+    mission_results.ship_mmsi = ((uint32_t)msg->data[0] << 24) |
+                                ((uint32_t)msg->data[1] << 16) |
+                                ((uint32_t)msg->data[2] << 8)  |
+                                 (uint32_t)msg->data[3];
+    
+    // Latitude (4 bytes float)
+    uint32_t temp_lat;
+    memcpy(&temp_lat, &msg->data[4], 4);
+    memcpy(&mission_results.ship_origin_lat, &temp_lat, 4);
+    
+    // Longitude (4 bytes float)
+    uint32_t temp_lon;
+    memcpy(&temp_lon, &msg->data[8], 4);
+    memcpy(&mission_results.ship_origin_lon, &temp_lon, 4);
+    
+    mission_results.mission_complete = 1;
+}
+
+/**
+ * @brief Imagem/objeto grande: gravado direto no destino do uart_bulk
+ */
+static void Payload_HandleBulk(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    UART_Bulk_HandleMessage(msg);
+}
+
+/**
+ * @brief Payload reportou erro (a requisição pendente é concluída pelo motor)
+ */
+static void Payload_HandleError(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    mission_results.mission_complete = 0;
+}
+
+static void Payload_PollAIS(void);
+
+/**
+ * @brief Chamado a cada passada do motor do protocolo
+ */
+static void Payload_Poll(UART_Protocol_t *proto)
+{
+    UART_Bulk_Poll();
+    Payload_PollAIS();
+    PayloadBridge_Poll();
+}
+
+static const UART_Handler_t payload_handlers[] = {
+    { MSG_RES_M1_OIL,  Payload_HandleOilResult  },
+    { MSG_RES_M2_SHIP, Payload_HandleShipResult },
+    { MSG_BULK_OFFER,  Payload_HandleBulk       },
+    { MSG_BULK_CHUNK,  Payload_HandleBulk       },
+    { MSG_ERROR,       Payload_HandleError      },
+};
+
+static const UART_ProtocolConfig_t payload_config = {
+    .handlers = payload_handlers,
+    .handler_count = sizeof(payload_handlers) / sizeof(payload_handlers[0]),
+    .poll = Payload_Poll
+};
+
+/* ============================================================================
+   INICIALIZAÇÃO
+   ============================================================================ */
+/**
+ * @brief Inicializa a porta do Payload e a recepção de objetos
+ * @param huart Handle da UART do Payload
+ */
+HAL_StatusTypeDef Payload_Init(UART_HandleTypeDef *huart)
+{
+    missions_in_flight = 0;
+    missions_completed = 0;
+    missions_failed = 0;
+    ais_head = 0;
+    ais_count = 0;
+    ais_flush_requested = 0;
+
+    UART_Template_Init(&start_m1_template, MSG_CMD_START_M1, NULL, 0);
+    UART_Template_Init(&start_m2_template, MSG_CMD_START_M2, NULL, 0);
+    PayloadBridge_Init();
+
+    HAL_StatusTypeDef status = UART_Protocol_Init(&payload_link, huart, &payload_config);
+    UART_Bulk_Init(&payload_link, UART_BULK_DEFAULT_SINK);
+    ResultQueue_Init();
+
+    return status;
+}
+
+/**
+ * @brief Retorna o contexto da porta do Payload
+ */
+UART_Protocol_t *Payload_GetLink(void)
+{
+    return &payload_link;
+}
+
+/* ============================================================================
+   INTEGRAÇÃO COM CAN PROTOCOL
+   ============================================================================ */
+/**
+ * @brief Coloca o resultado do Payload na fila de downlink para o COM
+ * @param msg Mensagem MSG_RES_M1_OIL ou MSG_RES_M2_SHIP (o motor do
+ *            protocolo mantém a posse do buffer)
+ * @note O envio ao CAN, a confirmação do COM e o descarte de resultados
+ *       repetidos ficam em result_queue.c
+ */
+static void Payload_QueueResult(const UART_Message_t *msg)
+{
+    if (msg->id == MSG_RES_M1_OIL && msg->length >= 5) {
+        // [oil_detected(1)] [area_percentage(4 bytes float)]
+        ResultQueue_Push(MISSION_1, msg->data, 5);
+    }
+    else if (msg->id == MSG_RES_M2_SHIP && msg->length >= 12) {
+        // [mmsi(4)] [lat(4 float)] [lon(4 float)]
+        ResultQueue_Push(MISSION_2, msg->data, 12);
+    }
+}
+
+/**
+ * @brief Callback das requisições de missão: encaminha o resultado ao COM
+ *        e abre espaço no pipeline para a próxima execução
+ */
+static void Payload_OnMissionResponse(UART_RequestStatus_t status,
+                                      const UART_Message_t *response, void *context)
+{
+    if (status == UART_REQ_OK) {
+        Payload_QueueResult(response);
+        mission_results.mission_complete = 0;  // Reseta flag
+        missions_completed++;
+    } else {
+        missions_failed++;
+    }
+
+    // Timeout/erro: a missão é reenviada na próxima volta se o CAN ainda pedir
+    if (missions_in_flight > 0) {
+        missions_in_flight--;
+    }
+}
+
+/* ============================================================================
+   FUNÇÕES DE CONTROLE DE MISSÃO
+   ============================================================================ */
+/**
+ * @brief Inicia Missão 1 enviando comando ao Payload
+ * @return HAL_OK se o comando entrou na janela de transmissão
+ * @note O resultado chega por Payload_OnMissionResponse (não bloqueia)
+ */
+HAL_StatusTypeDef UART_StartMission1(void)
+{
+    HAL_StatusTypeDef status = UART_SendRequestTemplate(&payload_link, &start_m1_template,
+                                                        MSG_RES_M1_OIL, UART_MISSION_TIMEOUT_MS,
+                                                        Payload_OnMissionResponse, NULL);
+    if (status != HAL_OK) {
+        return status;
+    }
+    
+    // Reseta resultados
+    mission_results.mission_complete = 0;
+    mission_results.oil_detected = 0;
+    mission_results.oil_area_percentage = 0.0f;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Inicia Missão 2 enviando comando ao Payload
+ * @return HAL_OK se o comando entrou na janela de transmissão
+ * @note O resultado chega por Payload_OnMissionResponse (não bloqueia).
+ *       Os registros AIS já enfileirados seguem logo atrás do comando, em
+ *       lotes, enquanto o Payload inicializa e processa.
+ */
+HAL_StatusTypeDef UART_StartMission2(void)
+{
+    HAL_StatusTypeDef status = UART_SendRequestTemplate(&payload_link, &start_m2_template,
+                                                        MSG_RES_M2_SHIP, UART_MISSION_TIMEOUT_MS,
+                                                        Payload_OnMissionResponse, NULL);
+    if (status != HAL_OK) {
+        return status;
+    }
+    
+    // Reseta resultados
+    mission_results.mission_complete = 0;
+    mission_results.ship_mmsi = 0;
+    mission_results.ship_origin_lat = 0.0f;
+    mission_results.ship_origin_lon = 0.0f;
+
+    UART_FlushAIS();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Enfileira um registro AIS para o Payload (Missão 2)
+ * @param ais_data Ponteiro para dados AIS (8 bytes)
+ * @return HAL_BUSY se a fila estiver cheia
+ * @note Os registros seguem em lotes MSG_DATA_AIS_BATCH de até
+ *       UART_AIS_BATCH_MAX registros, quando o lote enche ou
+ *       UART_AIS_FLUSH_MS após o registro mais antigo
+ */
+HAL_StatusTypeDef UART_SendAISData(uint8_t *ais_data)
+{
+    if (ais_count >= UART_AIS_QUEUE_SIZE) {
+        return HAL_BUSY;
+    }
+
+    if (ais_count == 0) {
+        ais_oldest_tick = HAL_GetTick();
+    }
+
+    uint16_t tail = (ais_head + ais_count) % UART_AIS_QUEUE_SIZE;
+    memcpy(ais_queue[tail], ais_data, UART_AIS_RECORD_SIZE);
+    ais_count++;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Envia os registros AIS pendentes sem esperar o lote encher
+ */
+void UART_FlushAIS(void)
+{
+    ais_flush_requested = (ais_count > 0);
+}
+
+/**
+ * @brief Quantidade de registros AIS ainda não enviados
+ */
+uint16_t UART_GetAISQueued(void)
+{
+    return ais_count;
+}
+
+/**
+ * @brief Monta e envia lotes AIS enquanto houver motivo e espaço na janela
+ */
+static void Payload_PollAIS(void)
+{
+    static uint8_t batch[1 + UART_AIS_BATCH_MAX * UART_AIS_RECORD_SIZE];
+
+    while (ais_count > 0) {
+        uint8_t full = (ais_count >= UART_AIS_BATCH_MAX);
+        uint8_t expired = (HAL_GetTick() - ais_oldest_tick) >= UART_AIS_FLUSH_MS;
+
+        if (!full && !expired && !ais_flush_requested) {
+            return;
+        }
+
+        uint8_t n = full ? UART_AIS_BATCH_MAX : (uint8_t)ais_count;
+        batch[0] = n;
+        for (uint8_t i = 0; i < n; i++) {
+            memcpy(&batch[1 + i * UART_AIS_RECORD_SIZE],
+                   ais_queue[(ais_head + i) % UART_AIS_QUEUE_SIZE], UART_AIS_RECORD_SIZE);
+        }
+
+        // Janela cheia: os registros ficam na fila e o lote é refeito depois
+        if (UART_Link_Send(&payload_link, MSG_DATA_AIS_BATCH, batch,
+                           1 + n * UART_AIS_RECORD_SIZE) != HAL_OK) {
+            return;
+        }
+
+        ais_head = (ais_head + n) % UART_AIS_QUEUE_SIZE;
+        ais_count -= n;
+        ais_oldest_tick = HAL_GetTick();    // O restante passa a contar a partir daqui
+    }
+
+    ais_flush_requested = 0;
+}
+
+/**
+ * @brief Coloca mais uma execução da missão no pipeline, se houver espaço
+ * @return HAL_BUSY com o pipeline, a tabela de requisições ou a janela
+ *         cheios; HAL_ERROR se mission não for uma missão
+ * @note Usada pelo loop (UART_ProcessMission) e direto pelo despacho do
+ *       comando CAN (payload_bridge.c)
+ */
+HAL_StatusTypeDef UART_DispatchMission(MissionType_t mission)
+{
+    HAL_StatusTypeDef status;
+
+    if (missions_in_flight >= UART_MISSION_PIPELINE_DEPTH) {
+        return HAL_BUSY;
+    }
+
+    switch (mission) {
+        case MISSION_1:
+            status = UART_StartMission1();
+            break;
+
+        case MISSION_2:
+            status = UART_StartMission2();
+            break;
+
+        default:
+            return HAL_ERROR;
+    }
+
+    if (status == HAL_OK) {
+        missions_in_flight++;
+    }
+    return status;
+}
+
+/**
+ * @brief Processa missão baseado no estado do CAN
+ *        Deve ser chamada no loop principal (junto com UART_Protocol_Process)
+ * @note Não bloqueia. Mantém até UART_MISSION_PIPELINE_DEPTH requisições em
+ *       voo: a próxima execução já está na fila do Payload quando o
+ *       resultado da atual chega, e os lotes AIS trafegam em paralelo ao
+ *       processamento. Os resultados são entregues em ordem (a requisição
+ *       mais antiga é concluída primeiro).
+ */
+void UART_ProcessMission(void)
+{
+    MissionType_t mission = CAN_GetMissionType();
+
+    // Sem missão, as requisições em andamento terminam sozinhas (resposta
+    // ou timeout); pipeline, tabela ou janela cheios: tenta na próxima volta
+    while (UART_DispatchMission(mission) == HAL_OK) {
+    }
+}
+
+/**
+ * @brief Contadores do pipeline de missões
+ */
+uint8_t UART_GetMissionsInFlight(void)
+{
+    return missions_in_flight;
+}
+
+uint32_t UART_GetMissionsCompleted(void)
+{
+    return missions_completed;
+}
+
+uint32_t UART_GetMissionsFailed(void)
+{
+    return missions_failed;
+}
+
+/* ============================================================================
+   GETTERS PARA RESULTADOS DAS MISSÕES
+   ============================================================================ */
+/**
+ * @brief Retorna se há óleo detectado (Missão 1)
+ */
+uint8_t UART_GetOilDetected(void)
+{
+    return mission_results.oil_detected;
+}
+
+/**
+ * @brief Retorna percentual de área de óleo (Missão 1)
+ */
+float UART_GetOilAreaPercentage(void)
+{
+    return mission_results.oil_area_percentage;
+}
+
+/**
+ * @brief Retorna MMSI do barco (Missão 2)
+ */
+uint32_t UART_GetShipMMSI(void)
+{
+    return mission_results.ship_mmsi;
+}
+
+/**
+ * @brief Retorna latitude de origem do barco (Missão 2)
+ */
+float UART_GetShipOriginLat(void)
+{
+    return mission_results.ship_origin_lat;
+}
+
+/**
+ * @brief Retorna longitude de origem do barco (Missão 2)
+ */
+float UART_GetShipOriginLon(void)
+{
+    return mission_results.ship_origin_lon;
+}
+
+/**
+ * @brief Verifica se a missão foi completada
+ */
+uint8_t UART_IsMissionComplete(void)
+{
+    return mission_results.mission_complete;
+}
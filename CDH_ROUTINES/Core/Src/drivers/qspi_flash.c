@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    qspi_flash.c
+  * @brief   Flash NOR serial no QUADSPI (apagamento, escrita e leitura)
+  ******************************************************************************
+  */
+
+#include "qspi_flash.h"
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+/**
+ * @brief Preenche um comando em linha simples (instrução, endereço e dados)
+ */
+static void QSPI_Flash_BuildCommand(QSPI_CommandTypeDef *cmd, uint8_t instruction,
+                                    uint32_t address_mode, uint32_t data_mode)
+{
+    cmd->InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+    cmd->Instruction       = instruction;
+    cmd->AddressMode       = address_mode;
+    cmd->AddressSize       = QSPI_ADDRESS_24_BITS;
+    cmd->Address           = 0;
+    cmd->AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+    cmd->AlternateBytes    = 0;
+    cmd->AlternateBytesSize = 0;
+    cmd->DataMode          = data_mode;
+    cmd->DummyCycles       = 0;
+    cmd->NbData            = 0;
+    cmd->DdrMode           = QSPI_DDR_MODE_DISABLE;
+    cmd->DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;
+    cmd->SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+}
+
+/**
+ * @brief Habilita escrita (obrigatório antes de programar/apagar)
+ */
+static HAL_StatusTypeDef QSPI_Flash_WriteEnable(void)
+{
+    QSPI_CommandTypeDef cmd;
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_WRITE_ENABLE, QSPI_ADDRESS_NONE, QSPI_DATA_NONE);
+
+    return HAL_QSPI_Command(&hqspi, &cmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE);
+}
+
+/**
+ * @brief Aguarda o fim da operação interna (bit WIP = 0) por auto-polling
+ */
+static HAL_StatusTypeDef QSPI_Flash_WaitReady(uint32_t timeout_ms)
+{
+    QSPI_CommandTypeDef cmd;
+    QSPI_AutoPollingTypeDef poll = {0};
+
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_READ_STATUS, QSPI_ADDRESS_NONE, QSPI_DATA_1_LINE);
+
+    poll.Match           = 0x00;
+    poll.Mask            = QSPI_STATUS_WIP;
+    poll.MatchMode       = QSPI_MATCH_MODE_AND;
+    poll.StatusBytesSize = 1;
+    poll.Interval        = 0x10;
+    poll.AutomaticStop   = QSPI_AUTOMATIC_STOP_ENABLE;
+
+    return HAL_QSPI_AutoPolling(&hqspi, &cmd, &poll, timeout_ms);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Lê o JEDEC ID (fabricante, tipo, capacidade)
+ */
+HAL_StatusTypeDef QSPI_Flash_ReadID(uint8_t id[3])
+{
+    QSPI_CommandTypeDef cmd;
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_READ_JEDEC_ID, QSPI_ADDRESS_NONE, QSPI_DATA_1_LINE);
+    cmd.NbData = 3;
+
+    if (HAL_QSPI_Command(&hqspi, &cmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_QSPI_Receive(&hqspi, id, HAL_QSPI_TIMEOUT_DEFAULT_VALUE);
+}
+
+/**
+ * @brief Apaga o setor de 4 KB que contém o endereço
+ * @param address Qualquer endereço dentro do setor
+ */
+HAL_StatusTypeDef QSPI_Flash_EraseSector(uint32_t address)
+{
+    if (address >= QSPI_FLASH_ADDR_LIMIT) {
+        return HAL_ERROR;
+    }
+
+    if (QSPI_Flash_WriteEnable() != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    QSPI_CommandTypeDef cmd;
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_SECTOR_ERASE_4K, QSPI_ADDRESS_1_LINE, QSPI_DATA_NONE);
+    cmd.Address = address & ~(uint32_t)(QSPI_FLASH_SECTOR_SIZE - 1);
+
+    if (HAL_QSPI_Command(&hqspi, &cmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return QSPI_Flash_WaitReady(QSPI_FLASH_TIMEOUT_ERASE);
+}
+
+/**
+ * @brief Programa dados (a região deve estar apagada)
+ * @param address Endereço inicial (qualquer alinhamento)
+ * @param data Dados a gravar
+ * @param length Quantidade de bytes
+ * @note Divide a escrita nas fronteiras de página de 256 bytes
+ */
+HAL_StatusTypeDef QSPI_Flash_Write(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    if (address + length > QSPI_FLASH_ADDR_LIMIT) {
+        return HAL_ERROR;
+    }
+
+    QSPI_CommandTypeDef cmd;
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_PAGE_PROGRAM, QSPI_ADDRESS_1_LINE, QSPI_DATA_1_LINE);
+
+    while (length > 0) {
+        uint32_t page_room = QSPI_FLASH_PAGE_SIZE - (address % QSPI_FLASH_PAGE_SIZE);
+        uint32_t chunk = (length < page_room) ? length : page_room;
+
+        if (QSPI_Flash_WriteEnable() != HAL_OK) {
+            return HAL_ERROR;
+        }
+
+        cmd.Address = address;
+        cmd.NbData = chunk;
+        if (HAL_QSPI_Command(&hqspi, &cmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK ||
+            HAL_QSPI_Transmit(&hqspi, (uint8_t *)data, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK ||
+            QSPI_Flash_WaitReady(QSPI_FLASH_TIMEOUT_PROGRAM) != HAL_OK) {
+            return HAL_ERROR;
+        }
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Lê dados em modo quad (1-1-4, 8 ciclos dummy)
+ */
+HAL_StatusTypeDef QSPI_Flash_Read(uint32_t address, uint8_t *data, uint32_t length)
+{
+    if (length == 0) {
+        return HAL_OK;
+    }
+    if (address + length > QSPI_FLASH_ADDR_LIMIT) {
+        return HAL_ERROR;
+    }
+
+    QSPI_CommandTypeDef cmd;
+    QSPI_Flash_BuildCommand(&cmd, QSPI_CMD_QUAD_OUT_READ, QSPI_ADDRESS_1_LINE, QSPI_DATA_4_LINES);
+    cmd.Address = address;
+    cmd.DummyCycles = 8;
+    cmd.NbData = length;
+
+    if (HAL_QSPI_Command(&hqspi, &cmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    return HAL_QSPI_Receive(&hqspi, data, HAL_QSPI_TIMEOUT_DEFAULT_VALUE);
+}
@@ -0,0 +1,318 @@
+/**
+  ******************************************************************************
+  * @file    result_queue.c
+  * @brief   Fila de resultados das missões (RAM + transbordo em QSPI) com
+  *          downlink CAN confirmado pelo COM
+  ******************************************************************************
+  */
+
+#include "result_queue.h"
+#include "can_driver.h"
+#include "qspi_flash.h"
+#include <string.h>
+
+#define RESULT_QUEUE_QSPI_SLOTS     (RESULT_QUEUE_QSPI_SIZE / RESULT_QUEUE_QSPI_SLOT)
+#define RESULT_QUEUE_SLOTS_PER_SECTOR (QSPI_FLASH_SECTOR_SIZE / RESULT_QUEUE_QSPI_SLOT)
+// Um setor fica sempre livre: o apagamento à frente nunca atinge dados não lidos
+#define RESULT_QUEUE_QSPI_CAPACITY  (RESULT_QUEUE_QSPI_SLOTS - RESULT_QUEUE_SLOTS_PER_SECTOR)
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+// Início da fila em RAM; o restante (mais novo) fica na QSPI
+static MissionResult_t ram_queue[RESULT_QUEUE_RAM_SIZE];
+static uint8_t ram_head = 0;
+static uint8_t ram_count = 0;
+
+#if RESULT_QUEUE_QSPI_SPILL
+static uint16_t spill_read = 0;     // Slot mais antigo na QSPI
+static uint16_t spill_write = 0;    // Próximo slot livre
+static uint16_t spill_count = 0;
+#endif
+
+// Último resultado aceito (para descartar repetições)
+static MissionResult_t last_result;
+static uint8_t has_last = 0;
+
+static uint16_t next_seq = 0;
+
+// Downlink do resultado mais antigo
+static uint8_t tx_frame = 0;        // Próximo frame (0 = INFO)
+static uint8_t tx_done = 0;         // Todos os frames enviados, aguardando ACK
+static uint32_t tx_sent_tick = 0;
+
+static uint32_t suppressed = 0;
+static uint32_t dropped = 0;
+static uint32_t retransmissions = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Result_PutU32BE(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (value >> 24) & 0xFF;
+    dst[1] = (value >> 16) & 0xFF;
+    dst[2] = (value >> 8) & 0xFF;
+    dst[3] = value & 0xFF;
+}
+
+/**
+ * @brief Quantidade de frames de dados (CAN_CDH_TELEMETRY) do resultado
+ */
+static uint8_t Result_DataFrames(const MissionResult_t *result)
+{
+    return (result->mission == MISSION_2) ? 3 : 1;
+}
+
+/**
+ * @brief Monta o frame index do resultado (0 = INFO, 1.. = dados)
+ * @note Mantém o formato de telemetria já usado pelo COM; floats chegam
+ *       little-endian do Payload e vão big-endian no CAN
+ */
+static void Result_BuildFrame(const MissionResult_t *result, uint8_t index, CAN_Message_t *msg)
+{
+    uint32_t temp;
+
+    memset(msg->data, 0, sizeof(msg->data));
+
+    if (index == 0) {
+        msg->id = CAN_CDH_RESULT_INFO;
+        msg->data[0] = result->mission;
+        msg->data[1] = (result->seq >> 8) & 0xFF;
+        msg->data[2] = result->seq & 0xFF;
+        Result_PutU32BE(&msg->data[3], result->timestamp_ms);
+        msg->data[7] = Result_DataFrames(result);
+        return;
+    }
+
+    msg->id = CAN_CDH_TELEMETRY;
+    msg->data[0] = result->mission;
+    msg->data[6] = (result->seq >> 8) & 0xFF;
+    msg->data[7] = result->seq & 0xFF;
+
+    if (result->mission == MISSION_1) {
+        // [mission_type(1)] [oil_detected(1)] [area_percentage(4 bytes)] [seq(2)]
+        msg->data[1] = result->data[0];
+        memcpy(&temp, &result->data[1], 4);
+        Result_PutU32BE(&msg->data[2], temp);
+    } else {
+        // [mission_type(1)] [packet_id(1)] [valor(4 bytes)] [seq(2)]
+        msg->data[1] = index;
+        if (index == 1) {
+            memcpy(&msg->data[2], &result->data[0], 4);    // MMSI já vem big-endian
+        } else {
+            memcpy(&temp, &result->data[4 * (index - 1)], 4);
+            Result_PutU32BE(&msg->data[2], temp);
+        }
+    }
+}
+
+#if RESULT_QUEUE_QSPI_SPILL
+/**
+ * @brief Grava o resultado no próximo slot da QSPI
+ * @note Apaga o setor quando a escrita entra nele (bloqueante, só acontece
+ *       com a RAM cheia)
+ */
+static HAL_StatusTypeDef Result_SpillWrite(const MissionResult_t *result)
+{
+    if (spill_count >= RESULT_QUEUE_QSPI_CAPACITY) {
+        return HAL_BUSY;
+    }
+
+    uint32_t address = RESULT_QUEUE_QSPI_BASE + (uint32_t)spill_write * RESULT_QUEUE_QSPI_SLOT;
+
+    if ((spill_write % RESULT_QUEUE_SLOTS_PER_SECTOR) == 0 &&
+        QSPI_Flash_EraseSector(address) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if (QSPI_Flash_Write(address, (const uint8_t *)result, sizeof(*result)) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    spill_write = (spill_write + 1) % RESULT_QUEUE_QSPI_SLOTS;
+    spill_count++;
+    return HAL_OK;
+}
+
+/**
+ * @brief Traz da QSPI para a RAM os resultados mais antigos que couberem
+ */
+static void Result_Refill(void)
+{
+    while (spill_count > 0 && ram_count < RESULT_QUEUE_RAM_SIZE) {
+        uint32_t address = RESULT_QUEUE_QSPI_BASE + (uint32_t)spill_read * RESULT_QUEUE_QSPI_SLOT;
+        MissionResult_t *slot = &ram_queue[(ram_head + ram_count) % RESULT_QUEUE_RAM_SIZE];
+
+        if (QSPI_Flash_Read(address, (uint8_t *)slot, sizeof(*slot)) != HAL_OK) {
+            return;  // Tenta de novo na próxima chamada
+        }
+
+        spill_read = (spill_read + 1) % RESULT_QUEUE_QSPI_SLOTS;
+        spill_count--;
+        ram_count++;
+    }
+}
+#endif
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Esvazia a fila (RAM e QSPI) e zera os contadores
+ */
+void ResultQueue_Init(void)
+{
+    ram_head = 0;
+    ram_count = 0;
+#if RESULT_QUEUE_QSPI_SPILL
+    spill_read = 0;
+    spill_write = 0;
+    spill_count = 0;
+#endif
+    has_last = 0;
+    next_seq = 0;
+    tx_frame = 0;
+    tx_done = 0;
+    suppressed = 0;
+    dropped = 0;
+    retransmissions = 0;
+}
+
+/**
+ * @brief Enfileira o resultado de uma missão
+ * @param mission MISSION_1 ou MISSION_2
+ * @param data Dados do resultado como vieram do Payload
+ * @param length Até RESULT_QUEUE_MAX_DATA bytes
+ * @return HAL_OK também quando o resultado é igual ao anterior (descartado);
+ *         HAL_BUSY se não houver espaço
+ */
+HAL_StatusTypeDef ResultQueue_Push(MissionType_t mission, const uint8_t *data, uint8_t length)
+{
+    if (length > RESULT_QUEUE_MAX_DATA) {
+        return HAL_ERROR;
+    }
+
+    // Mesmo resultado da execução anterior: não gasta banda de downlink
+    if (has_last && last_result.mission == mission && last_result.length == length &&
+        memcmp(last_result.data, data, length) == 0) {
+        suppressed++;
+        return HAL_OK;
+    }
+
+    MissionResult_t result = {0};
+    result.seq = next_seq;
+    result.mission = mission;
+    result.length = length;
+    result.timestamp_ms = HAL_GetTick();
+    memcpy(result.data, data, length);
+
+    uint8_t to_ram = (ram_count < RESULT_QUEUE_RAM_SIZE);
+
+#if RESULT_QUEUE_QSPI_SPILL
+    // Com algo já na QSPI, os novos vão atrás para manter a ordem
+    to_ram = to_ram && (spill_count == 0);
+    if (!to_ram && Result_SpillWrite(&result) != HAL_OK) {
+        dropped++;
+        return HAL_BUSY;
+    }
+#else
+    if (!to_ram) {
+        dropped++;
+        return HAL_BUSY;
+    }
+#endif
+
+    if (to_ram) {
+        ram_queue[(ram_head + ram_count) % RESULT_QUEUE_RAM_SIZE] = result;
+        ram_count++;
+    }
+
+    next_seq++;
+    last_result = result;
+    has_last = 1;
+    return HAL_OK;
+}
+
+/**
+ * @brief Envia o resultado mais antigo, um frame por vez, e reenvia se o
+ *        COM não confirmar a tempo
+ * @note Não bloqueia (exceto a leitura da QSPI ao repor a RAM)
+ */
+void ResultQueue_Poll(void)
+{
+    CAN_Message_t msg;
+
+#if RESULT_QUEUE_QSPI_SPILL
+    Result_Refill();
+#endif
+
+    if (ram_count == 0) {
+        return;
+    }
+
+    const MissionResult_t *head = &ram_queue[ram_head];
+
+    if (tx_done) {
+        if ((HAL_GetTick() - tx_sent_tick) < RESULT_QUEUE_ACK_TIMEOUT_MS) {
+            return;
+        }
+        tx_done = 0;
+        tx_frame = 0;
+        retransmissions++;
+    }
+
+    while (!tx_done && CAN_TxReady()) {
+        Result_BuildFrame(head, tx_frame, &msg);
+        CAN_Transmit(&msg);
+
+        if (++tx_frame > Result_DataFrames(head)) {
+            tx_done = 1;
+            tx_sent_tick = HAL_GetTick();
+        }
+    }
+}
+
+/**
+ * @brief Confirmação do COM: remove o resultado seq da fila
+ * @note Só o resultado mais antigo está em downlink; ACKs de outros
+ *       números (duplicados ou atrasados) são ignorados
+ */
+void ResultQueue_HandleAck(uint16_t seq)
+{
+    if (ram_count == 0 || ram_queue[ram_head].seq != seq) {
+        return;
+    }
+
+    ram_head = (ram_head + 1) % RESULT_QUEUE_RAM_SIZE;
+    ram_count--;
+    tx_frame = 0;
+    tx_done = 0;
+}
+
+/* ============================================================================
+   GETTERS
+   ============================================================================ */
+uint16_t ResultQueue_GetCount(void)
+{
+#if RESULT_QUEUE_QSPI_SPILL
+    return ram_count + spill_count;
+#else
+    return ram_count;
+#endif
+}
+
+uint32_t ResultQueue_GetSuppressed(void)
+{
+    return suppressed;
+}
+
+uint32_t ResultQueue_GetDropped(void)
+{
+    return dropped;
+}
+
+uint32_t ResultQueue_GetRetransmissions(void)
+{
+    return retransmissions;
+}
@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file    uart_bulk.c
+  * @brief   Recepção de objetos grandes do Payload em blocos (retomável,
+  *          gravação direta em QSPI ou RAM_D1, CRC-32 por objeto)
+  ******************************************************************************
+  */
+
+#include "uart_bulk.h"
+#include "qspi_flash.h"
+#include "crc32.h"
+#include "lzss.h"
+#include "main.h"
+#include <string.h>
+
+/* ============================================================================
+   ESTRUTURAS PRIVADAS
+   ============================================================================ */
+typedef struct {
+    UART_BulkState_t state;
+    uint16_t obj_id;
+    uint32_t total;             // Tamanho anunciado no MSG_BULK_OFFER
+    uint32_t expected_crc;
+    uint32_t crc;               // CRC parcial dos bytes já gravados
+    uint32_t next_offset;       // Próximo byte esperado (tudo antes já gravado)
+    uint32_t requested_end;     // Fim do trecho pedido no último MSG_BULK_REQ
+    uint32_t last_rx_tick;
+    uint8_t req_pending;        // MSG_BULK_REQ/END ainda não entrou na janela do enlace
+    uint8_t end_pending;
+    uint8_t end_status;
+    uint8_t gap_requested;      // Já pediu de novo por causa da lacuna atual
+    uint8_t flags;              // UART_BULK_FLAG_*
+    uint32_t raw_size;          // Tamanho após descompressão (= total sem LZSS)
+    uint32_t stored;            // Bytes já entregues ao sink
+    const UART_BulkSink_t *sink;
+} UART_BulkSession_t;
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+static UART_BulkSession_t bulk = {0};
+static UART_Protocol_t *bulk_proto = NULL;     // Porta do Payload
+static const UART_BulkSink_t *bulk_sink = UART_BULK_DEFAULT_SINK;
+static uint32_t bulk_resumes = 0;
+
+// Descompressão no caminho para o sink (objetos com UART_BULK_FLAG_LZSS)
+static LZSS_Decoder_t bulk_decoder;
+static uint8_t bulk_decoded[256];
+
+// Destino em RAM: fica em .bss, que o linker coloca em RAM_D1 (AXI SRAM)
+static uint8_t bulk_ram_buffer[UART_BULK_RAM_SIZE];
+
+// Destino em QSPI: setores apagados sob demanda à frente da escrita
+static uint32_t qspi_erased_end = 0;
+
+/* ============================================================================
+   DESTINOS (SINKS)
+   ============================================================================ */
+static HAL_StatusTypeDef BulkSink_RAM_Open(uint32_t size)
+{
+    return (size <= UART_BULK_RAM_SIZE) ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef BulkSink_RAM_Write(uint32_t offset, const uint8_t *data, uint16_t length)
+{
+    if (offset + length > UART_BULK_RAM_SIZE) {
+        return HAL_ERROR;
+    }
+
+    memcpy(&bulk_ram_buffer[offset], data, length);
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef BulkSink_QSPI_Open(uint32_t size)
+{
+    if (size > UART_BULK_QSPI_SIZE) {
+        return HAL_ERROR;
+    }
+
+    qspi_erased_end = 0;
+    return HAL_OK;
+}
+
+/**
+ * @note Apaga o(s) setor(es) de 4 KB só quando a escrita chega neles, então
+ *       o custo de apagamento é diluído ao longo da transferência
+ */
+static HAL_StatusTypeDef BulkSink_QSPI_Write(uint32_t offset, const uint8_t *data, uint16_t length)
+{
+    if (offset + length > UART_BULK_QSPI_SIZE) {
+        return HAL_ERROR;
+    }
+
+    while (qspi_erased_end < offset + length) {
+        if (QSPI_Flash_EraseSector(UART_BULK_QSPI_BASE + qspi_erased_end) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        qspi_erased_end += QSPI_FLASH_SECTOR_SIZE;
+    }
+
+    return QSPI_Flash_Write(UART_BULK_QSPI_BASE + offset, data, length);
+}
+
+const UART_BulkSink_t UART_BulkSink_RAM = {
+    .open = BulkSink_RAM_Open,
+    .write = BulkSink_RAM_Write
+};
+
+const UART_BulkSink_t UART_BulkSink_QSPI = {
+    .open = BulkSink_QSPI_Open,
+    .write = BulkSink_QSPI_Write
+};
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static uint16_t Bulk_GetU16BE(const uint8_t *src)
+{
+    return ((uint16_t)src[0] << 8) | src[1];
+}
+
+static uint32_t Bulk_GetU32BE(const uint8_t *src)
+{
+    return ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) |
+           ((uint32_t)src[2] << 8)  |  (uint32_t)src[3];
+}
+
+static void Bulk_PutU32BE(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (value >> 24) & 0xFF;
+    dst[1] = (value >> 16) & 0xFF;
+    dst[2] = (value >> 8) & 0xFF;
+    dst[3] = value & 0xFF;
+}
+
+/**
+ * @brief Pede ao Payload o próximo trecho a partir de next_offset
+ * @note Se a janela do enlace estiver cheia, tenta de novo em UART_Bulk_Poll
+ */
+static void Bulk_SendRequest(void)
+{
+    uint8_t req[10];
+    uint32_t span = bulk.total - bulk.next_offset;
+    if (span > UART_BULK_REQ_SPAN) {
+        span = UART_BULK_REQ_SPAN;
+    }
+
+    req[0] = (bulk.obj_id >> 8) & 0xFF;
+    req[1] = bulk.obj_id & 0xFF;
+    Bulk_PutU32BE(&req[2], bulk.next_offset);
+    Bulk_PutU32BE(&req[6], span);
+
+    if (UART_Link_Send(bulk_proto, MSG_BULK_REQ, req, sizeof(req)) == HAL_OK) {
+        bulk.requested_end = bulk.next_offset + span;
+        bulk.req_pending = 0;
+    } else {
+        bulk.req_pending = 1;
+    }
+
+    // O timeout conta a partir do pedido, não do último bloco
+    bulk.last_rx_tick = HAL_GetTick();
+}
+
+/**
+ * @brief Informa ao Payload o resultado final do objeto
+ */
+static void Bulk_SendEnd(uint8_t status)
+{
+    uint8_t end[3];
+    end[0] = (bulk.obj_id >> 8) & 0xFF;
+    end[1] = bulk.obj_id & 0xFF;
+    end[2] = status;
+
+    bulk.end_status = status;
+    bulk.end_pending = (UART_Link_Send(bulk_proto, MSG_BULK_END, end, sizeof(end)) != HAL_OK);
+}
+
+/**
+ * @brief Trata MSG_BULK_OFFER: começa um objeto novo ou retoma o atual
+ */
+static void Bulk_HandleOffer(const UART_Message_t *msg)
+{
+    if (msg->length < UART_BULK_OFFER_LEN) {
+        return;
+    }
+
+    uint16_t obj_id = Bulk_GetU16BE(&msg->data[0]);
+    uint32_t total = Bulk_GetU32BE(&msg->data[2]);
+    uint32_t crc = Bulk_GetU32BE(&msg->data[6]);
+    uint8_t flags = 0;
+    uint32_t raw_size = total;
+
+    if (msg->length >= UART_BULK_OFFER_EXT_LEN) {
+        flags = msg->data[10];
+        raw_size = Bulk_GetU32BE(&msg->data[11]);
+    }
+
+    uint8_t same_object = (obj_id == bulk.obj_id && total == bulk.total &&
+                           crc == bulk.expected_crc);
+
+    if (same_object && bulk.state == BULK_STATE_ACTIVE) {
+        // Payload reiniciou ou perdeu o pedido: retoma de onde parou
+        bulk_resumes++;
+        Bulk_SendRequest();
+        return;
+    }
+
+    if (same_object && bulk.state == BULK_STATE_COMPLETE) {
+        Bulk_SendEnd(BULK_END_OK);  // O MSG_BULK_END anterior se perdeu
+        return;
+    }
+
+    // Objeto novo (substitui qualquer transferência em andamento)
+    memset(&bulk, 0, sizeof(bulk));
+    bulk.obj_id = obj_id;
+    bulk.total = total;
+    bulk.expected_crc = crc;
+    bulk.crc = CRC32_INIT;
+    bulk.flags = flags;
+    bulk.raw_size = raw_size;
+    bulk.sink = bulk_sink;
+
+    if (flags & UART_BULK_FLAG_LZSS) {
+        LZSS_DecoderReset(&bulk_decoder);
+    }
+
+    if (total == 0 || bulk.sink->open(raw_size) != HAL_OK) {
+        bulk.state = BULK_STATE_FAILED;
+        Bulk_SendEnd(BULK_END_REJECTED);
+        return;
+    }
+
+    bulk.state = BULK_STATE_ACTIVE;
+    Bulk_SendRequest();
+}
+
+/**
+ * @brief Entrega um bloco recebido (em ordem) ao sink
+ * @note Objetos LZSS passam pelo decodificador em fluxo; o sink recebe os
+ *       dados originais em pedaços de até sizeof(bulk_decoded)
+ */
+static HAL_StatusTypeDef Bulk_Store(const uint8_t *data, uint16_t length)
+{
+    if (!(bulk.flags & UART_BULK_FLAG_LZSS)) {
+        if (bulk.sink->write(bulk.stored, data, length) != HAL_OK) {
+            return HAL_ERROR;
+        }
+        bulk.stored += length;
+        return HAL_OK;
+    }
+
+    uint16_t used = 0;
+    while (used < length) {
+        used += LZSS_DecoderSink(&bulk_decoder, &data[used], length - used);
+
+        size_t produced;
+        while ((produced = LZSS_DecoderPoll(&bulk_decoder, bulk_decoded, sizeof(bulk_decoded))) > 0) {
+            if (bulk.stored + produced > bulk.raw_size ||
+                bulk.sink->write(bulk.stored, bulk_decoded, produced) != HAL_OK) {
+                return HAL_ERROR;
+            }
+            bulk.stored += produced;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Trata MSG_BULK_CHUNK: grava no destino se for o próximo bloco
+ */
+static void Bulk_HandleChunk(const UART_Message_t *msg)
+{
+    if (bulk.state != BULK_STATE_ACTIVE || msg->length <= UART_BULK_CHUNK_HEADER) {
+        return;
+    }
+
+    uint16_t obj_id = Bulk_GetU16BE(&msg->data[0]);
+    uint32_t offset = Bulk_GetU32BE(&msg->data[2]);
+    uint16_t length = msg->length - UART_BULK_CHUNK_HEADER;
+
+    if (obj_id != bulk.obj_id || offset + length > bulk.total) {
+        return;
+    }
+
+    if (offset != bulk.next_offset) {
+        // Bloco à frente: algum se perdeu no enlace, pede de novo uma vez
+        if (offset > bulk.next_offset && !bulk.gap_requested) {
+            bulk.gap_requested = 1;
+            bulk_resumes++;
+            Bulk_SendRequest();
+        }
+        return;  // Bloco repetido ou fora de ordem: descarta
+    }
+
+    if (Bulk_Store(&msg->data[UART_BULK_CHUNK_HEADER], length) != HAL_OK) {
+        bulk.state = BULK_STATE_FAILED;
+        Bulk_SendEnd(BULK_END_REJECTED);
+        return;
+    }
+
+    bulk.crc = CRC32_Update(bulk.crc, &msg->data[UART_BULK_CHUNK_HEADER], length);
+    bulk.next_offset += length;
+    bulk.last_rx_tick = HAL_GetTick();
+    bulk.gap_requested = 0;
+
+    if (bulk.next_offset == bulk.total) {
+        if (CRC32_Final(bulk.crc) == bulk.expected_crc && bulk.stored == bulk.raw_size) {
+            bulk.state = BULK_STATE_COMPLETE;
+            Bulk_SendEnd(BULK_END_OK);
+        } else {
+            bulk.state = BULK_STATE_FAILED;
+            Bulk_SendEnd(BULK_END_CRC_ERROR);
+        }
+    } else if (bulk.next_offset >= bulk.requested_end) {
+        Bulk_SendRequest();
+    }
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Inicializa a recepção de objetos
+ * @param proto Porta por onde chegam os objetos (Payload)
+ * @param sink Destino dos dados (UART_BulkSink_QSPI ou UART_BulkSink_RAM)
+ */
+void UART_Bulk_Init(UART_Protocol_t *proto, const UART_BulkSink_t *sink)
+{
+    memset(&bulk, 0, sizeof(bulk));
+    bulk_proto = proto;
+    bulk_sink = sink;
+    bulk_resumes = 0;
+}
+
+/**
+ * @brief Troca o destino; só vale a partir do próximo MSG_BULK_OFFER
+ */
+void UART_Bulk_SetSink(const UART_BulkSink_t *sink)
+{
+    bulk_sink = sink;
+}
+
+/**
+ * @brief Trata as mensagens MSG_BULK_* vindas do Payload
+ * @param msg Mensagem já sem o byte de sequência (o chamador mantém a posse)
+ */
+void UART_Bulk_HandleMessage(const UART_Message_t *msg)
+{
+    switch (msg->id) {
+        case MSG_BULK_OFFER:
+            Bulk_HandleOffer(msg);
+            break;
+
+        case MSG_BULK_CHUNK:
+            Bulk_HandleChunk(msg);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Reenvia pedidos que não couberam no enlace e retoma após timeout
+ * @note Chamada pelo motor do protocolo (hook de polling da porta do Payload)
+ */
+void UART_Bulk_Poll(void)
+{
+    if (bulk_proto == NULL) {
+        return;
+    }
+
+    if (bulk.end_pending) {
+        Bulk_SendEnd(bulk.end_status);
+    }
+
+    if (bulk.state != BULK_STATE_ACTIVE) {
+        return;
+    }
+
+    if (bulk.req_pending) {
+        Bulk_SendRequest();
+    } else if ((HAL_GetTick() - bulk.last_rx_tick) >= UART_BULK_TIMEOUT_MS) {
+        // Nenhum bloco novo: enlace caiu ou o Payload perdeu o pedido
+        bulk_resumes++;
+        Bulk_SendRequest();
+    }
+}
+
+/**
+ * @brief Abandona o objeto atual (o Payload pode oferecê-lo de novo)
+ */
+void UART_Bulk_Abort(void)
+{
+    if (bulk.state == BULK_STATE_ACTIVE) {
+        bulk.state = BULK_STATE_FAILED;
+        Bulk_SendEnd(BULK_END_REJECTED);
+    }
+}
+
+/* ============================================================================
+   GETTERS
+   ============================================================================ */
+UART_BulkState_t UART_Bulk_GetState(void)
+{
+    return bulk.state;
+}
+
+uint16_t UART_Bulk_GetObjectId(void)
+{
+    return bulk.obj_id;
+}
+
+/**
+ * @brief Retorna quantos bytes do objeto já chegaram (comprimidos, se LZSS)
+ */
+uint32_t UART_Bulk_GetReceived(void)
+{
+    return bulk.next_offset;
+}
+
+uint32_t UART_Bulk_GetTotal(void)
+{
+    return bulk.total;
+}
+
+uint32_t UART_Bulk_GetStored(void)
+{
+    return bulk.stored;
+}
+
+uint32_t UART_Bulk_GetResumes(void)
+{
+    return bulk_resumes;
+}
+
+/**
+ * @brief Acesso ao objeto recebido com UART_BulkSink_RAM
+ */
+const uint8_t *UART_Bulk_GetRamBuffer(void)
+{
+    return bulk_ram_buffer;
+}
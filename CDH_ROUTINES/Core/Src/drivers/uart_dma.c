@@ -0,0 +1,445 @@
+/**
+  ******************************************************************************
+  * @file    uart_dma.c
+  * @brief   Motor de recepção por DMA circular e de transmissão por anel
+  *          compartilhado por todas as portas UART (callbacks HAL)
+  ******************************************************************************
+  */
+
+#include "uart_dma.h"
+#include "main.h"
+#include "dwt.h"
+#include <string.h>
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+static UART_DMA_Rx_t *ports[UART_DMA_MAX_PORTS];
+static UART_DMA_Tx_t *tx_ports[UART_DMA_MAX_PORTS];
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+/**
+ * @brief Localiza a porta registrada para o handle (chamada nas ISRs)
+ */
+static UART_DMA_Rx_t *UART_DMA_Find(UART_HandleTypeDef *huart)
+{
+    for (uint8_t i = 0; i < UART_DMA_MAX_PORTS; i++) {
+        if (ports[i] != NULL && ports[i]->huart == huart) {
+            return ports[i];
+        }
+    }
+
+    return NULL;
+}
+
+static UART_DMA_Tx_t *UART_DMA_FindTx(UART_HandleTypeDef *huart)
+{
+    for (uint8_t i = 0; i < UART_DMA_MAX_PORTS; i++) {
+        if (tx_ports[i] != NULL && tx_ports[i]->huart == huart) {
+            return tx_ports[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Arma o DMA circular com evento de linha ociosa
+ */
+static HAL_StatusTypeDef UART_DMA_Arm(UART_DMA_Rx_t *rx)
+{
+    rx->dma_pos = 0;
+    rx->read_pos = 0;
+    rx->consumed = rx->written;
+
+    return HAL_UARTEx_ReceiveToIdle_DMA(rx->huart, rx->buf, rx->size);
+}
+
+/**
+ * @brief Entrega ao DMA o próximo trecho contíguo do anel, se estiver ocioso
+ * @note Chamar com interrupções desabilitadas ou do próprio callback.
+ *       Com marca armada o trecho termina nela, para o TxCplt coincidir
+ *       com o último byte marcado.
+ */
+static void UART_DMA_Kick(UART_DMA_Tx_t *tx)
+{
+    uint32_t pending = tx->queued - tx->sent;
+
+    if (tx->dma_len != 0 || pending == 0) {
+        return;
+    }
+
+    uint16_t len = tx->size - tx->tail;
+    if (pending < len) {
+        len = (uint16_t)pending;
+    }
+
+    if (tx->watch == 1) {
+        uint32_t to_mark = tx->watch_end - tx->sent;
+        if (to_mark > 0 && to_mark < len) {
+            len = (uint16_t)to_mark;
+        }
+    }
+
+    tx->dma_len = len;
+    if (HAL_UART_Transmit_DMA(tx->huart, &tx->buf[tx->tail], len) != HAL_OK) {
+        // UART ocupada: o trecho fica no anel e sai no próximo Write
+        tx->dma_len = 0;
+        tx->errors++;
+    }
+}
+
+/**
+ * @brief Fecha o trecho entregue ao DMA (enviado ou perdido) e segue
+ */
+static void UART_DMA_TxAdvance(UART_DMA_Tx_t *tx)
+{
+    tx->sent += tx->dma_len;
+    tx->tail = (uint16_t)((tx->tail + tx->dma_len) % tx->size);
+    tx->dma_len = 0;
+
+    if (tx->watch == 1 && (int32_t)(tx->sent - tx->watch_end) >= 0) {
+        tx->watch_cycles = DWT_GetCycles();
+        tx->watch = 2;
+    }
+
+    UART_DMA_Kick(tx);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Registra a porta e inicia a recepção contínua
+ * @param rx Estado da porta (deve existir enquanto a recepção estiver ativa)
+ * @param huart Handle com hdmarx em modo DMA_CIRCULAR (ver usart.c)
+ * @param buf Buffer do DMA (acessível pelo DMA1: RAM_D1 ou RAM_D2)
+ * @param size Tamanho do buffer
+ * @return HAL_ERROR se não houver DMA associado ou se a tabela estiver cheia
+ */
+HAL_StatusTypeDef UART_DMA_StartRx(UART_DMA_Rx_t *rx, UART_HandleTypeDef *huart,
+                                   uint8_t *buf, uint16_t size)
+{
+    if (huart == NULL || huart->hdmarx == NULL || buf == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+
+    UART_DMA_Rx_t **slot = NULL;
+    for (uint8_t i = 0; i < UART_DMA_MAX_PORTS; i++) {
+        if (ports[i] == rx || (ports[i] != NULL && ports[i]->huart == huart)) {
+            slot = &ports[i];
+            break;
+        }
+        if (ports[i] == NULL && slot == NULL) {
+            slot = &ports[i];
+        }
+    }
+    if (slot == NULL) {
+        return HAL_ERROR;
+    }
+
+    rx->huart = huart;
+    rx->buf = buf;
+    rx->size = size;
+    rx->written = 0;
+    rx->restart = 0;
+    rx->overruns = 0;
+    rx->errors = 0;
+    *slot = rx;
+
+    return UART_DMA_Arm(rx);
+}
+
+/**
+ * @brief Para a recepção e remove a porta do motor
+ */
+void UART_DMA_StopRx(UART_DMA_Rx_t *rx)
+{
+    for (uint8_t i = 0; i < UART_DMA_MAX_PORTS; i++) {
+        if (ports[i] == rx) {
+            HAL_UART_AbortReceive(rx->huart);
+            ports[i] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Retorna os bytes contíguos ainda não lidos, direto do buffer do DMA
+ * @param rx Porta
+ * @param data Recebe o ponteiro para o primeiro byte não lido
+ * @return Quantidade de bytes contíguos (até o fim do buffer ou até o DMA)
+ */
+uint16_t UART_DMA_Peek(UART_DMA_Rx_t *rx, const uint8_t **data)
+{
+    if (rx->restart) {
+        // Erro abortou a recepção: o que estava no buffer é descartado
+        rx->restart = 0;
+        rx->errors++;
+        UART_DMA_Arm(rx);
+        return 0;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t written = rx->written;
+    uint16_t dma_pos = rx->dma_pos;
+    __set_PRIMASK(primask);
+
+    uint32_t pending = written - rx->consumed;
+    if (pending == 0) {
+        return 0;
+    }
+
+    if (pending > rx->size) {
+        // DMA deu a volta sobre dados não lidos: ressincroniza na posição atual
+        rx->overruns++;
+        rx->read_pos = dma_pos;
+        rx->consumed = written;
+        return 0;
+    }
+
+    uint16_t contiguous = rx->size - rx->read_pos;
+    if (pending < contiguous) {
+        contiguous = (uint16_t)pending;
+    }
+
+    *data = &rx->buf[rx->read_pos];
+    return contiguous;
+}
+
+/**
+ * @brief Marca bytes como lidos (após UART_DMA_Peek)
+ */
+void UART_DMA_Consume(UART_DMA_Rx_t *rx, uint16_t count)
+{
+    rx->read_pos = (uint16_t)((rx->read_pos + count) % rx->size);
+    rx->consumed += count;
+}
+
+/**
+ * @brief Verifica se há bytes novos (ou rearme pendente) sem tocar no buffer
+ */
+uint8_t UART_DMA_HasData(const UART_DMA_Rx_t *rx)
+{
+    return (rx->written != rx->consumed) || rx->restart;
+}
+
+/* ============================================================================
+   TRANSMISSÃO
+   ============================================================================ */
+/**
+ * @brief Registra o anel de transmissão da porta
+ * @param tx Estado do anel (deve existir enquanto a porta estiver ativa)
+ * @param huart Handle com hdmatx em modo DMA_NORMAL (ver usart.c)
+ * @param buf Anel (acessível pelo DMA1: RAM_D1 ou RAM_D2)
+ * @param size Tamanho do anel
+ * @return HAL_ERROR se não houver DMA associado ou se a tabela estiver cheia
+ */
+HAL_StatusTypeDef UART_DMA_StartTx(UART_DMA_Tx_t *tx, UART_HandleTypeDef *huart,
+                                   uint8_t *buf, uint16_t size)
+{
+    if (huart == NULL || huart->hdmatx == NULL || buf == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+
+    UART_DMA_Tx_t **slot = NULL;
+    for (uint8_t i = 0; i < UART_DMA_MAX_PORTS; i++) {
+        if (tx_ports[i] == tx || (tx_ports[i] != NULL && tx_ports[i]->huart == huart)) {
+            slot = &tx_ports[i];
+            break;
+        }
+        if (tx_ports[i] == NULL && slot == NULL) {
+            slot = &tx_ports[i];
+        }
+    }
+    if (slot == NULL) {
+        return HAL_ERROR;
+    }
+
+    HAL_UART_AbortTransmit(huart);
+
+    tx->huart = huart;
+    tx->buf = buf;
+    tx->size = size;
+    tx->head = 0;
+    tx->tail = 0;
+    tx->dma_len = 0;
+    tx->queued = 0;
+    tx->sent = 0;
+    tx->watch = 0;
+    tx->drops = 0;
+    tx->errors = 0;
+    *slot = tx;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reserva espaço no anel para o frame ser montado direto nele
+ * @param len Bytes reservados (pior caso do frame)
+ * @param pos Recebe a posição do primeiro byte; a escrita dá a volta em
+ *            tx->size e só vai para a linha em UART_DMA_Commit
+ * @return HAL_BUSY se não couber (nada é reservado)
+ * @note Só o loop principal escreve no anel: uma reserva por vez
+ */
+HAL_StatusTypeDef UART_DMA_Reserve(UART_DMA_Tx_t *tx, uint16_t len, uint16_t *pos)
+{
+    if (len > UART_DMA_TxFree(tx)) {
+        tx->drops++;
+        return HAL_BUSY;
+    }
+
+    *pos = tx->head;
+    return HAL_OK;
+}
+
+/**
+ * @brief Entrega ao DMA os len bytes montados a partir da reserva
+ * @param len Bytes de fato escritos (até o tamanho reservado)
+ */
+void UART_DMA_Commit(UART_DMA_Tx_t *tx, uint16_t len)
+{
+    if (len == 0) {
+        return;
+    }
+
+    tx->head = (uint16_t)((tx->head + len) % tx->size);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tx->queued += len;
+    UART_DMA_Kick(tx);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Copia o frame para o anel e dispara o DMA se estiver ocioso
+ * @return HAL_BUSY se o frame não couber inteiro (nada é escrito)
+ * @note Só o loop principal escreve no anel
+ */
+HAL_StatusTypeDef UART_DMA_Write(UART_DMA_Tx_t *tx, const uint8_t *data, uint16_t len)
+{
+    uint16_t pos;
+
+    if (len == 0) {
+        return HAL_OK;
+    }
+
+    if (UART_DMA_Reserve(tx, len, &pos) != HAL_OK) {
+        return HAL_BUSY;
+    }
+
+    uint16_t first = tx->size - pos;
+    if (len < first) {
+        first = len;
+    }
+    memcpy(&tx->buf[pos], data, first);
+    memcpy(tx->buf, &data[first], len - first);
+
+    UART_DMA_Commit(tx, len);
+    return HAL_OK;
+}
+
+/**
+ * @brief Espaço livre no anel (bytes)
+ */
+uint16_t UART_DMA_TxFree(const UART_DMA_Tx_t *tx)
+{
+    return (uint16_t)(tx->size - (tx->queued - tx->sent));
+}
+
+/**
+ * @brief Verifica se tudo o que foi escrito já saiu na linha
+ */
+uint8_t UART_DMA_TxIdle(const UART_DMA_Tx_t *tx)
+{
+    return tx->queued == tx->sent;
+}
+
+/**
+ * @brief Arma a marca de latência no fim do que já foi escrito
+ * @note Substitui uma marca anterior ainda não concluída
+ */
+void UART_DMA_WatchTx(UART_DMA_Tx_t *tx)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tx->watch_end = tx->queued;
+    if (tx->queued == tx->sent) {
+        tx->watch_cycles = DWT_GetCycles();
+        tx->watch = 2;
+    } else {
+        tx->watch = 1;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Consulta a marca de latência
+ * @param cycles Recebe o DWT->CYCCNT do fim do envio
+ * @return 1 uma única vez por marca, quando o último byte marcado saiu
+ */
+uint8_t UART_DMA_WatchDone(UART_DMA_Tx_t *tx, uint32_t *cycles)
+{
+    if (tx->watch != 2) {
+        return 0;
+    }
+
+    *cycles = tx->watch_cycles;
+    tx->watch = 0;
+    return 1;
+}
+
+/* ============================================================================
+   CALLBACKS HAL (CONTEXTO DE INTERRUPÇÃO)
+   ============================================================================ */
+/**
+ * @brief Evento de recepção: meia-volta, volta completa ou linha ociosa
+ * @param size Posição atual do DMA dentro do buffer (size = fim do buffer)
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size)
+{
+    UART_DMA_Rx_t *rx = UART_DMA_Find(huart);
+    if (rx == NULL) {
+        return;
+    }
+
+    uint16_t pos = (size >= rx->size) ? 0 : size;
+    rx->written += (uint16_t)((pos + rx->size - rx->dma_pos) % rx->size);
+    rx->dma_pos = pos;
+    rx->event_cycles = DWT_GetCycles();
+}
+
+/**
+ * @brief Fim de um trecho da transmissão (último byte na linha)
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    UART_DMA_Tx_t *tx = UART_DMA_FindTx(huart);
+    if (tx == NULL || tx->dma_len == 0) {
+        return;
+    }
+
+    UART_DMA_TxAdvance(tx);
+}
+
+/**
+ * @brief Erro de hardware: se a HAL abortou a recepção, o loop rearma;
+ *        se abortou a transmissão, o trecho é dado como perdido (o enlace
+ *        retransmite) e o anel segue
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    UART_DMA_Rx_t *rx = UART_DMA_Find(huart);
+    if (rx != NULL && huart->RxState == HAL_UART_STATE_READY) {
+        rx->restart = 1;
+    }
+
+    UART_DMA_Tx_t *tx = UART_DMA_FindTx(huart);
+    if (tx != NULL && tx->dma_len != 0 && huart->gState == HAL_UART_STATE_READY) {
+        tx->errors++;
+        UART_DMA_TxAdvance(tx);
+    }
+}
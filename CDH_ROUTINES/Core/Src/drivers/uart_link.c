@@ -0,0 +1,582 @@
+/**
+  ******************************************************************************
+  * @file    uart_link.c
+  * @brief   Enlace confiável com janela deslizante (ACK cumulativo, NACK
+  *          seletivo e timeout de retransmissão adaptativo)
+  ******************************************************************************
+  */
+
+#include "uart_link.h"
+#include "uart_protocol.h"
+#include "uart_msg_pool.h"
+#include <string.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+/**
+ * @brief Envia frame de controle (ACK/NACK/SYNC/RESET) sem número de sequência
+ */
+static void Link_SendControl(UART_Protocol_t *proto, uint8_t msg_id, uint8_t seq)
+{
+    static UART_Message_t ctrl;     // Fora da pilha: só usado no loop principal
+    ctrl.id = msg_id;
+    ctrl.seq = seq;
+    ctrl.length = 0;
+
+    UART_Transmit(proto, &ctrl, 0);
+}
+
+/**
+ * @brief Atualiza SRTT/RTTVAR com uma nova amostra e recalcula o RTO
+ */
+static void Link_UpdateRTO(UART_LinkState_t *link, uint32_t sample_ms)
+{
+    int32_t r = (int32_t)sample_ms;
+
+    if (!link->rtt_valid) {
+        link->srtt_ms = r;
+        link->rttvar_ms = r / 2;
+        link->rtt_valid = 1;
+    } else {
+        int32_t delta = link->srtt_ms - r;
+        if (delta < 0) delta = -delta;
+        link->rttvar_ms += (delta - link->rttvar_ms) / 4;   // beta = 1/4
+        link->srtt_ms += (r - link->srtt_ms) / 8;           // alpha = 1/8
+    }
+
+    uint32_t rto = (uint32_t)(link->srtt_ms + 4 * link->rttvar_ms);
+    if (rto < UART_LINK_RTO_MIN_MS) rto = UART_LINK_RTO_MIN_MS;
+    if (rto > UART_LINK_RTO_MAX_MS) rto = UART_LINK_RTO_MAX_MS;
+    link->rto_ms = rto;
+}
+
+/**
+ * @brief Recomeça a recepção em next_seq, devolvendo ao pool o que estava
+ *        guardado na janela
+ */
+static void Link_ResetReceiver(UART_LinkState_t *link, uint8_t next_seq)
+{
+    for (uint8_t i = 0; i < UART_LINK_WINDOW_SIZE; i++) {
+        UART_MsgPool_Release(link->rx_window[i]);
+        link->rx_window[i] = NULL;
+    }
+
+    link->rx_next = next_seq;
+    link->rx_skip = 0;
+    link->nack_sent = 0;
+    link->rx_wait_sync = 0;
+}
+
+/**
+ * @brief Inicia (ou reinicia) o MSG_SYNC com a base do transmissor
+ */
+static void Link_StartSync(UART_Protocol_t *proto)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    link->sync_pending = 1;
+    link->sync_tick = HAL_GetTick();
+    Link_SendControl(proto, MSG_SYNC, link->tx_base);
+}
+
+/**
+ * @brief Avança a base sobre frames descartados e avisa o receptor
+ * @note Sem o MSG_SYNC o receptor esperaria a sequência descartada para
+ *       sempre (e guardaria as seguintes na janela, presas ao pool)
+ */
+static void Link_SkipDropped(UART_Protocol_t *proto)
+{
+    UART_LinkState_t *link = &proto->link;
+    uint8_t skipped = 0;
+
+    while (link->tx_base != link->tx_next &&
+           !link->tx_window[link->tx_base % UART_LINK_WINDOW_SIZE].in_use) {
+        link->tx_base++;
+        skipped = 1;
+    }
+
+    if (!skipped) {
+        return;
+    }
+
+    if (!link->sync_pending) {
+        link->resyncs++;
+    }
+    Link_StartSync(proto);
+}
+
+/**
+ * @brief Libera todos os frames com sequência anterior a ack_seq
+ */
+static void Link_HandleAck(UART_Protocol_t *proto, uint8_t ack_seq)
+{
+    UART_LinkState_t *link = &proto->link;
+    uint8_t acked = (uint8_t)(ack_seq - link->tx_base);
+    uint8_t outstanding = (uint8_t)(link->tx_next - link->tx_base);
+
+    // MSG_RESET confirmado: a outra ponta já espera a nossa base
+    if (link->reset_pending && ack_seq == link->tx_base) {
+        link->reset_pending = 0;
+    }
+
+    // Qualquer ACK dentro da janela (mesmo o da própria base) mostra que o
+    // receptor já passou das sequências descartadas
+    if (link->sync_pending && acked <= outstanding) {
+        link->sync_pending = 0;
+    }
+
+    // ACK fora da janela (duplicado ou antigo)
+    if (acked == 0 || acked > outstanding) {
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+
+    while (link->tx_base != ack_seq) {
+        UART_LinkTxSlot_t *slot = &link->tx_window[link->tx_base % UART_LINK_WINDOW_SIZE];
+
+        // Algoritmo de Karn: só mede RTT de frames nunca retransmitidos
+        if (slot->in_use && slot->retries == 0) {
+            Link_UpdateRTO(link, now - slot->sent_tick);
+            UART_Stats_RecordRtt(proto, UART_RTT_LINK, slot->frame->id, now - slot->sent_tick);
+        }
+
+        if (slot->in_use) {
+            UART_MsgPool_Release(slot->frame);
+            slot->frame = NULL;
+            slot->in_use = 0;
+        }
+        link->tx_base++;
+    }
+
+    Link_SkipDropped(proto);
+}
+
+/**
+ * @brief Retransmite imediatamente um frame específico (pedido por NACK)
+ */
+static void Link_HandleNack(UART_Protocol_t *proto, uint8_t missing_seq)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    // NACK também confirma tudo que veio antes da lacuna
+    Link_HandleAck(proto, missing_seq);
+
+    if (missing_seq != link->tx_base || link->tx_base == link->tx_next) {
+        return;
+    }
+
+    UART_LinkTxSlot_t *slot = &link->tx_window[missing_seq % UART_LINK_WINDOW_SIZE];
+    if (slot->in_use) {
+        UART_Transmit(proto, slot->frame, slot->frame_len);
+        slot->sent_tick = HAL_GetTick();
+        slot->retries++;
+        link->retransmissions++;
+    }
+}
+
+/**
+ * @brief Armazena frame de dados recebido na janela de recepção
+ * @param frame Buffer do pool; a posse passa para o enlace
+ */
+static void Link_HandleData(UART_Protocol_t *proto, UART_Message_t *frame)
+{
+    UART_LinkState_t *link = &proto->link;
+    uint8_t seq = frame->seq;
+    uint8_t offset = (uint8_t)(seq - link->rx_next);
+
+    // Recém-reiniciado: sem saber a sequência da outra ponta, um ACK de
+    // rx_next confirmaria frames que nunca chegaram. Espera o MSG_SYNC
+    if (link->rx_wait_sync) {
+        UART_MsgPool_Release(frame);
+        return;
+    }
+
+    if (offset >= UART_LINK_WINDOW_SIZE) {
+        // Duplicado (nosso ACK se perdeu) ou fora da janela: reconfirma
+        UART_MsgPool_Release(frame);
+        Link_SendControl(proto, MSG_ACK, link->rx_next);
+        return;
+    }
+
+    UART_Message_t **slot = &link->rx_window[seq % UART_LINK_WINDOW_SIZE];
+    if (*slot == NULL) {
+        *slot = frame;          // O parser já separou o SEQ dos dados
+    } else {
+        UART_MsgPool_Release(frame);  // Cópia já armazenada
+    }
+
+    // Lacuna detectada: pede só o frame faltante, uma vez por lacuna
+    if (offset != 0 && (!link->nack_sent || link->nack_pending_seq != link->rx_next)) {
+        Link_SendControl(proto, MSG_NACK, link->rx_next);
+        link->nack_pending_seq = link->rx_next;
+        link->nack_sent = 1;
+    }
+}
+
+/**
+ * @brief O transmissor desistiu das sequências anteriores a next_seq
+ * @note Frames já guardados antes de next_seq ainda são entregues; só as
+ *       lacunas são puladas (em UART_Link_Receive), e o ACK sai no fim
+ */
+static void Link_HandleSync(UART_Protocol_t *proto, uint8_t next_seq)
+{
+    UART_LinkState_t *link = &proto->link;
+    uint8_t skip = (uint8_t)(next_seq - link->rx_next);
+    uint8_t behind = (uint8_t)(link->rx_next - next_seq);
+
+    // Com os envios parados durante a ressincronização, a base do
+    // transmissor fica no máximo uma janela à frente de rx_next, e um
+    // MSG_SYNC repetido (o ACK se perdeu) no máximo uma janela atrás. Fora
+    // disso uma das pontas reiniciou: recomeça a recepção na base dela
+    if (link->rx_wait_sync ||
+        (skip > UART_LINK_WINDOW_SIZE && behind > UART_LINK_WINDOW_SIZE)) {
+        if (!link->rx_wait_sync) {
+            link->peer_resets++;
+        }
+        Link_ResetReceiver(link, next_seq);
+        Link_SendControl(proto, MSG_ACK, link->rx_next);
+        return;
+    }
+
+    // Repetido ou já superado: só reconfirma
+    if (skip == 0 || skip > UART_LINK_WINDOW_SIZE) {
+        Link_SendControl(proto, MSG_ACK, link->rx_next);
+        return;
+    }
+
+    link->rx_skip = skip;
+    link->nack_sent = 0;
+}
+
+/**
+ * @brief A outra ponta reiniciou e vai transmitir a partir de first_seq
+ * @note A recepção dela também recomeçou: o MSG_SYNC mostra onde está a
+ *       nossa base, e os frames em voo saem de novo depois do ACK
+ */
+static void Link_HandleReset(UART_Protocol_t *proto, uint8_t first_seq)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    Link_ResetReceiver(link, first_seq);
+    link->peer_resets++;
+    Link_SendControl(proto, MSG_ACK, first_seq);
+
+    Link_StartSync(proto);
+}
+
+/* ============================================================================
+   INICIALIZAÇÃO
+   ============================================================================ */
+/**
+ * @brief Inicializa o enlace confiável da porta
+ * @param proto Contexto do protocolo (já com huart definido)
+ */
+void UART_Link_Init(UART_Protocol_t *proto)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    // Devolve ao pool o que ainda estiver nas janelas
+    for (uint8_t i = 0; i < UART_LINK_WINDOW_SIZE; i++) {
+        if (link->tx_window[i].in_use) {
+            UART_MsgPool_Release(link->tx_window[i].frame);
+        }
+        UART_MsgPool_Release(link->rx_window[i]);
+    }
+
+    memset(link, 0, sizeof(*link));
+    link->rto_ms = UART_LINK_RTO_INITIAL_MS;
+
+    // Anuncia o reinício: o primeiro MSG_RESET sai no próximo UART_Link_Poll
+    link->reset_pending = 1;
+    link->rx_wait_sync = 1;
+    link->sync_tick = HAL_GetTick() - link->rto_ms;
+}
+
+/* ============================================================================
+   TRANSMISSÃO
+   ============================================================================ */
+/**
+ * @brief Ocupa a próxima posição da janela com uma cópia do frame
+ *        (guardada para retransmissão)
+ * @param out Recebe a posição ocupada (frame->seq = SEQ)
+ */
+static HAL_StatusTypeDef Link_Enqueue(UART_Protocol_t *proto, uint8_t msg_id,
+                                      const uint8_t *data, uint16_t length,
+                                      UART_LinkTxSlot_t **out)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    if (proto->huart == NULL || length > UART_LINK_MAX_DATA ||
+        msg_id == MSG_ACK || msg_id == MSG_NACK || msg_id == MSG_SYNC || msg_id == MSG_RESET) {
+        return HAL_ERROR;
+    }
+
+    // Janela cheia, ressincronização ou reinício em andamento
+    if ((uint8_t)(link->tx_next - link->tx_base) >= UART_LINK_WINDOW_SIZE ||
+        link->sync_pending || link->reset_pending) {
+        return HAL_BUSY;
+    }
+
+    UART_Message_t *frame = UART_MsgPool_Acquire();
+    if (frame == NULL) {
+        return HAL_BUSY;
+    }
+
+    UART_LinkTxSlot_t *slot = &link->tx_window[link->tx_next % UART_LINK_WINDOW_SIZE];
+
+    slot->frame = frame;
+    frame->id = msg_id;
+    frame->seq = link->tx_next;
+    frame->length = length;
+    if (length > 0) {
+        memcpy(frame->data, data, length);
+    }
+    slot->frame_len = length;
+    slot->retries = 0;
+    slot->in_use = 1;
+
+    link->tx_next++;
+
+    *out = slot;
+    return HAL_OK;
+}
+
+/**
+ * @brief Envia mensagem pelo enlace confiável
+ * @param proto Contexto da porta
+ * @param msg_id ID da mensagem (não pode ser MSG_ACK/MSG_NACK/MSG_SYNC)
+ * @param data Dados úteis (pode ser NULL se length = 0)
+ * @param length Tamanho dos dados (máx. UART_LINK_MAX_DATA)
+ * @return HAL_OK se enviado, HAL_BUSY se a janela ou o pool estiverem cheios
+ *         ou se houver ressincronização (ou reinício) pendente
+ */
+HAL_StatusTypeDef UART_Link_Send(UART_Protocol_t *proto, uint8_t msg_id,
+                                 const uint8_t *data, uint16_t length)
+{
+    UART_LinkTxSlot_t *slot;
+    HAL_StatusTypeDef status = Link_Enqueue(proto, msg_id, data, length, &slot);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    UART_Transmit(proto, slot->frame, slot->frame_len);
+    slot->sent_tick = HAL_GetTick();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Envia um frame pré-montado pelo enlace confiável
+ * @note Só a primeira transmissão usa o template; retransmissões saem da
+ *       cópia guardada na janela, como as demais
+ */
+HAL_StatusTypeDef UART_Link_SendTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl)
+{
+    UART_LinkTxSlot_t *slot;
+    HAL_StatusTypeDef status = Link_Enqueue(proto, tpl->msg_id, &tpl->frame[5], tpl->length, &slot);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    UART_TransmitTemplate(proto, tpl, slot->frame->seq);
+    slot->sent_tick = HAL_GetTick();
+
+    return HAL_OK;
+}
+
+/* ============================================================================
+   RETRANSMISSÃO POR TIMEOUT
+   ============================================================================ */
+/**
+ * @brief Retransmite frames cujo RTO expirou (backoff exponencial)
+ * @note Frames que esgotam UART_LINK_MAX_RETRIES são descartados e o
+ *       receptor é ressincronizado (MSG_SYNC, repetido a cada RTO até o ACK).
+ *       O MSG_RESET do boot também é repetido a cada RTO até o ACK
+ */
+void UART_Link_Poll(UART_Protocol_t *proto)
+{
+    UART_LinkState_t *link = &proto->link;
+
+    if (proto->huart == NULL ||
+        (link->tx_base == link->tx_next && !link->sync_pending && !link->reset_pending)) {
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+    uint8_t timed_out = 0;
+
+    for (uint8_t seq = link->tx_base; seq != link->tx_next; seq++) {
+        UART_LinkTxSlot_t *slot = &link->tx_window[seq % UART_LINK_WINDOW_SIZE];
+
+        if (!slot->in_use || (now - slot->sent_tick) < link->rto_ms) {
+            continue;
+        }
+
+        if (slot->retries >= UART_LINK_MAX_RETRIES) {
+            // Desiste do frame: a base avança sobre ele em Link_SkipDropped
+            UART_MsgPool_Release(slot->frame);
+            slot->frame = NULL;
+            slot->in_use = 0;
+            link->dropped_frames++;
+            continue;
+        }
+
+        UART_Transmit(proto, slot->frame, slot->frame_len);
+        slot->sent_tick = now;
+        slot->retries++;
+        link->retransmissions++;
+        timed_out = 1;
+    }
+
+    Link_SkipDropped(proto);
+
+    if ((link->sync_pending || link->reset_pending) && (now - link->sync_tick) >= link->rto_ms) {
+        if (link->reset_pending) {
+            Link_SendControl(proto, MSG_RESET, link->tx_base);
+        }
+        if (link->sync_pending) {
+            Link_SendControl(proto, MSG_SYNC, link->tx_base);
+        }
+        link->sync_tick = now;
+        timed_out = 1;
+    }
+
+    // Backoff: dobra o RTO (uma vez por rodada) até a próxima amostra válida
+    if (timed_out) {
+        link->rto_ms *= 2;
+        if (link->rto_ms > UART_LINK_RTO_MAX_MS) link->rto_ms = UART_LINK_RTO_MAX_MS;
+    }
+}
+
+/* ============================================================================
+   RECEPÇÃO
+   ============================================================================ */
+/**
+ * @brief Entrega a próxima mensagem em ordem recebida na porta
+ * @return Buffer do pool (já sem o byte de SEQ) ou NULL se nada pendente
+ * @note Não bloqueia. A posse do buffer passa para o chamador, que deve
+ *       devolvê-lo com UART_MsgPool_Release
+ */
+UART_Message_t *UART_Link_Receive(UART_Protocol_t *proto)
+{
+    UART_LinkState_t *link = &proto->link;
+    UART_Message_t *frame;
+
+    UART_Link_Poll(proto);
+
+    while (link->rx_window[link->rx_next % UART_LINK_WINDOW_SIZE] == NULL) {
+        // Sequência descartada pelo transmissor (MSG_SYNC): pula a lacuna
+        if (link->rx_skip > 0) {
+            link->rx_next++;
+            link->rx_skip--;
+            if (link->rx_skip == 0) {
+                Link_SendControl(proto, MSG_ACK, link->rx_next);
+            }
+            continue;
+        }
+
+        frame = UART_ReadFrame(proto);
+        if (frame == NULL) {
+            return NULL;
+        }
+
+        switch (frame->id) {
+            case MSG_ACK:
+                Link_HandleAck(proto, frame->seq);
+                UART_MsgPool_Release(frame);
+                break;
+
+            case MSG_NACK:
+                Link_HandleNack(proto, frame->seq);
+                UART_MsgPool_Release(frame);
+                break;
+
+            case MSG_SYNC:
+                Link_HandleSync(proto, frame->seq);
+                UART_MsgPool_Release(frame);
+                break;
+
+            case MSG_RESET:
+                Link_HandleReset(proto, frame->seq);
+                UART_MsgPool_Release(frame);
+                break;
+
+            default:
+                Link_HandleData(proto, frame);
+                break;
+        }
+    }
+
+    // Entrega o frame em ordem e avança a janela
+    UART_Message_t **slot = &link->rx_window[link->rx_next % UART_LINK_WINDOW_SIZE];
+    UART_Message_t *msg = *slot;
+    *slot = NULL;
+    link->rx_next++;
+    if (link->rx_skip > 0) {
+        link->rx_skip--;    // Entregue dentro do trecho pedido pelo MSG_SYNC
+    }
+
+    if (link->nack_sent && link->nack_pending_seq != link->rx_next) {
+        link->nack_sent = 0;
+    }
+
+    // ACK cumulativo só depois de drenar os frames contíguos já recebidos
+    if (link->rx_window[link->rx_next % UART_LINK_WINDOW_SIZE] == NULL) {
+        Link_SendControl(proto, MSG_ACK, link->rx_next);
+    }
+
+    return msg;
+}
+
+/* ============================================================================
+   GETTERS
+   ============================================================================ */
+/**
+ * @brief Retorna quantos frames aguardam confirmação
+ */
+uint8_t UART_Link_GetInFlight(const UART_Protocol_t *proto)
+{
+    return (uint8_t)(proto->link.tx_next - proto->link.tx_base);
+}
+
+/**
+ * @brief Retorna o timeout de retransmissão atual (ms)
+ */
+uint32_t UART_Link_GetRTO(const UART_Protocol_t *proto)
+{
+    return proto->link.rto_ms;
+}
+
+/**
+ * @brief Retorna o total de retransmissões
+ */
+uint32_t UART_Link_GetRetransmissions(const UART_Protocol_t *proto)
+{
+    return proto->link.retransmissions;
+}
+
+/**
+ * @brief Retorna quantos frames foram descartados após UART_LINK_MAX_RETRIES
+ */
+uint32_t UART_Link_GetDroppedFrames(const UART_Protocol_t *proto)
+{
+    return proto->link.dropped_frames;
+}
+
+/**
+ * @brief Retorna quantas ressincronizações (MSG_SYNC) foram iniciadas
+ */
+uint32_t UART_Link_GetResyncs(const UART_Protocol_t *proto)
+{
+    return proto->link.resyncs;
+}
+
+/**
+ * @brief Retorna quantas vezes a recepção recomeçou por reinício da outra ponta
+ */
+uint32_t UART_Link_GetPeerResets(const UART_Protocol_t *proto)
+{
+    return proto->link.peer_resets;
+}
@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file    uart_msg_pool.c
+  * @brief   Pool de mensagens UART com aquisição/liberação explícitas
+  ******************************************************************************
+  */
+
+#include "uart_msg_pool.h"
+#include "main.h"
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+static UART_Message_t pool[UART_MSG_POOL_SIZE];
+static uint8_t free_list[UART_MSG_POOL_SIZE];   // Pilha de índices livres
+static uint8_t in_use[UART_MSG_POOL_SIZE];      // Detecta liberação dupla
+static uint8_t free_count = 0;
+static uint8_t low_water = UART_MSG_POOL_SIZE;
+static uint32_t acquire_failures = 0;
+
+/* ============================================================================
+   INICIALIZAÇÃO
+   ============================================================================ */
+/**
+ * @brief Marca todos os buffers como livres
+ * @note Não pode ser chamada com buffers ainda em posse de alguém
+ */
+void UART_MsgPool_Init(void)
+{
+    for (uint8_t i = 0; i < UART_MSG_POOL_SIZE; i++) {
+        free_list[i] = i;
+        in_use[i] = 0;
+    }
+
+    free_count = UART_MSG_POOL_SIZE;
+    low_water = UART_MSG_POOL_SIZE;
+    acquire_failures = 0;
+}
+
+/* ============================================================================
+   AQUISIÇÃO / LIBERAÇÃO
+   ============================================================================ */
+/**
+ * @brief Obtém um buffer livre do pool
+ * @return Ponteiro para o buffer (posse do chamador) ou NULL se esgotado
+ */
+UART_Message_t *UART_MsgPool_Acquire(void)
+{
+    UART_Message_t *msg = NULL;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (free_count > 0) {
+        uint8_t index = free_list[--free_count];
+        in_use[index] = 1;
+        msg = &pool[index];
+
+        if (free_count < low_water) {
+            low_water = free_count;
+        }
+    } else {
+        acquire_failures++;
+    }
+
+    __set_PRIMASK(primask);
+
+    if (msg != NULL) {
+        msg->id = 0;
+        msg->length = 0;
+    }
+
+    return msg;
+}
+
+/**
+ * @brief Devolve um buffer ao pool
+ * @param msg Buffer obtido com UART_MsgPool_Acquire (NULL é ignorado)
+ */
+void UART_MsgPool_Release(UART_Message_t *msg)
+{
+    if (msg == NULL || msg < &pool[0] || msg > &pool[UART_MSG_POOL_SIZE - 1]) {
+        return;
+    }
+
+    uint8_t index = (uint8_t)(msg - pool);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (in_use[index]) {
+        in_use[index] = 0;
+        free_list[free_count++] = index;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/* ============================================================================
+   GETTERS
+   ============================================================================ */
+uint8_t UART_MsgPool_GetFree(void)
+{
+    return free_count;
+}
+
+uint8_t UART_MsgPool_GetLowWater(void)
+{
+    return low_water;
+}
+
+uint32_t UART_MsgPool_GetFailures(void)
+{
+    return acquire_failures;
+}
@@ -1,33 +1,113 @@
 /**
   ******************************************************************************
   * @file    uart_protocol.c
-  * @brief   UART protocol implementation
+  * @brief   UART protocol implementation (motor comum a todas as portas)
   ******************************************************************************
   */
 
 #include "uart_protocol.h"
-#include "can_protocol.h"  // Para acessar missão atual
+#include "uart_msg_pool.h"
 #include "main.h"
 #include <string.h>
 
 /* ============================================================================
    VARIÁVEIS PRIVADAS
    ============================================================================ */
-static uint8_t rx_buffer[UART_MAX_PAYLOAD + 10];  // Buffer para recepção
-static UART_Message_t last_received_msg = {0};
-static volatile uint8_t msg_received_flag = 0;
+// Portas atendidas por UART_Protocol_Process
+static UART_Protocol_t *ports[UART_PROTOCOL_MAX_PORTS];
+static uint8_t port_count = 0;
 
-// Armazenamento dos resultados das missões
-typedef struct {
-    uint8_t oil_detected;        // Missão 1: Há derramamento? (0=não, 1=sim)
-    float oil_area_percentage;   // Missão 1: Área do óleo (%)
-    uint32_t ship_mmsi;          // Missão 2: ID do barco (MMSI)
-    float ship_origin_lat;       // Missão 2: Latitude origem
-    float ship_origin_lon;       // Missão 2: Longitude origem
-    uint8_t mission_complete;    // Flag indicando que missão terminou
-} MissionResults_t;
+/* ============================================================================
+   INICIALIZAÇÃO
+   ============================================================================ */
+/**
+ * @brief Inicializa uma porta do protocolo e a registra no motor
+ * @param proto Contexto da porta (estático: o DMA escreve nele)
+ * @param huart Handle da UART (com DMA de RX circular configurado em usart.c;
+ *              se também tiver hdmatx, a transmissão passa pelo anel de DMA)
+ * @param config Tabela de handlers e hook de polling (pode ser NULL)
+ * @return HAL_ERROR se não houver espaço no motor ou o DMA não iniciar
+ */
+HAL_StatusTypeDef UART_Protocol_Init(UART_Protocol_t *proto, UART_HandleTypeDef *huart,
+                                     const UART_ProtocolConfig_t *config)
+{
+    uint8_t registered = 0;
+
+    for (uint8_t i = 0; i < port_count; i++) {
+        if (ports[i] == proto) {
+            registered = 1;
+        }
+    }
+
+    if (!registered && port_count >= UART_PROTOCOL_MAX_PORTS) {
+        return HAL_ERROR;
+    }
+
+    // O pool é compartilhado: só é zerado antes da primeira porta
+    if (port_count == 0) {
+        UART_MsgPool_Init();
+    }
+
+    if (registered) {
+        UART_CancelRequests(proto);
+        UART_MsgPool_Release(proto->rx_frame);
+    }
+
+    proto->huart = huart;
+    proto->config = config;
+    proto->framing = UART_DEFAULT_FRAMING;
+    proto->rx_state = RX_STATE_START;
+    proto->rx_frame = NULL;
+    proto->rx_hunting = 0;
+    proto->rx_last_tick = 0;
+    proto->rx_checksum = 0;
+    proto->rx_cobs_count = 0;
+    proto->rx_cobs_discard = 0;
+    COBS_DecodeStart(&proto->rx_cobs);
+    memset(proto->requests, 0, sizeof(proto->requests));
+    memset(&proto->stats, 0, sizeof(proto->stats));
+
+    if (!registered) {
+        memset(&proto->link, 0, sizeof(proto->link));
+        ports[port_count++] = proto;
+    }
+    UART_Link_Init(proto);
 
-static MissionResults_t mission_results = {0};
+    if (huart->hdmatx != NULL) {
+        if (UART_DMA_StartTx(&proto->tx, huart, proto->tx_dma_buf,
+                             sizeof(proto->tx_dma_buf)) != HAL_OK) {
+            return HAL_ERROR;
+        }
+    } else {
+        memset(&proto->tx, 0, sizeof(proto->tx));
+    }
+
+    return UART_DMA_StartRx(&proto->rx, huart, proto->rx_dma_buf, sizeof(proto->rx_dma_buf));
+}
+
+/**
+ * @brief Seleciona o enquadramento usado na transmissão e na recepção
+ * @param mode UART_FRAMING_LEGACY ou UART_FRAMING_COBS
+ */
+void UART_SetFramingMode(UART_Protocol_t *proto, UART_FramingMode_t mode)
+{
+    proto->framing = mode;
+
+    // Descarta qualquer frame parcial do modo anterior
+    proto->rx_state = RX_STATE_START;
+    proto->rx_checksum = 0;
+    proto->rx_cobs_count = 0;
+    proto->rx_cobs_discard = 0;
+    COBS_DecodeStart(&proto->rx_cobs);
+}
+
+/**
+ * @brief Retorna o enquadramento atual da porta
+ */
+UART_FramingMode_t UART_GetFramingMode(const UART_Protocol_t *proto)
+{
+    return proto->framing;
+}
 
 /* ============================================================================
    CÁLCULO DE CHECKSUM
@@ -57,396 +137,790 @@ uint8_t CalculateChecksum(uint8_t msg_id, uint16_t length, uint8_t *data)
 /* ============================================================================
    TRANSMISSÃO UART
    ============================================================================ */
+/* Frame sendo montado direto no destino: anel de DMA (a escrita dá a volta
+   no fim) ou tx_buffer nas portas sem DMA de TX */
+typedef struct {
+    uint8_t *buf;
+    uint16_t size;
+    uint16_t pos;               // LEGACY: próxima posição
+    uint16_t len;               // LEGACY: bytes escritos
+    uint8_t checksum;           // XOR acumulado (o cabeçalho entra mesmo em COBS)
+    COBS_Encoder_t cobs;
+} UART_FrameWriter_t;
+
+/**
+ * @brief Grava um byte bruto do frame (codificado, em COBS)
+ */
+static void UART_FramePut(UART_Protocol_t *proto, UART_FrameWriter_t *w, uint8_t byte)
+{
+    if (proto->framing == UART_FRAMING_COBS) {
+        COBS_EncodePut(&w->cobs, byte);
+        return;
+    }
+
+    w->buf[w->pos++] = byte;
+    if (w->pos == w->size) {
+        w->pos = 0;
+    }
+    w->len++;
+}
+
+/**
+ * @brief Reserva o destino e grava o cabeçalho do frame
+ * @param length Campo de dados no fio (byte do enlace + dados)
+ * @return 0 se o anel de TX estiver cheio: o frame é descartado (contado em
+ *         tx.drops) e o enlace confiável retransmite por timeout
+ */
+static uint8_t UART_FrameBegin(UART_Protocol_t *proto, UART_FrameWriter_t *w,
+                               uint8_t msg_id, uint16_t length)
+{
+    uint16_t start = 0;
+    uint8_t len_h = (length >> 8) & 0xFF;
+    uint8_t len_l = length & 0xFF;
+
+    if (proto->tx.huart != NULL) {
+        // Pior caso dos dois enquadramentos (length <= UART_MAX_PAYLOAD):
+        // START+ID+LEN+CHK ou ID+CHK com overhead do COBS e o 0x00
+        if (UART_DMA_Reserve(&proto->tx, length + 5, &start) != HAL_OK) {
+            return 0;
+        }
+        w->buf = proto->tx.buf;
+        w->size = proto->tx.size;
+    } else {
+        w->buf = proto->tx_buffer;
+        w->size = sizeof(proto->tx_buffer);
+    }
+
+    w->pos = start;
+    w->len = 0;
+    w->checksum = UART_START_BYTE ^ msg_id ^ len_h ^ len_l;
+
+    if (proto->framing == UART_FRAMING_COBS) {
+        COBS_EncodeStart(&w->cobs, w->buf, w->size, start);
+    } else {
+        UART_FramePut(proto, w, UART_START_BYTE);
+    }
+    UART_FramePut(proto, w, msg_id);
+    if (proto->framing == UART_FRAMING_LEGACY) {
+        UART_FramePut(proto, w, len_h);
+        UART_FramePut(proto, w, len_l);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Grava dados do frame (entram no checksum)
+ */
+static void UART_FrameData(UART_Protocol_t *proto, UART_FrameWriter_t *w,
+                           const uint8_t *data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        w->checksum ^= data[i];
+        UART_FramePut(proto, w, data[i]);
+    }
+}
+
+/**
+ * @brief Fecha o frame com o checksum e o entrega à UART
+ */
+static void UART_FrameEnd(UART_Protocol_t *proto, UART_FrameWriter_t *w, uint8_t checksum)
+{
+    UART_FramePut(proto, w, checksum);
+
+    uint16_t len = (proto->framing == UART_FRAMING_COBS) ? COBS_EncodeFinish(&w->cobs) : w->len;
+
+    proto->stats.tx_frames++;
+    proto->stats.tx_bytes += len;
+
+    if (proto->tx.huart != NULL) {
+        UART_DMA_Commit(&proto->tx, len);
+    } else {
+        HAL_UART_Transmit(proto->huart, w->buf, len, HAL_MAX_DELAY);
+    }
+}
+
 /**
  * @brief Transmite mensagem via UART com protocolo
- * @param huart Handle da UART
- * @param msg Estrutura da mensagem a enviar
- * @param size Tamanho dos dados úteis
+ * @param proto Contexto da porta
+ * @param msg Mensagem: msg->seq é o primeiro byte do campo de dados no fio
+ * @param size Tamanho de msg->data a enviar
+ * @note O frame é montado direto no anel de TX do DMA (ou em tx_buffer, se
+ *       a porta não tiver DMA de TX): chamar apenas do loop principal
  */
-void UART_Transmit(UART_HandleTypeDef *huart, UART_Message_t *msg, uint16_t size)
+void UART_Transmit(UART_Protocol_t *proto, UART_Message_t *msg, uint16_t size)
 {
-    uint8_t tx_buffer[UART_MAX_PAYLOAD + 10];
-    uint16_t tx_index = 0;
-    
-    // Monta o frame: [START][ID][LEN_H][LEN_L][DATA...][CHECKSUM]
-    tx_buffer[tx_index++] = UART_START_BYTE;
-    tx_buffer[tx_index++] = msg->id;
-    tx_buffer[tx_index++] = (size >> 8) & 0xFF;   // Length high byte
-    tx_buffer[tx_index++] = size & 0xFF;          // Length low byte
-    
-    // Copia dados
-    for (uint16_t i = 0; i < size; i++) {
-        tx_buffer[tx_index++] = msg->data[i];
+    UART_FrameWriter_t w;
+
+    if (!UART_FrameBegin(proto, &w, msg->id, size + 1)) {
+        return;
     }
-    
-    // Adiciona checksum
-    uint8_t checksum = CalculateChecksum(msg->id, size, msg->data);
-    tx_buffer[tx_index++] = checksum;
-    
-    // Transmite via UART
-    HAL_UART_Transmit(huart, tx_buffer, tx_index, HAL_MAX_DELAY);
+
+    UART_FrameData(proto, &w, &msg->seq, 1);
+    UART_FrameData(proto, &w, msg->data, size);
+    UART_FrameEnd(proto, &w, w.checksum);
 }
 
 /* ============================================================================
-   RECEPÇÃO UART
+   FRAMES PRÉ-MONTADOS
    ============================================================================ */
 /**
- * @brief Recebe e valida mensagem UART
- * @param huart Handle da UART
- * @return Estrutura com mensagem recebida (id=0 se erro)
+ * @brief Monta o frame de um comando fixo para envio pelo enlace confiável
+ * @param tpl Template a preencher (normalmente estático)
+ * @param msg_id ID da mensagem (não pode ser de controle do enlace)
+ * @param data Dados fixos do comando (pode ser NULL se length = 0)
+ * @param length Até UART_TEMPLATE_MAX_DATA bytes
+ * @note O frame fica no formato LEGACY com SEQ = 0; em COBS a codificação
+ *       ainda é feita no envio
  */
-UART_Message_t UART_Receive(UART_HandleTypeDef *huart)
+HAL_StatusTypeDef UART_Template_Init(UART_FrameTemplate_t *tpl, uint8_t msg_id,
+                                     const uint8_t *data, uint16_t length)
 {
-    UART_Message_t msg = {0};
-    uint8_t byte;
-    uint16_t rx_index = 0;
-    
-    // 1. Aguarda START_BYTE
-    if (HAL_UART_Receive(huart, &byte, 1, 1000) != HAL_OK) {
-        return msg;  // Timeout ou erro
+    if (length > UART_TEMPLATE_MAX_DATA ||
+        msg_id == MSG_ACK || msg_id == MSG_NACK || msg_id == MSG_SYNC || msg_id == MSG_RESET) {
+        return HAL_ERROR;
     }
-    
-    if (byte != UART_START_BYTE) {
-        return msg;  // Byte inicial inválido
+
+    uint16_t size = length + 1;     // SEQ + dados
+    uint8_t *frame = tpl->frame;
+
+    tpl->msg_id = msg_id;
+    tpl->length = length;
+
+    frame[0] = UART_START_BYTE;
+    frame[1] = msg_id;
+    frame[2] = (size >> 8) & 0xFF;
+    frame[3] = size & 0xFF;
+    frame[4] = 0;                   // SEQ
+    if (length > 0) {
+        memcpy(&frame[5], data, length);
     }
-    
-    rx_buffer[rx_index++] = byte;
-    
-    // 2. Recebe ID
-    if (HAL_UART_Receive(huart, &byte, 1, 100) != HAL_OK) return msg;
-    msg.id = byte;
-    rx_buffer[rx_index++] = byte;
-    
-    // 3. Recebe LENGTH (2 bytes)
-    uint8_t len_h, len_l;
-    if (HAL_UART_Receive(huart, &len_h, 1, 100) != HAL_OK) return msg;
-    if (HAL_UART_Receive(huart, &len_l, 1, 100) != HAL_OK) return msg;
-    
-    uint16_t length = (len_h << 8) | len_l;
-    rx_buffer[rx_index++] = len_h;
-    rx_buffer[rx_index++] = len_l;
-    
-    // Validação de tamanho
-    if (length > UART_MAX_PAYLOAD) {
-        msg.id = 0;  // Erro
-        return msg;
+    frame[5 + length] = CalculateChecksum(msg_id, size, &frame[4]);
+    tpl->frame_len = 6 + length;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Transmite o frame pré-montado com o número de sequência do enlace
+ * @note O checksum do template só é corrigido pelo SEQ (XOR). Chamar apenas
+ *       do loop principal (ou do despacho do CAN, que também roda nele)
+ */
+void UART_TransmitTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl, uint8_t seq)
+{
+    UART_FrameWriter_t w;
+
+    if (!UART_FrameBegin(proto, &w, tpl->msg_id, tpl->length + 1)) {
+        return;
     }
-    
-    msg.length = length;
-    
-    // 4. Recebe DATA
-    for (uint16_t i = 0; i < length; i++) {
-        if (HAL_UART_Receive(huart, &byte, 1, 100) != HAL_OK) {
-            msg.id = 0;
-            return msg;
+
+    // Bytes brutos: o checksum já vem pronto no template
+    UART_FramePut(proto, &w, seq);
+    for (uint16_t i = 0; i < tpl->length; i++) {
+        UART_FramePut(proto, &w, tpl->frame[5 + i]);
+    }
+    UART_FrameEnd(proto, &w, tpl->frame[tpl->frame_len - 1] ^ seq);
+}
+
+/* ============================================================================
+   RECEPÇÃO UART
+   ============================================================================ */
+/**
+ * @brief Buffer do pool para o frame que começa (reaproveita o de um frame
+ *        descartado, se houver)
+ * @return NULL se o pool estiver vazio (o frame é perdido; o enlace
+ *         recupera por retransmissão)
+ */
+static UART_Message_t *UART_RxFrameBuffer(UART_Protocol_t *proto)
+{
+    if (proto->rx_frame == NULL) {
+        proto->rx_frame = UART_MsgPool_Acquire();
+        if (proto->rx_frame == NULL) {
+            proto->stats.pool_drops++;
         }
-        msg.data[i] = byte;
-        rx_buffer[rx_index++] = byte;
     }
-    
-    // 5. Recebe CHECKSUM
-    uint8_t received_checksum;
-    if (HAL_UART_Receive(huart, &received_checksum, 1, 100) != HAL_OK) {
-        msg.id = 0;
-        return msg;
+
+    return proto->rx_frame;
+}
+
+/**
+ * @brief Passa um byte pelo parser COBS
+ * @return Buffer do pool quando o byte fecha um frame válido, senão NULL
+ * @note Decodifica direto no buffer do pool: [ID][SEQ][DATA...][CHECKSUM].
+ *       Só no delimitador se sabe qual foi o último byte (o checksum), por
+ *       isso cada byte decodificado fica retido até chegar o seguinte
+ */
+static UART_Message_t *UART_ParseByteCOBS(UART_Protocol_t *proto, uint8_t byte)
+{
+    uint16_t count = proto->rx_cobs_count;
+    uint8_t out;
+
+    if (byte != COBS_DELIMITER) {
+        if (proto->rx_cobs_discard) {
+            return NULL;
+        }
+        if (count == 0 && proto->rx_cobs.code == 0 && UART_RxFrameBuffer(proto) == NULL) {
+            proto->rx_cobs_discard = 1;     // Sem buffer: espera o próximo frame
+            return NULL;
+        }
+        if (!COBS_DecodePut(&proto->rx_cobs, byte, &out)) {
+            return NULL;
+        }
+
+        // O byte retido não era o checksum: vai para o seu lugar
+        if (count == 1) {
+            proto->rx_frame->id = proto->rx_cobs_held;
+        } else if (count == 2) {
+            proto->rx_frame->seq = proto->rx_cobs_held;
+        } else if (count > 2) {
+            if (count - 3 >= UART_MAX_PAYLOAD - 1) {
+                // Longo demais: descarta até o delimitador
+                proto->rx_cobs_discard = 1;
+                proto->stats.resyncs++;
+                proto->stats.framing_errors++;
+                return NULL;
+            }
+            proto->rx_frame->data[count - 3] = proto->rx_cobs_held;
+        }
+
+        proto->rx_checksum ^= out;
+        proto->rx_cobs_held = out;
+        proto->rx_cobs_count = count + 1;
+        return NULL;
     }
-    
-    // 6. Valida CHECKSUM
-    uint8_t calculated_checksum = CalculateChecksum(msg.id, length, msg.data);
-    
-    if (received_checksum != calculated_checksum) {
-        msg.id = 0;  // Checksum inválido
-        return msg;
+
+    // Delimitador: fecha o frame e já fica sincronizado para o próximo
+    uint8_t started = (proto->rx_cobs.code != 0) && !proto->rx_cobs_discard;
+    uint8_t valid = COBS_DecodeValid(&proto->rx_cobs);
+    uint8_t checksum = proto->rx_checksum;
+
+    COBS_DecodeStart(&proto->rx_cobs);
+    proto->rx_cobs_count = 0;
+    proto->rx_cobs_discard = 0;
+    proto->rx_checksum = 0;
+
+    if (!started) {
+        return NULL;    // Delimitador repetido ou frame já descartado
     }
-    
+
+    // ID + SEQ + CHECKSUM no mínimo; o tamanho no fio inclui o SEQ
+    if (!valid || count < 3) {
+        proto->stats.framing_errors++;
+        return NULL;
+    }
+
+    // XOR de START, ID, LEN, SEQ, dados e checksum dá zero
+    uint16_t length = count - 2;
+    checksum ^= UART_START_BYTE ^ ((length >> 8) & 0xFF) ^ (length & 0xFF);
+    if (checksum != 0) {
+        proto->stats.checksum_errors++;
+        return NULL;
+    }
+
+    UART_Message_t *msg = proto->rx_frame;
+    msg->length = length - 1;
+    proto->rx_frame = NULL;  // Posse passa para o chamador
+    proto->stats.rx_frames++;
     return msg;
 }
 
-/* ============================================================================
-   PROCESSAMENTO DE RESPOSTAS DO PAYLOAD
-   ============================================================================ */
 /**
- * @brief Processa respostas recebidas do Payload
+ * @brief Passa um byte pelo parser LEGACY
+ * @return Buffer do pool quando o byte fecha um frame válido, senão NULL
+ * @note O frame é montado direto no buffer do pool, sem cópias; o byte do
+ *       enlace vai para msg->seq
  */
-void Check_Payload_Response(void)
+static UART_Message_t *UART_ParseByteLegacy(UART_Protocol_t *proto, uint8_t byte)
 {
-    UART_Message_t msg = UART_Receive(&huart5);
-    
-    if (msg.id == 0) {
-        return;  // Nenhuma mensagem válida ou erro
-    }
-    
-    switch (msg.id) {
-        case MSG_RES_M1_OIL:
-            // Resposta da Missão 1: Detecção de óleo
-            // Formato: [oil_detected(1)] [area_percentage(4 bytes float)]
-            if (msg.length >= 5) {
-                mission_results.oil_detected = msg.data[0];
-                
-                // Extrai float (4 bytes, little-endian)
-                uint32_t temp;
-                memcpy(&temp, &msg.data[1], 4);
-                memcpy(&mission_results.oil_area_percentage, &temp, 4);
-                
-                mission_results.mission_complete = 1;
+    proto->rx_checksum ^= byte;
+
+    switch (proto->rx_state) {
+        case RX_STATE_START:
+            if (byte != UART_START_BYTE) {
+                // Conta uma ressincronização por trecho de lixo, não por byte
+                if (!proto->rx_hunting) {
+                    proto->rx_hunting = 1;
+                    proto->stats.resyncs++;
+                }
+                break;
             }
-            break;
-            
-        case MSG_RES_M2_SHIP:
-            // Resposta da Missão 2: Identificação do barco
-            // Formato: [mmsi(4)] [lat(4 float)] [lon(4 float)]
-            if (msg.length >= 12) {
-                // MMSI (4 bytes)
-                mission_results.ship_mmsi = ((uint32_t)msg.data[0] << 24) |
-                                            ((uint32_t)msg.data[1] << 16) |
-                                            ((uint32_t)msg.data[2] << 8)  |
-                                             (uint32_t)msg.data[3];
-                
-                // Latitude (4 bytes float)
-                uint32_t temp_lat;
-                memcpy(&temp_lat, &msg.data[4], 4);
-                memcpy(&mission_results.ship_origin_lat, &temp_lat, 4);
-                
-                // Longitude (4 bytes float)
-                uint32_t temp_lon;
-                memcpy(&temp_lon, &msg.data[8], 4);
-                memcpy(&mission_results.ship_origin_lon, &temp_lon, 4);
-                
-                mission_results.mission_complete = 1;
+            proto->rx_hunting = 0;
+            if (UART_RxFrameBuffer(proto) != NULL) {
+                proto->rx_checksum = UART_START_BYTE;
+                proto->rx_state = RX_STATE_ID;
             }
             break;
-            
-        case MSG_ACK:
-            // Payload confirmou recebimento
-            // TODO: Implementar lógica se necessário
+
+        case RX_STATE_ID:
+            proto->rx_frame->id = byte;
+            proto->rx_state = RX_STATE_LEN_H;
             break;
-            
-        case MSG_ERROR:
-            // Payload reportou erro
-            // TODO: Implementar tratamento de erro
-            mission_results.mission_complete = 0;
+
+        case RX_STATE_LEN_H:
+            proto->rx_frame_length = (uint16_t)byte << 8;
+            proto->rx_state = RX_STATE_LEN_L;
             break;
-            
-        default:
-            // Mensagem desconhecida
+
+        case RX_STATE_LEN_L:
+            proto->rx_frame_length |= byte;
+            proto->rx_frame_index = 0;
+            if (proto->rx_frame_length == 0 || proto->rx_frame_length > UART_MAX_PAYLOAD) {
+                proto->stats.framing_errors++;
+                proto->rx_state = RX_STATE_START;  // Tamanho inválido: ressincroniza
+            } else {
+                proto->rx_state = RX_STATE_SEQ;
+            }
+            break;
+
+        case RX_STATE_SEQ:
+            proto->rx_frame->seq = byte;
+            proto->rx_state = (proto->rx_frame_length > 1) ? RX_STATE_DATA : RX_STATE_CHECKSUM;
+            break;
+
+        case RX_STATE_DATA:
+            proto->rx_frame->data[proto->rx_frame_index++] = byte;
+            if (proto->rx_frame_index >= proto->rx_frame_length - 1) {
+                proto->rx_state = RX_STATE_CHECKSUM;
+            }
             break;
+
+        case RX_STATE_CHECKSUM:
+            proto->rx_state = RX_STATE_START;
+            // XOR de todos os bytes, inclusive o checksum, dá zero
+            if (proto->rx_checksum == 0) {
+                UART_Message_t *msg = proto->rx_frame;
+                msg->length = proto->rx_frame_length - 1;
+                proto->rx_frame = NULL;  // Posse passa para o chamador
+                proto->stats.rx_frames++;
+                return msg;
+            }
+            proto->stats.checksum_errors++;
+            break;  // Checksum inválido: descarta frame
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Extrai o próximo frame válido do buffer do DMA (não bloqueante)
+ * @param proto Contexto da porta
+ * @return Buffer do pool com o frame (posse do chamador) ou NULL
+ * @note Lê os bytes direto do buffer circular do DMA e para no primeiro
+ *       frame completo; o restante fica para a próxima chamada
+ */
+UART_Message_t *UART_ReadFrame(UART_Protocol_t *proto)
+{
+    const uint8_t *data;
+    uint16_t available;
+
+    while ((available = UART_DMA_Peek(&proto->rx, &data)) > 0) {
+        // Um tamanho corrompido deixaria o parser esperando bytes que não
+        // vêm (ou engolindo os frames seguintes): depois de um silêncio
+        // maior que o tempo de linha de meio buffer, recomeça no próximo início
+        uint32_t now = HAL_GetTick();
+        if (proto->framing == UART_FRAMING_LEGACY && proto->rx_state != RX_STATE_START &&
+            (now - proto->rx_last_tick) > UART_RX_FRAME_TIMEOUT_MS) {
+            proto->rx_state = RX_STATE_START;
+            proto->stats.framing_errors++;
+        }
+        proto->rx_last_tick = now;
+
+        for (uint16_t i = 0; i < available; i++) {
+            uint8_t byte = data[i];
+            UART_Message_t *msg = NULL;
+
+            if (proto->framing == UART_FRAMING_COBS) {
+                msg = UART_ParseByteCOBS(proto, byte);
+            } else {
+                msg = UART_ParseByteLegacy(proto, byte);
+            }
+
+            if (msg != NULL) {
+                UART_DMA_Consume(&proto->rx, i + 1);
+                proto->stats.rx_bytes += i + 1;
+                return msg;
+            }
+        }
+
+        UART_DMA_Consume(&proto->rx, available);
+        proto->stats.rx_bytes += available;
     }
+
+    return NULL;
 }
 
 /* ============================================================================
-   FUNÇÕES DE CONTROLE DE MISSÃO
+   REQUISIÇÕES ASSÍNCRONAS
    ============================================================================ */
 /**
- * @brief Inicia Missão 1 enviando comando ao Payload
+ * @brief Conclui a requisição pendente mais antiga que espera response_id
+ * @param response_id ID recebido (MSG_ERROR conclui a mais antiga de todas)
+ * @param status Resultado entregue ao callback
+ * @param response Mensagem recebida (NULL em timeout/cancelamento)
  */
-void UART_StartMission1(void)
+static void UART_CompleteRequest(UART_Protocol_t *proto, uint8_t response_id,
+                                 UART_RequestStatus_t status, const UART_Message_t *response)
 {
-    UART_Message_t msg;
-    msg.id = MSG_CMD_START_M1;
-    msg.length = 0;  // Sem dados adicionais
-    
-    UART_Transmit(&huart5, &msg, 0);
-    
-    // Reseta resultados
-    mission_results.mission_complete = 0;
-    mission_results.oil_detected = 0;
-    mission_results.oil_area_percentage = 0.0f;
+    UART_PendingRequest_t *oldest = NULL;
+
+    for (uint8_t i = 0; i < UART_MAX_PENDING_REQUESTS; i++) {
+        UART_PendingRequest_t *req = &proto->requests[i];
+        if (!req->in_use || (response_id != MSG_ERROR && req->response_id != response_id)) {
+            continue;
+        }
+        if (oldest == NULL || (int32_t)(req->sent_tick - oldest->sent_tick) < 0) {
+            oldest = req;
+        }
+    }
+
+    if (oldest == NULL) {
+        return;  // Resposta não solicitada
+    }
+
+    // Libera a entrada antes do callback (que pode mandar outra requisição)
+    UART_ResponseCallback_t callback = oldest->callback;
+    void *context = oldest->context;
+    oldest->in_use = 0;
+
+    if (status == UART_REQ_OK) {
+        UART_Stats_RecordRtt(proto, UART_RTT_REQUEST, oldest->cmd_id,
+                             HAL_GetTick() - oldest->sent_tick);
+    } else if (status == UART_REQ_ERROR) {
+        proto->stats.req_errors++;
+    }
+
+    if (callback != NULL) {
+        callback(status, response, context);
+    }
 }
 
 /**
- * @brief Inicia Missão 2 enviando comando ao Payload
+ * @brief Encerra por timeout as requisições sem resposta
  */
-void UART_StartMission2(void)
+static void UART_PollRequests(UART_Protocol_t *proto)
 {
-    UART_Message_t msg;
-    msg.id = MSG_CMD_START_M2;
-    msg.length = 0;  // Sem dados adicionais
-    
-    UART_Transmit(&huart5, &msg, 0);
-    
-    // Reseta resultados
-    mission_results.mission_complete = 0;
-    mission_results.ship_mmsi = 0;
-    mission_results.ship_origin_lat = 0.0f;
-    mission_results.ship_origin_lon = 0.0f;
+    uint32_t now = HAL_GetTick();
+
+    for (uint8_t i = 0; i < UART_MAX_PENDING_REQUESTS; i++) {
+        UART_PendingRequest_t *req = &proto->requests[i];
+        if (!req->in_use || (now - req->sent_tick) < req->timeout_ms) {
+            continue;
+        }
+
+        UART_ResponseCallback_t callback = req->callback;
+        void *context = req->context;
+        req->in_use = 0;
+        proto->stats.req_timeouts++;
+
+        if (callback != NULL) {
+            callback(UART_REQ_TIMEOUT, NULL, context);
+        }
+    }
 }
 
 /**
- * @brief Envia dados AIS para o Payload (Missão 2)
- * @param ais_data Ponteiro para dados AIS (8 bytes)
+ * @brief Primeira entrada livre da tabela de requisições (NULL = cheia)
  */
-void UART_SendAISData(uint8_t *ais_data)
+static UART_PendingRequest_t *UART_FreeRequest(UART_Protocol_t *proto)
 {
-    UART_Message_t msg;
-    msg.id = MSG_DATA_AIS;
-    msg.length = 8;  // 8 bytes de dados AIS
-    
-    memcpy(msg.data, ais_data, 8);
-    
-    UART_Transmit(&huart5, &msg, 8);
+    for (uint8_t i = 0; i < UART_MAX_PENDING_REQUESTS; i++) {
+        if (!proto->requests[i].in_use) {
+            return &proto->requests[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Registra a requisição já enviada
+ */
+static void UART_ArmRequest(UART_PendingRequest_t *req, uint8_t cmd_id, uint8_t response_id,
+                            uint32_t timeout_ms, UART_ResponseCallback_t callback, void *context)
+{
+    req->cmd_id = cmd_id;
+    req->response_id = response_id;
+    req->sent_tick = HAL_GetTick();
+    req->timeout_ms = timeout_ms;
+    req->callback = callback;
+    req->context = context;
+    req->in_use = 1;
+}
+
+/**
+ * @brief Envia um comando e registra o callback da resposta
+ * @param proto Contexto da porta
+ * @param cmd_id ID do comando
+ * @param data Dados do comando (pode ser NULL se length = 0)
+ * @param length Tamanho dos dados
+ * @param response_id ID que conclui a requisição
+ * @param timeout_ms Prazo para a resposta, contado a partir do envio
+ * @param callback Chamado uma única vez com o resultado (pode ser NULL)
+ * @param context Ponteiro repassado ao callback
+ * @return HAL_BUSY se a tabela de requisições ou a janela do enlace estiverem
+ *         cheias (nada é registrado nesse caso)
+ */
+HAL_StatusTypeDef UART_SendRequest(UART_Protocol_t *proto, uint8_t cmd_id,
+                                   const uint8_t *data, uint16_t length,
+                                   uint8_t response_id, uint32_t timeout_ms,
+                                   UART_ResponseCallback_t callback, void *context)
+{
+    UART_PendingRequest_t *req = UART_FreeRequest(proto);
+    if (req == NULL) {
+        return HAL_BUSY;
+    }
+
+    HAL_StatusTypeDef status = UART_Link_Send(proto, cmd_id, data, length);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    UART_ArmRequest(req, cmd_id, response_id, timeout_ms, callback, context);
+    return HAL_OK;
+}
+
+/**
+ * @brief Como UART_SendRequest, mas com o comando já montado em um template
+ * @note Caminho do despacho de comandos do CAN (payload_bridge.c)
+ */
+HAL_StatusTypeDef UART_SendRequestTemplate(UART_Protocol_t *proto, const UART_FrameTemplate_t *tpl,
+                                           uint8_t response_id, uint32_t timeout_ms,
+                                           UART_ResponseCallback_t callback, void *context)
+{
+    UART_PendingRequest_t *req = UART_FreeRequest(proto);
+    if (req == NULL) {
+        return HAL_BUSY;
+    }
+
+    HAL_StatusTypeDef status = UART_Link_SendTemplate(proto, tpl);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    UART_ArmRequest(req, tpl->msg_id, response_id, timeout_ms, callback, context);
+    return HAL_OK;
+}
+
+/**
+ * @brief Cancela todas as requisições pendentes (callbacks com UART_REQ_CANCELLED)
+ */
+void UART_CancelRequests(UART_Protocol_t *proto)
+{
+    for (uint8_t i = 0; i < UART_MAX_PENDING_REQUESTS; i++) {
+        UART_PendingRequest_t *req = &proto->requests[i];
+        if (!req->in_use) {
+            continue;
+        }
+
+        req->in_use = 0;
+        if (req->callback != NULL) {
+            req->callback(UART_REQ_CANCELLED, NULL, req->context);
+        }
+    }
+}
+
+/**
+ * @brief Verifica se há requisição aguardando a resposta response_id
+ */
+uint8_t UART_IsRequestPending(const UART_Protocol_t *proto, uint8_t response_id)
+{
+    for (uint8_t i = 0; i < UART_MAX_PENDING_REQUESTS; i++) {
+        if (proto->requests[i].in_use && proto->requests[i].response_id == response_id) {
+            return 1;
+        }
+    }
+
+    return 0;
 }
 
 /* ============================================================================
-   INTEGRAÇÃO COM CAN PROTOCOL
+   MOTOR DO PROTOCOLO
    ============================================================================ */
 /**
- * @brief Processa missão baseado no estado do CAN
- *        Deve ser chamada no loop principal
+ * @brief Entrega a mensagem ao handler da tabela e conclui a requisição
+ * @param msg Buffer do pool (sem o byte de sequência); devolvido ao pool aqui
  */
-void UART_ProcessMission(void)
+static void UART_Dispatch(UART_Protocol_t *proto, UART_Message_t *msg)
 {
-        MissionType_t mission = CAN_GetMissionType();
-        
-        static uint8_t mission_started = 0;
-        
-        switch (mission) {
-            case MISSION_1:
-                if (!mission_started) {
-                    UART_StartMission1();
-                    mission_started = 1;
-                }
-                
-                // Verifica resposta do Payload
-                Check_Payload_Response();
-                
-                // Se missão completou, pode processar resultado
-                if (mission_results.mission_complete) {
-                    // Enviar resultado via CAN para COM
-                    CAN_Message_t payloadResponse;
-                    payloadResponse.id = CAN_CDH_TELEMETRY;  // 0x100 - Telemetria geral
-                    
-                    // Formato: [mission_type(1)] [oil_detected(1)] [area_percentage(4 bytes)] [unused(2)]
-                    payloadResponse.data[0] = MISSION_1;
-                    payloadResponse.data[1] = mission_results.oil_detected;
-                    
-                    // Converte float para bytes (little-endian)
-                    uint32_t area_temp;
-                    memcpy(&area_temp, &mission_results.oil_area_percentage, 4);
-                    payloadResponse.data[2] = (area_temp >> 24) & 0xFF;
-                    payloadResponse.data[3] = (area_temp >> 16) & 0xFF;
-                    payloadResponse.data[4] = (area_temp >> 8) & 0xFF;
-                    payloadResponse.data[5] = area_temp & 0xFF;
-                    payloadResponse.data[6] = 0;  // Unused
-                    payloadResponse.data[7] = 0;  // Unused
-                    
-                    CAN_Transmit(&payloadResponse);
-                    mission_started = 0;  // Permite nova execução
-                    mission_results.mission_complete = 0;  // Reseta flag
-                }
-                break;
-                
-            case MISSION_2:
-                if (!mission_started) {
-                    UART_StartMission2();
-                    mission_started = 1;
-                }
-                
-                // Verifica resposta do Payload
-                Check_Payload_Response();
-                
-                if (mission_results.mission_complete) {
-                    // Enviar resultado via CAN - Mensagem 1: MMSI
-                    CAN_Message_t payloadResponse;
-                    payloadResponse.id = CAN_CDH_TELEMETRY;  // 0x100 - Telemetria geral
-                    
-                    // Formato MSG 1: [mission_type(1)] [packet_id(1)] [mmsi(4 bytes)] [unused(2)]
-                    payloadResponse.data[0] = MISSION_2;
-                    payloadResponse.data[1] = 0x01;  // Packet 1 - MMSI
-                    payloadResponse.data[2] = (mission_results.ship_mmsi >> 24) & 0xFF;
-                    payloadResponse.data[3] = (mission_results.ship_mmsi >> 16) & 0xFF;
-                    payloadResponse.data[4] = (mission_results.ship_mmsi >> 8) & 0xFF;
-                    payloadResponse.data[5] = mission_results.ship_mmsi & 0xFF;
-                    payloadResponse.data[6] = 0;
-                    payloadResponse.data[7] = 0;
-                    
-                    CAN_Transmit(&payloadResponse);
-                    HAL_Delay(5);  // Pequeno delay entre mensagens
-                    
-                    // Mensagem 2: Latitude
-                    payloadResponse.data[1] = 0x02;  // Packet 2 - Latitude
-                    uint32_t lat_temp;
-                    memcpy(&lat_temp, &mission_results.ship_origin_lat, 4);
-                    payloadResponse.data[2] = (lat_temp >> 24) & 0xFF;
-                    payloadResponse.data[3] = (lat_temp >> 16) & 0xFF;
-                    payloadResponse.data[4] = (lat_temp >> 8) & 0xFF;
-                    payloadResponse.data[5] = lat_temp & 0xFF;
-                    payloadResponse.data[6] = 0;
-                    payloadResponse.data[7] = 0;
-                    
-                    CAN_Transmit(&payloadResponse);
-                    HAL_Delay(5);
-                    
-                    // Mensagem 3: Longitude
-                    payloadResponse.data[1] = 0x03;  // Packet 3 - Longitude
-                    uint32_t lon_temp;
-                    memcpy(&lon_temp, &mission_results.ship_origin_lon, 4);
-                    payloadResponse.data[2] = (lon_temp >> 24) & 0xFF;
-                    payloadResponse.data[3] = (lon_temp >> 16) & 0xFF;
-                    payloadResponse.data[4] = (lon_temp >> 8) & 0xFF;
-                    payloadResponse.data[5] = lon_temp & 0xFF;
-                    payloadResponse.data[6] = 0;
-                    payloadResponse.data[7] = 0;
-                    
-                    CAN_Transmit(&payloadResponse);
-                    
-                    mission_started = 0;
-                    mission_results.mission_complete = 0;  // Reseta flag
-                }
-                break;
-                
-            default:
-                mission_started = 0;
+    const UART_ProtocolConfig_t *config = proto->config;
+    uint8_t handled = 0;
+
+    if (config != NULL) {
+        for (uint8_t i = 0; i < config->handler_count; i++) {
+            if (config->handlers[i].msg_id == msg->id) {
+                config->handlers[i].handler(proto, msg);
+                handled = 1;
                 break;
+            }
+        }
+    }
+
+    // Depois do handler, para o callback já ver o estado atualizado
+    if (msg->id == MSG_ERROR) {
+        UART_CompleteRequest(proto, MSG_ERROR, UART_REQ_ERROR, msg);
+    } else if (UART_IsRequestPending(proto, msg->id)) {
+        UART_CompleteRequest(proto, msg->id, UART_REQ_OK, msg);
+        handled = 1;
+    }
+
+    if (!handled) {
+        proto->stats.unhandled++;
+    }
+
+    UART_MsgPool_Release(msg);
+}
+
+/**
+ * @brief Atende todas as portas registradas: recepção, ACK/retransmissão,
+ *        handlers, timeouts de requisições e hooks de polling
+ * @note Não bloqueia; chamar a cada volta do loop principal. Portas sem
+ *       bytes novos e sem frames em voo custam só algumas comparações.
+ */
+void UART_Protocol_Process(void)
+{
+    for (uint8_t i = 0; i < port_count; i++) {
+        UART_Protocol_t *proto = ports[i];
+        UART_Message_t *msg;
+
+        while ((msg = UART_Link_Receive(proto)) != NULL) {
+            UART_Dispatch(proto, msg);
         }
+
+        UART_PollRequests(proto);
+
+        if (proto->config != NULL && proto->config->poll != NULL) {
+            proto->config->poll(proto);
+        }
+    }
 }
 
 /* ============================================================================
-   GETTERS PARA RESULTADOS DAS MISSÕES
+   ESTATÍSTICAS
    ============================================================================ */
 /**
- * @brief Retorna se há óleo detectado (Missão 1)
+ * @brief Retorna os contadores da porta
  */
-uint8_t UART_GetOilDetected(void)
+const UART_ProtocolStats_t *UART_Protocol_GetStats(const UART_Protocol_t *proto)
 {
-    return mission_results.oil_detected;
+    return &proto->stats;
 }
 
 /**
- * @brief Retorna percentual de área de óleo (Missão 1)
+ * @brief Retorna um contador pelo índice (inclui os do enlace e do DMA)
+ * @param index Ver UART_StatIndex_t
+ * @return Valor do contador (0 para índice inválido)
  */
-float UART_GetOilAreaPercentage(void)
+uint32_t UART_Protocol_GetStat(const UART_Protocol_t *proto, UART_StatIndex_t index)
 {
-    return mission_results.oil_area_percentage;
+    const UART_ProtocolStats_t *stats = &proto->stats;
+
+    switch (index) {
+        case UART_STAT_RX_BYTES:         return stats->rx_bytes;
+        case UART_STAT_RX_FRAMES:        return stats->rx_frames;
+        case UART_STAT_TX_BYTES:         return stats->tx_bytes;
+        case UART_STAT_TX_FRAMES:        return stats->tx_frames;
+        case UART_STAT_CHECKSUM_ERRORS:  return stats->checksum_errors;
+        case UART_STAT_FRAMING_ERRORS:   return stats->framing_errors;
+        case UART_STAT_RESYNCS:          return stats->resyncs;
+        case UART_STAT_POOL_DROPS:       return stats->pool_drops;
+        case UART_STAT_UNHANDLED:        return stats->unhandled;
+        case UART_STAT_REQ_TIMEOUTS:     return stats->req_timeouts;
+        case UART_STAT_REQ_ERRORS:       return stats->req_errors;
+        case UART_STAT_RETRANSMISSIONS:  return proto->link.retransmissions;
+        case UART_STAT_LINK_DROPS:       return proto->link.dropped_frames;
+        case UART_STAT_DMA_OVERRUNS:     return proto->rx.overruns;
+        case UART_STAT_DMA_ERRORS:       return proto->rx.errors;
+        case UART_STAT_SRTT_MS:          return proto->link.rtt_valid ? (uint32_t)proto->link.srtt_ms : 0;
+        case UART_STAT_RTO_MS:           return proto->link.rto_ms;
+        case UART_STAT_TX_DROPS:         return proto->tx.drops;
+        case UART_STAT_TX_DMA_ERRORS:    return proto->tx.errors;
+        case UART_STAT_LINK_RESYNCS:     return proto->link.resyncs;
+        case UART_STAT_PEER_RESETS:      return proto->link.peer_resets;
+        default:                         return 0;
+    }
 }
 
 /**
- * @brief Retorna MMSI do barco (Missão 2)
+ * @brief Zera contadores e histogramas da porta (o estado do enlace é mantido)
  */
-uint32_t UART_GetShipMMSI(void)
+void UART_Protocol_ResetStats(UART_Protocol_t *proto)
 {
-    return mission_results.ship_mmsi;
+    memset(&proto->stats, 0, sizeof(proto->stats));
+    proto->link.retransmissions = 0;
+    proto->link.dropped_frames = 0;
+    proto->link.resyncs = 0;
+    proto->link.peer_resets = 0;
+    proto->rx.overruns = 0;
+    proto->rx.errors = 0;
+    proto->tx.drops = 0;
+    proto->tx.errors = 0;
 }
 
 /**
- * @brief Retorna latitude de origem do barco (Missão 2)
+ * @brief Converte uma latência em ms no bucket log2 do histograma
  */
-float UART_GetShipOriginLat(void)
+uint8_t UART_Stats_RttBucket(uint32_t elapsed_ms)
 {
-    return mission_results.ship_origin_lat;
+    if (elapsed_ms == 0) {
+        return 0;
+    }
+
+    // Posição do bit mais alto + 1 (CLZ no Cortex-M7)
+    uint8_t bucket = 32 - __builtin_clz(elapsed_ms);
+    return (bucket < UART_STATS_RTT_BUCKETS) ? bucket : (UART_STATS_RTT_BUCKETS - 1);
 }
 
 /**
- * @brief Retorna longitude de origem do barco (Missão 2)
+ * @brief Acumula uma amostra de latência no histograma do msg_id
+ * @param kind UART_RTT_LINK (frame -> ACK) ou UART_RTT_REQUEST (comando -> resposta)
+ * @note Custo constante: busca linear em UART_STATS_RTT_IDS entradas. IDs que
+ *       não cabem na tabela só incrementam rtt_untracked.
  */
-float UART_GetShipOriginLon(void)
+void UART_Stats_RecordRtt(UART_Protocol_t *proto, UART_RttKind_t kind,
+                          uint8_t msg_id, uint32_t elapsed_ms)
 {
-    return mission_results.ship_origin_lon;
+    UART_RttHistogram_t *table = proto->stats.rtt[kind];
+    UART_RttHistogram_t *hist = NULL;
+
+    for (uint8_t i = 0; i < UART_STATS_RTT_IDS; i++) {
+        if (table[i].in_use && table[i].msg_id == msg_id) {
+            hist = &table[i];
+            break;
+        }
+        if (!table[i].in_use && hist == NULL) {
+            hist = &table[i];   // Primeira livre, usada se o ID for novo
+        }
+    }
+
+    if (hist == NULL) {
+        proto->stats.rtt_untracked++;
+        return;
+    }
+
+    if (!hist->in_use) {
+        hist->in_use = 1;
+        hist->msg_id = msg_id;
+    }
+
+    uint16_t *count = &hist->buckets[UART_Stats_RttBucket(elapsed_ms)];
+    if (*count < 0xFFFF) {
+        (*count)++;
+    }
+}
+
+/**
+ * @brief Quantidade de portas registradas no motor
+ */
+uint8_t UART_Protocol_GetPortCount(void)
+{
+    return port_count;
 }
 
 /**
- * @brief Verifica se a missão foi completada
+ * @brief Porta registrada pelo índice (ordem de UART_Protocol_Init)
+ * @return NULL se o índice não existir
  */
-uint8_t UART_IsMissionComplete(void)
+UART_Protocol_t *UART_Protocol_GetPort(uint8_t index)
 {
-    return mission_results.mission_complete;
-}
\ No newline at end of file
+    return (index < port_count) ? ports[index] : NULL;
+}
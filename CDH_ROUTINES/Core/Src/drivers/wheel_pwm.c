@@ -0,0 +1,192 @@
+/**
+  ******************************************************************************
+  * @file    wheel_pwm.c
+  * @brief   Roda de reação por PWM/DIR/EN com tacômetro por captura
+  ******************************************************************************
+  */
+
+#include "wheel_pwm.h"
+#include "main.h"
+#include <math.h>
+
+#define WHEEL_PI                3.14159265f
+#define WHEEL_TACH_RING         (WHEEL_TACH_PULSES_PER_REV + 1)
+#define WHEEL_TACH_TIMEOUT_TICKS (WHEEL_TACH_TIMEOUT_MS * (WHEEL_TACH_TICK_HZ / 1000U))
+
+/* ============================================================================
+   VARIÁVEIS PRIVADAS
+   ============================================================================ */
+static TIM_HandleTypeDef *pwm_tim = NULL;
+static uint32_t pwm_channel = 0;
+static TIM_HandleTypeDef *tach_tim = NULL;
+static uint32_t tach_channel = 0;
+static uint8_t started = 0;
+
+static WheelPWM_Status_t status = {.direction = 1};
+
+// Capturas do TIM5 (escritas pela ISR)
+static volatile uint32_t tach_ring[WHEEL_TACH_RING];
+static volatile uint8_t tach_head = 0;
+static volatile uint8_t tach_run = 0;       // Pulsos seguidos sem pausa > timeout (até o anel)
+static volatile uint32_t tach_edges = 0;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Configura PWM e tacômetro e liga os dois timers
+ * @note Chamadas seguintes só param a roda (os timers já estão rodando)
+ */
+HAL_StatusTypeDef WheelPWM_Init(TIM_HandleTypeDef *htim_pwm, uint32_t pwm_ch,
+                                TIM_HandleTypeDef *htim_tach, uint32_t tach_ch)
+{
+    pwm_tim = htim_pwm;
+    pwm_channel = pwm_ch;
+    WheelPWM_Stop();
+
+    if (started) {
+        return HAL_OK;
+    }
+
+    uint32_t clock = TIM_GetAPB1TimerClock();
+
+    // PWM no clock do timer: ARR + 1 passos de duty por período
+    __HAL_TIM_SET_PRESCALER(htim_pwm, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim_pwm, clock / WHEEL_PWM_FREQ_HZ - 1);
+    htim_pwm->Instance->EGR = TIM_EGR_UG;
+
+    // Tacômetro em 1 us; o prescaler vale a partir do evento de update
+    tach_tim = htim_tach;
+    tach_channel = tach_ch;
+    tach_run = 0;
+    tach_edges = 0;
+    __HAL_TIM_SET_PRESCALER(htim_tach, clock / WHEEL_TACH_TICK_HZ - 1);
+    htim_tach->Instance->EGR = TIM_EGR_UG;
+
+    if (HAL_TIM_PWM_Start(htim_pwm, pwm_ch) != HAL_OK ||
+        HAL_TIM_IC_Start_IT(htim_tach, tach_ch) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    started = 1;
+    return HAL_OK;
+}
+
+/**
+ * @brief Duty com sinal; o DIR só muda e o EN só liga com duty diferente de zero
+ */
+void WheelPWM_SetDuty(float duty)
+{
+    if (pwm_tim == NULL) {
+        return;
+    }
+
+    if (duty > 1.0f) duty = 1.0f;
+    if (duty < -1.0f) duty = -1.0f;
+
+    uint32_t period = __HAL_TIM_GET_AUTORELOAD(pwm_tim) + 1U;
+    uint32_t compare = (uint32_t)(fabsf(duty) * (float)period + 0.5f);
+
+    if (duty > 0.0f) {
+        HAL_GPIO_WritePin(ADCS_DIR_GPIO_Port, ADCS_DIR_Pin, GPIO_PIN_RESET);
+    } else if (duty < 0.0f) {
+        HAL_GPIO_WritePin(ADCS_DIR_GPIO_Port, ADCS_DIR_Pin, GPIO_PIN_SET);
+    }
+    __HAL_TIM_SET_COMPARE(pwm_tim, pwm_channel, compare);
+
+    if (!status.enabled && compare > 0) {
+        HAL_GPIO_WritePin(ADCS_EN_GPIO_Port, ADCS_EN_Pin, GPIO_PIN_SET);
+        status.enabled = 1;
+    }
+    status.duty = duty;
+}
+
+/**
+ * @brief EN baixo primeiro: o driver corta a ponte sem esperar o PWM
+ */
+void WheelPWM_Stop(void)
+{
+    HAL_GPIO_WritePin(ADCS_EN_GPIO_Port, ADCS_EN_Pin, GPIO_PIN_RESET);
+    if (pwm_tim != NULL) {
+        __HAL_TIM_SET_COMPARE(pwm_tim, pwm_channel, 0);
+    }
+    status.enabled = 0;
+    status.duty = 0.0f;
+}
+
+/**
+ * @brief Velocidade pelo intervalo dos últimos pulsos (até uma volta)
+ * @note Um pulso isolado (depois de uma pausa > timeout) ainda não dá
+ *       período: a leitura continua zero até o segundo
+ */
+float WheelPWM_GetSpeed(void)
+{
+    if (tach_tim == NULL) {
+        return 0.0f;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t now = __HAL_TIM_GET_COUNTER(tach_tim);
+    uint8_t head = tach_head;
+    uint32_t pulses = (tach_run > 0) ? (uint32_t)tach_run - 1U : 0U;
+    uint32_t last = tach_ring[head];
+    uint32_t first = tach_ring[(head + WHEEL_TACH_RING - pulses) % WHEEL_TACH_RING];
+    status.edges = tach_edges;
+    __set_PRIMASK(primask);
+
+    float magnitude = 0.0f;
+    uint32_t since = now - last;
+
+    if (pulses > 0 && since < WHEEL_TACH_TIMEOUT_TICKS) {
+        float period = (float)(last - first) / (float)pulses;
+
+        // Sem pulso há mais que um período: a roda está no máximo a esta velocidade
+        if ((float)since > period) {
+            period = (float)since;
+        }
+        magnitude = 2.0f * WHEEL_PI * (float)WHEEL_TACH_TICK_HZ /
+                    ((float)WHEEL_TACH_PULSES_PER_REV * period);
+    }
+
+    // O FG não tem sentido: o sinal segue o DIR só com a roda (quase) parada
+    if (magnitude < WHEEL_TACH_REVERSE_SPEED) {
+        if (status.duty > 0.0f) {
+            status.direction = 1;
+        } else if (status.duty < 0.0f) {
+            status.direction = -1;
+        }
+    }
+
+    status.speed = (float)status.direction * magnitude;
+    return status.speed;
+}
+
+void WheelPWM_GetStatus(WheelPWM_Status_t *out)
+{
+    *out = status;
+    out->edges = tach_edges;
+}
+
+/**
+ * @brief Borda do FG capturada pelo TIM5
+ */
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim != tach_tim) {
+        return;
+    }
+
+    uint32_t capture = HAL_TIM_ReadCapturedValue(htim, tach_channel);
+    uint8_t head = (uint8_t)((tach_head + 1) % WHEEL_TACH_RING);
+
+    if (tach_run == 0 || capture - tach_ring[tach_head] >= WHEEL_TACH_TIMEOUT_TICKS) {
+        tach_run = 1;
+    } else if (tach_run < WHEEL_TACH_RING) {
+        tach_run++;
+    }
+
+    tach_ring[head] = capture;
+    tach_head = head;
+    tach_edges++;
+}
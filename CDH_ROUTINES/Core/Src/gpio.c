@@ -37,7 +37,6 @@
      PC15-OSC32_OUT (OSC32_OUT)   ------> RCC_OSC32_OUT
      PH0-OSC_IN (PH0)   ------> RCC_OSC_IN
      PH1-OSC_OUT (PH1)   ------> RCC_OSC_OUT
-     PA2   ------> S_TIM2_CH3
      PH11   ------> I2C4_SCL
      PH12   ------> I2C4_SDA
      PB12   ------> SPI2_NSS
@@ -111,14 +110,6 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(INT_ACC_GPIO_Port, &GPIO_InitStruct);
 
-  /*Configure GPIO pin : ADCS_PWM_Pin */
-  GPIO_InitStruct.Pin = ADCS_PWM_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
-  GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-  GPIO_InitStruct.Alternate = GPIO_AF1_TIM2;
-  HAL_GPIO_Init(ADCS_PWM_GPIO_Port, &GPIO_InitStruct);
-
   /*Configure GPIO pins : ADCS_DIR_Pin ADCS_EN_Pin */
   GPIO_InitStruct.Pin = ADCS_DIR_Pin|ADCS_EN_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
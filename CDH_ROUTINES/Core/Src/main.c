@@ -23,6 +23,7 @@
 #include "i2c.h"
 #include "quadspi.h"
 #include "spi.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -32,7 +33,9 @@
 #include "can_driver.h"
 #include "can_protocol.h"
 #include "uart_protocol.h"
+#include "payload_mission.h"
 #include "adcs.h"
+#include "dwt.h"
 #include "antena.h"
 /* USER CODE END Includes */
 
@@ -43,6 +46,16 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define MOTOR_SWEEP_STEP        15      // Incremento da velocidade do teste
+#define MOTOR_SWEEP_LIMIT       100     // Inverte o sentido ao passar de ±100
+#define MOTOR_SWEEP_PERIOD_MS   3000    // Tempo em cada velocidade (depois da rampa)
+
+// Malha do ADCS na interrupção do TIM6 (0 = ADCS_Process no loop principal)
+#define ADCS_CONTROL_ON_TIM6    1
+
+// Bancada: MSG_PING periódico ao Payload (eco em MSG_PONG, fora das missões)
+#define PAYLOAD_BENCH_TEST      0       // 1 = habilita
+#define PAYLOAD_BENCH_PERIOD_MS 1000
 
 /* USER CODE END PD */
 
@@ -56,6 +69,19 @@
 /* USER CODE BEGIN PV */
 SolarTracker_t satelite;
 int16_t velo = 0;
+static int16_t velo_step = MOTOR_SWEEP_STEP;
+static uint32_t velo_tick = 0;
+
+// Portas do protocolo UART além do Payload (sem handlers: só ACK + estatísticas)
+UART_Protocol_t camera_link;   // UART8
+UART_Protocol_t debug_link;    // USART3
+
+#if PAYLOAD_BENCH_TEST
+// Teste do Payload: contadores para o Live Watch
+uint32_t payload_test_ok = 0;
+uint32_t payload_test_fail = 0;
+static uint32_t payload_test_tick = 0;
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -67,7 +93,69 @@ void PeriphCommonClock_Config(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+#if PAYLOAD_BENCH_TEST
+/**
+ * @brief Callback do teste rápido com o Payload (resposta ou timeout)
+ */
+static void Payload_TestCallback(UART_RequestStatus_t status,
+                                 const UART_Message_t *response, void *context)
+{
+    if (status == UART_REQ_OK) {
+        payload_test_ok++;
+    } else {
+        payload_test_fail++;
+    }
+}
+
+/**
+ * @brief Teste rápido da UART_PROTOCOL na COM5 (enlace confiável: SEQ + ACK)
+ * @note Um MSG_PING por vez, a cada PAYLOAD_BENCH_PERIOD_MS. O MSG_PONG não
+ *       é usado pelas missões, então o teste nunca consome um resultado
+ *       (UART_CompleteRequest conclui a requisição mais antiga pelo ID)
+ */
+static void Payload_BenchTest(void)
+{
+    if ((HAL_GetTick() - payload_test_tick) < PAYLOAD_BENCH_PERIOD_MS ||
+        UART_IsRequestPending(Payload_GetLink(), MSG_PONG)) {
+        return;
+    }
+
+    uint8_t test_data[3] = {0xAA, 0xBB, 0xCC};
+    if (UART_SendRequest(Payload_GetLink(), MSG_PING, test_data, sizeof(test_data),
+                         MSG_PONG, PAYLOAD_BENCH_PERIOD_MS, Payload_TestCallback, NULL) == HAL_OK) {
+        payload_test_tick = HAL_GetTick();
+    }
+}
+#endif
+
+/**
+ * @brief Varredura de teste do motor (degraus 0 -> 100 -> -100 -> ...)
+ * @note Cada degrau vira uma rampa em curva S (ADCS_SetSpeedRamp, avançada
+ *       pelo ADCS_Process); o próximo sai MOTOR_SWEEP_PERIOD_MS depois de a
+ *       rampa chegar. Fora dos modos ADCS/DETUMBLING, que comandam a roda.
+ */
+static void Motor_SweepStep(void)
+{
+    if (!ADCS_IsRampDone()) {
+        velo_tick = HAL_GetTick();
+        return;
+    }
+    if ((HAL_GetTick() - velo_tick) < MOTOR_SWEEP_PERIOD_MS) {
+        return;
+    }
+    velo_tick = HAL_GetTick();
 
+    if (ADCS_SetSpeedRamp((float)velo) != HAL_OK) {
+        return;
+    }
+    velo += velo_step;
+
+    if (velo > MOTOR_SWEEP_LIMIT) {
+        velo_step = -MOTOR_SWEEP_STEP;
+    } else if (velo < -MOTOR_SWEEP_LIMIT) {
+        velo_step = MOTOR_SWEEP_STEP;
+    }
+}
 /* USER CODE END 0 */
 
 /**
@@ -116,14 +204,30 @@ int main(void)
   MX_UART4_Init();
   MX_UART8_Init();
   MX_USART3_UART_Init();
+  MX_TIM2_Init();
+  MX_TIM5_Init();
+  MX_TIM6_Init();
   /* USER CODE BEGIN 2 */
+  DWT_Init();  // Contador de ciclos para as medidas de latência
+  
   //CAN_Init();
   //CAN_Protocol_Init();
   //HAL_Delay(10);  // Aguarda CAN estabilizar
   
+  Payload_Init(&huart5);  // Recepção por DMA + enlace confiável com o Payload
+  UART_Protocol_Init(&camera_link, &huart8, NULL);
+  UART_Protocol_Init(&debug_link, &huart3, NULL);
+
   ADCS_Init(&huart4);  // Inicializa ADCS (motor SimpleFOC)
   HAL_Delay(10);
 
+  // Malha de controle do ADCS no TIM6 (depende do modo vindo do COM via CAN;
+  // fora dos modos ADCS/DETUMBLING é ela que avança a rampa do Motor_SweepStep).
+  // Se não ligar (ADCS sem inicializar), o ADCS_Process do loop assume.
+#if ADCS_CONTROL_ON_TIM6
+  ADCS_Control_Start(&huart4, ADCS_CONTROL_RATE_HZ);
+#endif
+
   // --- ADICIONADO: INICIALIZAÇÃO DO SOLAR TRACKER ---
   // Calibração dos ADCs para garantir precisão na leitura de luz
   if (HAL_ADCEx_Calibration_Start(&hadc2, ADC_CALIB_OFFSET, ADC_SINGLE_ENDED) != HAL_OK) Error_Handler();
@@ -151,48 +255,21 @@ int main(void)
   while (1)
   {
 
-    // Teste rápido da UART_PROTOCOL na COM5
-    UART_Message_t msg;
-    msg.id = MSG_CMD_START_M2;
-    msg.length = 3;
-    msg.data[0] = 0xAA;
-    msg.data[1] = 0xBB;
-    msg.data[2] = 0xCC;
-    UART_Transmit(&huart5, &msg, msg.length);
-    
-    // Aguarda o payload processar e responder (importante!)
-    HAL_Delay(200);  // 200ms para dar tempo do Python processar
+#if PAYLOAD_BENCH_TEST
+    Payload_BenchTest();
+#endif
 
-    Check_Payload_Response();
+    // Não bloqueia: atende todas as portas e dispara callbacks/timeouts
+    UART_Protocol_Process();
     
-    // Nota: Esse delay de 2s vai fazer o SolarTracker atualizar a cada 2s.
-    // Se precisar de resposta rápida do motor, diminua esse tempo.
-//    ADCS_SetSpeed(&huart4, velo);
-
-    // Primeira parte: aumentar a velocidade até 100
-    while (velo <= 100) {
-        ADCS_SetSpeed(&huart4, velo);
-        velo += 15;
-        HAL_Delay(3000);  // Atraso de 3 segundos
-    }
-
-    // Segunda parte: diminuir a velocidade até 0
-    while (velo >= 0) {
-        ADCS_SetSpeed(&huart4, velo);
-        velo -= 15;
-        HAL_Delay(3000);  // Atraso de 3 segundos
-    }
-
-    // Terceira parte: diminuir a velocidade até -100
-    while (velo >= -100) {
-        ADCS_SetSpeed(&huart4, velo);
-        velo -= 15;
-        HAL_Delay(3000);  // Atraso de 3 segundos
-    }
+    // Missões pedidas pelo COM (o primeiro comando já sai no despacho do CAN)
+    UART_ProcessMission();
 
+    // Teste do motor: rampa até o próximo degrau, 3 s parado, sem travar o loop
+    Motor_SweepStep();
 
-
-    HAL_Delay(2000);
+    // Rampa da roda e, sem a malha no TIM6, o controle do ADCS
+    ADCS_Process(&huart4);
 
     // testa deploy da antena
     //Deploy_Antenna();
@@ -224,6 +301,9 @@ int main(void)
     // Calcula: Normalização -> Ângulo Solar -> Ação do Motor
 //    Solar_Process(&satelite);
 
+    // Vetor solar para o estimador de atitude do ADCS
+//    ADCS_SetSunVector(satelite.vetor_solar, satelite.sol_visivel);
+
     // 3. ATUAÇÃO DO MOTOR (Exemplo de integração)
     // Aqui você conecta a lógica do tracker com seu driver de motor real
 
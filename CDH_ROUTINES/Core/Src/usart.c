@@ -21,7 +21,79 @@
 #include "usart.h"
 
 /* USER CODE BEGIN 0 */
+/* DMA de recepção circular das portas do protocolo (ver uart_dma.c) */
+DMA_HandleTypeDef hdma_uart5_rx;
+DMA_HandleTypeDef hdma_uart8_rx;
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_uart4_rx;
 
+/* DMA de transmissão (anel de TX em uart_dma.c) */
+DMA_HandleTypeDef hdma_uart5_tx;
+DMA_HandleTypeDef hdma_uart4_tx;
+
+/**
+  * @brief Configura um stream do DMA1 em modo circular para a RX da UART
+  *        e habilita as interrupções do stream e da UART (evento IDLE)
+  */
+static void UART_RxDMA_Init(UART_HandleTypeDef *uartHandle, DMA_HandleTypeDef *hdma,
+                            DMA_Stream_TypeDef *stream, uint32_t request,
+                            IRQn_Type dma_irq, IRQn_Type uart_irq)
+{
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  hdma->Instance = stream;
+  hdma->Init.Request = request;
+  hdma->Init.Direction = DMA_PERIPH_TO_MEMORY;
+  hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma->Init.MemInc = DMA_MINC_ENABLE;
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma->Init.Mode = DMA_CIRCULAR;
+  hdma->Init.Priority = DMA_PRIORITY_LOW;
+  hdma->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  __HAL_LINKDMA(uartHandle, hdmarx, *hdma);
+
+  HAL_NVIC_SetPriority(dma_irq, 5, 0);
+  HAL_NVIC_EnableIRQ(dma_irq);
+  HAL_NVIC_SetPriority(uart_irq, 5, 0);
+  HAL_NVIC_EnableIRQ(uart_irq);
+}
+
+/**
+  * @brief Configura um stream do DMA1 em modo normal para a TX da UART
+  * @note  A interrupção da UART já é habilitada por UART_RxDMA_Init
+  */
+static void UART_TxDMA_Init(UART_HandleTypeDef *uartHandle, DMA_HandleTypeDef *hdma,
+                            DMA_Stream_TypeDef *stream, uint32_t request,
+                            IRQn_Type dma_irq)
+{
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  hdma->Instance = stream;
+  hdma->Init.Request = request;
+  hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma->Init.MemInc = DMA_MINC_ENABLE;
+  hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma->Init.Mode = DMA_NORMAL;
+  hdma->Init.Priority = DMA_PRIORITY_MEDIUM;
+  hdma->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+  if (HAL_DMA_Init(hdma) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  __HAL_LINKDMA(uartHandle, hdmatx, *hdma);
+
+  HAL_NVIC_SetPriority(dma_irq, 5, 0);
+  HAL_NVIC_EnableIRQ(dma_irq);
+}
 /* USER CODE END 0 */
 
 UART_HandleTypeDef huart4;
@@ -239,7 +311,12 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
   /* USER CODE BEGIN UART4_MspInit 1 */
-
+    /* UART4_RX DMA + interrupção (telemetria do SimpleFOC, ver adcs.c) */
+    UART_RxDMA_Init(uartHandle, &hdma_uart4_rx, DMA1_Stream5, DMA_REQUEST_UART4_RX,
+                    DMA1_Stream5_IRQn, UART4_IRQn);
+    /* UART4_TX DMA (comandos ao SimpleFOC) */
+    UART_TxDMA_Init(uartHandle, &hdma_uart4_tx, DMA1_Stream4, DMA_REQUEST_UART4_TX,
+                    DMA1_Stream4_IRQn);
   /* USER CODE END UART4_MspInit 1 */
   }
   else if(uartHandle->Instance==UART5)
@@ -273,7 +350,12 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
   /* USER CODE BEGIN UART5_MspInit 1 */
-
+    /* UART5_RX DMA + interrupção (protocolo do Payload) */
+    UART_RxDMA_Init(uartHandle, &hdma_uart5_rx, DMA1_Stream0, DMA_REQUEST_UART5_RX,
+                    DMA1_Stream0_IRQn, UART5_IRQn);
+    /* UART5_TX DMA (comandos ao Payload sem bloquear o loop) */
+    UART_TxDMA_Init(uartHandle, &hdma_uart5_tx, DMA1_Stream3, DMA_REQUEST_UART5_TX,
+                    DMA1_Stream3_IRQn);
   /* USER CODE END UART5_MspInit 1 */
   }
   else if(uartHandle->Instance==UART8)
@@ -307,7 +389,9 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
 
   /* USER CODE BEGIN UART8_MspInit 1 */
-
+    /* UART8_RX DMA + interrupção (protocolo da câmera) */
+    UART_RxDMA_Init(uartHandle, &hdma_uart8_rx, DMA1_Stream1, DMA_REQUEST_UART8_RX,
+                    DMA1_Stream1_IRQn, UART8_IRQn);
   /* USER CODE END UART8_MspInit 1 */
   }
   else if(uartHandle->Instance==USART3)
@@ -341,7 +425,9 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
 
   /* USER CODE BEGIN USART3_MspInit 1 */
-
+    /* USART3_RX DMA + interrupção (protocolo de debug) */
+    UART_RxDMA_Init(uartHandle, &hdma_usart3_rx, DMA1_Stream2, DMA_REQUEST_USART3_RX,
+                    DMA1_Stream2_IRQn, USART3_IRQn);
   /* USER CODE END USART3_MspInit 1 */
   }
 }
@@ -364,7 +450,11 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOA, ADCS_TX_Pin|ADCS_RX_Pin);
 
   /* USER CODE BEGIN UART4_MspDeInit 1 */
-
+    HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(DMA1_Stream5_IRQn);
+    HAL_NVIC_DisableIRQ(DMA1_Stream4_IRQn);
+    HAL_NVIC_DisableIRQ(UART4_IRQn);
   /* USER CODE END UART4_MspDeInit 1 */
   }
   else if(uartHandle->Instance==UART5)
@@ -382,7 +472,11 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOB, DEBUG_UART_RX_Pin|DEBUG_UART_TX_Pin);
 
   /* USER CODE BEGIN UART5_MspDeInit 1 */
-
+    HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(DMA1_Stream0_IRQn);
+    HAL_NVIC_DisableIRQ(DMA1_Stream3_IRQn);
+    HAL_NVIC_DisableIRQ(UART5_IRQn);
   /* USER CODE END UART5_MspDeInit 1 */
   }
   else if(uartHandle->Instance==UART8)
@@ -400,7 +494,9 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOE, CAM_RX_Pin|CAM_TX_Pin);
 
   /* USER CODE BEGIN UART8_MspDeInit 1 */
-
+    HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_NVIC_DisableIRQ(DMA1_Stream1_IRQn);
+    HAL_NVIC_DisableIRQ(UART8_IRQn);
   /* USER CODE END UART8_MspDeInit 1 */
   }
   else if(uartHandle->Instance==USART3)
@@ -418,7 +514,9 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     HAL_GPIO_DeInit(GPIOD, PAY_TX_Pin|PAY_RX_Pin);
 
   /* USER CODE BEGIN USART3_MspDeInit 1 */
-
+    HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_NVIC_DisableIRQ(DMA1_Stream2_IRQn);
+    HAL_NVIC_DisableIRQ(USART3_IRQn);
   /* USER CODE END USART3_MspDeInit 1 */
   }
 }
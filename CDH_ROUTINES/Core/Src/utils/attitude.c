@@ -0,0 +1,208 @@
+/**
+  ******************************************************************************
+  * @file    attitude.c
+  * @brief   Estimador de atitude em quatérnio (Mahony) com giroscópio,
+  *          acelerômetro e vetor solar
+  ******************************************************************************
+  */
+
+#include "attitude.h"
+#include <stddef.h>
+#include <math.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static inline float Attitude_Clamp(float x, float lo, float hi)
+{
+    return (x > hi) ? hi : (x < lo) ? lo : x;
+}
+
+/**
+ * @brief Normaliza v no lugar
+ * @return Norma antes da normalização (0 = vetor nulo, não alterado)
+ */
+static float Attitude_Normalize3(float v[3])
+{
+    float norm = Attitude_Sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+    if (norm > 0.0f) {
+        float inv = 1.0f / norm;
+        v[0] *= inv;
+        v[1] *= inv;
+        v[2] *= inv;
+    }
+    return norm;
+}
+
+/**
+ * @brief Acumula k * (medida x estimada) em e
+ */
+static inline void Attitude_AddCross(float e[3], const float m[3], const float v[3], float k)
+{
+    e[0] += k * (m[1] * v[2] - m[2] * v[1]);
+    e[1] += k * (m[2] * v[0] - m[0] * v[2]);
+    e[2] += k * (m[0] * v[1] - m[1] * v[0]);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Configura ganhos e zera o estado (atitude identidade, sem bias)
+ * @param kp_acc Ganho da gravidade (0 = não usa o acelerômetro)
+ * @param kp_sun Ganho do Sol (0 = não usa o vetor solar)
+ * @param ki Ganho da estimativa de bias (0 = sem bias)
+ */
+void Attitude_Init(Attitude_t *att, float kp_acc, float kp_sun, float ki)
+{
+    static const float sun_default[3] = {1.0f, 0.0f, 0.0f};
+
+    att->kp_acc = kp_acc;
+    att->kp_sun = kp_sun;
+    att->ki = ki;
+    Attitude_SetSunReference(att, sun_default, 0);
+    Attitude_Reset(att);
+}
+
+/**
+ * @brief Volta para a atitude identidade e zera o bias (mantém ganhos)
+ */
+void Attitude_Reset(Attitude_t *att)
+{
+    att->q.w = 1.0f;
+    att->q.x = 0.0f;
+    att->q.y = 0.0f;
+    att->q.z = 0.0f;
+    att->bias[0] = 0.0f;
+    att->bias[1] = 0.0f;
+    att->bias[2] = 0.0f;
+    att->acc_used = 0;
+    att->sun_used = 0;
+    att->updates = 0;
+}
+
+/**
+ * @brief Direção do Sol no sistema inercial
+ * @param ref Vetor (normalizado aqui)
+ * @param planar 1 se o sensor só mede o azimute no plano XY do corpo (os
+ *        LDRs laterais do SolarTracker): a estimativa é projetada no
+ *        mesmo plano antes da comparação
+ */
+void Attitude_SetSunReference(Attitude_t *att, const float ref[3], uint8_t planar)
+{
+    att->sun_ref[0] = ref[0];
+    att->sun_ref[1] = ref[1];
+    att->sun_ref[2] = ref[2];
+    Attitude_Normalize3(att->sun_ref);
+    att->sun_planar = planar;
+}
+
+/**
+ * @brief Uma iteração do estimador
+ * @param gyro Velocidade angular no corpo (rad/s)
+ * @param accel Força específica no corpo (m/s²) ou NULL
+ * @param sun Direção do Sol no corpo (qualquer norma) ou NULL
+ * @param dt Período desde a última iteração (s)
+ */
+void Attitude_Update(Attitude_t *att, const float gyro[3], const float *accel,
+                     const float *sun, float dt)
+{
+    float e_p[3] = {0.0f, 0.0f, 0.0f};     // Correção proporcional (com ganhos)
+    float e_i[3] = {0.0f, 0.0f, 0.0f};     // Erro para o bias (sem ganhos)
+    float m[3];
+    float v[3];
+
+    att->acc_used = 0;
+    att->sun_used = 0;
+
+    // Gravidade: só perto de 1 g (fora disso há aceleração linear ou queda livre)
+    if (accel != NULL && att->kp_acc > 0.0f) {
+        m[0] = accel[0];
+        m[1] = accel[1];
+        m[2] = accel[2];
+        float norm = Attitude_Normalize3(m);
+
+        if (fabsf(norm - ATTITUDE_GRAVITY) < ATTITUDE_ACC_GATE * ATTITUDE_GRAVITY) {
+            const Attitude_Quat_t *q = &att->q;
+            v[0] = 2.0f * (q->x * q->z - q->w * q->y);
+            v[1] = 2.0f * (q->y * q->z + q->w * q->x);
+            v[2] = 1.0f - 2.0f * (q->x * q->x + q->y * q->y);
+
+            Attitude_AddCross(e_p, m, v, att->kp_acc);
+            Attitude_AddCross(e_i, m, v, 1.0f);
+            att->acc_used = 1;
+        }
+    }
+
+    if (sun != NULL && att->kp_sun > 0.0f) {
+        m[0] = sun[0];
+        m[1] = sun[1];
+        m[2] = sun[2];
+        Attitude_RotateToBody(&att->q, att->sun_ref, v);
+        if (att->sun_planar) {
+            m[2] = 0.0f;
+            v[2] = 0.0f;
+        }
+
+        if (Attitude_Normalize3(m) > 0.0f && Attitude_Normalize3(v) > ATTITUDE_SUN_MIN_NORM) {
+            Attitude_AddCross(e_p, m, v, att->kp_sun);
+            Attitude_AddCross(e_i, m, v, 1.0f);
+            att->sun_used = 1;
+        }
+    }
+
+    // Bias: integral do erro, limitada (sem referência o bias fica parado)
+    for (uint8_t i = 0; i < 3; i++) {
+        att->bias[i] = Attitude_Clamp(att->bias[i] - att->ki * e_i[i] * dt,
+                                      -ATTITUDE_BIAS_LIMIT, ATTITUDE_BIAS_LIMIT);
+    }
+
+    float gx = gyro[0] - att->bias[0] + e_p[0];
+    float gy = gyro[1] - att->bias[1] + e_p[1];
+    float gz = gyro[2] - att->bias[2] + e_p[2];
+
+    // Integração de primeira ordem: q' = 0.5 * q (x) (0, w)
+    Attitude_Quat_t q = att->q;
+    float h = 0.5f * dt;
+    att->q.w = q.w + h * (-q.x * gx - q.y * gy - q.z * gz);
+    att->q.x = q.x + h * ( q.w * gx + q.y * gz - q.z * gy);
+    att->q.y = q.y + h * ( q.w * gy - q.x * gz + q.z * gx);
+    att->q.z = q.z + h * ( q.w * gz + q.x * gy - q.y * gx);
+
+    float norm = Attitude_Sqrt(att->q.w * att->q.w + att->q.x * att->q.x +
+                               att->q.y * att->q.y + att->q.z * att->q.z);
+    float inv = 1.0f / norm;
+    att->q.w *= inv;
+    att->q.x *= inv;
+    att->q.y *= inv;
+    att->q.z *= inv;
+
+    att->updates++;
+}
+
+/**
+ * @brief Leva um vetor do sistema inercial para o corpo (R(q)^T * v)
+ */
+void Attitude_RotateToBody(const Attitude_Quat_t *q, const float v[3], float out[3])
+{
+    float xx = q->x * q->x, yy = q->y * q->y, zz = q->z * q->z;
+    float xy = q->x * q->y, xz = q->x * q->z, yz = q->y * q->z;
+    float wx = q->w * q->x, wy = q->w * q->y, wz = q->w * q->z;
+
+    out[0] = (1.0f - 2.0f * (yy + zz)) * v[0] + 2.0f * (xy + wz) * v[1] + 2.0f * (xz - wy) * v[2];
+    out[1] = 2.0f * (xy - wz) * v[0] + (1.0f - 2.0f * (xx + zz)) * v[1] + 2.0f * (yz + wx) * v[2];
+    out[2] = 2.0f * (xz + wy) * v[0] + 2.0f * (yz - wx) * v[1] + (1.0f - 2.0f * (xx + yy)) * v[2];
+}
+
+/**
+ * @brief Ângulos de Euler ZYX (rad)
+ */
+void Attitude_ToEuler(const Attitude_Quat_t *q, float *roll, float *pitch, float *yaw)
+{
+    *roll = atan2f(2.0f * (q->w * q->x + q->y * q->z),
+                   1.0f - 2.0f * (q->x * q->x + q->y * q->y));
+    *pitch = asinf(Attitude_Clamp(2.0f * (q->w * q->y - q->z * q->x), -1.0f, 1.0f));
+    *yaw = atan2f(2.0f * (q->w * q->z + q->x * q->y),
+                  1.0f - 2.0f * (q->y * q->y + q->z * q->z));
+}
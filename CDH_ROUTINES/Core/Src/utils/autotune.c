@@ -0,0 +1,212 @@
+/**
+  ******************************************************************************
+  * @file    autotune.c
+  * @brief   Auto-tune de PID por realimentação a relé
+  ******************************************************************************
+  */
+
+#include "autotune.h"
+#include <math.h>
+#include <string.h>
+
+#define AUTOTUNE_PI             3.14159265f
+#define AUTOTUNE_TL_GAIN        2.2f    // Tyreus-Luyben: kp = Ku / 2.2
+#define AUTOTUNE_TL_TI          2.2f    //                Ti = 2.2 Tu
+#define AUTOTUNE_TL_TD          6.3f    //                Td = Tu / 6.3
+#define AUTOTUNE_SETTLE_PERIODS 2.0f    // VERIFY ignora 2 Tu (sai da oscilação do relé)
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Autotune_EnterPhase(Autotune_t *at, Autotune_Phase_t phase)
+{
+    at->phase = phase;
+    at->elapsed = 0.0f;
+    at->sq_sum = 0.0f;
+    at->samples = 0;
+}
+
+/**
+ * @brief Acumula o erro da janela; retorna 1 quando ela fecha
+ */
+static uint8_t Autotune_Window(Autotune_t *at, float error, float skip, float *rms)
+{
+    if (at->elapsed > skip) {
+        at->sq_sum += error * error;
+        at->samples++;
+    }
+    if (at->elapsed < skip + at->cfg.eval_time || at->samples == 0) {
+        return 0;
+    }
+    *rms = sqrtf(at->sq_sum / (float)at->samples);
+    return 1;
+}
+
+/**
+ * @brief Ku e Tu médios e os ganhos novos
+ * @return 0 se a oscilação não passou da histerese
+ */
+static uint8_t Autotune_Identify(Autotune_t *at)
+{
+    float a = at->amplitude_sum / (float)at->measured;
+    float eps = at->cfg.hysteresis;
+
+    at->tu = at->period_sum / (float)at->measured;
+    if (a <= eps || at->tu <= 0.0f) {
+        return 0;
+    }
+
+    at->ku = 4.0f * at->cfg.relay_amplitude / (AUTOTUNE_PI * sqrtf(a * a - eps * eps));
+    at->new_kp = at->ku / AUTOTUNE_TL_GAIN;
+    at->new_ki = at->new_kp / (AUTOTUNE_TL_TI * at->tu);
+    at->new_kd = at->new_kp * at->tu / AUTOTUNE_TL_TD;
+    return 1;
+}
+
+/**
+ * @brief Relé com histerese; um ciclo vai de uma troca para +1 à seguinte
+ */
+static Autotune_Event_t Autotune_Relay(Autotune_t *at, float error, float measurement)
+{
+    float eps = at->cfg.hysteresis;
+
+    if (measurement > at->peak_max) at->peak_max = measurement;
+    if (measurement < at->peak_min) at->peak_min = measurement;
+
+    if (at->relay > 0 && error < -eps) {
+        at->relay = -1;
+    } else if (at->relay < 0 && error > eps) {
+        at->relay = 1;
+
+        // O primeiro ciclo completo é transitório: descartado
+        if (at->rises >= 2) {
+            at->period_sum += at->elapsed - at->last_rise;
+            at->amplitude_sum += 0.5f * (at->peak_max - at->peak_min);
+            at->measured++;
+        }
+        if (at->rises < 2) {
+            at->rises++;
+        }
+        at->last_rise = at->elapsed;
+        at->peak_max = measurement;
+        at->peak_min = measurement;
+    }
+
+    if (at->measured >= at->cfg.cycles) {
+        if (Autotune_Identify(at)) {
+            Autotune_EnterPhase(at, AUTOTUNE_VERIFY);
+            return AUTOTUNE_EVT_APPLY;
+        }
+        Autotune_EnterPhase(at, AUTOTUNE_FAILED);
+        return AUTOTUNE_EVT_RELEASE;
+    }
+
+    if (at->elapsed >= at->cfg.relay_timeout) {
+        Autotune_EnterPhase(at, AUTOTUNE_FAILED);
+        return AUTOTUNE_EVT_RELEASE;
+    }
+
+    return AUTOTUNE_EVT_NONE;
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Autotune_Init(Autotune_t *at, const Autotune_Config_t *cfg)
+{
+    memset(at, 0, sizeof(Autotune_t));
+    at->cfg = *cfg;
+    at->phase = AUTOTUNE_IDLE;
+}
+
+/**
+ * @brief Começa um experimento (zera o resultado anterior)
+ */
+void Autotune_Start(Autotune_t *at, float kp, float ki, float kd)
+{
+    Autotune_Config_t cfg = at->cfg;
+
+    Autotune_Init(at, &cfg);
+    at->old_kp = kp;
+    at->old_ki = ki;
+    at->old_kd = kd;
+    Autotune_EnterPhase(at, AUTOTUNE_BASELINE);
+}
+
+/**
+ * @brief Interrompe o experimento
+ * @return RESTORE em VERIFY (ganhos novos no PID), RELEASE no relé
+ */
+Autotune_Event_t Autotune_Abort(Autotune_t *at)
+{
+    Autotune_Event_t event = AUTOTUNE_EVT_NONE;
+
+    if (at->phase == AUTOTUNE_VERIFY) {
+        event = AUTOTUNE_EVT_RESTORE;
+    } else if (at->phase == AUTOTUNE_RELAY) {
+        event = AUTOTUNE_EVT_RELEASE;
+    }
+
+    if (Autotune_IsRunning(at)) {
+        Autotune_EnterPhase(at, AUTOTUNE_FAILED);
+    }
+    return event;
+}
+
+/**
+ * @brief Uma iteração do experimento
+ * @param out Saída do relé (unidade do PID); só vale em AUTOTUNE_RELAY
+ */
+Autotune_Event_t Autotune_Update(Autotune_t *at, float setpoint, float measurement,
+                                 float dt, float *out)
+{
+    float error = setpoint - measurement;
+    Autotune_Event_t event = AUTOTUNE_EVT_NONE;
+
+    if (!Autotune_IsRunning(at)) {
+        return AUTOTUNE_EVT_NONE;
+    }
+    at->elapsed += dt;
+
+    switch (at->phase) {
+        case AUTOTUNE_BASELINE:
+            if (Autotune_Window(at, error, 0.0f, &at->rms_baseline)) {
+                Autotune_EnterPhase(at, AUTOTUNE_RELAY);
+                at->relay = (error >= 0.0f) ? 1 : -1;
+                at->peak_max = measurement;
+                at->peak_min = measurement;
+            }
+            break;
+
+        case AUTOTUNE_RELAY:
+            event = Autotune_Relay(at, error, measurement);
+            break;
+
+        case AUTOTUNE_VERIFY: {
+            // Piso na histerese: com a malha parada o RMS base é só ruído
+            float base = (at->rms_baseline > at->cfg.hysteresis) ? at->rms_baseline
+                                                                 : at->cfg.hysteresis;
+            if (Autotune_Window(at, error, AUTOTUNE_SETTLE_PERIODS * at->tu, &at->rms_verify)) {
+                if (at->rms_verify > at->cfg.degrade_ratio * base) {
+                    Autotune_EnterPhase(at, AUTOTUNE_ROLLED_BACK);
+                    event = AUTOTUNE_EVT_RESTORE;
+                } else {
+                    Autotune_EnterPhase(at, AUTOTUNE_DONE);
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    *out = (at->phase == AUTOTUNE_RELAY) ? (float)at->relay * at->cfg.relay_amplitude : 0.0f;
+    return event;
+}
+
+uint8_t Autotune_IsRunning(const Autotune_t *at)
+{
+    return at->phase == AUTOTUNE_BASELINE || at->phase == AUTOTUNE_RELAY ||
+           at->phase == AUTOTUNE_VERIFY;
+}
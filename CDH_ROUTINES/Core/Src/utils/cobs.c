@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    cobs.c
+  * @brief   Codificador/decodificador COBS byte a byte (sem buffer próprio)
+  ******************************************************************************
+  */
+
+#include "cobs.h"
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+/**
+ * @brief Reserva a posição atual do destino (com volta no fim do buffer)
+ */
+static uint16_t COBS_Advance(COBS_Encoder_t *enc)
+{
+    uint16_t pos = enc->pos;
+
+    enc->pos = (uint16_t)(pos + 1);
+    if (enc->pos == enc->size) {
+        enc->pos = 0;
+    }
+    enc->count++;
+
+    return pos;
+}
+
+/**
+ * @brief Fecha o bloco atual (grava o código) e abre o próximo
+ */
+static void COBS_NextBlock(COBS_Encoder_t *enc)
+{
+    enc->buf[enc->code_pos] = enc->code;
+    enc->code_pos = COBS_Advance(enc);
+    enc->code = 1;
+}
+
+/* ============================================================================
+   CODIFICAÇÃO
+   ============================================================================ */
+/**
+ * @brief Começa um frame codificado em buf[pos]
+ * @param buf Destino (linear ou anel)
+ * @param size Tamanho do destino: a escrita continua em buf[0] depois do fim
+ * @param pos Primeira posição do frame
+ * @note O chamador garante COBS_ENCODED_MAX(len) + 1 bytes livres a partir
+ *       de pos; o byte de código de cada bloco é gravado quando o bloco fecha
+ */
+void COBS_EncodeStart(COBS_Encoder_t *enc, uint8_t *buf, uint16_t size, uint16_t pos)
+{
+    enc->buf = buf;
+    enc->size = size;
+    enc->pos = pos;
+    enc->count = 0;
+    enc->code = 1;
+    enc->code_pos = COBS_Advance(enc);
+}
+
+/**
+ * @brief Codifica um byte bruto
+ */
+void COBS_EncodePut(COBS_Encoder_t *enc, uint8_t byte)
+{
+    // Bloco de 254 bytes sem zero: só abre outro se ainda vier dado
+    if (enc->code == 0xFF) {
+        COBS_NextBlock(enc);
+    }
+
+    if (byte == 0) {
+        COBS_NextBlock(enc);
+    } else {
+        enc->buf[COBS_Advance(enc)] = byte;
+        enc->code++;
+    }
+}
+
+/**
+ * @brief Fecha o último bloco e grava o delimitador
+ * @return Tamanho total escrito (inclui o delimitador)
+ */
+uint16_t COBS_EncodeFinish(COBS_Encoder_t *enc)
+{
+    enc->buf[enc->code_pos] = enc->code;
+    enc->buf[COBS_Advance(enc)] = COBS_DELIMITER;
+
+    return enc->count;
+}
+
+/* ============================================================================
+   DECODIFICAÇÃO
+   ============================================================================ */
+/**
+ * @brief Prepara o decodificador para um novo frame
+ */
+void COBS_DecodeStart(COBS_Decoder_t *dec)
+{
+    dec->code = 0;
+    dec->left = 0;
+}
+
+/**
+ * @brief Decodifica um byte do frame (nunca o delimitador)
+ * @param out Recebe o byte decodificado
+ * @return 1 se *out foi escrito, 0 se o byte era só um código
+ * @note Cada byte de entrada gera no máximo um de saída: o zero implícito
+ *       do bloco anterior sai junto com o código do bloco seguinte, e por
+ *       isso nunca aparece no fim do frame
+ */
+uint8_t COBS_DecodePut(COBS_Decoder_t *dec, uint8_t byte, uint8_t *out)
+{
+    if (dec->left > 0) {
+        dec->left--;
+        *out = byte;
+        return 1;
+    }
+
+    // Zero implícito, exceto no início do frame e após bloco cheio
+    uint8_t zero = (dec->code != 0 && dec->code != 0xFF);
+
+    dec->code = byte;
+    dec->left = (uint8_t)(byte - 1);
+
+    if (zero) {
+        *out = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Verifica, no delimitador, se o frame fechou um bloco inteiro
+ * @return 0 se o frame estiver vazio ou com o último bloco truncado
+ */
+uint8_t COBS_DecodeValid(const COBS_Decoder_t *dec)
+{
+    return dec->code != 0 && dec->left == 0;
+}
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    crc32.c
+  * @brief   CRC-32 por tabela de nibbles (64 bytes de tabela em flash)
+  ******************************************************************************
+  */
+
+#include "crc32.h"
+
+static const uint32_t crc32_nibble_table[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+/**
+ * @brief Acumula bytes em um CRC parcial
+ * @param crc CRC parcial (CRC32_INIT no primeiro bloco)
+ * @param data Dados
+ * @param len Quantidade de bytes
+ * @return CRC parcial atualizado (aplicar CRC32_Final no fim)
+ */
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Calcula o CRC-32 de um bloco completo
+ */
+uint32_t CRC32_Compute(const uint8_t *data, size_t len)
+{
+    return CRC32_Final(CRC32_Update(CRC32_INIT, data, len));
+}
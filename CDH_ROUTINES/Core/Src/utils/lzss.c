@@ -0,0 +1,256 @@
+/**
+  ******************************************************************************
+  * @file    lzss.c
+  * @brief   Codificador/decodificador LZSS em fluxo com RAM fixa
+  ******************************************************************************
+  */
+
+#include "lzss.h"
+#include <string.h>
+
+#define LZSS_WINDOW_MASK            (LZSS_WINDOW_SIZE - 1)
+#define LZSS_LITERAL_BITS           9
+#define LZSS_BACKREF_BITS           (1 + LZSS_WINDOW_BITS + LZSS_LOOKAHEAD_BITS)
+
+/* ============================================================================
+   CODIFICADOR
+   ============================================================================ */
+/**
+ * @brief Prepara o codificador para um novo fluxo
+ */
+void LZSS_EncoderReset(LZSS_Encoder_t *enc)
+{
+    enc->len = 0;
+    enc->pos = 0;
+    enc->bits = 0;
+    enc->bit_count = 0;
+    enc->finishing = 0;
+}
+
+/**
+ * @brief Entrega bytes ao codificador
+ * @return Quantos bytes foram aceitos (0 se o buffer estiver cheio: chamar Poll)
+ */
+size_t LZSS_EncoderSink(LZSS_Encoder_t *enc, const uint8_t *in, size_t len)
+{
+    if (enc->finishing) {
+        return 0;
+    }
+
+    // Descarta o histórico além de uma janela para abrir espaço
+    if (enc->len == sizeof(enc->buf) && enc->pos > LZSS_WINDOW_SIZE) {
+        uint16_t shift = enc->pos - LZSS_WINDOW_SIZE;
+        memmove(enc->buf, &enc->buf[shift], enc->len - shift);
+        enc->len -= shift;
+        enc->pos -= shift;
+    }
+
+    size_t room = sizeof(enc->buf) - enc->len;
+    if (len > room) {
+        len = room;
+    }
+
+    memcpy(&enc->buf[enc->len], in, len);
+    enc->len += len;
+
+    return len;
+}
+
+/**
+ * @brief Procura no histórico a maior cópia para a posição atual
+ * @param max_len Bytes disponíveis à frente (<= LZSS_MAX_MATCH)
+ * @param dist Saída: distância da cópia (1..LZSS_WINDOW_SIZE)
+ * @return Tamanho da cópia (0 se menor que LZSS_MIN_MATCH)
+ * @note Busca linear na janela; a cópia pode sobrepor a posição atual
+ *       (sequências repetidas viram uma única cópia)
+ */
+static uint16_t LZSS_FindMatch(const LZSS_Encoder_t *enc, uint16_t max_len, uint16_t *dist)
+{
+    const uint8_t *cur = &enc->buf[enc->pos];
+    uint16_t history = (enc->pos < LZSS_WINDOW_SIZE) ? enc->pos : LZSS_WINDOW_SIZE;
+    uint16_t best = 0;
+
+    for (uint16_t d = 1; d <= history; d++) {
+        const uint8_t *cand = cur - d;
+
+        // Rejeita rápido: primeiro byte e o byte que faria a cópia crescer
+        if (cand[0] != cur[0] || cand[best] != cur[best]) {
+            continue;
+        }
+
+        uint16_t n = 1;
+        while (n < max_len && cand[n] == cur[n]) {
+            n++;
+        }
+
+        if (n > best) {
+            best = n;
+            *dist = d;
+            if (best == max_len) {
+                break;
+            }
+        }
+    }
+
+    return (best >= LZSS_MIN_MATCH) ? best : 0;
+}
+
+/**
+ * @brief Codifica o que for possível e copia a saída para out
+ * @return Bytes escritos em out (0 = precisa de mais entrada ou terminou)
+ */
+size_t LZSS_EncoderPoll(LZSS_Encoder_t *enc, uint8_t *out, size_t size)
+{
+    size_t produced = 0;
+
+    while (produced < size) {
+        if (enc->bit_count >= 8) {
+            enc->bit_count -= 8;
+            out[produced++] = (uint8_t)(enc->bits >> enc->bit_count);
+            continue;
+        }
+
+        uint16_t avail = enc->len - enc->pos;
+
+        // Sem a janela de busca completa só codifica no fim do fluxo
+        if (avail == 0 || (!enc->finishing && avail < LZSS_MAX_MATCH)) {
+            if (enc->finishing && avail == 0 && enc->bit_count > 0) {
+                out[produced++] = (uint8_t)(enc->bits << (8 - enc->bit_count));
+                enc->bit_count = 0;
+            }
+            break;
+        }
+
+        uint16_t dist = 0;
+        uint16_t match = LZSS_FindMatch(enc, (avail < LZSS_MAX_MATCH) ? avail : LZSS_MAX_MATCH, &dist);
+
+        if (match > 0) {
+            enc->bits = (enc->bits << LZSS_BACKREF_BITS)
+                      | ((uint32_t)(dist - 1) << LZSS_LOOKAHEAD_BITS)
+                      | (uint32_t)(match - LZSS_MIN_MATCH);
+            enc->bit_count += LZSS_BACKREF_BITS;
+            enc->pos += match;
+        } else {
+            enc->bits = (enc->bits << LZSS_LITERAL_BITS) | 0x100U | enc->buf[enc->pos];
+            enc->bit_count += LZSS_LITERAL_BITS;
+            enc->pos++;
+        }
+    }
+
+    return produced;
+}
+
+/**
+ * @brief Marca o fim da entrada: os próximos Poll esvaziam o codificador
+ */
+void LZSS_EncoderFinish(LZSS_Encoder_t *enc)
+{
+    enc->finishing = 1;
+}
+
+/**
+ * @brief Verifica se toda a entrada já foi codificada e entregue (após Finish)
+ */
+uint8_t LZSS_EncoderIsDone(const LZSS_Encoder_t *enc)
+{
+    return enc->finishing && enc->pos == enc->len && enc->bit_count == 0;
+}
+
+/* ============================================================================
+   DECODIFICADOR
+   ============================================================================ */
+/**
+ * @brief Prepara o decodificador para um novo fluxo
+ */
+void LZSS_DecoderReset(LZSS_Decoder_t *dec)
+{
+    memset(dec->window, 0, sizeof(dec->window));
+    dec->head = 0;
+    dec->in_len = 0;
+    dec->in_pos = 0;
+    dec->bits = 0;
+    dec->bit_count = 0;
+    dec->copy_left = 0;
+    dec->copy_dist = 0;
+}
+
+/**
+ * @brief Entrega bytes comprimidos ao decodificador
+ * @return Quantos bytes foram aceitos (0 se o buffer estiver cheio: chamar Poll)
+ */
+size_t LZSS_DecoderSink(LZSS_Decoder_t *dec, const uint8_t *in, size_t len)
+{
+    if (dec->in_pos > 0) {
+        memmove(dec->in_buf, &dec->in_buf[dec->in_pos], dec->in_len - dec->in_pos);
+        dec->in_len -= dec->in_pos;
+        dec->in_pos = 0;
+    }
+
+    size_t room = sizeof(dec->in_buf) - dec->in_len;
+    if (len > room) {
+        len = room;
+    }
+
+    memcpy(&dec->in_buf[dec->in_len], in, len);
+    dec->in_len += len;
+
+    return len;
+}
+
+/**
+ * @brief Escreve um byte na saída e na janela
+ */
+static inline void LZSS_DecoderEmit(LZSS_Decoder_t *dec, uint8_t byte, uint8_t *out)
+{
+    dec->window[dec->head & LZSS_WINDOW_MASK] = byte;
+    dec->head++;
+    *out = byte;
+}
+
+/**
+ * @brief Decodifica o que for possível para out
+ * @return Bytes escritos em out (0 = precisa de mais entrada)
+ * @note Os bits de preenchimento do último byte (< 8) nunca formam um
+ *       símbolo completo, então o fim do fluxo não precisa ser sinalizado
+ */
+size_t LZSS_DecoderPoll(LZSS_Decoder_t *dec, uint8_t *out, size_t size)
+{
+    size_t produced = 0;
+
+    while (produced < size) {
+        if (dec->copy_left > 0) {
+            uint8_t byte = dec->window[(dec->head - dec->copy_dist) & LZSS_WINDOW_MASK];
+            LZSS_DecoderEmit(dec, byte, &out[produced++]);
+            dec->copy_left--;
+            continue;
+        }
+
+        // Completa o acumulador (cabem 3 bytes além do que já está lá)
+        while (dec->bit_count <= 24 && dec->in_pos < dec->in_len) {
+            dec->bits = (dec->bits << 8) | dec->in_buf[dec->in_pos++];
+            dec->bit_count += 8;
+        }
+
+        if (dec->bit_count == 0) {
+            break;
+        }
+
+        uint8_t literal = (dec->bits >> (dec->bit_count - 1)) & 1U;
+        uint8_t needed = literal ? LZSS_LITERAL_BITS : LZSS_BACKREF_BITS;
+        if (dec->bit_count < needed) {
+            break;  // Símbolo incompleto: espera mais entrada
+        }
+
+        dec->bit_count -= needed;
+        uint32_t symbol = dec->bits >> dec->bit_count;
+
+        if (literal) {
+            LZSS_DecoderEmit(dec, (uint8_t)symbol, &out[produced++]);
+        } else {
+            dec->copy_dist = ((symbol >> LZSS_LOOKAHEAD_BITS) & LZSS_WINDOW_MASK) + 1;
+            dec->copy_left = (symbol & ((1U << LZSS_LOOKAHEAD_BITS) - 1)) + LZSS_MIN_MATCH;
+        }
+    }
+
+    return produced;
+}
@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    matrix.c
+  * @brief   Operações de matriz em float para filtros pequenos (até 6x6)
+  ******************************************************************************
+  */
+
+#include "matrix.h"
+
+void Mat_Init(Mat_t *m, uint16_t rows, uint16_t cols, float *data)
+{
+    m->rows = rows;
+    m->cols = cols;
+    m->data = data;
+}
+
+void Mat_Identity(Mat_t *m)
+{
+    for (uint16_t r = 0; r < m->rows; r++) {
+        for (uint16_t c = 0; c < m->cols; c++) {
+            MAT_AT(m, r, c) = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+/**
+ * @brief dst = a * b (a: n x k, b: k x m, dst: n x m)
+ */
+void Mat_Mult(const Mat_t *a, const Mat_t *b, Mat_t *dst)
+{
+    for (uint16_t r = 0; r < a->rows; r++) {
+        const float *row = &a->data[r * a->cols];
+        for (uint16_t c = 0; c < b->cols; c++) {
+            float sum = 0.0f;
+            for (uint16_t k = 0; k < a->cols; k++) {
+                sum += row[k] * b->data[k * b->cols + c];
+            }
+            MAT_AT(dst, r, c) = sum;
+        }
+    }
+}
+
+/**
+ * @brief dst = a * b^T (a: n x k, b: m x k, dst: n x m)
+ * @note Percorre as duas entradas por linha: evita a transposta explícita
+ */
+void Mat_MultTrans(const Mat_t *a, const Mat_t *b, Mat_t *dst)
+{
+    for (uint16_t r = 0; r < a->rows; r++) {
+        const float *row_a = &a->data[r * a->cols];
+        for (uint16_t c = 0; c < b->rows; c++) {
+            const float *row_b = &b->data[c * b->cols];
+            float sum = 0.0f;
+            for (uint16_t k = 0; k < a->cols; k++) {
+                sum += row_a[k] * row_b[k];
+            }
+            MAT_AT(dst, r, c) = sum;
+        }
+    }
+}
+
+void Mat_Trans(const Mat_t *a, Mat_t *dst)
+{
+    for (uint16_t r = 0; r < a->rows; r++) {
+        for (uint16_t c = 0; c < a->cols; c++) {
+            MAT_AT(dst, c, r) = MAT_AT(a, r, c);
+        }
+    }
+}
+
+void Mat_Add(const Mat_t *a, const Mat_t *b, Mat_t *dst)
+{
+    uint32_t n = (uint32_t)a->rows * a->cols;
+    for (uint32_t i = 0; i < n; i++) {
+        dst->data[i] = a->data[i] + b->data[i];
+    }
+}
+
+void Mat_Sub(const Mat_t *a, const Mat_t *b, Mat_t *dst)
+{
+    uint32_t n = (uint32_t)a->rows * a->cols;
+    for (uint32_t i = 0; i < n; i++) {
+        dst->data[i] = a->data[i] - b->data[i];
+    }
+}
+
+void Mat_Scale(const Mat_t *a, float k, Mat_t *dst)
+{
+    uint32_t n = (uint32_t)a->rows * a->cols;
+    for (uint32_t i = 0; i < n; i++) {
+        dst->data[i] = a->data[i] * k;
+    }
+}
+
+/**
+ * @brief m = (m + m^T) / 2 (quadrada); segura a covariância simétrica
+ */
+void Mat_Symmetrize(Mat_t *m)
+{
+    for (uint16_t r = 0; r < m->rows; r++) {
+        for (uint16_t c = r + 1; c < m->cols; c++) {
+            float avg = 0.5f * (MAT_AT(m, r, c) + MAT_AT(m, c, r));
+            MAT_AT(m, r, c) = avg;
+            MAT_AT(m, c, r) = avg;
+        }
+    }
+}
+
+/**
+ * @brief dst = a^-1 (quadrada, ordem até MAT_MAX_INVERSE)
+ * @return 1 se inverteu; 0 se singular (dst indefinida)
+ */
+uint8_t Mat_Inverse(Mat_t *a, Mat_t *dst)
+{
+    uint16_t n = a->rows;
+
+    if (n == 0 || n > MAT_MAX_INVERSE || a->cols != n) {
+        return 0;
+    }
+
+    Mat_Identity(dst);
+
+    for (uint16_t col = 0; col < n; col++) {
+        // Pivô: maior valor absoluto da coluna
+        uint16_t pivot = col;
+        float best = (MAT_AT(a, col, col) < 0.0f) ? -MAT_AT(a, col, col) : MAT_AT(a, col, col);
+        for (uint16_t r = col + 1; r < n; r++) {
+            float v = (MAT_AT(a, r, col) < 0.0f) ? -MAT_AT(a, r, col) : MAT_AT(a, r, col);
+            if (v > best) {
+                best = v;
+                pivot = r;
+            }
+        }
+        if (best < 1e-20f) {
+            return 0;
+        }
+
+        if (pivot != col) {
+            for (uint16_t c = 0; c < n; c++) {
+                float t = MAT_AT(a, col, c);
+                MAT_AT(a, col, c) = MAT_AT(a, pivot, c);
+                MAT_AT(a, pivot, c) = t;
+                t = MAT_AT(dst, col, c);
+                MAT_AT(dst, col, c) = MAT_AT(dst, pivot, c);
+                MAT_AT(dst, pivot, c) = t;
+            }
+        }
+
+        float inv = 1.0f / MAT_AT(a, col, col);
+        for (uint16_t c = 0; c < n; c++) {
+            MAT_AT(a, col, c) *= inv;
+            MAT_AT(dst, col, c) *= inv;
+        }
+
+        for (uint16_t r = 0; r < n; r++) {
+            float f = MAT_AT(a, r, col);
+            if (r == col || f == 0.0f) {
+                continue;
+            }
+            for (uint16_t c = 0; c < n; c++) {
+                MAT_AT(a, r, c) -= f * MAT_AT(a, col, c);
+                MAT_AT(dst, r, c) -= f * MAT_AT(dst, col, c);
+            }
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,333 @@
+/**
+  ******************************************************************************
+  * @file    mekf.c
+  * @brief   MEKF de atitude (erro multiplicativo + bias do giroscópio)
+  ******************************************************************************
+  */
+
+#include "mekf.h"
+#include "matrix.h"
+#include <math.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static float Mekf_Normalize3(float v[3])
+{
+    float norm = Attitude_Sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+    if (norm > 0.0f) {
+        float inv = 1.0f / norm;
+        v[0] *= inv;
+        v[1] *= inv;
+        v[2] *= inv;
+    }
+    return norm;
+}
+
+static void Mekf_NormalizeQuat(Attitude_Quat_t *q)
+{
+    float inv = 1.0f / Attitude_Sqrt(q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z);
+    q->w *= inv;
+    q->x *= inv;
+    q->y *= inv;
+    q->z *= inv;
+}
+
+/**
+ * @brief q = q (x) (1, v/2), normalizado (rotação pequena no corpo)
+ */
+static void Mekf_RotateSmall(Attitude_Quat_t *q, float vx, float vy, float vz)
+{
+    Attitude_Quat_t p = *q;
+    vx *= 0.5f;
+    vy *= 0.5f;
+    vz *= 0.5f;
+    q->w = p.w - p.x * vx - p.y * vy - p.z * vz;
+    q->x = p.x + p.w * vx + p.y * vz - p.z * vy;
+    q->y = p.y + p.w * vy - p.x * vz + p.z * vx;
+    q->z = p.z + p.w * vz + p.x * vy - p.y * vx;
+    Mekf_NormalizeQuat(q);
+}
+
+/**
+ * @brief Correção com m medidas (m <= 3): inovação y, H (m x 6) em mekf->h
+ * @param r_var Variância de cada medida
+ * @param axis Direção de referência no corpo (unitária): a medida não corrige
+ *        a rotação em torno dela
+ * @return 0 se a covariância da inovação for singular (nada muda)
+ * @note H não vê a rotação em torno de axis, mas as correlações de P levariam
+ *       parte da correção para lá; com a linearização mudando a cada passo,
+ *       o desvio nesse eixo cairia sem o erro cair junto. O ganho é projetado
+ *       fora de axis e P (Joseph com o ganho projetado) fica
+ *       P - K H P + (u^T K H P u) u u^T, u = axis
+ */
+static uint8_t Mekf_Correct(Mekf_t *mekf, const float *y, uint16_t m, float r_var,
+                            const float axis[3])
+{
+    Mat_t P, H, PHt, S, S_inv, K, tmp;
+
+    Mat_Init(&P, MEKF_STATES, MEKF_STATES, mekf->P);
+    Mat_Init(&H, m, MEKF_STATES, mekf->h);
+    Mat_Init(&PHt, MEKF_STATES, m, mekf->pht);
+    Mat_Init(&S, m, m, mekf->s);
+    Mat_Init(&S_inv, m, m, mekf->s_inv);
+    Mat_Init(&K, MEKF_STATES, m, mekf->k);
+    Mat_Init(&tmp, MEKF_STATES, MEKF_STATES, mekf->tmp);
+
+    // S = H P H^T + R
+    Mat_MultTrans(&P, &H, &PHt);
+    Mat_Mult(&H, &PHt, &S);
+    for (uint16_t i = 0; i < m; i++) {
+        MAT_AT(&S, i, i) += r_var;
+    }
+    if (!Mat_Inverse(&S, &S_inv)) {
+        mekf->rejected++;
+        return 0;
+    }
+
+    // K = P H^T S^-1;  x = K y
+    Mat_Mult(&PHt, &S_inv, &K);
+
+    float x[MEKF_STATES];
+    for (uint16_t r = 0; r < MEKF_STATES; r++) {
+        x[r] = 0.0f;
+        for (uint16_t c = 0; c < m; c++) {
+            x[r] += MAT_AT(&K, r, c) * y[c];
+        }
+    }
+
+    // P = P - K (H P) = P - K (P H^T)^T (P simétrica)
+    Mat_MultTrans(&K, &PHt, &tmp);
+    float lost = 0.0f;
+    for (uint16_t r = 0; r < 3; r++) {
+        for (uint16_t c = 0; c < 3; c++) {
+            lost += axis[r] * MAT_AT(&tmp, r, c) * axis[c];
+        }
+    }
+    Mat_Sub(&P, &tmp, &P);
+    for (uint16_t r = 0; r < 3; r++) {
+        for (uint16_t c = 0; c < 3; c++) {
+            MAT_AT(&P, r, c) += lost * axis[r] * axis[c];
+        }
+    }
+    Mat_Symmetrize(&P);
+
+    // Correção só fora de axis
+    float along = x[0] * axis[0] + x[1] * axis[1] + x[2] * axis[2];
+    x[0] -= along * axis[0];
+    x[1] -= along * axis[1];
+    x[2] -= along * axis[2];
+
+    // Reset do erro: vai para o estado nominal
+    Mekf_RotateSmall(&mekf->q, x[0], x[1], x[2]);
+    mekf->bias[0] += x[3];
+    mekf->bias[1] += x[4];
+    mekf->bias[2] += x[5];
+    mekf->updates++;
+    return 1;
+}
+
+/**
+ * @brief Correção por uma direção de referência (3 componentes)
+ * @param meas Direção medida no corpo (unitária)
+ * @param ref Direção de referência no sistema inercial (unitária)
+ */
+static uint8_t Mekf_UpdateVector(Mekf_t *mekf, const float meas[3], const float ref[3], float sigma)
+{
+    float v[3];
+    float y[3];
+
+    Attitude_RotateToBody(&mekf->q, ref, v);
+
+    // H = [[v x], 0]
+    float *h = mekf->h;
+    for (uint8_t i = 0; i < 3 * MEKF_STATES; i++) {
+        h[i] = 0.0f;
+    }
+    h[1] = -v[2];  h[2] = v[1];
+    h[MEKF_STATES + 0] = v[2];  h[MEKF_STATES + 2] = -v[0];
+    h[2 * MEKF_STATES + 0] = -v[1];  h[2 * MEKF_STATES + 1] = v[0];
+
+    y[0] = meas[0] - v[0];
+    y[1] = meas[1] - v[1];
+    y[2] = meas[2] - v[2];
+
+    return Mekf_Correct(mekf, y, 3, sigma * sigma, v);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Configura ruídos e zera o estado (atitude identidade)
+ * @note Preenche todo o Mekf_t: pode ficar em memória não inicializada
+ */
+void Mekf_Init(Mekf_t *mekf, const Mekf_Config_t *cfg)
+{
+    static const float sun_default[3] = {1.0f, 0.0f, 0.0f};
+
+    mekf->cfg = *cfg;
+    Mekf_SetSunReference(mekf, sun_default, 0);
+    Mekf_Reset(mekf);
+}
+
+/**
+ * @brief Volta para atitude identidade, bias zero e covariância inicial
+ */
+void Mekf_Reset(Mekf_t *mekf)
+{
+    Mat_t P;
+    float att_var = mekf->cfg.att_sigma0 * mekf->cfg.att_sigma0;
+    float bias_var = mekf->cfg.bias_sigma0 * mekf->cfg.bias_sigma0;
+
+    mekf->q.w = 1.0f;
+    mekf->q.x = 0.0f;
+    mekf->q.y = 0.0f;
+    mekf->q.z = 0.0f;
+    mekf->bias[0] = 0.0f;
+    mekf->bias[1] = 0.0f;
+    mekf->bias[2] = 0.0f;
+
+    Mat_Init(&P, MEKF_STATES, MEKF_STATES, mekf->P);
+    Mat_Identity(&P);
+    for (uint8_t i = 0; i < 3; i++) {
+        MAT_AT(&P, i, i) = att_var;
+        MAT_AT(&P, i + 3, i + 3) = bias_var;
+    }
+
+    mekf->acc_used = 0;
+    mekf->sun_used = 0;
+    mekf->predicts = 0;
+    mekf->updates = 0;
+    mekf->rejected = 0;
+}
+
+/**
+ * @brief Direção do Sol no sistema inercial
+ * @param planar 1 se o sensor só mede o azimute no plano XY do corpo
+ */
+void Mekf_SetSunReference(Mekf_t *mekf, const float ref[3], uint8_t planar)
+{
+    mekf->sun_ref[0] = ref[0];
+    mekf->sun_ref[1] = ref[1];
+    mekf->sun_ref[2] = ref[2];
+    Mekf_Normalize3(mekf->sun_ref);
+    mekf->sun_planar = planar;
+}
+
+/**
+ * @brief Propaga atitude e covariância com o giroscópio
+ * @param gyro Velocidade angular medida no corpo (rad/s)
+ * @param dt Período desde a última propagação (s)
+ */
+void Mekf_Predict(Mekf_t *mekf, const float gyro[3], float dt)
+{
+    Mat_t P, Phi, tmp;
+    float wx = gyro[0] - mekf->bias[0];
+    float wy = gyro[1] - mekf->bias[1];
+    float wz = gyro[2] - mekf->bias[2];
+
+    Mekf_RotateSmall(&mekf->q, wx * dt, wy * dt, wz * dt);
+
+    // Phi = [I - [w x]dt, -I dt; 0, I]
+    Mat_Init(&Phi, MEKF_STATES, MEKF_STATES, mekf->phi);
+    Mat_Identity(&Phi);
+    MAT_AT(&Phi, 0, 1) = wz * dt;   MAT_AT(&Phi, 0, 2) = -wy * dt;
+    MAT_AT(&Phi, 1, 0) = -wz * dt;  MAT_AT(&Phi, 1, 2) = wx * dt;
+    MAT_AT(&Phi, 2, 0) = wy * dt;   MAT_AT(&Phi, 2, 1) = -wx * dt;
+    for (uint8_t i = 0; i < 3; i++) {
+        MAT_AT(&Phi, i, i + 3) = -dt;
+    }
+
+    // P = Phi P Phi^T + Q
+    Mat_Init(&P, MEKF_STATES, MEKF_STATES, mekf->P);
+    Mat_Init(&tmp, MEKF_STATES, MEKF_STATES, mekf->tmp);
+    Mat_Mult(&Phi, &P, &tmp);
+    Mat_MultTrans(&tmp, &Phi, &P);
+
+    float q_att = mekf->cfg.gyro_noise * mekf->cfg.gyro_noise * dt;
+    float q_bias = mekf->cfg.bias_noise * mekf->cfg.bias_noise * dt;
+    for (uint8_t i = 0; i < 3; i++) {
+        MAT_AT(&P, i, i) += q_att;
+        MAT_AT(&P, i + 3, i + 3) += q_bias;
+    }
+
+    mekf->predicts++;
+}
+
+/**
+ * @brief Correção pela gravidade (acelerômetro)
+ * @param accel Força específica no corpo (m/s²)
+ * @return 1 se usou a medida; 0 fora de 1 g +- ATTITUDE_ACC_GATE
+ */
+uint8_t Mekf_UpdateGravity(Mekf_t *mekf, const float accel[3])
+{
+    static const float gravity_ref[3] = {0.0f, 0.0f, 1.0f};
+    float m[3] = {accel[0], accel[1], accel[2]};
+    float norm = Mekf_Normalize3(m);
+
+    mekf->acc_used = 0;
+    if (fabsf(norm - ATTITUDE_GRAVITY) >= ATTITUDE_ACC_GATE * ATTITUDE_GRAVITY) {
+        return 0;
+    }
+
+    mekf->acc_used = Mekf_UpdateVector(mekf, m, gravity_ref, mekf->cfg.acc_noise);
+    return mekf->acc_used;
+}
+
+/**
+ * @brief Correção pelo vetor solar
+ * @param sun Direção do Sol no corpo (qualquer norma)
+ * @return 1 se usou a medida
+ * @note Uma chamada por amostra nova do sensor: a mesma medida aplicada de
+ *       novo entra como informação independente e a covariância encolhe
+ *       sem motivo
+ */
+uint8_t Mekf_UpdateSun(Mekf_t *mekf, const float sun[3])
+{
+    float m[3] = {sun[0], sun[1], sun[2]};
+
+    mekf->sun_used = 0;
+
+    if (!mekf->sun_planar) {
+        if (Mekf_Normalize3(m) > 0.0f) {
+            mekf->sun_used = Mekf_UpdateVector(mekf, m, mekf->sun_ref, mekf->cfg.sun_noise);
+        }
+        return mekf->sun_used;
+    }
+
+    // Azimute: y = ângulo de v_xy até m_xy; H = d(azimute)/d(dtheta)
+    float v[3];
+    Attitude_RotateToBody(&mekf->q, mekf->sun_ref, v);
+
+    float rho2 = v[0] * v[0] + v[1] * v[1];
+    if (rho2 < ATTITUDE_SUN_MIN_NORM * ATTITUDE_SUN_MIN_NORM ||
+        (m[0] == 0.0f && m[1] == 0.0f)) {
+        return 0;
+    }
+
+    float y = atan2f(v[0] * m[1] - v[1] * m[0], v[0] * m[0] + v[1] * m[1]);
+
+    float *h = mekf->h;
+    h[0] = v[0] * v[2] / rho2;
+    h[1] = v[1] * v[2] / rho2;
+    h[2] = -1.0f;
+    h[3] = 0.0f;
+    h[4] = 0.0f;
+    h[5] = 0.0f;
+
+    // Com o Sol perto de +-Z sobra pouco sinal no plano XY: o desvio do
+    // azimute cresce com 1/rho (mesmo ruído dos LDRs sobre uma projeção menor)
+    mekf->sun_used = Mekf_Correct(mekf, &y, 1, mekf->cfg.sun_noise * mekf->cfg.sun_noise / rho2,
+                                  v);
+    return mekf->sun_used;
+}
+
+void Mekf_GetSigma(const Mekf_t *mekf, float att_sigma[3], float bias_sigma[3])
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        att_sigma[i] = Attitude_Sqrt(mekf->P[i * MEKF_STATES + i]);
+        bias_sigma[i] = Attitude_Sqrt(mekf->P[(i + 3) * MEKF_STATES + i + 3]);
+    }
+}
@@ -0,0 +1,249 @@
+/**
+  ******************************************************************************
+  * @file    pid.c
+  * @brief   PID discreto (float e Q31) com derivada filtrada e back-calculation
+  ******************************************************************************
+  */
+
+#include "pid.h"
+
+#define PID_Q31_MAX_SHIFT       15
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static inline float PID_Clamp(float x, float lo, float hi)
+{
+    return (x > hi) ? hi : (x < lo) ? lo : x;
+}
+
+static inline int64_t PID_Clamp64(int64_t x, int64_t lo, int64_t hi)
+{
+    return (x > hi) ? hi : (x < lo) ? lo : x;
+}
+
+static inline int32_t PID_Sat32(int64_t x)
+{
+    return (int32_t)PID_Clamp64(x, INT32_MIN, INT32_MAX);
+}
+
+/**
+ * @brief Ganho Q31 (com shift) vezes valor Q31
+ * @return Resultado em Q31, sem saturar (64 bits)
+ */
+static inline int64_t PID_MulQ31(int32_t gain, int32_t x, uint8_t shift)
+{
+    return ((int64_t)gain * x) >> (31 - shift);
+}
+
+/**
+ * @brief Recalcula os coeficientes derivados de ganhos e período
+ */
+static void PID_F32_Coefficients(PID_F32_t *pid)
+{
+    const PID_Config_t *cfg = &pid->cfg;
+    float den = cfg->tau + cfg->dt;
+
+    pid->d_alpha = (den > 0.0f) ? cfg->tau / den : 0.0f;
+    pid->d_gain = (den > 0.0f) ? cfg->kd / den : 0.0f;
+    pid->ki_dt = cfg->ki * cfg->dt;
+    pid->kt_dt = cfg->kt * cfg->dt;
+}
+
+static void PID_Q31_Coefficients(PID_Q31_t *pid)
+{
+    const PID_Config_t *cfg = &pid->cfg;
+    float den = cfg->tau + cfg->dt;
+    float d_alpha = (den > 0.0f) ? cfg->tau / den : 0.0f;
+    float d_gain = (den > 0.0f) ? cfg->kd / den : 0.0f;
+    float ki_dt = cfg->ki * cfg->dt;
+    float kt_dt = cfg->kt * cfg->dt;
+
+    // Menor shift que acomoda o maior ganho (mais resolução nos pequenos)
+    float largest = (cfg->kp < 0.0f) ? -cfg->kp : cfg->kp;
+    if (d_gain > largest) largest = d_gain;
+    if (ki_dt > largest) largest = ki_dt;
+    if (kt_dt > largest) largest = kt_dt;
+
+    uint8_t shift = 0;
+    while (shift < PID_Q31_MAX_SHIFT && largest >= (float)(1UL << shift)) {
+        shift++;
+    }
+
+    float scale = 1.0f / (float)(1UL << shift);
+    pid->shift = shift;
+    pid->kp = PID_FLOAT_TO_Q31(cfg->kp * scale);
+    pid->ki_dt = PID_FLOAT_TO_Q31(ki_dt * scale);
+    pid->kt_dt = PID_FLOAT_TO_Q31(kt_dt * scale);
+    pid->d_gain = PID_FLOAT_TO_Q31(d_gain * scale);
+    pid->d_alpha = PID_FLOAT_TO_Q31(d_alpha);
+}
+
+/* ============================================================================
+   FLOAT
+   ============================================================================ */
+/**
+ * @brief Configura o controlador e zera o estado
+ */
+void PID_F32_Init(PID_F32_t *pid, const PID_Config_t *cfg)
+{
+    pid->cfg = *cfg;
+    PID_F32_Coefficients(pid);
+    PID_F32_Reset(pid);
+}
+
+/**
+ * @brief Zera integral, derivada e histórico (mantém ganhos)
+ */
+void PID_F32_Reset(PID_F32_t *pid)
+{
+    pid->integrator = 0.0f;
+    pid->deriv = 0.0f;
+    pid->last_meas = 0.0f;
+    pid->last_error = 0.0f;
+    pid->primed = 0;
+}
+
+/**
+ * @brief Uma iteração do controlador (chamar a cada cfg.dt)
+ * @return Saída já limitada a [out_min, out_max]
+ */
+float PID_F32_Update(PID_F32_t *pid, float setpoint, float measurement)
+{
+    float error = setpoint - measurement;
+
+    if (!pid->primed) {
+        pid->last_meas = measurement;   // Sem derivada na primeira amostra
+        pid->primed = 1;
+    }
+
+    pid->deriv = pid->d_alpha * pid->deriv - pid->d_gain * (measurement - pid->last_meas);
+    pid->last_meas = measurement;
+
+    float out = pid->cfg.kp * error + pid->integrator + pid->deriv;
+    float out_sat = PID_Clamp(out, pid->cfg.out_min, pid->cfg.out_max);
+
+    // Back-calculation: o excesso sobre o limite descarrega a integral
+    pid->integrator += pid->ki_dt * error + pid->kt_dt * (out_sat - out);
+    pid->integrator = PID_Clamp(pid->integrator, pid->cfg.out_min, pid->cfg.out_max);
+    pid->last_error = error;
+
+    return out_sat;
+}
+
+/**
+ * @brief Troca os ganhos sem degrau na saída
+ * @note A diferença do termo proporcional vai para a integral; I e D já
+ *       estão multiplicados pelos ganhos e não mudam
+ */
+void PID_F32_SetGains(PID_F32_t *pid, float kp, float ki, float kd)
+{
+    if (pid->primed) {
+        pid->integrator += (pid->cfg.kp - kp) * pid->last_error;
+        pid->integrator = PID_Clamp(pid->integrator, pid->cfg.out_min, pid->cfg.out_max);
+    }
+
+    pid->cfg.kp = kp;
+    pid->cfg.ki = ki;
+    pid->cfg.kd = kd;
+    PID_F32_Coefficients(pid);
+}
+
+/**
+ * @brief Muda o período de amostragem (ganhos em unidades de tempo real)
+ */
+void PID_F32_SetSampleTime(PID_F32_t *pid, float dt)
+{
+    pid->cfg.dt = dt;
+    PID_F32_Coefficients(pid);
+}
+
+/**
+ * @brief Muda os limites do atuador (pode ser chamada a cada iteração)
+ */
+void PID_F32_SetLimits(PID_F32_t *pid, float out_min, float out_max)
+{
+    pid->cfg.out_min = out_min;
+    pid->cfg.out_max = out_max;
+}
+
+/* ============================================================================
+   Q31
+   ============================================================================ */
+/**
+ * @brief Configura o controlador e zera o estado
+ * @note Limites do cfg em fundo de escala (-1.0 a 1.0); único ponto com
+ *       float além do SetGains
+ */
+void PID_Q31_Init(PID_Q31_t *pid, const PID_Config_t *cfg)
+{
+    pid->cfg = *cfg;
+    pid->out_min = PID_FLOAT_TO_Q31(cfg->out_min);
+    pid->out_max = PID_FLOAT_TO_Q31(cfg->out_max);
+    PID_Q31_Coefficients(pid);
+    PID_Q31_Reset(pid);
+}
+
+void PID_Q31_Reset(PID_Q31_t *pid)
+{
+    pid->integrator = 0;
+    pid->deriv = 0;
+    pid->last_meas = 0;
+    pid->last_error = 0;
+    pid->primed = 0;
+}
+
+/**
+ * @brief Uma iteração do controlador, só com inteiros
+ * @return Saída Q31 já limitada a [out_min, out_max]
+ */
+int32_t PID_Q31_Update(PID_Q31_t *pid, int32_t setpoint, int32_t measurement)
+{
+    int32_t error = PID_Sat32((int64_t)setpoint - measurement);
+
+    if (!pid->primed) {
+        pid->last_meas = measurement;
+        pid->primed = 1;
+    }
+
+    int32_t delta = PID_Sat32((int64_t)measurement - pid->last_meas);
+    pid->deriv = PID_Sat32(PID_MulQ31(pid->d_alpha, pid->deriv, 0) -
+                           PID_MulQ31(pid->d_gain, delta, pid->shift));
+    pid->last_meas = measurement;
+
+    int64_t out = PID_MulQ31(pid->kp, error, pid->shift) + pid->integrator + pid->deriv;
+    int32_t out_sat = (int32_t)PID_Clamp64(out, pid->out_min, pid->out_max);
+
+    int64_t integrator = (int64_t)pid->integrator
+                       + PID_MulQ31(pid->ki_dt, error, pid->shift)
+                       + PID_MulQ31(pid->kt_dt, PID_Sat32(out_sat - out), pid->shift);
+    pid->integrator = (int32_t)PID_Clamp64(integrator, pid->out_min, pid->out_max);
+    pid->last_error = error;
+
+    return out_sat;
+}
+
+/**
+ * @brief Troca os ganhos sem degrau na saída (usa float: fora da ISR)
+ */
+void PID_Q31_SetGains(PID_Q31_t *pid, float kp, float ki, float kd)
+{
+    if (pid->primed) {
+        float integrator = PID_Q31_TO_FLOAT(pid->integrator) +
+                           (pid->cfg.kp - kp) * PID_Q31_TO_FLOAT(pid->last_error);
+        integrator = PID_Clamp(integrator, PID_Q31_TO_FLOAT(pid->out_min),
+                               PID_Q31_TO_FLOAT(pid->out_max));
+        pid->integrator = PID_FLOAT_TO_Q31(integrator);
+    }
+
+    pid->cfg.kp = kp;
+    pid->cfg.ki = ki;
+    pid->cfg.kd = kd;
+    PID_Q31_Coefficients(pid);
+}
+
+void PID_Q31_SetLimits(PID_Q31_t *pid, int32_t out_min, int32_t out_max)
+{
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+}
@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file    profile.c
+  * @brief   Perfil de velocidade da roda (trapezoidal ou curva S)
+  ******************************************************************************
+  */
+
+#include "profile.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static inline float Profile_Clamp(float x, float lo, float hi)
+{
+    return (x < lo) ? lo : ((x > hi) ? hi : x);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Profile_Init(Profile_t *p, const Profile_Config_t *cfg)
+{
+    memset(p, 0, sizeof(Profile_t));
+    p->cfg = *cfg;
+}
+
+void Profile_Reset(Profile_t *p, float speed)
+{
+    p->speed = speed;
+    p->accel = 0.0f;
+    p->target = speed;
+}
+
+void Profile_SetTarget(Profile_t *p, float target)
+{
+    p->target = Profile_Clamp(target, p->cfg.speed_min, p->cfg.speed_max);
+}
+
+/**
+ * @brief Um passo do perfil
+ * @note O último passo cai exatamente no alvo (sem ultrapassar por
+ *       discretização); a aceleração residual nesse passo é < 2 jerk dt
+ */
+float Profile_Update(Profile_t *p, float dt)
+{
+    float error = p->target - p->speed;
+    float dir = (error >= 0.0f) ? 1.0f : -1.0f;
+
+    if (error == 0.0f && p->accel == 0.0f) {
+        return p->speed;
+    }
+
+    if (p->cfg.jerk_max > 0.0f) {
+        // Maior aceleração que ainda freia a jerk_max até o alvo
+        float brake = sqrtf(2.0f * p->cfg.jerk_max * fabsf(error));
+        float goal = dir * fminf(p->cfg.accel_max, brake);
+        float step = p->cfg.jerk_max * dt;
+
+        p->accel += Profile_Clamp(goal - p->accel, -step, step);
+
+        // Sobre a curva de frenagem a aceleração a acompanha (jerk ~ jerk_max)
+        if (p->accel * dir > brake) {
+            p->accel = dir * brake;
+        }
+    } else {
+        p->accel = dir * p->cfg.accel_max;
+    }
+
+    float dv = p->accel * dt;
+    if (dv * dir >= fabsf(error) && p->accel * dir >= 0.0f) {
+        p->speed = p->target;
+        p->accel = 0.0f;
+    } else {
+        p->speed += dv;
+    }
+
+    return p->speed;
+}
+
+uint8_t Profile_IsDone(const Profile_t *p)
+{
+    return p->speed == p->target && p->accel == 0.0f;
+}
+
+float Profile_Duration(const Profile_Config_t *cfg, float dv)
+{
+    float a = cfg->accel_max;
+    float j = cfg->jerk_max;
+
+    dv = fabsf(dv);
+    if (a <= 0.0f) {
+        return 0.0f;
+    }
+    if (j <= 0.0f) {
+        return dv / a;
+    }
+    if (dv >= a * a / j) {
+        return dv / a + a / j;
+    }
+    return 2.0f * sqrtf(dv / j);
+}
@@ -0,0 +1,234 @@
+/**
+  ******************************************************************************
+  * @file    framing_test.c
+  * @brief   Teste de loopback do comando da roda: codificador do firmware
+  *          (adcs.c, ADCS_SetFraming) contra o pollSerial() do sketch de
+  *          ADCS_EXAMPLES.md (simplefoc.c)
+  *
+  *   framing_test
+  *
+  * Os bytes saem pelo DMA da UART4 emulada (sim_hal.c) e entram no
+  * SimpleFOC emulado; uma escuta na linha guarda o que foi enviado e pode
+  * corromper um byte. Confere:
+  *   - ASCII: "MC1" na inicialização, "M{inteiro}\n" arredondado,
+  *     supressão de repetição e reenvio depois de ADCS_KEEPALIVE_MS;
+  *   - binário: frame de 7 bytes com o float exato, configuração em ASCII
+  *     aceita no mesmo modo, volta para ASCII;
+  *   - CRC: frame corrompido descartado sem mexer no alvo;
+  *   - ressincronização: SYNC falso (no CRC corrompido ou em ruído na
+  *     linha) e o próximo frame do firmware ainda é aceito.
+  *
+  * Código de saída: 0 se todas as verificações passaram, 1 se alguma falhou.
+  ******************************************************************************
+  */
+
+#include "sim.h"
+#include "sim_hal.h"
+#include "simplefoc.h"
+#include "plant.h"
+#include "adcs.h"
+#include "usart.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_STEP_S             0.001
+#define TEST_WAIT_MS            5       // Comando de até 7 bytes: < 1 ms de linha
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+static Plant_t plant;
+static SimpleFOC_t foc;
+static double test_t = 0.0;
+
+// Escuta da linha CDH -> SimpleFOC
+static uint8_t seen[64];
+static uint16_t seen_len = 0;
+static int8_t corrupt_index = -1;       // Byte a trocar no próximo trecho (-1 = nenhum)
+static uint8_t corrupt_value = 0;
+
+static int checks = 0;
+static int failures = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Test_Tap(uint8_t *data, uint16_t size)
+{
+    if (corrupt_index >= 0 && corrupt_index < size) {
+        data[corrupt_index] = corrupt_value;
+        corrupt_index = -1;
+    }
+
+    for (uint16_t i = 0; i < size && seen_len < sizeof(seen); i++) {
+        seen[seen_len++] = data[i];
+    }
+}
+
+/**
+ * @brief HAL_Delay e espera do teste: só relógio e UART (a roda não importa)
+ */
+static void Test_Advance(double t_end)
+{
+    while (test_t < t_end - 0.5 * TEST_STEP_S) {
+        test_t += TEST_STEP_S;
+        SimHal_SetTime(test_t);
+        SimHal_Poll();
+    }
+}
+
+static void Test_Wait(uint32_t ms)
+{
+    Test_Advance(test_t + ms * 1e-3);
+}
+
+/**
+ * @brief Comando de velocidade do firmware até chegar do outro lado
+ */
+static void Test_Speed(float speed)
+{
+    seen_len = 0;
+    ADCS_SetSpeedFloat(&huart4, speed);
+    Test_Wait(TEST_WAIT_MS);
+}
+
+static void Test_Check(int ok, const char *what)
+{
+    checks++;
+    if (!ok) {
+        failures++;
+    }
+    printf("%s %s\n", ok ? "ok   " : "FALHA", what);
+}
+
+static int Test_Seen(const char *text)
+{
+    size_t len = strlen(text);
+    return seen_len == len && memcmp(seen, text, len) == 0;
+}
+
+static int Test_SeenBinary(float value)
+{
+    return seen_len == ADCS_BIN_FRAME_SIZE && seen[0] == ADCS_BIN_SYNC &&
+           seen[1] == ADCS_BIN_CMD_TARGET && memcmp(&seen[2], &value, sizeof(value)) == 0;
+}
+
+/* ============================================================================
+   VERIFICAÇÕES
+   ============================================================================ */
+static void Test_Ascii(void)
+{
+    Test_Check(foc.ascii_commands == 1 && foc.controller == SIMPLEFOC_CONTROL_VELOCITY &&
+               foc.unknown == 0, "ASCII: MC1 na inicialização");
+
+    Test_Speed(42.4f);
+    Test_Check(Test_Seen("M42\n") && foc.target == 42.0, "ASCII: 42.4 sai como M42");
+
+    Test_Speed(-17.6f);
+    Test_Check(Test_Seen("M-18\n") && foc.target == -18.0, "ASCII: -17.6 sai como M-18");
+
+    // Arredondado, -18.2 é o mesmo comando: não sai de novo
+    uint32_t before = foc.ascii_commands;
+    Test_Speed(-18.2f);
+    Test_Check(seen_len == 0 && foc.ascii_commands == before, "ASCII: repetição suprimida");
+
+    Test_Wait(ADCS_KEEPALIVE_MS);
+    Test_Speed(-18.2f);
+    Test_Check(Test_Seen("M-18\n") && foc.ascii_commands == before + 1,
+               "ASCII: reenvio depois de ADCS_KEEPALIVE_MS");
+}
+
+static void Test_Binary(void)
+{
+    ADCS_SetFraming(ADCS_FRAMING_BINARY);
+
+    // Mesma velocidade do último comando ASCII: sai assim mesmo, no novo formato
+    Test_Speed(-18.0f);
+    Test_Check(Test_SeenBinary(-18.0f) && foc.binary_commands == 1,
+               "binário: troca de formato invalida a supressão");
+
+    // Exemplo de ADCS_EXAMPLES.md: A5 01 00 00 2A 42 CRC
+    static const uint8_t example[6] = {0xA5, 0x01, 0x00, 0x00, 0x2A, 0x42};
+    Test_Speed(42.5f);
+    Test_Check(seen_len == ADCS_BIN_FRAME_SIZE && memcmp(seen, example, 6) == 0 &&
+               foc.target == 42.5 && foc.crc_errors == 0, "binário: 42.5 como no exemplo");
+
+    Test_Speed(-17.6f);
+    Test_Check(Test_SeenBinary(-17.6f) && foc.target == (double)-17.6f,
+               "binário: fração chega exata");
+
+    uint32_t before = foc.ascii_commands;
+    seen_len = 0;
+    ADCS_SendCommand(&huart4, ADCS_CMD_SELECT_MOTOR);
+    Test_Wait(TEST_WAIT_MS);
+    Test_Check(Test_Seen(ADCS_CMD_SELECT_MOTOR) && foc.ascii_commands == before + 1 &&
+               foc.unknown == 0, "binário: configuração em ASCII continua aceita");
+}
+
+static void Test_Corruption(void)
+{
+    // Um byte do valor trocado na linha: CRC falha, alvo fica
+    uint32_t crc_before = foc.crc_errors;
+    corrupt_index = 3;
+    corrupt_value = 0x11;
+    Test_Speed(55.25f);
+    Test_Check(foc.crc_errors == crc_before + 1 && foc.target == (double)-17.6f,
+               "CRC: frame corrompido descartado");
+
+    Test_Speed(60.75f);
+    Test_Check(foc.target == 60.75, "CRC: próximo frame aceito");
+
+    // CRC trocado por 0xA5: o stub guarda o SYNC falso, o próximo frame
+    // falha uma vez e ressincroniza no SYNC verdadeiro
+    corrupt_index = ADCS_BIN_FRAME_SIZE - 1;
+    corrupt_value = ADCS_BIN_SYNC;
+    Test_Speed(-33.5f);
+    Test_Check(foc.target == 60.75 && foc.bin_len == 1, "ressincronização: SYNC falso guardado");
+
+    crc_before = foc.crc_errors;
+    Test_Speed(-44.0f);
+    Test_Check(foc.target == -44.0 && foc.crc_errors == crc_before + 1 && foc.bin_len == 0,
+               "ressincronização: frame seguinte aceito");
+
+    // Ruído na linha com um SYNC perdido antes do frame
+    static const uint8_t noise[] = {ADCS_BIN_SYNC, 0x13, 0x37};
+    SimpleFOC_Receive(&foc, noise, sizeof(noise));
+    Test_Speed(77.0f);
+    Test_Check(foc.target == 77.0 && foc.bin_len == 0, "ressincronização: ruído antes do frame");
+}
+
+static void Test_BackToAscii(void)
+{
+    ADCS_SetFraming(ADCS_FRAMING_ASCII);
+
+    uint32_t before = foc.ascii_commands;
+    Test_Speed(77.0f);
+    Test_Check(Test_Seen("M77\n") && foc.ascii_commands == before + 1 && foc.target == 77.0,
+               "volta para ASCII no próximo comando");
+}
+
+int main(void)
+{
+    Sim_Config_t cfg;
+    const double q0[4] = {1.0, 0.0, 0.0, 0.0};
+    const double w0[3] = {0.0, 0.0, 0.0};
+
+    Sim_DefaultConfig(&cfg);
+    Plant_Init(&plant, &cfg.plant, q0, w0);
+    SimpleFOC_Init(&foc, &plant);
+    SimHal_Reset(NULL, &foc, Test_Advance);
+    SimHal_SetUartTap(Test_Tap);
+
+    // Sem IMU (sensores NULL): só a parte da UART do ADCS_Init interessa
+    ADCS_Init(&huart4);
+    Test_Wait(TEST_WAIT_MS);
+
+    Test_Ascii();
+    Test_Binary();
+    Test_Corruption();
+    Test_BackToAscii();
+
+    printf("%s: %d de %d verificações falharam\n", failures ? "FALHA" : "ok",
+           failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/**
+  ******************************************************************************
+  * @file    stm32h7xx_hal.h
+  * @brief   Subconjunto da HAL do STM32H7 para o simulador do ADCS (Linux)
+  *
+  * Substitui só a HAL do fabricante (Drivers/): os cabeçalhos do projeto
+  * (main.h, usart.h, tim.h...) são os de Core/Inc, sem alteração. Os tipos
+  * têm apenas os campos que o firmware toca; as funções são implementadas
+  * em sim_hal.c sobre o modelo da planta.
+  ******************************************************************************
+  */
+
+#ifndef __STM32H7XX_HAL_H
+#define __STM32H7XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================
+   NÚCLEO
+   ============================================================================ */
+typedef enum {
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY           0xFFFFFFFFU
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+
+// Um único contexto de execução: as seções críticas não fazem nada
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+
+/* Contador de ciclos: avança com o tempo simulado (SystemCoreClock) */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+    volatile uint32_t LAR;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+extern uint32_t SystemCoreClock;
+
+#define DWT                     (&sim_dwt)
+#define CoreDebug               (&sim_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk  (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+/* ============================================================================
+   GPIO
+   ============================================================================ */
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef sim_gpio[9];
+
+#define GPIOA                   (&sim_gpio[0])
+#define GPIOB                   (&sim_gpio[1])
+#define GPIOC                   (&sim_gpio[2])
+#define GPIOD                   (&sim_gpio[3])
+#define GPIOE                   (&sim_gpio[4])
+#define GPIOF                   (&sim_gpio[5])
+#define GPIOG                   (&sim_gpio[6])
+#define GPIOH                   (&sim_gpio[7])
+#define GPIOI                   (&sim_gpio[8])
+
+#define GPIO_PIN_0              ((uint16_t)0x0001)
+#define GPIO_PIN_1              ((uint16_t)0x0002)
+#define GPIO_PIN_2              ((uint16_t)0x0004)
+#define GPIO_PIN_3              ((uint16_t)0x0008)
+#define GPIO_PIN_4              ((uint16_t)0x0010)
+#define GPIO_PIN_5              ((uint16_t)0x0020)
+#define GPIO_PIN_6              ((uint16_t)0x0040)
+#define GPIO_PIN_7              ((uint16_t)0x0080)
+#define GPIO_PIN_8              ((uint16_t)0x0100)
+#define GPIO_PIN_9              ((uint16_t)0x0200)
+#define GPIO_PIN_10             ((uint16_t)0x0400)
+#define GPIO_PIN_11             ((uint16_t)0x0800)
+#define GPIO_PIN_12             ((uint16_t)0x1000)
+#define GPIO_PIN_13             ((uint16_t)0x2000)
+#define GPIO_PIN_14             ((uint16_t)0x4000)
+#define GPIO_PIN_15             ((uint16_t)0x8000)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+/* ============================================================================
+   DMA / UART
+   ============================================================================ */
+typedef struct {
+    uint32_t channel;
+} DMA_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile uint32_t gState;
+    volatile uint32_t RxState;
+} UART_HandleTypeDef;
+
+#define HAL_UART_STATE_READY    0x20U
+#define HAL_UART_STATE_BUSY_TX  0x21U
+#define HAL_UART_STATE_BUSY_RX  0x22U
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data,
+                                    uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data,
+                                        uint16_t size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *data,
+                                               uint16_t size);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart);
+
+// Callbacks (implementados pelo firmware em uart_dma.c)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/* ============================================================================
+   SPI
+   ============================================================================ */
+typedef struct {
+    void *Instance;
+} SPI_HandleTypeDef;
+
+typedef enum {
+    HAL_SPI_STATE_RESET = 0x00,
+    HAL_SPI_STATE_READY = 0x01,
+    HAL_SPI_STATE_BUSY = 0x02
+} HAL_SPI_StateTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size,
+                                   uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx,
+                                          uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *tx,
+                                              uint8_t *rx, uint16_t size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi);
+
+/* ============================================================================
+   TIMER
+   ============================================================================ */
+typedef struct {
+    uint32_t PSC;
+    uint32_t ARR;
+    uint32_t CNT;
+    uint32_t EGR;
+    uint32_t SR;
+    uint32_t CCR[4];            // CCR1..CCR4
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+} TIM_HandleTypeDef;
+
+extern TIM_TypeDef sim_tim2;
+extern TIM_TypeDef sim_tim5;
+extern TIM_TypeDef sim_tim6;
+
+#define TIM2                    (&sim_tim2)
+#define TIM5                    (&sim_tim5)
+#define TIM6                    (&sim_tim6)
+#define TIM_CHANNEL_1           0x00000000U
+#define TIM_CHANNEL_2           0x00000004U
+#define TIM_CHANNEL_3           0x00000008U
+#define TIM_CHANNEL_4           0x0000000CU
+#define TIM_EGR_UG              (1UL << 0)
+#define TIM_FLAG_UPDATE         (1UL << 0)
+
+#define __HAL_TIM_SET_PRESCALER(h, v)   ((h)->Instance->PSC = (v))
+#define __HAL_TIM_SET_AUTORELOAD(h, v)  ((h)->Instance->ARR = (v))
+#define __HAL_TIM_SET_COUNTER(h, v)     ((h)->Instance->CNT = (v))
+#define __HAL_TIM_CLEAR_FLAG(h, f)      ((h)->Instance->SR &= ~(f))
+#define __HAL_TIM_GET_AUTORELOAD(h)     ((h)->Instance->ARR)
+#define __HAL_TIM_GET_COUNTER(h)        ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COMPARE(h, ch, v) ((h)->Instance->CCR[(ch) >> 2] = (v))
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t channel);
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t channel);
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+
+/* ============================================================================
+   FDCAN (só o tipo: o modo de operação vem do cenário)
+   ============================================================================ */
+typedef struct {
+    void *Instance;
+} FDCAN_HandleTypeDef;
+
+/* ============================================================================
+   QUADSPI (só o tipo: a flash é emulada acima do qspi_flash.h)
+   ============================================================================ */
+typedef struct {
+    void *Instance;
+} QSPI_HandleTypeDef;
+
+#endif /* __STM32H7XX_HAL_H */
@@ -0,0 +1,228 @@
+/**
+  ******************************************************************************
+  * @file    main.c
+  * @brief   Linha de comando do simulador do ADCS
+  *
+  *   adcs_sim [-m detumble|adcs|idle] [-t segundos] [-w x,y,z (deg/s)]
+  *            [-W roda (rad/s)] [-r taxa (Hz, 0 = loop principal)]
+  *            [-g kp,ki,kd] [-a s] [-R rad/s] [-s semente] [-o trace.csv]
+  *            [-b] [-e] [-B] [-P]
+  *
+  *   -a  auto-tune do PID s segundos depois de entrar no modo (só adcs)
+  *   -R  rampa da roda até rad/s (ADCS_SetSpeedRamp; só idle)
+  *   -b  bancada (gravidade no acelerômetro)    -e  eclipse (LDRs no escuro)
+  *   -B  comandos da roda no modo binário
+  *   -P  roda no atuador PWM/DIR/EN com tacômetro (sem UART)
+  *
+  * Código de saída: 0 se a rotação em Z estabilizou (ou modo idle), 1 se
+  * não, 2 em erro de uso ou de inicialização.
+  ******************************************************************************
+  */
+
+#include "sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEG_TO_RAD              (M_PI / 180.0)
+
+static void Usage(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s [-m detumble|adcs|idle] [-t s] [-w x,y,z] [-W rad/s] [-r Hz]\n"
+            "          [-g kp,ki,kd] [-a s] [-R rad/s] [-s semente] [-o trace.csv]\n"
+            "          [-b] [-e] [-B] [-P]\n", prog);
+}
+
+static int ParseMode(const char *s, CDH_OperationMode_t *mode)
+{
+    if (strcmp(s, "detumble") == 0) {
+        *mode = CDH_MODE_DETUMBLING;
+    } else if (strcmp(s, "adcs") == 0) {
+        *mode = CDH_MODE_ADCS;
+    } else if (strcmp(s, "idle") == 0) {
+        *mode = CDH_MODE_IDLE;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static void PrintResult(const Sim_Config_t *cfg, const Sim_Result_t *r)
+{
+    printf("=== Simulação ADCS (%.1f s, %u Hz) ===\n", cfg->duration, cfg->control_rate_hz);
+
+    printf("Detumbling\n");
+    if (r->settle_time >= 0.0) {
+        printf("  estabilizou em Z (planta): %.2f s\n", r->settle_time);
+    } else {
+        printf("  estabilizou em Z (planta): não\n");
+    }
+    if (r->fw_converged) {
+        printf("  convergência (firmware):   %.2f s\n", r->fw_converge_time);
+    } else {
+        printf("  convergência (firmware):   não\n");
+    }
+    printf("  limite de momento:         %s\n", r->fw_momentum_limited ? "sim" : "não");
+    printf("  w final (deg/s):           %.3f %.3f %.3f (|w| = %.3f)\n",
+           r->final_rate[0] / DEG_TO_RAD, r->final_rate[1] / DEG_TO_RAD,
+           r->final_rate[2] / DEG_TO_RAD, r->final_rate_norm / DEG_TO_RAD);
+    printf("  w_z RMS último quarto:     %.4f deg/s\n", r->rate_z_rms / DEG_TO_RAD);
+
+    if (cfg->autotune_at >= 0.0) {
+        static const char *const phases[] = {"parado", "referência", "relé", "verificação",
+                                             "ganhos novos", "ganhos antigos de volta", "falhou"};
+        printf("Auto-tune\n");
+        printf("  fase final:                %s\n",
+               (r->autotune_phase < 7) ? phases[r->autotune_phase] : "?");
+        printf("  Ku / Tu:                   %.3f / %.3f s\n", r->autotune_ku, r->autotune_tu);
+        printf("  kp / ki / kd:              %.4f / %.4f / %.6f\n", r->autotune_gains[0],
+               r->autotune_gains[1], r->autotune_gains[2]);
+        printf("  w_z RMS antes / depois:    %.4f / %.4f deg/s\n",
+               r->autotune_rms[0] / DEG_TO_RAD, r->autotune_rms[1] / DEG_TO_RAD);
+    }
+
+    printf("Estimação\n");
+    printf("  erro de atitude RMS/final: %.2f / %.2f deg\n",
+           r->att_error_rms / DEG_TO_RAD, r->att_error_final / DEG_TO_RAD);
+    printf("  sigma da MEKF (máx.):      %.2f deg\n", r->att_sigma_final / DEG_TO_RAD);
+    printf("  erro do bias:              %.4f deg/s\n", r->bias_error_final / DEG_TO_RAD);
+
+    printf("Roda\n");
+    printf("  velocidade final / pico:   %.2f / %.2f rad/s\n", r->wheel_final, r->wheel_peak);
+    printf("  aceleração de pico:        %.1f rad/s²\n", r->wheel_accel_peak);
+    if (cfg->ramp) {
+        if (r->ramp_time >= 0.0) {
+            printf("  rampa até o alvo:          %.2f s\n", r->ramp_time);
+        } else {
+            printf("  rampa até o alvo:          não terminou\n");
+        }
+    }
+    printf("  pedidos de dessaturação:   %u\n", r->desat_events);
+    printf("  deriva do momento:         %.3e N m s\n", r->momentum_drift);
+
+    printf("Firmware\n");
+    printf("  comandos enviados/perdidos: %u / %u\n", r->commands_sent, r->commands_dropped);
+    printf("  telemetria aceita/rejeitada: %u / %u\n", r->telemetry_samples, r->telemetry_rejected);
+    if (cfg->pwm_actuator) {
+        printf("  bordas do tacômetro:       %u\n", r->tach_edges);
+    }
+    printf("  falhas do motor:           0x%02X\n", r->motor_faults);
+    printf("  iterações da malha:        %u\n", r->control_ticks);
+    printf("  HAL_Delay na interrupção:  %u\n", r->isr_delays);
+
+    printf("Desempenho\n");
+    printf("  %.1f s simulados em %.2f s (%.0fx tempo real)\n",
+           r->sim_time, r->wall_time, r->speedup);
+}
+
+int main(int argc, char **argv)
+{
+    Sim_Config_t cfg;
+    Sim_Result_t result;
+    const char *trace_path = NULL;
+    int opt;
+
+    Sim_DefaultConfig(&cfg);
+    cfg.w0[0] = 5.0 * DEG_TO_RAD;
+    cfg.w0[1] = -3.0 * DEG_TO_RAD;
+    cfg.w0[2] = 30.0 * DEG_TO_RAD;
+
+    while ((opt = getopt(argc, argv, "m:t:w:W:r:g:a:R:s:o:beBPh")) != -1) {
+        switch (opt) {
+        case 'm':
+            if (ParseMode(optarg, &cfg.mode) != 0) {
+                Usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 't':
+            cfg.duration = atof(optarg);
+            break;
+        case 'w': {
+            double w[3];
+            if (sscanf(optarg, "%lf,%lf,%lf", &w[0], &w[1], &w[2]) != 3) {
+                Usage(argv[0]);
+                return 2;
+            }
+            for (int i = 0; i < 3; i++) {
+                cfg.w0[i] = w[i] * DEG_TO_RAD;
+            }
+            break;
+        }
+        case 'W':
+            cfg.wheel0 = atof(optarg);
+            break;
+        case 'r':
+            cfg.control_rate_hz = (uint32_t)atoi(optarg);
+            break;
+        case 'g':
+            if (sscanf(optarg, "%f,%f,%f", &cfg.pid_kp, &cfg.pid_ki, &cfg.pid_kd) != 3) {
+                Usage(argv[0]);
+                return 2;
+            }
+            cfg.pid_override = 1;
+            break;
+        case 'a':
+            cfg.autotune_at = atof(optarg);
+            break;
+        case 'R':
+            cfg.ramp = 1;
+            cfg.ramp_speed = (float)atof(optarg);
+            break;
+        case 's':
+            cfg.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'o':
+            trace_path = optarg;
+            break;
+        case 'b':
+            cfg.sensors.gravity = 1;
+            break;
+        case 'e':
+            cfg.sensors.eclipse = 1;
+            break;
+        case 'B':
+            cfg.binary_framing = 1;
+            break;
+        case 'P':
+            cfg.pwm_actuator = 1;
+            break;
+        default:
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (cfg.duration <= 0.0) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    if (trace_path != NULL) {
+        cfg.trace = fopen(trace_path, "w");
+        if (cfg.trace == NULL) {
+            perror(trace_path);
+            return 2;
+        }
+    }
+
+    int status = Sim_Run(&cfg, &result);
+
+    if (cfg.trace != NULL) {
+        fclose(cfg.trace);
+    }
+    if (status != 0) {
+        fprintf(stderr, "firmware não inicializou (BMI088 ou taxa da malha)\n");
+        return 2;
+    }
+
+    PrintResult(&cfg, &result);
+
+    if (cfg.mode == CDH_MODE_IDLE) {
+        return 0;
+    }
+    return (result.settle_time >= 0.0) ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+/**
+  ******************************************************************************
+  * @file    mc_main.c
+  * @brief   Linha de comando do Monte Carlo do ADCS
+  *
+  *   adcs_mc [-n cenários] [-j processos] [-s semente] [-t segundos]
+  *           [-p fração em modo ADCS] [-g kp,ki,kd] [-a s] [-r taxa (Hz)]
+  *           [-o cenarios.csv]
+  *
+  * Resumo: distribuição do tempo até estabilizar (detumbling) e do erro de
+  * apontamento (modo ADCS), em percentis; o CSV tem uma linha por cenário.
+  * Código de saída: 0 se todos os cenários rodaram, 1 se algum falhou, 2
+  * em erro de uso.
+  ******************************************************************************
+  */
+
+#include "montecarlo.h"
+#include "Detumbling.h"
+#include "autotune.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEG_TO_RAD              (M_PI / 180.0)
+
+/* ============================================================================
+   ESTATÍSTICA
+   ============================================================================ */
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Percentil pelo posto mais próximo (valores já ordenados)
+ */
+static double Percentile(const double *sorted, uint32_t n, double p)
+{
+    uint32_t rank = (uint32_t)ceil(p * n);
+    return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+static void PrintDistribution(const char *label, double *values, uint32_t n, double scale)
+{
+    if (n == 0) {
+        printf("  %-28s -\n", label);
+        return;
+    }
+
+    qsort(values, n, sizeof(double), CompareDouble);
+    printf("  %-28s p50 %.3f  p90 %.3f  p99 %.3f  máx %.3f\n", label,
+           Percentile(values, n, 0.50) / scale, Percentile(values, n, 0.90) / scale,
+           Percentile(values, n, 0.99) / scale, values[n - 1] / scale);
+}
+
+/* ============================================================================
+   SAÍDA
+   ============================================================================ */
+static void WriteCsv(FILE *f, const MonteCarlo_Run_t *runs, uint32_t count)
+{
+    fprintf(f, "index,mode,wx0,wy0,wz0,jx,jy,jz,noise_scale,voltage_limit,status,"
+               "settle_time,fw_converge_time,momentum_limited,rate_z_rms,att_error_rms,"
+               "wheel_peak,motor_faults,wall_time\n");
+
+    for (uint32_t i = 0; i < count; i++) {
+        const MonteCarlo_Scenario_t *s = &runs[i].scenario;
+        const Sim_Result_t *r = &runs[i].result;
+
+        fprintf(f, "%u,%s,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f,%.3f,%.3f,%d,"
+                   "%.3f,%.3f,%u,%.6f,%.6f,%.3f,%u,%.4f\n",
+                runs[i].index, (s->mode == CDH_MODE_ADCS) ? "adcs" : "detumble",
+                s->w0[0], s->w0[1], s->w0[2], s->inertia[0], s->inertia[1], s->inertia[2],
+                s->noise_scale, s->voltage_limit, runs[i].status,
+                r->settle_time, r->fw_converge_time, r->fw_momentum_limited,
+                r->rate_z_rms, r->att_error_rms, r->wheel_peak, r->motor_faults, r->wall_time);
+    }
+}
+
+static void PrintSummary(const MonteCarlo_Config_t *mc, const MonteCarlo_Run_t *runs,
+                         uint32_t workers, double wall)
+{
+    double *settle = malloc(mc->runs * sizeof(double));
+    double *fw_converge = malloc(mc->runs * sizeof(double));
+    double *rate_rms = malloc(mc->runs * sizeof(double));
+    double *att_rms = malloc(mc->runs * sizeof(double));
+    uint32_t detumble = 0, pointing = 0, failed = 0;
+    uint32_t settled = 0, fw_converged = 0, limited = 0, held = 0, faults = 0;
+    uint32_t isr_delays = 0;
+    uint32_t tuned[AUTOTUNE_FAILED + 1] = {0};
+    double sim_total = 0.0, wall_total = 0.0;
+
+    for (uint32_t i = 0; i < mc->runs; i++) {
+        const Sim_Result_t *r = &runs[i].result;
+
+        if (runs[i].status != 0) {
+            failed++;
+            continue;
+        }
+        sim_total += r->sim_time;
+        wall_total += r->wall_time;
+        isr_delays += r->isr_delays;
+        if (r->motor_faults != 0) {
+            faults++;
+        }
+
+        if (runs[i].scenario.mode == CDH_MODE_DETUMBLING) {
+            detumble++;
+            if (r->settle_time >= 0.0) {
+                settle[settled++] = r->settle_time;
+            }
+            if (r->fw_converged) {
+                fw_converge[fw_converged++] = r->fw_converge_time;
+            }
+            if (r->fw_momentum_limited) {
+                limited++;
+            }
+        } else {
+            rate_rms[pointing] = r->rate_z_rms;
+            att_rms[pointing] = r->att_error_rms;
+            pointing++;
+            if (r->settle_time >= 0.0) {
+                held++;
+            }
+            if (r->autotune_phase <= AUTOTUNE_FAILED) {
+                tuned[r->autotune_phase]++;
+            }
+        }
+    }
+
+    printf("=== Monte Carlo ADCS: %u cenários de %.1f s, %u processos, semente %llu ===\n",
+           mc->runs, mc->base.duration, workers, (unsigned long long)mc->seed);
+
+    printf("Detumbling (%u cenários, órbita)\n", detumble);
+    printf("  estabilizou em Z:            %u (%.1f%%)\n", settled,
+           detumble ? 100.0 * settled / detumble : 0.0);
+    PrintDistribution("tempo até estabilizar (s)", settle, settled, 1.0);
+    PrintDistribution("convergência firmware (s)", fw_converge, fw_converged, 1.0);
+    printf("  limite de momento:           %u\n", limited);
+
+    printf("Apontamento (%u cenários, modo ADCS na bancada)\n", pointing);
+    printf("  |w_z| < %.1f deg/s até o fim: %u (%.1f%%)\n", DETUMBLE_RATE_DONE / DEG_TO_RAD, held,
+           pointing ? 100.0 * held / pointing : 0.0);
+    PrintDistribution("w_z RMS (deg/s)", rate_rms, pointing, DEG_TO_RAD);
+    PrintDistribution("erro de atitude RMS (deg)", att_rms, pointing, DEG_TO_RAD);
+    if (mc->base.autotune_at >= 0.0) {
+        printf("  auto-tune novos/antigos/falhou/em andamento: %u / %u / %u / %u\n",
+               tuned[AUTOTUNE_DONE], tuned[AUTOTUNE_ROLLED_BACK], tuned[AUTOTUNE_FAILED],
+               tuned[AUTOTUNE_BASELINE] + tuned[AUTOTUNE_RELAY] + tuned[AUTOTUNE_VERIFY]);
+    }
+
+    printf("Firmware\n");
+    printf("  cenários sem resultado:      %u\n", failed);
+    printf("  com falha do motor:          %u\n", faults);
+    printf("  HAL_Delay na interrupção:    %u\n", isr_delays);
+
+    printf("Desempenho\n");
+    printf("  %.0f s simulados em %.2f s (%.1f cenários/s, %.0fx tempo real)\n",
+           sim_total, wall, wall > 0.0 ? mc->runs / wall : 0.0, wall > 0.0 ? sim_total / wall : 0.0);
+    printf("  paralelismo efetivo:         %.2f de %u\n",
+           wall > 0.0 ? wall_total / wall : 0.0, workers);
+
+    free(settle);
+    free(fw_converge);
+    free(rate_rms);
+    free(att_rms);
+}
+
+/* ============================================================================
+   MAIN
+   ============================================================================ */
+static void Usage(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s [-n cenários] [-j processos] [-s semente] [-t s] [-p fração]\n"
+            "          [-g kp,ki,kd] [-a s] [-r Hz] [-o cenarios.csv]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    MonteCarlo_Config_t mc;
+    const char *csv_path = NULL;
+    int opt;
+
+    MonteCarlo_DefaultConfig(&mc);
+
+    while ((opt = getopt(argc, argv, "n:j:s:t:p:g:a:r:o:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            mc.runs = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            mc.workers = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            mc.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            mc.base.duration = atof(optarg);
+            break;
+        case 'p':
+            mc.pointing_fraction = atof(optarg);
+            break;
+        case 'g':
+            if (sscanf(optarg, "%f,%f,%f", &mc.base.pid_kp, &mc.base.pid_ki,
+                       &mc.base.pid_kd) != 3) {
+                Usage(argv[0]);
+                return 2;
+            }
+            mc.base.pid_override = 1;
+            break;
+        case 'a':
+            mc.base.autotune_at = atof(optarg);
+            break;
+        case 'r':
+            mc.base.control_rate_hz = (uint32_t)atoi(optarg);
+            break;
+        case 'o':
+            csv_path = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (mc.runs == 0 || mc.base.duration <= 0.0 ||
+        mc.workers < 1 || mc.workers > MONTECARLO_WORKERS_MAX) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    MonteCarlo_Run_t *runs = malloc(mc.runs * sizeof(MonteCarlo_Run_t));
+    if (runs == NULL) {
+        perror("malloc");
+        return 2;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int status = MonteCarlo_Run(&mc, runs);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wall = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    if (status != 0) {
+        perror("fork/pipe");
+    }
+
+    PrintSummary(&mc, runs, mc.workers, wall);
+
+    if (csv_path != NULL) {
+        FILE *f = fopen(csv_path, "w");
+        if (f == NULL) {
+            perror(csv_path);
+        } else {
+            WriteCsv(f, runs, mc.runs);
+            fclose(f);
+        }
+    }
+
+    uint32_t failed = 0;
+    for (uint32_t i = 0; i < mc.runs; i++) {
+        if (runs[i].status != 0) {
+            failed++;
+        }
+    }
+    free(runs);
+
+    return (status != 0 || failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,334 @@
+/**
+  ******************************************************************************
+  * @file    mekf_test.c
+  * @brief   Teste da MEKF (mekf.c) contra trajetórias de referência
+  *
+  *   mekf_test
+  *
+  * Referência: atitude verdadeira integrada em double a partir de uma
+  * velocidade angular conhecida; giroscópio com bias constante e ruído,
+  * azimute do Sol (LDRs laterais) a 20 Hz, acelerômetro a cada passo. O
+  * filtro parte da identidade com os parâmetros de adcs.h
+  * (ADCS_MEKF_*). Dois casos:
+  *   - bancada: gravidade + Sol, atitude e bias observáveis;
+  *   - órbita: só o Sol (sem gravidade), a rotação em torno do Sol não é
+  *     observável e o sigma tem que mostrar isso.
+  * Em ambos o erro de cada eixo tem que ficar dentro de 3 sigma.
+  *
+  * Depois roda a simulação padrão em malha fechada (detumbling em órbita,
+  * firmware inteiro) e confere erro, sigma e bias no fim.
+  *
+  * Código de saída: 0 se todas as verificações passaram, 1 se alguma falhou.
+  ******************************************************************************
+  */
+
+#include "sim.h"
+#include "plant.h"
+#include "rng.h"
+#include "mekf.h"
+#include "adcs.h"
+#include <stdio.h>
+#include <math.h>
+
+#define REF_RATE_HZ             200     // Predict + gravidade (malha do TIM6)
+#define REF_SUN_DIVIDER         10      // Sol a 20 Hz (sun_period do simulador)
+#define REF_DURATION            120.0   // s
+#define REF_SETTLE              10.0    // Consistência só depois da convergência (s)
+#define REF_LDR_NOISE           0.01    // Ruído de cada componente XY do Sol medido
+#define REF_SUN_VISIBLE         0.15    // |Sol no plano XY| mínimo (sol_visivel)
+#define REF_ACC_NOISE           0.05    // m/s² por eixo
+#define REF_INSIDE_MIN          0.95    // Fração mínima de amostras dentro de 3 sigma
+
+#define DEG                     (180.0 / M_PI)
+
+/* ============================================================================
+   TRAJETÓRIAS
+   ============================================================================ */
+typedef struct {
+    const char *name;
+    uint8_t gravity;            // 1 = acelerômetro vê 1 g (bancada)
+    double w[3];                // Velocidade angular média no corpo (rad/s)
+    double wobble[3];           // Amplitude da parte senoidal (rad/s)
+    double wobble_hz;
+    double bias[3];             // Bias verdadeiro do giroscópio (rad/s)
+    double q0[4];               // Atitude verdadeira inicial (filtro começa na identidade)
+} Ref_Case_t;
+
+typedef struct {
+    double inside;              // Fração das amostras (eixo a eixo) dentro de 3 sigma
+    double att_error;           // Ângulo final entre estimada e verdadeira (rad)
+    double sun_error;           // Ângulo final entre o Sol estimado e o verdadeiro no corpo (rad)
+    double bias_error;          // |bias estimado - verdadeiro| no fim (rad/s)
+    double bias_sigmas;         // Maior |erro do bias| / sigma entre os eixos
+    double att_sigma_max;       // Maior desvio de atitude no fim (rad)
+} Ref_Result_t;
+
+static const double sun_inertial[3] = {1.0, 0.0, 0.0};
+
+static int checks = 0;
+static int failures = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Test_Check(int ok, const char *what)
+{
+    checks++;
+    if (!ok) {
+        failures++;
+    }
+    printf("%s %s\n", ok ? "ok   " : "FALHA", what);
+}
+
+/**
+ * @brief q = q (x) exp(w dt / 2) com w constante no passo (exato)
+ */
+static void Ref_Rotate(double q[4], const double w[3], double dt)
+{
+    double norm = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    double half = 0.5 * norm * dt;
+    double s = (norm > 0.0) ? sin(half) / norm : 0.5 * dt;
+    double p[4] = {cos(half), w[0] * s, w[1] * s, w[2] * s};
+    double a[4] = {q[0], q[1], q[2], q[3]};
+
+    q[0] = a[0] * p[0] - a[1] * p[1] - a[2] * p[2] - a[3] * p[3];
+    q[1] = a[0] * p[1] + a[1] * p[0] + a[2] * p[3] - a[3] * p[2];
+    q[2] = a[0] * p[2] - a[1] * p[3] + a[2] * p[0] + a[3] * p[1];
+    q[3] = a[0] * p[3] + a[1] * p[2] - a[2] * p[1] + a[3] * p[0];
+
+    double inv = 1.0 / sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; i++) {
+        q[i] *= inv;
+    }
+}
+
+/**
+ * @brief Erro no corpo: q_true = q_est (x) [1, dtheta/2]
+ */
+static void Ref_ErrorBody(const Attitude_Quat_t *est, const double q[4], double dtheta[3])
+{
+    double a[4] = {est->w, -est->x, -est->y, -est->z};
+    double e[4];
+
+    e[0] = a[0] * q[0] - a[1] * q[1] - a[2] * q[2] - a[3] * q[3];
+    e[1] = a[0] * q[1] + a[1] * q[0] + a[2] * q[3] - a[3] * q[2];
+    e[2] = a[0] * q[2] - a[1] * q[3] + a[2] * q[0] + a[3] * q[1];
+    e[3] = a[0] * q[3] + a[1] * q[2] - a[2] * q[1] + a[3] * q[0];
+
+    double sign = (e[0] < 0.0) ? -1.0 : 1.0;
+    double vec = sqrt(e[1] * e[1] + e[2] * e[2] + e[3] * e[3]);
+    double angle = 2.0 * atan2(vec, fabs(e[0]));
+    double scale = (vec > 0.0) ? sign * angle / vec : 2.0;
+
+    for (int i = 0; i < 3; i++) {
+        dtheta[i] = e[i + 1] * scale;
+    }
+}
+
+static double Ref_Angle(const double a[3], const double b[3])
+{
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    double cross[3] = {a[1] * b[2] - a[2] * b[1],
+                       a[2] * b[0] - a[0] * b[2],
+                       a[0] * b[1] - a[1] * b[0]};
+    return atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot);
+}
+
+/**
+ * @brief Roda a MEKF ao longo de uma trajetória de referência
+ */
+static void Ref_Run(const Ref_Case_t *ref, uint64_t seed, Ref_Result_t *out)
+{
+    static const Mekf_Config_t cfg = {
+        .gyro_noise = ADCS_MEKF_GYRO_NOISE,
+        .bias_noise = ADCS_MEKF_BIAS_NOISE,
+        .acc_noise = ADCS_MEKF_ACC_NOISE,
+        .sun_noise = ADCS_MEKF_SUN_NOISE,
+        .att_sigma0 = ADCS_MEKF_ATT_SIGMA0,
+        .bias_sigma0 = ADCS_MEKF_BIAS_SIGMA0
+    };
+    const float sun_ref[3] = {(float)sun_inertial[0], (float)sun_inertial[1],
+                              (float)sun_inertial[2]};
+    const double dt = 1.0 / REF_RATE_HZ;
+    const double gyro_sigma = ADCS_MEKF_GYRO_NOISE * sqrt((double)REF_RATE_HZ);
+    const uint32_t steps = (uint32_t)(REF_DURATION * REF_RATE_HZ);
+
+    Mekf_t mekf;
+    Rng_t rng;
+    double q[4] = {ref->q0[0], ref->q0[1], ref->q0[2], ref->q0[3]};
+    uint32_t samples = 0;
+    uint32_t inside = 0;
+
+    Mekf_Init(&mekf, &cfg);
+    Mekf_SetSunReference(&mekf, sun_ref, 1);
+    Rng_Seed(&rng, seed);
+
+    for (uint32_t n = 1; n <= steps; n++) {
+        double t = n * dt;
+
+        // Verdade: velocidade no meio do passo
+        double phase = 2.0 * M_PI * ref->wobble_hz * (t - 0.5 * dt);
+        double w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = ref->w[i] + ref->wobble[i] * sin(phase + i);
+        }
+        Ref_Rotate(q, w, dt);
+
+        float gyro[3];
+        for (int i = 0; i < 3; i++) {
+            gyro[i] = (float)(w[i] + ref->bias[i] + gyro_sigma * Rng_Gauss(&rng));
+        }
+        Mekf_Predict(&mekf, gyro, (float)dt);
+
+        // Acelerômetro: 1 g na bancada, queda livre em órbita (fica de fora)
+        static const double up[3] = {0.0, 0.0, ATTITUDE_GRAVITY};
+        double g_body[3] = {0.0, 0.0, 0.0};
+        if (ref->gravity) {
+            Plant_RotateToBody(q, up, g_body);
+        }
+        float accel[3];
+        for (int i = 0; i < 3; i++) {
+            accel[i] = (float)(g_body[i] + REF_ACC_NOISE * Rng_Gauss(&rng));
+        }
+        Mekf_UpdateGravity(&mekf, accel);
+
+        // Sol: uma correção por amostra, como no ADCS_UpdateAttitude
+        if (n % REF_SUN_DIVIDER == 0) {
+            double sun[3];
+            Plant_RotateToBody(q, sun_inertial, sun);
+            if (hypot(sun[0], sun[1]) >= REF_SUN_VISIBLE) {
+                const float m[3] = {(float)(sun[0] + REF_LDR_NOISE * Rng_Gauss(&rng)),
+                                    (float)(sun[1] + REF_LDR_NOISE * Rng_Gauss(&rng)),
+                                    0.0f};
+                Mekf_UpdateSun(&mekf, m);
+            }
+        }
+
+        if (t >= REF_SETTLE) {
+            float att_sigma[3], bias_sigma[3];
+            double dtheta[3];
+            Mekf_GetSigma(&mekf, att_sigma, bias_sigma);
+            Ref_ErrorBody(&mekf.q, q, dtheta);
+            for (int i = 0; i < 3; i++) {
+                samples++;
+                if (fabs(dtheta[i]) <= 3.0 * att_sigma[i]) {
+                    inside++;
+                }
+            }
+        }
+    }
+
+    float att_sigma[3], bias_sigma[3];
+    double dtheta[3];
+    Mekf_GetSigma(&mekf, att_sigma, bias_sigma);
+    Ref_ErrorBody(&mekf.q, q, dtheta);
+
+    const double q_est[4] = {mekf.q.w, mekf.q.x, mekf.q.y, mekf.q.z};
+    double sun_true[3], sun_est[3];
+    Plant_RotateToBody(q, sun_inertial, sun_true);
+    Plant_RotateToBody(q_est, sun_inertial, sun_est);
+
+    out->inside = (samples > 0) ? (double)inside / samples : 0.0;
+    out->att_error = Plant_AngleBetween(q_est, q);
+    out->sun_error = Ref_Angle(sun_est, sun_true);
+    out->att_sigma_max = fmax(att_sigma[0], fmax(att_sigma[1], att_sigma[2]));
+
+    double bias_sq = 0.0;
+    out->bias_sigmas = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double e = mekf.bias[i] - ref->bias[i];
+        bias_sq += e * e;
+        out->bias_sigmas = fmax(out->bias_sigmas, fabs(e) / bias_sigma[i]);
+    }
+    out->bias_error = sqrt(bias_sq);
+}
+
+static void Test_Report(const char *name, const Ref_Result_t *r)
+{
+    printf("  %s: erro %.2f deg (Sol %.2f deg), sigma máx. %.2f deg, %.1f%% dentro de 3 sigma, "
+           "bias %.4f deg/s (%.1f sigma)\n",
+           name, r->att_error * DEG, r->sun_error * DEG, r->att_sigma_max * DEG,
+           100.0 * r->inside, r->bias_error * DEG, r->bias_sigmas);
+}
+
+/* ============================================================================
+   VERIFICAÇÕES
+   ============================================================================ */
+static void Test_Bench(void)
+{
+    // Mesa girando em Z com balanço nos três eixos; começa 20 deg fora
+    const Ref_Case_t ref = {
+        .name = "bancada",
+        .gravity = 1,
+        .w = {0.0, 0.0, 0.2},
+        .wobble = {0.02, 0.02, 0.1},
+        .wobble_hz = 0.05,
+        .bias = {0.004, -0.003, 0.002},
+        .q0 = {0.9848, 0.1005, 0.1005, 0.1005}
+    };
+    Ref_Result_t r;
+
+    Ref_Run(&ref, 1, &r);
+    Test_Report(ref.name, &r);
+    Test_Check(r.att_error < 1.0 / DEG, "bancada: atitude a menos de 1 deg");
+    Test_Check(r.bias_error < 0.05 / DEG, "bancada: bias a menos de 0.05 deg/s");
+    Test_Check(r.inside >= REF_INSIDE_MIN, "bancada: erro dentro de 3 sigma");
+}
+
+static void Test_Orbit(void)
+{
+    // Rotação residual depois do detumbling: o Sol passa perto de +-Z do corpo
+    const Ref_Case_t ref = {
+        .name = "órbita",
+        .gravity = 0,
+        .w = {0.08, -0.05, 0.03},
+        .wobble = {0.0, 0.0, 0.0},
+        .wobble_hz = 0.0,
+        .bias = {0.004, -0.003, 0.002},
+        .q0 = {0.9848, 0.1005, 0.1005, 0.1005}
+    };
+    Ref_Result_t r;
+
+    Ref_Run(&ref, 1, &r);
+    Test_Report(ref.name, &r);
+    Test_Check(r.inside >= REF_INSIDE_MIN, "órbita: erro dentro de 3 sigma");
+    Test_Check(r.att_error <= 3.0 * r.att_sigma_max, "órbita: sigma cobre o erro em torno do Sol");
+    Test_Check(r.sun_error < 2.0 / DEG, "órbita: Sol no corpo a menos de 2 deg");
+    Test_Check(r.bias_sigmas <= 3.0, "órbita: bias dentro de 3 sigma");
+}
+
+static void Test_ClosedLoop(void)
+{
+    // Mesmo cenário do adcs_sim sem opções (órbita, semente 1)
+    Sim_Config_t cfg;
+    Sim_Result_t r;
+
+    Sim_DefaultConfig(&cfg);
+    cfg.w0[0] = 5.0 / DEG;
+    cfg.w0[1] = -3.0 / DEG;
+    cfg.w0[2] = 30.0 / DEG;
+    if (Sim_Run(&cfg, &r) != 0) {
+        Test_Check(0, "malha fechada: firmware inicializou");
+        return;
+    }
+
+    printf("  malha fechada: erro RMS/final %.2f / %.2f deg, sigma máx. %.2f deg, bias %.4f deg/s\n",
+           r.att_error_rms * DEG, r.att_error_final * DEG, r.att_sigma_final * DEG,
+           r.bias_error_final * DEG);
+    Test_Check(r.att_error_final <= 3.0 * r.att_sigma_final,
+               "malha fechada: sigma cobre o erro final");
+    Test_Check(r.att_error_rms < 10.0 / DEG, "malha fechada: erro RMS abaixo de 10 deg");
+    Test_Check(r.bias_error_final < 0.05 / DEG, "malha fechada: bias a menos de 0.05 deg/s");
+    Test_Check(r.isr_delays == 0, "malha fechada: nenhum HAL_Delay na interrupção do TIM6");
+}
+
+int main(void)
+{
+    Test_Bench();
+    Test_Orbit();
+    Test_ClosedLoop();
+
+    printf("%s: %d de %d verificações falharam\n", failures ? "FALHA" : "ok",
+           failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/**
+  ******************************************************************************
+  * @file    montecarlo.c
+  * @brief   Sorteio dos cenários e execução em processos paralelos
+  ******************************************************************************
+  */
+
+#include "montecarlo.h"
+#include "rng.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DEG_TO_RAD              (M_PI / 180.0)
+
+// Escrita de um registro no pipe é atômica só até PIPE_BUF
+_Static_assert(sizeof(MonteCarlo_Run_t) <= PIPE_BUF, "MonteCarlo_Run_t maior que PIPE_BUF");
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static double MonteCarlo_Range(Rng_t *rng, double lo, double hi)
+{
+    return lo + (hi - lo) * Rng_Uniform(rng);
+}
+
+/**
+ * @brief Processo filho: um cenário e o resultado no pipe
+ */
+static void MonteCarlo_Child(const MonteCarlo_Config_t *mc, uint32_t index, int fd)
+{
+    MonteCarlo_Run_t run;
+    Sim_Config_t cfg;
+
+    memset(&run, 0, sizeof(run));
+    run.index = index;
+    MonteCarlo_Sample(mc, index, &cfg, &run.scenario);
+    run.status = Sim_Run(&cfg, &run.result);
+
+    if (write(fd, &run, sizeof(run)) != (ssize_t)sizeof(run)) {
+        _exit(1);
+    }
+    _exit(0);
+}
+
+/**
+ * @brief Lê os registros já entregues (pipe não bloqueante)
+ */
+static void MonteCarlo_Drain(int fd, MonteCarlo_Run_t *runs, uint32_t count)
+{
+    MonteCarlo_Run_t run;
+
+    while (read(fd, &run, sizeof(run)) == (ssize_t)sizeof(run)) {
+        if (run.index < count) {
+            runs[run.index] = run;
+        }
+    }
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief 1000 cenários de 30 s, um processo por núcleo
+ */
+void MonteCarlo_DefaultConfig(MonteCarlo_Config_t *mc)
+{
+    memset(mc, 0, sizeof(MonteCarlo_Config_t));
+
+    Sim_DefaultConfig(&mc->base);
+    mc->base.duration = 30.0;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    mc->runs = 1000;
+    mc->workers = (cores < 1) ? 1 : (cores > MONTECARLO_WORKERS_MAX) ? MONTECARLO_WORKERS_MAX
+                                                                      : (uint32_t)cores;
+    mc->seed = 1;
+
+    mc->pointing_fraction = 0.25;
+    mc->rate_max = 30.0 * DEG_TO_RAD;
+    mc->pointing_rate_max = 5.0 * DEG_TO_RAD;
+    mc->inertia_spread = 0.2;
+    mc->noise_scale_max = 3.0;
+    mc->gyro_bias_max = 0.5 * DEG_TO_RAD;
+    mc->voltage_min = 6.0;
+}
+
+/**
+ * @brief Apontamento: mesa de rolamento a ar (gravidade, só rotação em Z);
+ *        detumbling: órbita, rotação nos 3 eixos
+ */
+void MonteCarlo_Sample(const MonteCarlo_Config_t *mc, uint32_t index,
+                       Sim_Config_t *cfg, MonteCarlo_Scenario_t *scenario)
+{
+    Rng_t rng;
+
+    Rng_Seed(&rng, (mc->seed << 32) ^ index);
+    *cfg = mc->base;
+    cfg->trace = NULL;
+
+    if (Rng_Uniform(&rng) < mc->pointing_fraction) {
+        cfg->mode = CDH_MODE_ADCS;
+        cfg->sensors.gravity = 1;
+        cfg->w0[0] = 0.0;
+        cfg->w0[1] = 0.0;
+        cfg->w0[2] = MonteCarlo_Range(&rng, -mc->pointing_rate_max, mc->pointing_rate_max);
+    } else {
+        cfg->mode = CDH_MODE_DETUMBLING;
+        cfg->sensors.gravity = 0;
+        for (int i = 0; i < 3; i++) {
+            cfg->w0[i] = MonteCarlo_Range(&rng, -mc->rate_max, mc->rate_max);
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        cfg->plant.inertia[i] *= MonteCarlo_Range(&rng, 1.0 - mc->inertia_spread,
+                                                  1.0 + mc->inertia_spread);
+    }
+
+    double noise = MonteCarlo_Range(&rng, 1.0, mc->noise_scale_max);
+    cfg->sensors.gyro_noise *= noise;
+    cfg->sensors.gyro_bias_walk *= noise;
+    cfg->sensors.acc_noise *= noise;
+    cfg->sensors.ldr_noise *= noise;
+    for (int i = 0; i < 3; i++) {
+        cfg->sensors.gyro_bias[i] = MonteCarlo_Range(&rng, -mc->gyro_bias_max, mc->gyro_bias_max);
+    }
+
+    cfg->plant.voltage_limit = MonteCarlo_Range(&rng, mc->voltage_min, mc->base.plant.voltage_limit);
+    cfg->seed = Rng_Next(&rng);
+
+    scenario->mode = cfg->mode;
+    memcpy(scenario->w0, cfg->w0, sizeof(scenario->w0));
+    memcpy(scenario->inertia, cfg->plant.inertia, sizeof(scenario->inertia));
+    scenario->noise_scale = noise;
+    scenario->voltage_limit = cfg->plant.voltage_limit;
+    scenario->seed = cfg->seed;
+}
+
+/**
+ * @brief Distribui os cenários em até mc->workers processos filhos
+ * @note Filho que morre sem escrever deixa status = -2 no seu índice
+ */
+int MonteCarlo_Run(const MonteCarlo_Config_t *mc, MonteCarlo_Run_t *runs)
+{
+    uint32_t workers = mc->workers;
+    uint32_t next = 0;
+    uint32_t active = 0;
+    int error = 0;
+    int fds[2];
+
+    if (workers < 1) workers = 1;
+    if (workers > MONTECARLO_WORKERS_MAX) workers = MONTECARLO_WORKERS_MAX;
+
+    for (uint32_t i = 0; i < mc->runs; i++) {
+        Sim_Config_t cfg;
+        memset(&runs[i], 0, sizeof(MonteCarlo_Run_t));
+        runs[i].index = i;
+        runs[i].status = -2;
+        MonteCarlo_Sample(mc, i, &cfg, &runs[i].scenario);
+    }
+
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    // Buffers do stdio não podem ser herdados pela metade
+    fflush(NULL);
+
+    while (next < mc->runs || active > 0) {
+        while (!error && active < workers && next < mc->runs) {
+            pid_t pid = fork();
+            if (pid < 0) {
+                error = 1;
+                break;
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                MonteCarlo_Child(mc, next, fds[1]);
+            }
+            active++;
+            next++;
+        }
+
+        if (active == 0) {
+            break;
+        }
+
+        int status;
+        if (waitpid(-1, &status, 0) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = 1;
+            break;
+        }
+        active--;
+
+        // O filho escreve antes de sair: o registro já está no pipe
+        MonteCarlo_Drain(fds[0], runs, mc->runs);
+    }
+
+    MonteCarlo_Drain(fds[0], runs, mc->runs);
+    close(fds[0]);
+    close(fds[1]);
+
+    return error ? -1 : 0;
+}
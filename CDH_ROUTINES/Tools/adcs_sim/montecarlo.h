@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    montecarlo.h
+  * @brief   Monte Carlo do ADCS: cenários sorteados em paralelo
+  *
+  * Cada cenário parte da configuração base e sorteia, a partir de
+  * (semente, índice):
+  *   - modo: detumbling (órbita) ou apontamento (modo ADCS, bancada);
+  *   - velocidade angular inicial;
+  *   - inércia do corpo (+-inertia_spread em cada eixo);
+  *   - ruído dos sensores (x1 a x noise_scale_max) e bias do giroscópio;
+  *   - limite de tensão do motor (velocidade máxima da roda = V / kt).
+  * O sorteio de um índice não depende do número de processos.
+  *
+  * O firmware guarda estado em variáveis estáticas e não volta ao estado
+  * de boot entre simulações: cada cenário roda num processo filho (fork) a
+  * partir do estado limpo do pai, até `workers` ao mesmo tempo. O
+  * resultado volta por um pipe (registro menor que PIPE_BUF: escrita
+  * atômica).
+  ******************************************************************************
+  */
+
+#ifndef __MONTECARLO_H
+#define __MONTECARLO_H
+
+#include <stdint.h>
+#include "sim.h"
+
+#define MONTECARLO_WORKERS_MAX  64
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    Sim_Config_t base;          // Planta, sensores, firmware e duração
+    uint32_t runs;
+    uint32_t workers;           // Simulações simultâneas (processos)
+    uint64_t seed;
+
+    double pointing_fraction;   // Fração dos cenários em modo ADCS
+    double rate_max;            // Detumbling: |w_i| inicial até (rad/s)
+    double pointing_rate_max;   // Apontamento: |w_z| inicial até (rad/s)
+    double inertia_spread;      // Variação relativa de cada Jii
+    double noise_scale_max;     // Multiplicador máximo dos ruídos
+    double gyro_bias_max;       // |bias| inicial por eixo até (rad/s)
+    double voltage_min;         // voltage_limit sorteado em [voltage_min, base]
+} MonteCarlo_Config_t;
+
+/* ============================================================================
+   RESULTADO DE UM CENÁRIO
+   ============================================================================ */
+typedef struct {
+    CDH_OperationMode_t mode;
+    double w0[3];
+    double inertia[3];
+    double noise_scale;
+    double voltage_limit;
+    uint64_t seed;
+} MonteCarlo_Scenario_t;
+
+typedef struct {
+    uint32_t index;
+    int32_t status;             // Sim_Run; -2 = processo terminou sem resultado
+    MonteCarlo_Scenario_t scenario;
+    Sim_Result_t result;
+} MonteCarlo_Run_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void MonteCarlo_DefaultConfig(MonteCarlo_Config_t *mc);
+
+// Configuração do cenário `index` (determinística)
+void MonteCarlo_Sample(const MonteCarlo_Config_t *mc, uint32_t index,
+                       Sim_Config_t *cfg, MonteCarlo_Scenario_t *scenario);
+
+// Roda mc->runs cenários; runs[i] recebe o cenário i. Retorna 0 ou -1 (fork/pipe)
+int MonteCarlo_Run(const MonteCarlo_Config_t *mc, MonteCarlo_Run_t *runs);
+
+#endif /* __MONTECARLO_H */
@@ -0,0 +1,232 @@
+/**
+  ******************************************************************************
+  * @file    plant.c
+  * @brief   Dinâmica do corpo rígido e da roda de reação
+  ******************************************************************************
+  */
+
+#include "plant.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Plant_Cross(const double a[3], const double b[3], double out[3])
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static void Plant_RotateToInertial(const double q[4], const double v[3], double out[3])
+{
+    // out = R(q) v = v + 2 qv x (qv x v + w v)
+    const double u[3] = {q[1], q[2], q[3]};
+    double t[3];
+    double c[3];
+
+    Plant_Cross(u, v, t);
+    t[0] += q[0] * v[0];
+    t[1] += q[0] * v[1];
+    t[2] += q[0] * v[2];
+    Plant_Cross(u, t, c);
+    out[0] = v[0] + 2.0 * c[0];
+    out[1] = v[1] + 2.0 * c[1];
+    out[2] = v[2] + 2.0 * c[2];
+}
+
+static void Plant_Normalize(double q[4])
+{
+    double inv = 1.0 / sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; i++) {
+        q[i] *= inv;
+    }
+}
+
+/**
+ * @brief Derivadas de (q, w, Ω) com o torque líquido na roda fixo
+ */
+static void Plant_Derivative(const Plant_t *plant, const double q[4], const double w[3],
+                             double wheel_speed, double wheel_torque,
+                             double dq[4], double dw[3], double *dwheel)
+{
+    const Plant_Config_t *cfg = &plant->cfg;
+    double h[3];
+    double gyro[3];
+
+    // H = J w + Jw Ω a
+    for (int i = 0; i < 3; i++) {
+        h[i] = cfg->inertia[i] * w[i] + cfg->wheel_inertia * wheel_speed * cfg->wheel_axis[i];
+    }
+    Plant_Cross(w, h, gyro);
+
+    for (int i = 0; i < 3; i++) {
+        dw[i] = (-gyro[i] - wheel_torque * cfg->wheel_axis[i] + cfg->dist_torque[i]) / cfg->inertia[i];
+    }
+    *dwheel = wheel_torque / cfg->wheel_inertia;
+
+    dq[0] = 0.5 * (-q[1] * w[0] - q[2] * w[1] - q[3] * w[2]);
+    dq[1] = 0.5 * ( q[0] * w[0] + q[2] * w[2] - q[3] * w[1]);
+    dq[2] = 0.5 * ( q[0] * w[1] - q[1] * w[2] + q[3] * w[0]);
+    dq[3] = 0.5 * ( q[0] * w[2] + q[1] * w[1] - q[2] * w[0]);
+}
+
+/**
+ * @brief Uma iteração da malha de velocidade do SimpleFOC (LPF + PI com rampa)
+ */
+static void Plant_MotorControl(Plant_t *plant, double dt)
+{
+    const Plant_Config_t *cfg = &plant->cfg;
+
+    double alpha = cfg->vel_tf / (cfg->vel_tf + dt);
+    plant->vel_filtered = alpha * plant->vel_filtered + (1.0 - alpha) * plant->wheel_speed;
+
+    // PIDController do SimpleFOC: integral trapezoidal, saturação e rampa
+    double error = plant->target - plant->vel_filtered;
+    double integral = plant->integral + cfg->vel_ki * dt * 0.5 * (error + plant->error_prev);
+    if (integral > cfg->voltage_limit) integral = cfg->voltage_limit;
+    if (integral < -cfg->voltage_limit) integral = -cfg->voltage_limit;
+
+    double uq = cfg->vel_kp * error + integral;
+    if (uq > cfg->voltage_limit) uq = cfg->voltage_limit;
+    if (uq < -cfg->voltage_limit) uq = -cfg->voltage_limit;
+
+    double max_step = cfg->vel_ramp * dt;
+    if (cfg->vel_ramp > 0.0) {
+        if (uq > plant->uq + max_step) uq = plant->uq + max_step;
+        if (uq < plant->uq - max_step) uq = plant->uq - max_step;
+    }
+
+    plant->integral = integral;
+    plant->error_prev = error;
+    plant->uq = uq;
+    plant->iq = (uq - cfg->motor_kt * plant->wheel_speed) / cfg->motor_resistance;
+    plant->torque = cfg->motor_kt * plant->iq;
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Valores nominais: 1U em mesa de rolamento a ar, roda de 1e-4 kg m²
+ * @note Jzz / Jw = 100 (DETUMBLE_INERTIA_RATIO); motor e malha com os
+ *       padrões do SimpleFOC (P = 0.5, I = 10, Tf = 5 ms, rampa 1000 V/s)
+ */
+void Plant_DefaultConfig(Plant_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(Plant_Config_t));
+
+    cfg->inertia[0] = 0.012;
+    cfg->inertia[1] = 0.011;
+    cfg->inertia[2] = 0.010;
+
+    cfg->wheel_inertia = 1e-4;
+    cfg->wheel_axis[2] = -1.0;
+    cfg->friction_viscous = 1e-6;
+    cfg->friction_coulomb = 2e-5;
+
+    cfg->motor_resistance = 8.0;
+    cfg->motor_kt = 0.07;
+    cfg->voltage_limit = 12.0;
+    cfg->vel_kp = 0.5;
+    cfg->vel_ki = 10.0;
+    cfg->vel_ramp = 1000.0;
+    cfg->vel_tf = 0.005;
+}
+
+void Plant_Init(Plant_t *plant, const Plant_Config_t *cfg, const double q0[4], const double w0[3])
+{
+    memset(plant, 0, sizeof(Plant_t));
+    plant->cfg = *cfg;
+    memcpy(plant->q, q0, sizeof(plant->q));
+    memcpy(plant->w, w0, sizeof(plant->w));
+    Plant_Normalize(plant->q);
+}
+
+void Plant_SetTarget(Plant_t *plant, double target)
+{
+    plant->target = target;
+}
+
+/**
+ * @brief Avança dt (malha do motor uma vez, corpo e roda por RK4)
+ */
+void Plant_Step(Plant_t *plant, double dt)
+{
+    const Plant_Config_t *cfg = &plant->cfg;
+
+    Plant_MotorControl(plant, dt);
+
+    // Atrito: roda parada segura o torque até vencer o atrito seco
+    double wheel_torque;
+    if (fabs(plant->wheel_speed) < 1e-3 && fabs(plant->torque) <= cfg->friction_coulomb) {
+        // Roda presa ao corpo: o resto do momento relativo passa ao corpo
+        for (int i = 0; i < 3; i++) {
+            plant->w[i] += cfg->wheel_inertia * plant->wheel_speed * cfg->wheel_axis[i] / cfg->inertia[i];
+        }
+        wheel_torque = 0.0;
+        plant->wheel_speed = 0.0;
+    } else {
+        double sign = (plant->wheel_speed != 0.0) ? copysign(1.0, plant->wheel_speed)
+                                                  : copysign(1.0, plant->torque);
+        wheel_torque = plant->torque - cfg->friction_viscous * plant->wheel_speed -
+                       cfg->friction_coulomb * sign;
+    }
+
+    double k_q[4][4], k_w[4][3], k_o[4];
+    double q[4], w[3], o;
+    const double scale[4] = {0.0, 0.5, 0.5, 1.0};
+
+    Plant_Derivative(plant, plant->q, plant->w, plant->wheel_speed, wheel_torque,
+                     k_q[0], k_w[0], &k_o[0]);
+
+    for (int stage = 1; stage < 4; stage++) {
+        double h = dt * scale[stage];
+
+        for (int i = 0; i < 4; i++) q[i] = plant->q[i] + h * k_q[stage - 1][i];
+        for (int i = 0; i < 3; i++) w[i] = plant->w[i] + h * k_w[stage - 1][i];
+        o = plant->wheel_speed + h * k_o[stage - 1];
+
+        Plant_Derivative(plant, q, w, o, wheel_torque, k_q[stage], k_w[stage], &k_o[stage]);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        plant->q[i] += dt / 6.0 * (k_q[0][i] + 2.0 * k_q[1][i] + 2.0 * k_q[2][i] + k_q[3][i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        plant->w[i] += dt / 6.0 * (k_w[0][i] + 2.0 * k_w[1][i] + 2.0 * k_w[2][i] + k_w[3][i]);
+    }
+    plant->wheel_speed += dt / 6.0 * (k_o[0] + 2.0 * k_o[1] + 2.0 * k_o[2] + k_o[3]);
+    Plant_Normalize(plant->q);
+}
+
+void Plant_Momentum(const Plant_t *plant, double h[3])
+{
+    double body[3];
+
+    for (int i = 0; i < 3; i++) {
+        body[i] = plant->cfg.inertia[i] * plant->w[i] +
+                  plant->cfg.wheel_inertia * plant->wheel_speed * plant->cfg.wheel_axis[i];
+    }
+    Plant_RotateToInertial(plant->q, body, h);
+}
+
+/**
+ * @brief out = R(q)^T v (vetor inercial visto no corpo)
+ */
+void Plant_RotateToBody(const double q[4], const double v[3], double out[3])
+{
+    const double conj[4] = {q[0], -q[1], -q[2], -q[3]};
+    Plant_RotateToInertial(conj, v, out);
+}
+
+/**
+ * @brief Ângulo da rotação entre duas atitudes (rad, 0 a pi)
+ */
+double Plant_AngleBetween(const double q1[4], const double q2[4])
+{
+    double dot = fabs(q1[0] * q2[0] + q1[1] * q2[1] + q1[2] * q2[2] + q1[3] * q2[3]);
+    if (dot > 1.0) dot = 1.0;
+    return 2.0 * acos(dot);
+}
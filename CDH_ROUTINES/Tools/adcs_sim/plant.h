@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    plant.h
+  * @brief   Planta do simulador: corpo rígido, roda de reação e a malha de
+  *          velocidade do SimpleFOC
+  *
+  * Corpo (sistema do corpo, inércia J diagonal, roda no eixo a):
+  *   J dw/dt = -w x (J w + Jw Ω a) - τ_m a + τ_ext
+  *   dq/dt   = 0.5 * q (x) (0, w)              (q: corpo -> inercial)
+  * Roda (Ω relativa ao corpo):
+  *   Jw dΩ/dt = τ_m - b Ω - atrito seco
+  * Motor em controle de tensão (sem sensor de corrente), como no sketch:
+  *   Uq = PI(alvo - Ω filtrada), limitado a voltage_limit
+  *   Iq = (Uq - ke Ω) / R,  τ_m = kt Iq          (ke = kt)
+  *
+  * O firmware assume que acelerar a roda no sentido positivo acelera o
+  * corpo em +Z (PID e detumbling em adcs.c): é o eixo a = -Z.
+  * Integração RK4 em double com τ_m constante em cada passo.
+  ******************************************************************************
+  */
+
+#ifndef __PLANT_H
+#define __PLANT_H
+
+#include <stdint.h>
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    // Corpo
+    double inertia[3];          // Jxx, Jyy, Jzz (kg m²)
+    double dist_torque[3];      // Torque externo constante no corpo (N m)
+
+    // Roda
+    double wheel_inertia;       // Jw (kg m²)
+    double wheel_axis[3];       // Eixo da roda no corpo (unitário)
+    double friction_viscous;    // b (N m s/rad)
+    double friction_coulomb;    // Atrito seco (N m)
+
+    // Motor e driver (SimpleFOC)
+    double motor_resistance;    // R (ohm)
+    double motor_kt;            // kt = ke (N m/A = V s/rad)
+    double voltage_limit;       // motor.voltage_limit (V)
+    double vel_kp;              // motor.PID_velocity.P (V s/rad)
+    double vel_ki;              // motor.PID_velocity.I (V/rad)
+    double vel_ramp;            // motor.PID_velocity.output_ramp (V/s)
+    double vel_tf;              // motor.LPF_velocity.Tf (s)
+} Plant_Config_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    Plant_Config_t cfg;
+
+    double q[4];                // Corpo -> inercial (w, x, y, z)
+    double w[3];                // Velocidade angular do corpo (rad/s)
+    double wheel_speed;         // Ω (rad/s)
+
+    // Malha de velocidade do SimpleFOC
+    double target;              // motor.target (rad/s)
+    double vel_filtered;        // Ω depois do LPF (também vai na telemetria)
+    double integral;            // Termo integral do PI (V)
+    double error_prev;
+    double uq;                  // Tensão aplicada (V)
+    double iq;                  // Corrente (A)
+    double torque;              // τ_m (N m)
+} Plant_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Plant_DefaultConfig(Plant_Config_t *cfg);
+void Plant_Init(Plant_t *plant, const Plant_Config_t *cfg, const double q0[4], const double w0[3]);
+void Plant_SetTarget(Plant_t *plant, double target);
+void Plant_Step(Plant_t *plant, double dt);
+
+// Momento angular total no sistema inercial (conservado sem torque externo)
+void Plant_Momentum(const Plant_t *plant, double h[3]);
+
+// Conversões (q: corpo -> inercial)
+void Plant_RotateToBody(const double q[4], const double v[3], double out[3]);
+double Plant_AngleBetween(const double q1[4], const double q2[4]);
+
+#endif /* __PLANT_H */
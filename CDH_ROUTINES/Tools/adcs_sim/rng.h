@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    rng.h
+  * @brief   Gerador pseudoaleatório do simulador (xorshift64*, Box-Muller)
+  *
+  * Estado explícito por instância: a mesma semente reproduz a mesma
+  * simulação, sem depender do rand() da libc.
+  ******************************************************************************
+  */
+
+#ifndef __RNG_H
+#define __RNG_H
+
+#include <stdint.h>
+#include <math.h>
+
+typedef struct {
+    uint64_t state;
+    double spare;               // Segunda amostra gaussiana do Box-Muller
+    uint8_t has_spare;
+} Rng_t;
+
+static inline void Rng_Seed(Rng_t *rng, uint64_t seed)
+{
+    // Espalha sementes pequenas (splitmix64); o estado nunca pode ser 0
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    rng->state = (z ^ (z >> 31)) | 1ULL;
+    rng->has_spare = 0;
+}
+
+static inline uint64_t Rng_Next(Rng_t *rng)
+{
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Uniforme em (0, 1)
+ */
+static inline double Rng_Uniform(Rng_t *rng)
+{
+    return ((double)(Rng_Next(rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Normal com média 0 e desvio padrão 1
+ */
+static inline double Rng_Gauss(Rng_t *rng)
+{
+    if (rng->has_spare) {
+        rng->has_spare = 0;
+        return rng->spare;
+    }
+
+    double r = sqrt(-2.0 * log(Rng_Uniform(rng)));
+    double theta = 2.0 * M_PI * Rng_Uniform(rng);
+    rng->spare = r * sin(theta);
+    rng->has_spare = 1;
+    return r * cos(theta);
+}
+
+#endif /* __RNG_H */
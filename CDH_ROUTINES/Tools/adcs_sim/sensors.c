@@ -0,0 +1,244 @@
+/**
+  ******************************************************************************
+  * @file    sensors.c
+  * @brief   BMI088 emulado no nível de registrador e LDRs do SolarTracker
+  ******************************************************************************
+  */
+
+#include "sensors.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+   REGISTRADORES DO BMI088 (datasheet BST-BMI088-DS001)
+   ============================================================================ */
+#define ACC_CHIP_ID             0x00
+#define ACC_DATA                0x12    // X LSB ... Z MSB
+#define ACC_CONF                0x40
+#define ACC_RANGE               0x41
+#define ACC_PWR_CTRL            0x7D
+#define ACC_SOFTRESET           0x7E
+#define ACC_CHIP_ID_VALUE       0x1E
+
+#define GYR_CHIP_ID             0x00
+#define GYR_DATA                0x02    // X LSB ... Z MSB
+#define GYR_RANGE               0x0F
+#define GYR_BANDWIDTH           0x10
+#define GYR_SOFTRESET           0x14
+#define GYR_CHIP_ID_VALUE       0x0F
+
+#define SOFTRESET_CMD           0xB6
+#define ACC_PWR_ON              0x04
+#define STANDARD_GRAVITY        9.80665
+
+// GYRO_BANDWIDTH: ODR e banda do filtro por código (0 a 7)
+static const double gyr_odr_hz[8] = {2000.0, 2000.0, 1000.0, 400.0, 200.0, 100.0, 200.0, 100.0};
+static const double gyr_bw_hz[8] = {532.0, 230.0, 116.0, 47.0, 23.0, 12.0, 64.0, 32.0};
+
+// Normal de cada LDR no plano XY (graus, sem a inclinação), índices S_* do SolarTracker
+static const double ldr_face_deg[SENSORS_LDR_COUNT] = {-90.0, -90.0, 90.0, 0.0, 0.0, 180.0, 180.0, 90.0};
+static const double ldr_tilt_sign[SENSORS_LDR_COUNT] = {-1.0, 1.0, 1.0, 1.0, -1.0, 1.0, -1.0, -1.0};
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Sensors_ResetAcc(Sensors_t *sensors)
+{
+    memset(sensors->acc_regs, 0, sizeof(sensors->acc_regs));
+    sensors->acc_regs[ACC_CHIP_ID] = ACC_CHIP_ID_VALUE;
+    sensors->acc_regs[ACC_CONF] = 0xA8;
+    sensors->acc_regs[ACC_RANGE] = 0x01;
+}
+
+static void Sensors_ResetGyr(Sensors_t *sensors)
+{
+    memset(sensors->gyr_regs, 0, sizeof(sensors->gyr_regs));
+    sensors->gyr_regs[GYR_CHIP_ID] = GYR_CHIP_ID_VALUE;
+    sensors->gyr_regs[GYR_BANDWIDTH] = 0x80;
+}
+
+/**
+ * @brief Grava um valor físico como inteiro de 16 bits (little-endian, satura)
+ */
+static void Sensors_PutRaw(uint8_t *regs, double value, double lsb)
+{
+    double raw = round(value / lsb);
+    if (raw > 32767.0) raw = 32767.0;
+    if (raw < -32768.0) raw = -32768.0;
+
+    int16_t v = (int16_t)raw;
+    regs[0] = (uint8_t)(v & 0xFF);
+    regs[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+static void Sensors_SampleAcc(Sensors_t *sensors, const Plant_t *plant, double odr)
+{
+    const double up[3] = {0.0, 0.0, sensors->cfg.gravity ? STANDARD_GRAVITY : 0.0};
+    double f[3];
+    double full_scale_g = 1.5 * (double)(2 << (sensors->acc_regs[ACC_RANGE] & 0x03));
+    double lsb = full_scale_g * STANDARD_GRAVITY / 32768.0;
+    double sigma = sensors->cfg.acc_noise * sqrt(0.4 * odr);
+
+    // Desligado (ACC_PWR_CTRL): os registradores de dados não mudam
+    if (sensors->acc_regs[ACC_PWR_CTRL] != ACC_PWR_ON) {
+        return;
+    }
+
+    Plant_RotateToBody(plant->q, up, f);
+    for (int i = 0; i < 3; i++) {
+        Sensors_PutRaw(&sensors->acc_regs[ACC_DATA + 2 * i],
+                       f[i] + sigma * Rng_Gauss(&sensors->rng), lsb);
+    }
+    sensors->acc_samples++;
+}
+
+static void Sensors_SampleGyr(Sensors_t *sensors, const Plant_t *plant, double odr, double bw)
+{
+    double full_scale_dps = 2000.0 / (double)(1 << (sensors->gyr_regs[GYR_RANGE] & 0x07));
+    double lsb = full_scale_dps * M_PI / 180.0 / 32768.0;
+    double sigma = sensors->cfg.gyro_noise * sqrt(bw);
+    double walk = sensors->cfg.gyro_bias_walk * sqrt(1.0 / odr);
+
+    for (int i = 0; i < 3; i++) {
+        sensors->bias[i] += walk * Rng_Gauss(&sensors->rng);
+        Sensors_PutRaw(&sensors->gyr_regs[GYR_DATA + 2 * i],
+                       plant->w[i] + sensors->bias[i] + sigma * Rng_Gauss(&sensors->rng), lsb);
+    }
+    sensors->gyr_samples++;
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+/**
+ * @brief Valores típicos do datasheet do BMI088 e dos LDRs da placa
+ */
+void Sensors_DefaultConfig(Sensors_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(Sensors_Config_t));
+
+    cfg->gyro_noise = 0.014 * M_PI / 180.0;         // 0.014 deg/s/sqrt(Hz)
+    cfg->gyro_bias_walk = 1e-5;
+    cfg->acc_noise = 175e-6 * STANDARD_GRAVITY;     // 175 ug/sqrt(Hz)
+    cfg->gravity = 0;
+
+    cfg->sun_inertial[0] = 1.0;
+    cfg->ldr_dark = 300.0;
+    cfg->ldr_full = 50000.0;
+    cfg->ldr_noise = 150.0;
+    cfg->ldr_tilt = 20.0 * M_PI / 180.0;
+}
+
+void Sensors_Init(Sensors_t *sensors, const Sensors_Config_t *cfg, uint64_t seed)
+{
+    memset(sensors, 0, sizeof(Sensors_t));
+    sensors->cfg = *cfg;
+    Rng_Seed(&sensors->rng, seed);
+    memcpy(sensors->bias, cfg->gyro_bias, sizeof(sensors->bias));
+
+    Sensors_ResetAcc(sensors);
+    Sensors_ResetGyr(sensors);
+}
+
+void Sensors_Update(Sensors_t *sensors, const Plant_t *plant, double t)
+{
+    double acc_odr = 12.5 * pow(2.0, (double)((sensors->acc_regs[ACC_CONF] & 0x0F) - 5));
+    uint8_t gyr_code = sensors->gyr_regs[GYR_BANDWIDTH] & 0x07;
+    double gyr_odr = gyr_odr_hz[gyr_code];
+
+    if (t >= sensors->acc_next_sample) {
+        Sensors_SampleAcc(sensors, plant, acc_odr);
+        sensors->acc_next_sample += 1.0 / acc_odr;
+        if (sensors->acc_next_sample <= t) {
+            sensors->acc_next_sample = t + 1.0 / acc_odr;
+        }
+    }
+
+    if (t >= sensors->gyr_next_sample) {
+        Sensors_SampleGyr(sensors, plant, gyr_odr, gyr_bw_hz[gyr_code]);
+        sensors->gyr_next_sample += 1.0 / gyr_odr;
+        if (sensors->gyr_next_sample <= t) {
+            sensors->gyr_next_sample = t + 1.0 / gyr_odr;
+        }
+    }
+}
+
+/**
+ * @brief Acelerômetro: leitura devolve um byte falso antes dos dados
+ * @param rx NULL em escrita (HAL_SPI_Transmit)
+ */
+void Sensors_AccTransfer(Sensors_t *sensors, const uint8_t *tx, uint8_t *rx, uint16_t size)
+{
+    uint8_t reg = tx[0] & 0x7F;
+
+    if (tx[0] & 0x80) {
+        if (rx == NULL) {
+            return;
+        }
+        rx[0] = 0xFF;
+        if (size > 1) {
+            rx[1] = 0xFF;
+        }
+        for (uint16_t i = 2; i < size; i++) {
+            rx[i] = sensors->acc_regs[(reg + i - 2) & 0x7F];
+        }
+        return;
+    }
+
+    if (size < 2) {
+        return;
+    }
+    if (reg == ACC_SOFTRESET && tx[1] == SOFTRESET_CMD) {
+        Sensors_ResetAcc(sensors);
+    } else if (reg != ACC_CHIP_ID) {
+        sensors->acc_regs[reg] = tx[1];
+    }
+}
+
+/**
+ * @brief Giroscópio: dados logo depois do endereço
+ */
+void Sensors_GyrTransfer(Sensors_t *sensors, const uint8_t *tx, uint8_t *rx, uint16_t size)
+{
+    uint8_t reg = tx[0] & 0x7F;
+
+    if (tx[0] & 0x80) {
+        if (rx == NULL) {
+            return;
+        }
+        rx[0] = 0xFF;
+        for (uint16_t i = 1; i < size; i++) {
+            rx[i] = sensors->gyr_regs[(reg + i - 1) & 0x7F];
+        }
+        return;
+    }
+
+    if (size < 2) {
+        return;
+    }
+    if (reg == GYR_SOFTRESET && tx[1] == SOFTRESET_CMD) {
+        Sensors_ResetGyr(sensors);
+    } else if (reg != GYR_CHIP_ID) {
+        sensors->gyr_regs[reg] = tx[1];
+    }
+}
+
+void Sensors_ReadLdr(Sensors_t *sensors, const Plant_t *plant, uint16_t adc[SENSORS_LDR_COUNT])
+{
+    double sun[3];
+
+    Plant_RotateToBody(plant->q, sensors->cfg.sun_inertial, sun);
+
+    for (int i = 0; i < SENSORS_LDR_COUNT; i++) {
+        double angle = ldr_face_deg[i] * M_PI / 180.0 + ldr_tilt_sign[i] * sensors->cfg.ldr_tilt;
+        double cosine = cos(angle) * sun[0] + sin(angle) * sun[1];
+        double value = sensors->cfg.ldr_dark + sensors->cfg.ldr_noise * Rng_Gauss(&sensors->rng);
+
+        if (!sensors->cfg.eclipse && cosine > 0.0) {
+            value += (sensors->cfg.ldr_full - sensors->cfg.ldr_dark) * cosine;
+        }
+        if (value < 0.0) value = 0.0;
+        if (value > 65535.0) value = 65535.0;
+        adc[i] = (uint16_t)value;
+    }
+}
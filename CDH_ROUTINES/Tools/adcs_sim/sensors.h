@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    sensors.h
+  * @brief   Modelos de sensores do simulador: BMI088 (registradores SPI) e
+  *          LDRs do SolarTracker (contagens do ADC)
+  *
+  * BMI088: o driver real (BMI088.c) conversa por SPI com um banco de
+  * registradores emulado. Os registradores de dados são renovados na
+  * ODR configurada (ACC_CONF, GYRO_BANDWIDTH) e a faixa segue ACC_RANGE e
+  * GYRO_RANGE, com quantização de 16 bits:
+  *   gyro  = w + bias + ruído branco (densidade * sqrt(banda)); o bias anda
+  *           por passeio aleatório
+  *   accel = força específica: R(q)^T (0, 0, g) na bancada, 0 em órbita
+  *
+  * LDRs: 8 sensores no plano XY (2 por face, inclinados +-ldr_tilt em Z),
+  * resposta de cosseno com a direção do Sol no corpo:
+  *   adc = escuro + (cheio - escuro) * max(0, n . s) + ruído
+  ******************************************************************************
+  */
+
+#ifndef __SENSORS_H
+#define __SENSORS_H
+
+#include <stdint.h>
+#include "plant.h"
+#include "rng.h"
+
+#define SENSORS_LDR_COUNT       8       // NUM_SENSORES do SolarTracker
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    // BMI088
+    double gyro_noise;          // Densidade de ruído (rad/s/sqrt(Hz))
+    double gyro_bias[3];        // Bias inicial (rad/s)
+    double gyro_bias_walk;      // Passeio aleatório do bias (rad/s²/sqrt(Hz))
+    double acc_noise;           // Densidade de ruído (m/s²/sqrt(Hz))
+    uint8_t gravity;            // 1 = bancada (1 g em +Z inercial), 0 = órbita
+
+    // LDRs
+    double sun_inertial[3];     // Direção do Sol no sistema inercial (unitária)
+    uint8_t eclipse;            // 1 = sem Sol (só o escuro e o ruído)
+    double ldr_dark;            // Contagem no escuro
+    double ldr_full;            // Contagem com o Sol na normal do sensor
+    double ldr_noise;           // Desvio padrão (contagens)
+    double ldr_tilt;            // Inclinação de cada par em torno de Z (rad)
+} Sensors_Config_t;
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    Sensors_Config_t cfg;
+    Rng_t rng;
+
+    // Bancos de registradores (endereço de 7 bits)
+    uint8_t acc_regs[128];
+    uint8_t gyr_regs[128];
+    double acc_next_sample;     // Instante da próxima amostra (s)
+    double gyr_next_sample;
+
+    double bias[3];             // Bias atual do giroscópio (rad/s)
+    uint32_t acc_samples;
+    uint32_t gyr_samples;
+} Sensors_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Sensors_DefaultConfig(Sensors_Config_t *cfg);
+void Sensors_Init(Sensors_t *sensors, const Sensors_Config_t *cfg, uint64_t seed);
+
+// Renova os registradores de dados vencidos pela ODR (chamar a cada passo)
+void Sensors_Update(Sensors_t *sensors, const Plant_t *plant, double t);
+
+// Transações SPI (buffers como no fio: endereço no primeiro byte)
+void Sensors_AccTransfer(Sensors_t *sensors, const uint8_t *tx, uint8_t *rx, uint16_t size);
+void Sensors_GyrTransfer(Sensors_t *sensors, const uint8_t *tx, uint8_t *rx, uint16_t size);
+
+// Leitura dos LDRs na ordem dos índices S_* do SolarTracker
+void Sensors_ReadLdr(Sensors_t *sensors, const Plant_t *plant, uint16_t adc[SENSORS_LDR_COUNT]);
+
+#endif /* __SENSORS_H */
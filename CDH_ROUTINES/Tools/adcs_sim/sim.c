@@ -0,0 +1,365 @@
+/**
+  ******************************************************************************
+  * @file    sim.c
+  * @brief   Laço da simulação: planta, sensores, UART, TIM6 e loop principal
+  ******************************************************************************
+  */
+
+#include "sim.h"
+#include "sim_hal.h"
+#include "simplefoc.h"
+#include "adcs.h"
+#include "tim.h"
+#include "SolarTracker.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_METRIC_PERIOD       0.01    // Amostragem das métricas de estimação (s)
+#define SIM_TICK_TOLERANCE      0.5     // Fração do passo aceita no disparo de eventos
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+static const Sim_Config_t *sim_cfg;
+static Plant_t plant;
+static Sensors_t sensors;
+static SimpleFOC_t foc;
+static SolarTracker_t tracker;
+
+static uint64_t step = 0;
+static double sim_t = 0.0;
+static double next_monitor = 0.0;
+
+// Métricas (a partir de t0, fim da inicialização)
+static uint8_t measuring = 0;
+static double t0 = 0.0;
+static double last_unsettled = 0.0;
+static double wheel_peak = 0.0;
+static double wheel_accel_peak = 0.0;
+static double wheel_last = 0.0;
+static double rate_z_sq = 0.0;
+static double att_sq = 0.0;
+static uint32_t tail_samples = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static double Sim_WallClock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint8_t Sim_Due(double t_event)
+{
+    return sim_t >= t_event - SIM_TICK_TOLERANCE * sim_cfg->physics_dt;
+}
+
+static double Sim_AttitudeError(const ADCS_Attitude_t *att)
+{
+    const double q_est[4] = {att->q.w, att->q.x, att->q.y, att->q.z};
+    return Plant_AngleBetween(q_est, plant.q);
+}
+
+/**
+ * @brief Um passo da planta com sensores e UART (sem o firmware)
+ */
+static void Sim_Step(void)
+{
+    Plant_Step(&plant, sim_cfg->physics_dt);
+    step++;
+    sim_t = (double)step * sim_cfg->physics_dt;
+    SimHal_SetTime(sim_t);
+
+    Sensors_Update(&sensors, &plant, sim_t);
+
+    // motor.monitor(): uma linha por período na UART
+    if (!sim_cfg->pwm_actuator && Sim_Due(next_monitor)) {
+        char line[64];
+        uint16_t len = SimpleFOC_Monitor(&foc, line, sizeof(line));
+        if (len > 0) {
+            SimHal_UartSend(line, len);
+        }
+        next_monitor += sim_cfg->monitor_period;
+    }
+
+    SimHal_Poll();
+
+    if (measuring) {
+        double wheel = fabs(plant.wheel_speed);
+        if (wheel > wheel_peak) {
+            wheel_peak = wheel;
+        }
+        if (fabs(plant.w[2]) >= DETUMBLE_RATE_DONE) {
+            last_unsettled = sim_t;
+        }
+    }
+}
+
+/**
+ * @brief HAL_Delay: a planta anda, a malha do TIM6 não (espera ocupada)
+ */
+static void Sim_Advance(double t_end)
+{
+    while (sim_t < t_end - SIM_TICK_TOLERANCE * sim_cfg->physics_dt) {
+        Sim_Step();
+    }
+}
+
+/**
+ * @brief Loop principal: LDRs -> SolarTracker -> vetor solar do estimador
+ */
+static void Sim_SunUpdate(void)
+{
+    Sensors_ReadLdr(&sensors, &plant, tracker.adc_raw);
+    Solar_Process(&tracker);
+    ADCS_SetSunVector(tracker.vetor_solar, tracker.sol_visivel);
+}
+
+static void Sim_Trace(FILE *f, const ADCS_Attitude_t *att)
+{
+    fprintf(f, "%.4f,%.6f,%.6f,%.6f,%.4f,%.4f,%.4f,%.4f,%.6f,%.6f,%.6f\n",
+            sim_t - t0, plant.w[0], plant.w[1], plant.w[2],
+            plant.wheel_speed, plant.target, plant.uq, plant.iq,
+            Sim_AttitudeError(att), att->gyro_bias[2], sensors.bias[2]);
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Sim_DefaultConfig(Sim_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(Sim_Config_t));
+
+    Plant_DefaultConfig(&cfg->plant);
+    Sensors_DefaultConfig(&cfg->sensors);
+
+    cfg->mode = CDH_MODE_DETUMBLING;
+    cfg->duration = 60.0;
+    cfg->q0[0] = 1.0;
+
+    cfg->control_rate_hz = ADCS_CONTROL_RATE_HZ;
+    cfg->main_loop_period = 0.005;
+    cfg->sun_period = 0.05;
+    cfg->autotune_at = -1.0;
+
+    cfg->monitor_period = 0.01;
+    cfg->physics_dt = 1e-4;
+    cfg->seed = 1;
+    cfg->trace_period = 0.01;
+}
+
+int Sim_Run(const Sim_Config_t *cfg, Sim_Result_t *result)
+{
+    double wall_start = Sim_WallClock();
+
+    memset(result, 0, sizeof(Sim_Result_t));
+    sim_cfg = cfg;
+    step = 0;
+    sim_t = 0.0;
+    next_monitor = cfg->monitor_period;
+    measuring = 0;
+
+    Plant_Init(&plant, &cfg->plant, cfg->q0, cfg->w0);
+    plant.wheel_speed = cfg->wheel0;
+    plant.vel_filtered = cfg->wheel0;
+    plant.target = cfg->wheel0;
+    Sensors_Init(&sensors, &cfg->sensors, cfg->seed);
+    SimpleFOC_Init(&foc, &plant);
+    foc.target = cfg->wheel0;
+    SimHal_Reset(&sensors, &foc, Sim_Advance);
+
+    // Sequência do main.c: ADCS_Init (HAL_Delay faz a planta andar), malha
+    if (ADCS_SetActuator(&huart4, cfg->pwm_actuator ? ADCS_ACTUATOR_PWM
+                                                    : ADCS_ACTUATOR_UART) != HAL_OK) {
+        return -1;
+    }
+    ADCS_Init(&huart4);
+    if (!ADCS_IsSensorReady()) {
+        return -1;
+    }
+    if (cfg->binary_framing) {
+        ADCS_SetFraming(ADCS_FRAMING_BINARY);
+    }
+    if (cfg->pid_override) {
+        ADCS_SetPIDGains(cfg->pid_kp, cfg->pid_ki, cfg->pid_kd);
+    }
+    const float sun_ref[3] = {(float)cfg->sensors.sun_inertial[0],
+                              (float)cfg->sensors.sun_inertial[1],
+                              (float)cfg->sensors.sun_inertial[2]};
+    ADCS_SetSunReference(sun_ref);
+    Solar_Init(&tracker);
+
+    if (cfg->control_rate_hz > 0 &&
+        ADCS_Control_Start(&huart4, cfg->control_rate_hz) != HAL_OK) {
+        return -1;
+    }
+
+    // Comando do COM: o cenário começa aqui
+    SimHal_SetMode(cfg->mode);
+    t0 = sim_t;
+    last_unsettled = t0;
+    wheel_peak = fabs(plant.wheel_speed);
+    wheel_accel_peak = 0.0;
+    wheel_last = plant.wheel_speed;
+    result->ramp_time = -1.0;
+    if (cfg->ramp && ADCS_SetSpeedRamp(cfg->ramp_speed) != HAL_OK) {
+        return -1;
+    }
+    rate_z_sq = 0.0;
+    att_sq = 0.0;
+    tail_samples = 0;
+    measuring = 1;
+
+    double h0[3], h1[3];
+    Plant_Momentum(&plant, h0);
+
+    double t_end = t0 + cfg->duration;
+    double t_tail = t0 + 0.75 * cfg->duration;
+    double next_tick = 0.0;
+    double next_main = t0;
+    double next_sun = t0;
+    double next_metric = t0;
+    double next_trace = t0;
+    double autotune_at = (cfg->autotune_at >= 0.0) ? t0 + cfg->autotune_at : -1.0;
+    ADCS_Attitude_t att;
+
+    if (cfg->trace != NULL) {
+        fprintf(cfg->trace, "t,wx,wy,wz,wheel,wheel_target,uq,iq,att_error,bias_z_est,bias_z_true\n");
+    }
+
+    while (sim_t < t_end - SIM_TICK_TOLERANCE * cfg->physics_dt) {
+        Sim_Step();
+
+        // Interrupção do TIM6 (uma por período; atraso não acumula ticks)
+        double period = SimHal_TimerPeriod();
+        if (period > 0.0) {
+            if (next_tick == 0.0) {
+                next_tick = sim_t + period;
+            } else if (Sim_Due(next_tick)) {
+                SimHal_EnterIsr();
+                HAL_TIM_PeriodElapsedCallback(&htim6);
+                SimHal_ExitIsr();
+                next_tick += period;
+                if (Sim_Due(next_tick)) {
+                    next_tick = sim_t + period;
+                }
+            }
+        }
+
+        // Loop principal
+        if (Sim_Due(next_main)) {
+            // Comando do COM (CAN_COM_AUTOTUNE_CMD) tratado no loop principal
+            if (autotune_at >= 0.0 && Sim_Due(autotune_at)) {
+                ADCS_Autotune_Start();
+                autotune_at = -1.0;
+            }
+            ADCS_Process(&huart4);
+            next_main += cfg->main_loop_period;
+        }
+        if (Sim_Due(next_sun)) {
+            Sim_SunUpdate();
+            next_sun += cfg->sun_period;
+        }
+
+        // Métricas e registro
+        if (Sim_Due(next_metric) || (cfg->trace != NULL && Sim_Due(next_trace))) {
+            ADCS_GetAttitude(&att);
+            if (Sim_Due(next_metric)) {
+                double accel = fabs(plant.wheel_speed - wheel_last) / SIM_METRIC_PERIOD;
+                if (accel > wheel_accel_peak) {
+                    wheel_accel_peak = accel;
+                }
+                wheel_last = plant.wheel_speed;
+                if (cfg->ramp && result->ramp_time < 0.0 && ADCS_IsRampDone()) {
+                    result->ramp_time = sim_t - t0;
+                }
+                if (sim_t >= t_tail) {
+                    double err = Sim_AttitudeError(&att);
+                    rate_z_sq += plant.w[2] * plant.w[2];
+                    att_sq += err * err;
+                    tail_samples++;
+                }
+                next_metric += SIM_METRIC_PERIOD;
+            }
+            if (cfg->trace != NULL && Sim_Due(next_trace)) {
+                Sim_Trace(cfg->trace, &att);
+                next_trace += cfg->trace_period;
+            }
+        }
+    }
+
+    // Verdade da planta
+    Plant_Momentum(&plant, h1);
+    result->momentum_drift = sqrt((h1[0] - h0[0]) * (h1[0] - h0[0]) +
+                                  (h1[1] - h0[1]) * (h1[1] - h0[1]) +
+                                  (h1[2] - h0[2]) * (h1[2] - h0[2]));
+    result->settle_time = (fabs(plant.w[2]) < DETUMBLE_RATE_DONE) ? last_unsettled - t0 : -1.0;
+    for (int i = 0; i < 3; i++) {
+        result->final_rate[i] = plant.w[i];
+    }
+    result->final_rate_norm = sqrt(plant.w[0] * plant.w[0] + plant.w[1] * plant.w[1] +
+                                   plant.w[2] * plant.w[2]);
+    result->rate_z_rms = (tail_samples > 0) ? sqrt(rate_z_sq / tail_samples) : 0.0;
+    result->wheel_final = plant.wheel_speed;
+    result->wheel_peak = wheel_peak;
+    result->wheel_accel_peak = wheel_accel_peak;
+
+    // Estimação
+    ADCS_GetAttitude(&att);
+    result->att_error_rms = (tail_samples > 0) ? sqrt(att_sq / tail_samples) : 0.0;
+    result->att_error_final = Sim_AttitudeError(&att);
+    result->att_sigma_final = fmax(att.att_sigma[0], fmax(att.att_sigma[1], att.att_sigma[2]));
+    double bias_sq = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double e = att.gyro_bias[i] - sensors.bias[i];
+        bias_sq += e * e;
+    }
+    result->bias_error_final = sqrt(bias_sq);
+
+    // Visto pelo firmware
+    Detumble_Gyro_t detumble;
+    ADCS_CommandStats_t cmd;
+    ADCS_MotorState_t motor;
+    ADCS_TimingStats_t timing;
+    SimHal_Stats_t hal;
+    Autotune_t autotune;
+    ADCS_Momentum_t momentum;
+
+    ADCS_GetDetumbleStatus(&detumble);
+    ADCS_GetCommandStats(&cmd);
+    ADCS_GetMotorState(&motor);
+    ADCS_GetTimingStats(&timing);
+    SimHal_GetStats(&hal);
+    ADCS_GetAutotuneStatus(&autotune);
+    ADCS_GetMomentum(&momentum);
+
+    result->fw_converged = detumble.converged;
+    result->fw_converge_time = detumble.converged ? (double)detumble.converge_ms / 1000.0 : -1.0;
+    result->fw_momentum_limited = detumble.momentum_limited;
+    result->desat_events = momentum.desat_events;
+    result->autotune_phase = (uint8_t)autotune.phase;
+    result->autotune_ku = autotune.ku;
+    result->autotune_tu = autotune.tu;
+    result->autotune_gains[0] = autotune.new_kp;
+    result->autotune_gains[1] = autotune.new_ki;
+    result->autotune_gains[2] = autotune.new_kd;
+    result->autotune_rms[0] = autotune.rms_baseline;
+    result->autotune_rms[1] = autotune.rms_verify;
+    result->commands_sent = cmd.commands_sent;
+    result->commands_dropped = cmd.commands_dropped;
+    result->telemetry_samples = motor.samples;
+    result->telemetry_rejected = motor.rejected;
+    result->tach_edges = hal.tach_edges;
+    result->motor_faults = ADCS_GetMotorFaults();
+    result->control_ticks = timing.ticks;
+    result->isr_delays = hal.isr_delays;
+
+    result->sim_time = sim_t;
+    result->wall_time = Sim_WallClock() - wall_start;
+    result->speedup = (result->wall_time > 0.0) ? sim_t / result->wall_time : 0.0;
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+  ******************************************************************************
+  * @file    sim.h
+  * @brief   Simulação em malha fechada do ADCS (firmware real + planta)
+  *
+  * O código do firmware (adcs.c, BMI088.c, uart_dma.c, Detumbling.c,
+  * SolarTracker.c e os utils) roda sem alteração sobre a HAL emulada:
+  *   - a interrupção do TIM6 é chamada no período configurado pelo
+  *     ADCS_Control_Start (ou o ADCS_Process no loop principal, sem ela);
+  *   - o loop principal lê os LDRs, chama Solar_Process e entrega o vetor
+  *     solar com ADCS_SetSunVector;
+  *   - a planta avança em passos fixos de physics_dt, mais rápido que o
+  *     tempo real;
+  *   - com pwm_actuator, a roda segue o duty do TIM2 e o FG vai para a
+  *     captura do TIM5 (o SimpleFOC fica mudo na UART).
+  *
+  * O firmware guarda estado em variáveis estáticas: uma simulação por
+  * processo.
+  ******************************************************************************
+  */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "can_protocol.h"
+#include "plant.h"
+#include "sensors.h"
+
+/* ============================================================================
+   CONFIGURAÇÃO
+   ============================================================================ */
+typedef struct {
+    Plant_Config_t plant;
+    Sensors_Config_t sensors;
+
+    // Cenário
+    CDH_OperationMode_t mode;   // Modo pedido pelo COM depois da inicialização
+    double duration;            // Tempo simulado depois da inicialização (s)
+    double w0[3];               // Velocidade angular inicial (rad/s)
+    double q0[4];               // Atitude inicial (corpo -> inercial)
+    double wheel0;              // Velocidade inicial da roda (rad/s)
+
+    // Firmware
+    uint32_t control_rate_hz;   // TIM6 (0 = ADCS_Process no loop principal)
+    double main_loop_period;    // Uma volta do loop principal (s)
+    double sun_period;          // Leitura dos LDRs + Solar_Process (s)
+    uint8_t binary_framing;     // ADCS_SetFraming(ADCS_FRAMING_BINARY)
+    uint8_t pwm_actuator;       // ADCS_SetActuator(ADCS_ACTUATOR_PWM): sem UART, tacômetro
+    uint8_t pid_override;       // 1 = ADCS_SetPIDGains(pid_kp, pid_ki, pid_kd)
+    float pid_kp;
+    float pid_ki;
+    float pid_kd;
+    double autotune_at;         // ADCS_Autotune_Start depois de t s no modo (< 0 = não)
+    uint8_t ramp;               // 1 = ADCS_SetSpeedRamp(ramp_speed) no início (fora de adcs/detumble)
+    float ramp_speed;           // rad/s
+
+    // SimpleFOC e integração
+    double monitor_period;      // motor.monitor_downsample em tempo (s)
+    double physics_dt;          // Passo da planta (s)
+    uint64_t seed;
+
+    // Registro (CSV, NULL = sem registro)
+    FILE *trace;
+    double trace_period;
+} Sim_Config_t;
+
+/* ============================================================================
+   RESULTADO
+   ============================================================================ */
+typedef struct {
+    // Detumbling (valores verdadeiros da planta)
+    double settle_time;         // |w_z| abaixo de DETUMBLE_RATE_DONE até o fim (-1 = nunca)
+    double final_rate[3];       // rad/s
+    double final_rate_norm;
+    double rate_z_rms;          // Último quarto da simulação
+
+    // Detumbling (visto pelo firmware)
+    uint8_t fw_converged;
+    double fw_converge_time;    // s
+    uint8_t fw_momentum_limited;
+
+    // Auto-tune (visto pelo firmware)
+    uint8_t autotune_phase;     // Autotune_Phase_t no fim
+    float autotune_ku;
+    float autotune_tu;          // s
+    float autotune_gains[3];    // kp, ki, kd calculados
+    float autotune_rms[2];      // Erro RMS antes / depois (rad/s)
+
+    // Estimação
+    double att_error_rms;       // Último quarto (rad)
+    double att_error_final;
+    double att_sigma_final;     // Maior desvio padrão da MEKF (rad)
+    double bias_error_final;    // |bias estimado - verdadeiro| (rad/s)
+
+    // Roda e conservação
+    double wheel_final;         // rad/s
+    double wheel_peak;
+    double wheel_accel_peak;    // rad/s², em janelas de 10 ms
+    double ramp_time;           // Até ADCS_IsRampDone (-1 = sem rampa ou não terminou)
+    uint32_t desat_events;      // Pedidos de dessaturação (ADCS_GetMomentum)
+    double momentum_drift;      // |H(fim) - H(início)| (N m s)
+
+    // Firmware
+    uint32_t commands_sent;
+    uint32_t commands_dropped;
+    uint32_t telemetry_samples;
+    uint32_t telemetry_rejected;
+    uint32_t tach_edges;        // Bordas do FG capturadas (atuador PWM)
+    uint8_t motor_faults;
+    uint32_t control_ticks;
+    uint32_t isr_delays;
+
+    // Desempenho
+    double sim_time;            // s simulados (inicialização incluída)
+    double wall_time;           // s de relógio
+    double speedup;
+} Sim_Result_t;
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void Sim_DefaultConfig(Sim_Config_t *cfg);
+
+// Roda um cenário completo; retorna 0 ou -1 se o firmware não inicializar
+int Sim_Run(const Sim_Config_t *cfg, Sim_Result_t *result);
+
+#endif /* __SIM_H */
@@ -0,0 +1,542 @@
+/**
+  ******************************************************************************
+  * @file    sim_hal.c
+  * @brief   HAL do STM32H7 emulada sobre os modelos do simulador
+  ******************************************************************************
+  */
+
+#include "sim_hal.h"
+#include "usart.h"
+#include "spi.h"
+#include "tim.h"
+#include "adcs.h"
+#include "wheel_pwm.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_TX_MAX              256     // Maior trecho entregue ao DMA de TX
+#define SIM_RX_CHUNK_MAX        64      // Maior linha do motor.monitor()
+#define SIM_RX_QUEUE            8
+#define SIM_PI                  3.14159265358979323846
+
+/* ============================================================================
+   PERIFÉRICOS (definidos pelo CubeMX no firmware)
+   ============================================================================ */
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+GPIO_TypeDef sim_gpio[9];
+TIM_TypeDef sim_tim2;
+TIM_TypeDef sim_tim5;
+TIM_TypeDef sim_tim6;
+
+DMA_HandleTypeDef hdma_uart5_rx;
+DMA_HandleTypeDef hdma_uart8_rx;
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_uart5_tx;
+DMA_HandleTypeDef hdma_uart4_tx;
+DMA_HandleTypeDef hdma_uart4_rx;
+
+UART_HandleTypeDef huart4 = {.hdmatx = &hdma_uart4_tx, .hdmarx = &hdma_uart4_rx};
+UART_HandleTypeDef huart5;
+UART_HandleTypeDef huart8;
+UART_HandleTypeDef huart3;
+
+SPI_HandleTypeDef hspi1;
+SPI_HandleTypeDef hspi4;
+
+TIM_HandleTypeDef htim2 = {.Instance = TIM2};
+TIM_HandleTypeDef htim5 = {.Instance = TIM5};
+TIM_HandleTypeDef htim6 = {.Instance = TIM6};
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+static Sensors_t *sim_sensors = NULL;
+static SimpleFOC_t *sim_foc = NULL;
+static SimHal_AdvanceFn sim_advance = NULL;
+static SimHal_UartTapFn sim_tap = NULL;
+
+static double sim_time = 0.0;
+static uint32_t sim_tick = 0;
+static uint8_t sim_in_isr = 0;
+static uint8_t timer_running = 0;
+static CDH_OperationMode_t sim_mode = CDH_MODE_IDLE;
+static SimHal_Stats_t stats;
+
+// UART4 TX: um trecho no DMA por vez
+static uint8_t tx_data[SIM_TX_MAX];
+static uint16_t tx_size = 0;
+static double tx_done = 0.0;
+static uint8_t tx_busy = 0;
+
+// UART4 RX: buffer circular do firmware e linhas a caminho
+typedef struct {
+    char data[SIM_RX_CHUNK_MAX];
+    uint16_t size;
+    double arrival;
+} SimHal_RxChunk_t;
+
+static uint8_t *rx_buf = NULL;
+static uint16_t rx_size = 0;
+static uint16_t rx_pos = 0;
+static uint8_t rx_armed = 0;
+static SimHal_RxChunk_t rx_queue[SIM_RX_QUEUE];
+static uint8_t rx_head = 0;
+static uint8_t rx_count = 0;
+static double rx_line_free = 0.0;      // Fim do último byte já colocado na linha
+
+// Driver PWM (TIM2_CH3, DIR, EN) e FG na captura do TIM5_CH1
+static uint8_t pwm_running = 0;
+static uint8_t tach_running = 0;
+static double tach_angle = 0.0;         // Ângulo desde a última borda (rad)
+static double tach_time = 0.0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static double SimHal_LineTime(uint16_t size)
+{
+    return (double)size * SIM_UART_BITS_PER_BYTE / SIM_UART_BAUD;
+}
+
+/**
+ * @brief Bytes CDH -> SimpleFOC que terminaram de sair na linha
+ */
+static void SimHal_TxDeliver(uint8_t *data, uint16_t size)
+{
+    if (sim_tap != NULL) {
+        sim_tap(data, size);
+    }
+    if (sim_foc != NULL) {
+        SimpleFOC_Receive(sim_foc, data, size);
+    }
+    stats.tx_bytes += size;
+}
+
+static void SimHal_RxDeliver(const SimHal_RxChunk_t *chunk)
+{
+    for (uint16_t i = 0; i < chunk->size; i++) {
+        if (!rx_armed) {
+            stats.rx_dropped++;
+            continue;
+        }
+        rx_buf[rx_pos++] = (uint8_t)chunk->data[i];
+        stats.rx_bytes++;
+        if (rx_pos == rx_size) {
+            // Volta completa do DMA circular
+            rx_pos = 0;
+            HAL_UARTEx_RxEventCallback(&huart4, rx_size);
+        }
+    }
+
+    // Linha ociosa depois do último byte
+    if (rx_armed && rx_pos > 0) {
+        HAL_UARTEx_RxEventCallback(&huart4, rx_pos);
+    }
+}
+
+/**
+ * @brief Contagem do timer no instante t (clock do APB1 / (PSC + 1))
+ */
+static uint32_t SimHal_TimerCount(const TIM_TypeDef *tim, double t)
+{
+    return (uint32_t)(uint64_t)(t * (double)SIM_APB1_TIMER_HZ / (double)(tim->PSC + 1));
+}
+
+/**
+ * @brief Driver PWM: alvo da roda pelo duty e bordas do FG pela rotação
+ * @note O driver tem a própria malha de velocidade (a do modelo do
+ *       SimpleFOC). EN baixo vira alvo zero: o modelo não tem roda livre.
+ */
+static void SimHal_PwmPoll(void)
+{
+    if (sim_foc == NULL) {
+        return;
+    }
+    Plant_t *plant = sim_foc->plant;
+
+    if (pwm_running) {
+        double target = 0.0;
+        if (ADCS_EN_GPIO_Port->ODR & ADCS_EN_Pin) {
+            double duty = (double)sim_tim2.CCR[TIM_CHANNEL_3 >> 2] / (double)(sim_tim2.ARR + 1);
+            if (ADCS_DIR_GPIO_Port->ODR & ADCS_DIR_Pin) {
+                duty = -duty;
+            }
+            target = duty * ADCS_PWM_FULL_SCALE;
+        }
+        Plant_SetTarget(plant, target);
+    }
+
+    double dt = sim_time - tach_time;
+    tach_time = sim_time;
+    if (!tach_running || dt <= 0.0) {
+        return;
+    }
+
+    // Uma borda de subida a cada 1/WHEEL_TACH_PULSES_PER_REV de volta
+    double pitch = 2.0 * SIM_PI / WHEEL_TACH_PULSES_PER_REV;
+    double speed = fabs(plant->wheel_speed);
+    tach_angle += speed * dt;
+    while (tach_angle >= pitch) {
+        tach_angle -= pitch;
+        sim_tim5.CCR[TIM_CHANNEL_1 >> 2] = SimHal_TimerCount(&sim_tim5, sim_time - tach_angle / speed);
+        stats.tach_edges++;
+        HAL_TIM_IC_CaptureCallback(&htim5);
+    }
+}
+
+/* ============================================================================
+   LIGAÇÃO COM O SIMULADOR
+   ============================================================================ */
+void SimHal_Reset(Sensors_t *sensors, SimpleFOC_t *foc, SimHal_AdvanceFn advance)
+{
+    sim_sensors = sensors;
+    sim_foc = foc;
+    sim_advance = advance;
+    sim_tap = NULL;
+
+    memset(sim_gpio, 0, sizeof(sim_gpio));
+    memset(&sim_tim2, 0, sizeof(sim_tim2));
+    memset(&sim_tim5, 0, sizeof(sim_tim5));
+    memset(&sim_tim6, 0, sizeof(sim_tim6));
+    memset(&stats, 0, sizeof(stats));
+    sim_in_isr = 0;
+    timer_running = 0;
+    sim_mode = CDH_MODE_IDLE;
+
+    // Chip selects em repouso (MX_GPIO_Init)
+    OBC_CS_ACC_GPIO_Port->ODR |= OBC_CS_ACC_Pin;
+    OBC_CS_GYR_GPIO_Port->ODR |= OBC_CS_GYR_Pin;
+
+    tx_busy = 0;
+    rx_armed = 0;
+    rx_count = 0;
+    rx_line_free = 0.0;
+    pwm_running = 0;
+    tach_running = 0;
+    tach_angle = 0.0;
+    tach_time = 0.0;
+    huart4.gState = HAL_UART_STATE_READY;
+    huart4.RxState = HAL_UART_STATE_READY;
+
+    SimHal_SetTime(0.0);
+}
+
+void SimHal_SetTime(double t)
+{
+    sim_time = t;
+    sim_tick = (uint32_t)floor(t * 1000.0 + 1e-9);
+    sim_dwt.CYCCNT = (uint32_t)(uint64_t)(t * (double)SystemCoreClock);
+    sim_tim5.CNT = SimHal_TimerCount(&sim_tim5, t);
+}
+
+double SimHal_Time(void)
+{
+    return sim_time;
+}
+
+void SimHal_Poll(void)
+{
+    if (tx_busy && sim_time >= tx_done) {
+        tx_busy = 0;
+        huart4.gState = HAL_UART_STATE_READY;
+        SimHal_TxDeliver(tx_data, tx_size);
+        HAL_UART_TxCpltCallback(&huart4);
+    }
+
+    while (rx_count > 0 && sim_time >= rx_queue[rx_head].arrival) {
+        SimHal_RxDeliver(&rx_queue[rx_head]);
+        rx_head = (uint8_t)((rx_head + 1) % SIM_RX_QUEUE);
+        rx_count--;
+    }
+
+    SimHal_PwmPoll();
+}
+
+void SimHal_UartSend(const char *data, uint16_t size)
+{
+    if (rx_count == SIM_RX_QUEUE || size > SIM_RX_CHUNK_MAX) {
+        stats.rx_dropped += size;
+        return;
+    }
+
+    SimHal_RxChunk_t *chunk = &rx_queue[(rx_head + rx_count) % SIM_RX_QUEUE];
+    double start = (rx_line_free > sim_time) ? rx_line_free : sim_time;
+
+    memcpy(chunk->data, data, size);
+    chunk->size = size;
+    chunk->arrival = start + SimHal_LineTime(size);
+    rx_line_free = chunk->arrival;
+    rx_count++;
+}
+
+void SimHal_SetUartTap(SimHal_UartTapFn tap)
+{
+    sim_tap = tap;
+}
+
+double SimHal_TimerPeriod(void)
+{
+    if (!timer_running) {
+        return 0.0;
+    }
+    return (double)(sim_tim6.PSC + 1) * (double)(sim_tim6.ARR + 1) / (double)SIM_APB1_TIMER_HZ;
+}
+
+void SimHal_EnterIsr(void)
+{
+    sim_in_isr = 1;
+}
+
+void SimHal_ExitIsr(void)
+{
+    sim_in_isr = 0;
+}
+
+void SimHal_SetMode(CDH_OperationMode_t mode)
+{
+    sim_mode = mode;
+}
+
+void SimHal_GetStats(SimHal_Stats_t *out)
+{
+    *out = stats;
+}
+
+/* ============================================================================
+   NÚCLEO
+   ============================================================================ */
+uint32_t HAL_GetTick(void)
+{
+    return sim_tick;
+}
+
+/**
+ * @brief Espera ocupada: avança o tempo (e a planta) como no alvo
+ * @note Na interrupção do TIM6 o HAL_Delay seguraria a malha pelo tempo
+ *       inteiro (o SysTick, prioridade 4, ainda anda): aqui é contado como erro
+ */
+void HAL_Delay(uint32_t delay)
+{
+    uint32_t wait = delay;
+
+    if (wait < HAL_MAX_DELAY) {
+        wait++;
+    }
+    if (sim_in_isr) {
+        stats.isr_delays++;
+    }
+
+    double t_end = (double)(sim_tick + wait) / 1000.0;
+    if (sim_advance != NULL) {
+        sim_advance(t_end);
+    } else {
+        SimHal_SetTime(t_end);
+    }
+}
+
+void Error_Handler(void)
+{
+}
+
+uint32_t TIM_GetAPB1TimerClock(void)
+{
+    return SIM_APB1_TIMER_HZ;
+}
+
+CDH_OperationMode_t CAN_GetCurrentMode(void)
+{
+    return sim_mode;
+}
+
+/* ============================================================================
+   GPIO / SPI
+   ============================================================================ */
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state == GPIO_PIN_SET) {
+        port->ODR |= pin;
+    } else {
+        port->ODR &= ~(uint32_t)pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->ODR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx,
+                                          uint16_t size, uint32_t timeout)
+{
+    (void)timeout;
+
+    if (hspi != &hspi4 || sim_sensors == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+
+    uint8_t acc = !(OBC_CS_ACC_GPIO_Port->ODR & OBC_CS_ACC_Pin);
+    uint8_t gyr = !(OBC_CS_GYR_GPIO_Port->ODR & OBC_CS_GYR_Pin);
+
+    stats.spi_transfers++;
+    if (acc && !gyr) {
+        Sensors_AccTransfer(sim_sensors, tx, rx, size);
+    } else if (gyr && !acc) {
+        Sensors_GyrTransfer(sim_sensors, tx, rx, size);
+    } else if (rx != NULL) {
+        // Nenhum (ou os dois) selecionado: MISO em alta impedância
+        memset(rx, 0xFF, size);
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size,
+                                   uint32_t timeout)
+{
+    return HAL_SPI_TransmitReceive(hspi, data, NULL, size, timeout);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *tx,
+                                              uint8_t *rx, uint16_t size)
+{
+    (void)hspi;
+    (void)tx;
+    (void)rx;
+    (void)size;
+    return HAL_ERROR;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    return HAL_SPI_STATE_READY;
+}
+
+/* ============================================================================
+   UART
+   ============================================================================ */
+/**
+ * @brief Envio bloqueante: espera o tempo de linha
+ */
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data,
+                                    uint16_t size, uint32_t timeout)
+{
+    (void)timeout;
+
+    if (huart != &huart4) {
+        return HAL_OK;
+    }
+    if (size > SIM_TX_MAX) {
+        return HAL_ERROR;
+    }
+
+    double t_end = sim_time + SimHal_LineTime(size);
+    if (sim_advance != NULL) {
+        sim_advance(t_end);
+    } else {
+        SimHal_SetTime(t_end);
+    }
+
+    uint8_t line[SIM_TX_MAX];
+    memcpy(line, data, size);
+    SimHal_TxDeliver(line, size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data,
+                                        uint16_t size)
+{
+    if (huart != &huart4 || size == 0 || size > SIM_TX_MAX) {
+        return HAL_ERROR;
+    }
+    if (tx_busy) {
+        return HAL_BUSY;
+    }
+
+    memcpy(tx_data, data, size);
+    tx_size = size;
+    tx_done = sim_time + SimHal_LineTime(size);
+    tx_busy = 1;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart4) {
+        tx_busy = 0;
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *data,
+                                               uint16_t size)
+{
+    if (huart != &huart4 || data == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+
+    rx_buf = data;
+    rx_size = size;
+    rx_pos = 0;
+    rx_armed = 1;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart4) {
+        rx_armed = 0;
+    }
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/* ============================================================================
+   TIMER
+   ============================================================================ */
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance != TIM6) {
+        return HAL_ERROR;
+    }
+    timer_running = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM6) {
+        timer_running = 0;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    if (htim->Instance != TIM2 || channel != TIM_CHANNEL_3) {
+        return HAL_ERROR;
+    }
+    pwm_running = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    if (htim->Instance != TIM5 || channel != TIM_CHANNEL_1) {
+        return HAL_ERROR;
+    }
+    tach_running = 1;
+    tach_angle = 0.0;
+    tach_time = sim_time;
+    return HAL_OK;
+}
+
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    return htim->Instance->CCR[channel >> 2];
+}
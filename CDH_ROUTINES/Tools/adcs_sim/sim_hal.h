@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    sim_hal.h
+  * @brief   Ligação entre a HAL emulada e os modelos do simulador
+  *
+  * Relógio: HAL_GetTick e DWT->CYCCNT seguem o tempo simulado. HAL_Delay
+  * avança o tempo (planta incluída) pela função passada ao SimHal_Reset,
+  * como a espera ocupada do firmware real.
+  *
+  * UART4 (SimpleFOC, 115200 8N1): o DMA de TX entrega os bytes ao
+  * SimpleFOC emulado e chama HAL_UART_TxCpltCallback depois do tempo de
+  * linha; as linhas do motor.monitor() entram no buffer circular do DMA de
+  * RX e geram o evento de linha ociosa ao fim do último byte.
+  *
+  * Driver PWM (ADCS_SetActuator): o duty do TIM2_CH3 com DIR e EN vira o
+  * alvo da malha de velocidade do modelo; cada 1/WHEEL_TACH_PULSES_PER_REV
+  * de volta da roda gera uma captura no TIM5_CH1 (instante interpolado) e
+  * chama HAL_TIM_IC_CaptureCallback.
+  *
+  * SPI4: o chip select em nível baixo (OBC_CS_ACC / OBC_CS_GYR) escolhe o
+  * acelerômetro ou o giroscópio emulado.
+  ******************************************************************************
+  */
+
+#ifndef __SIM_HAL_H
+#define __SIM_HAL_H
+
+#include "main.h"
+#include "can_protocol.h"
+#include "sensors.h"
+#include "simplefoc.h"
+
+#define SIM_CORE_CLOCK_HZ       72000000U   // HSE 16 MHz * 9 / 2 (SystemClock_Config)
+#define SIM_APB1_TIMER_HZ       72000000U   // APB1 / 2, timers x2
+#define SIM_UART_BAUD           115200.0
+#define SIM_UART_BITS_PER_BYTE  10.0        // 8N1
+
+typedef void (*SimHal_AdvanceFn)(double t_end);
+
+// Vê (e pode alterar) os bytes CDH -> SimpleFOC antes da entrega
+typedef void (*SimHal_UartTapFn)(uint8_t *data, uint16_t size);
+
+typedef struct {
+    uint32_t isr_delays;        // HAL_Delay dentro da interrupção do TIM6 (trava no alvo)
+    uint32_t tx_bytes;          // CDH -> SimpleFOC
+    uint32_t rx_bytes;          // SimpleFOC -> CDH
+    uint32_t rx_dropped;        // Recepção desarmada: bytes perdidos
+    uint32_t spi_transfers;
+    uint32_t tach_edges;        // Bordas do FG (driver PWM)
+} SimHal_Stats_t;
+
+void SimHal_Reset(Sensors_t *sensors, SimpleFOC_t *foc, SimHal_AdvanceFn advance);
+
+// Relógio
+void SimHal_SetTime(double t);
+double SimHal_Time(void);
+
+// Entregas pendentes da UART até o instante atual (chamar a cada passo)
+void SimHal_Poll(void);
+
+// SimpleFOC -> CDH (chega inteiro depois do tempo de linha)
+void SimHal_UartSend(const char *data, uint16_t size);
+
+// Escuta da linha CDH -> SimpleFOC (NULL desliga; o SimHal_Reset também)
+void SimHal_SetUartTap(SimHal_UartTapFn tap);
+
+// TIM6: período configurado pelo firmware (0 = parado)
+double SimHal_TimerPeriod(void);
+
+// Contexto de interrupção do TIM6 (HAL_Delay ali é contado como erro)
+void SimHal_EnterIsr(void);
+void SimHal_ExitIsr(void);
+
+// Modo de operação devolvido por CAN_GetCurrentMode
+void SimHal_SetMode(CDH_OperationMode_t mode);
+
+void SimHal_GetStats(SimHal_Stats_t *stats);
+
+#endif /* __SIM_HAL_H */
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    simplefoc.c
+  * @brief   Protocolo serial do SimpleFOC emulado sobre a planta
+  ******************************************************************************
+  */
+
+#include "simplefoc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static uint8_t SimpleFOC_CRC8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0x00;
+
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static void SimpleFOC_SetTarget(SimpleFOC_t *foc, double target)
+{
+    foc->target = target;
+    if (foc->controller == SIMPLEFOC_CONTROL_VELOCITY) {
+        Plant_SetTarget(foc->plant, target);
+    }
+}
+
+/**
+ * @brief handleBinary() do sketch
+ */
+static void SimpleFOC_HandleBinary(SimpleFOC_t *foc)
+{
+    if (SimpleFOC_CRC8(&foc->bin_frame[1], 5) != foc->bin_frame[6]) {
+        foc->crc_errors++;
+        // CRC inválido: procura o próximo SYNC dentro do próprio frame
+        for (uint8_t i = 1; i < SIMPLEFOC_BIN_FRAME_SIZE; i++) {
+            if (foc->bin_frame[i] == SIMPLEFOC_BIN_SYNC) {
+                memmove(foc->bin_frame, &foc->bin_frame[i], SIMPLEFOC_BIN_FRAME_SIZE - i);
+                foc->bin_len = SIMPLEFOC_BIN_FRAME_SIZE - i;
+                return;
+            }
+        }
+        foc->bin_len = 0;
+        return;
+    }
+
+    if (foc->bin_frame[1] == SIMPLEFOC_BIN_CMD_TARGET) {
+        float value;
+        memcpy(&value, &foc->bin_frame[2], sizeof(value));
+        SimpleFOC_SetTarget(foc, value);
+        foc->binary_commands++;
+    }
+    foc->bin_len = 0;
+}
+
+/**
+ * @brief command.motor(): "M{número}" = alvo, "MC{n}" = tipo de controle
+ */
+static void SimpleFOC_HandleLine(SimpleFOC_t *foc)
+{
+    char *end;
+
+    foc->line[foc->line_len] = '\0';
+
+    if (foc->line[0] != 'M') {
+        foc->unknown++;
+        return;
+    }
+
+    if (foc->line[1] == 'C') {
+        long controller = strtol(&foc->line[2], &end, 10);
+        if (end != &foc->line[2] && *end == '\0') {
+            foc->controller = (uint8_t)controller;
+            foc->ascii_commands++;
+            return;
+        }
+    } else {
+        double target = strtod(&foc->line[1], &end);
+        if (end != &foc->line[1] && *end == '\0') {
+            SimpleFOC_SetTarget(foc, target);
+            foc->ascii_commands++;
+            return;
+        }
+    }
+
+    foc->unknown++;
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void SimpleFOC_Init(SimpleFOC_t *foc, Plant_t *plant)
+{
+    memset(foc, 0, sizeof(SimpleFOC_t));
+    foc->plant = plant;
+    foc->controller = SIMPLEFOC_CONTROL_VELOCITY;
+}
+
+/**
+ * @brief pollSerial() do sketch sobre os bytes que chegaram
+ */
+void SimpleFOC_Receive(SimpleFOC_t *foc, const uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t b = data[i];
+
+        if (foc->bin_len > 0 || b == SIMPLEFOC_BIN_SYNC) {
+            foc->bin_frame[foc->bin_len++] = b;
+            if (foc->bin_len == SIMPLEFOC_BIN_FRAME_SIZE) {
+                SimpleFOC_HandleBinary(foc);
+            }
+        } else if (b == '\n') {
+            SimpleFOC_HandleLine(foc);
+            foc->line_len = 0;
+        } else if (foc->line_len < SIMPLEFOC_LINE_MAX - 1) {
+            foc->line[foc->line_len++] = (char)b;
+        }
+    }
+}
+
+/**
+ * @brief motor.monitor(): Serial.print com 4 casas, separado por '\t'
+ */
+uint16_t SimpleFOC_Monitor(const SimpleFOC_t *foc, char *out, uint16_t size)
+{
+    const Plant_t *plant = foc->plant;
+    int len = snprintf(out, size, "%.4f\t%.4f\t%.4f\n",
+                       plant->uq, plant->iq, plant->vel_filtered);
+
+    return (len < 0 || len >= size) ? 0 : (uint16_t)len;
+}
@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file    simplefoc.h
+  * @brief   Lado serial do SimpleFOC emulado (sketch de ADCS_EXAMPLES.md)
+  *
+  * Recepção igual ao pollSerial() do sketch: frame binário de 7 bytes
+  * começando em 0xA5 (CRC-8 0x07) ou linha de texto para o Commander
+  * ("M{alvo}", "MC{controle}"). Transmissão: motor.monitor() com
+  * _MON_VOLT_Q | _MON_CURR_Q | _MON_VEL, uma linha "Uq\tIq\tvel\n" por
+  * chamada de SimpleFOC_Monitor.
+  ******************************************************************************
+  */
+
+#ifndef __SIMPLEFOC_H
+#define __SIMPLEFOC_H
+
+#include <stdint.h>
+#include "plant.h"
+
+#define SIMPLEFOC_BIN_SYNC          0xA5
+#define SIMPLEFOC_BIN_CMD_TARGET    0x01
+#define SIMPLEFOC_BIN_FRAME_SIZE    7
+#define SIMPLEFOC_LINE_MAX          32
+#define SIMPLEFOC_CONTROL_VELOCITY  1       // motor.controller (MotionControlType)
+
+typedef struct {
+    Plant_t *plant;
+
+    // pollSerial()
+    uint8_t bin_frame[SIMPLEFOC_BIN_FRAME_SIZE];
+    uint8_t bin_len;
+    char line[SIMPLEFOC_LINE_MAX];
+    uint8_t line_len;
+
+    uint8_t controller;         // Último "MC"; o alvo só move a roda em velocidade
+    double target;              // motor.target
+
+    // Contadores
+    uint32_t ascii_commands;
+    uint32_t binary_commands;
+    uint32_t crc_errors;
+    uint32_t unknown;           // Linhas que o Commander não entende
+} SimpleFOC_t;
+
+void SimpleFOC_Init(SimpleFOC_t *foc, Plant_t *plant);
+void SimpleFOC_Receive(SimpleFOC_t *foc, const uint8_t *data, uint16_t size);
+
+// Uma linha do motor.monitor() em out; retorna o tamanho
+uint16_t SimpleFOC_Monitor(const SimpleFOC_t *foc, char *out, uint16_t size);
+
+#endif /* __SIMPLEFOC_H */
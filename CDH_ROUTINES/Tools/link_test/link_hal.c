@@ -0,0 +1,270 @@
+/**
+  ******************************************************************************
+  * @file    link_hal.c
+  * @brief   HAL do STM32H7 emulada para o teste do protocolo UART
+  ******************************************************************************
+  */
+
+#include "link_hal.h"
+#include "usart.h"
+#include "rng.h"
+#include <string.h>
+
+#define LINK_CHUNK_MAX          1100    // Maior trecho (anel de TX inteiro)
+#define LINK_QUEUE              64      // Trechos em trânsito por sentido
+#define LINK_BYTES_PER_MS       11.52   // 115200 8N1
+
+/* ============================================================================
+   PERIFÉRICOS (definidos pelo CubeMX no firmware)
+   ============================================================================ */
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+uint32_t SystemCoreClock = 400000000U;
+
+DMA_HandleTypeDef hdma_uart5_rx;
+DMA_HandleTypeDef hdma_uart5_tx;
+DMA_HandleTypeDef hdma_uart8_rx;
+
+// UART5 com DMA nos dois sentidos (Payload); UART8 só com DMA de RX
+UART_HandleTypeDef huart5 = {.hdmatx = &hdma_uart5_tx, .hdmarx = &hdma_uart5_rx};
+UART_HandleTypeDef huart8 = {.hdmarx = &hdma_uart8_rx};
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+typedef struct {
+    uint16_t size;
+    uint16_t done;              // Bytes já na linha
+    uint8_t lost;
+    uint8_t dma;                // Veio do DMA de TX (TxCplt na entrega)
+    uint8_t data[LINK_CHUNK_MAX];
+} LinkHal_Chunk_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+
+    // Recepção: buffer circular do DMA
+    uint8_t *rx_buf;
+    uint16_t rx_size;
+    uint16_t rx_pos;
+    uint8_t rx_armed;
+
+    // Sentido que sai desta porta
+    LinkHal_Wire_t wire;
+    LinkHal_Chunk_t queue[LINK_QUEUE];
+    uint8_t head;
+    uint8_t count;
+    double budget;              // Bytes que a linha ainda pode levar neste ms
+    uint8_t tx_busy;
+} LinkHal_Port_t;
+
+static LinkHal_Port_t port[2];
+static uint32_t tick = 0;
+static Rng_t rng;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static LinkHal_Port_t *LinkHal_Find(UART_HandleTypeDef *huart)
+{
+    for (uint8_t i = 0; i < 2; i++) {
+        if (port[i].huart == huart) {
+            return &port[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Põe o trecho no fio (perda e corrupção decididas aqui)
+ */
+static HAL_StatusTypeDef LinkHal_Send(LinkHal_Port_t *p, const uint8_t *data,
+                                      uint16_t size, uint8_t dma)
+{
+    if (size == 0 || size > LINK_CHUNK_MAX || p->count >= LINK_QUEUE) {
+        return HAL_ERROR;
+    }
+
+    LinkHal_Chunk_t *c = &p->queue[(p->head + p->count) % LINK_QUEUE];
+    LinkHal_Wire_t *w = &p->wire;
+
+    memcpy(c->data, data, size);
+    c->size = size;
+    c->done = 0;
+    c->dma = dma;
+    c->lost = w->blackout || (w->filter != NULL && w->filter(data, size)) ||
+              Rng_Uniform(&rng) < w->loss;
+
+    if (!c->lost && Rng_Uniform(&rng) < w->corrupt) {
+        c->data[Rng_Next(&rng) % size] ^= (uint8_t)(1 + Rng_Next(&rng) % 255);
+        w->corrupted++;
+    }
+
+    w->chunks++;
+    if (c->lost) {
+        w->lost++;
+    }
+    p->count++;
+    return HAL_OK;
+}
+
+/**
+ * @brief Escreve um byte no DMA circular da porta de destino (eventos de
+ *        meia-volta e volta completa, como o DMA do alvo)
+ */
+static void LinkHal_Deliver(LinkHal_Port_t *to, uint8_t byte)
+{
+    if (!to->rx_armed) {
+        return;
+    }
+
+    to->rx_buf[to->rx_pos++] = byte;
+    if (to->rx_pos == to->rx_size / 2) {
+        HAL_UARTEx_RxEventCallback(to->huart, to->rx_pos);
+    } else if (to->rx_pos == to->rx_size) {
+        to->rx_pos = 0;
+        HAL_UARTEx_RxEventCallback(to->huart, to->rx_size);
+    }
+}
+
+/* ============================================================================
+   FUNÇÕES PÚBLICAS
+   ============================================================================ */
+void LinkHal_Reset(UART_HandleTypeDef *a, UART_HandleTypeDef *b, uint32_t seed)
+{
+    memset(port, 0, sizeof(port));
+    port[0].huart = a;
+    port[1].huart = b;
+    tick = 0;
+    Rng_Seed(&rng, seed);
+}
+
+LinkHal_Wire_t *LinkHal_Wire(UART_HandleTypeDef *from)
+{
+    LinkHal_Port_t *p = LinkHal_Find(from);
+    return (p != NULL) ? &p->wire : NULL;
+}
+
+void LinkHal_Step(void)
+{
+    tick++;
+    sim_dwt.CYCCNT += SystemCoreClock / 1000U;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        LinkHal_Port_t *from = &port[i];
+        LinkHal_Port_t *to = &port[1 - i];
+
+        // A linha leva LINK_BYTES_PER_MS por ms, um trecho depois do outro
+        from->budget += LINK_BYTES_PER_MS;
+        if (from->count == 0) {
+            from->budget = 0.0;
+        }
+
+        while (from->count > 0 && from->budget >= 1.0) {
+            LinkHal_Chunk_t *c = &from->queue[from->head];
+
+            while (c->done < c->size && from->budget >= 1.0) {
+                if (!c->lost) {
+                    LinkHal_Deliver(to, c->data[c->done]);
+                }
+                c->done++;
+                from->budget -= 1.0;
+            }
+            if (c->done < c->size) {
+                break;
+            }
+
+            from->head = (uint8_t)((from->head + 1) % LINK_QUEUE);
+            from->count--;
+
+            // Linha ociosa depois do último byte do trecho
+            if (!c->lost && to->rx_armed && to->rx_pos > 0) {
+                HAL_UARTEx_RxEventCallback(to->huart, to->rx_pos);
+            }
+            if (c->dma) {
+                from->tx_busy = 0;
+                from->huart->gState = HAL_UART_STATE_READY;
+                HAL_UART_TxCpltCallback(from->huart);
+            }
+        }
+    }
+}
+
+/* ============================================================================
+   HAL
+   ============================================================================ */
+uint32_t HAL_GetTick(void)
+{
+    return tick;
+}
+
+void HAL_Delay(uint32_t delay)
+{
+    for (uint32_t i = 0; i < delay; i++) {
+        LinkHal_Step();
+    }
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data,
+                                    uint16_t size, uint32_t timeout)
+{
+    (void)timeout;
+
+    LinkHal_Port_t *p = LinkHal_Find(huart);
+    return (p != NULL) ? LinkHal_Send(p, data, size, 0) : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data,
+                                        uint16_t size)
+{
+    LinkHal_Port_t *p = LinkHal_Find(huart);
+    if (p == NULL || huart->hdmatx == NULL) {
+        return HAL_ERROR;
+    }
+    if (p->tx_busy) {
+        return HAL_BUSY;
+    }
+
+    HAL_StatusTypeDef status = LinkHal_Send(p, data, size, 1);
+    if (status == HAL_OK) {
+        p->tx_busy = 1;
+        huart->gState = HAL_UART_STATE_BUSY_TX;
+    }
+    return status;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
+{
+    LinkHal_Port_t *p = LinkHal_Find(huart);
+    if (p != NULL) {
+        p->tx_busy = 0;
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *data,
+                                               uint16_t size)
+{
+    LinkHal_Port_t *p = LinkHal_Find(huart);
+    if (p == NULL || data == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+
+    p->rx_buf = data;
+    p->rx_size = size;
+    p->rx_pos = 0;
+    p->rx_armed = 1;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
+{
+    LinkHal_Port_t *p = LinkHal_Find(huart);
+    if (p != NULL) {
+        p->rx_armed = 0;
+    }
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    link_hal.h
+  * @brief   HAL emulada para o teste do protocolo UART no host: duas
+  *          portas ligadas por um fio com atraso, perdas e corrupção
+  *
+  * Relógio: HAL_GetTick avança 1 ms a cada LinkHal_Step.
+  *
+  * Cada chamada de HAL_UART_Transmit (bloqueante) ou HAL_UART_Transmit_DMA
+  * vira um trecho no fio. Os trechos saem um depois do outro a 115200 8N1
+  * e os bytes entram no buffer circular do DMA de RX da outra ponta, com
+  * os eventos de meia-volta, volta completa e linha ociosa (fim do trecho).
+  * No DMA de TX o HAL_UART_TxCpltCallback vem com o último byte na linha.
+  *
+  * O fio de cada sentido pode perder trechos (probabilidade), corromper um
+  * byte, ficar mudo (blackout) ou descartar por um filtro do teste.
+  ******************************************************************************
+  */
+
+#ifndef __LINK_HAL_H
+#define __LINK_HAL_H
+
+#include "main.h"
+
+typedef int (*LinkHal_Filter_t)(const uint8_t *data, uint16_t size);
+
+typedef struct {
+    double loss;                // Probabilidade de perder o trecho inteiro
+    double corrupt;             // Probabilidade de trocar um byte do trecho
+    uint8_t blackout;           // 1 = nada passa
+    LinkHal_Filter_t filter;    // Retorna 1 para descartar o trecho (pode ser NULL)
+
+    // Contadores
+    uint32_t chunks;
+    uint32_t lost;
+    uint32_t corrupted;
+} LinkHal_Wire_t;
+
+// Zera o relógio e os fios e liga a ↔ b
+void LinkHal_Reset(UART_HandleTypeDef *a, UART_HandleTypeDef *b, uint32_t seed);
+
+// Fio no sentido que sai de huart
+LinkHal_Wire_t *LinkHal_Wire(UART_HandleTypeDef *from);
+
+// Avança 1 ms: entrega o que chegou e conclui os trechos do DMA de TX
+void LinkHal_Step(void);
+
+#endif /* __LINK_HAL_H */
@@ -0,0 +1,476 @@
+/**
+  ******************************************************************************
+  * @file    main.c
+  * @brief   Teste do protocolo UART no host: enlace confiável (uart_link.c)
+  *          sobre um fio com perdas, nos dois enquadramentos
+  *
+  *   link_test [-v]      (-v: contadores do fio e do parser)
+  *
+  * Duas portas do firmware (UART8 com TX bloqueante, UART5 com TX por DMA)
+  * trocam mensagens numeradas. Cada cenário confere na recepção:
+  *   - ordem estritamente crescente (sem duplicatas nem inversões);
+  *   - conteúdo íntegro (o padrão inclui bytes 0x00 e, a cada 16
+  *     mensagens, uma de tamanho máximo sem 0x00, para o COBS);
+  *   - só faltam mensagens que o transmissor descartou após
+  *     UART_LINK_MAX_RETRIES;
+  *   - o enlace continua vivo depois dos descartes e do reinício de uma
+  *     das pontas (a última mensagem chega e não sobra nada em voo);
+  *   - nenhum buffer do pool fica preso.
+  *
+  * Código de saída: 0 se todos os cenários passaram, 1 se algum falhou.
+  ******************************************************************************
+  */
+
+#include "link_hal.h"
+#include "uart_protocol.h"
+#include "uart_msg_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_MSG_ID             MSG_DATA_AIS
+
+/* ============================================================================
+   PONTAS DO ENLACE
+   ============================================================================ */
+typedef struct {
+    UART_Protocol_t proto;
+    const char *name;
+
+    // Transmissão
+    uint32_t to_send;           // Mensagens a enviar no cenário
+    uint32_t next_tx;           // Próximo contador (1, 2, ...)
+    uint32_t reboot_lost;       // Em voo ou descartadas antes do reinício desta ponta
+
+    // Recepção (mensagens da outra ponta)
+    uint32_t last_rx;           // Último contador recebido (0 = nenhum)
+    uint32_t delivered;
+    uint32_t missing;           // Lacunas na sequência de contadores
+    uint32_t order_errors;
+    uint32_t payload_errors;
+    uint32_t redeliver_from;    // Trecho que pode chegar de novo depois do reinício
+    uint32_t redeliver_to;
+    uint32_t redelivered;
+} Endpoint_t;
+
+static Endpoint_t end_a = {.name = "UART8"};
+static Endpoint_t end_b = {.name = "UART5"};
+static uint8_t verbose = 0;
+
+/* ============================================================================
+   MENSAGENS DE TESTE
+   ============================================================================ */
+/* A cada TEST_LONG_EVERY mensagens, uma de tamanho máximo e sem 0x00:
+   o COBS precisa fechar blocos cheios (254 bytes sem zero) */
+#define TEST_LONG_EVERY         16
+
+static uint16_t Test_Length(uint32_t counter)
+{
+    if (counter % TEST_LONG_EVERY == 0) {
+        return UART_LINK_MAX_DATA;
+    }
+    return (uint16_t)(4 + (counter * 37U) % 240U);
+}
+
+static uint8_t Test_Byte(uint32_t counter, uint16_t i)
+{
+    if (counter % TEST_LONG_EVERY == 0) {
+        return (uint8_t)(1 + (counter * 7U + i * 13U) % 255U);
+    }
+    return (uint8_t)(counter * 7U + i * 13U);     // Passa por 0x00 com frequência
+}
+
+// Contador em 4 dígitos de base 255 (+1): nunca 0x00
+static void Test_PutCounter(uint8_t *buf, uint32_t counter)
+{
+    for (uint8_t k = 0; k < 4; k++) {
+        buf[k] = (uint8_t)(1 + counter % 255U);
+        counter /= 255U;
+    }
+}
+
+static uint32_t Test_GetCounter(const uint8_t *buf)
+{
+    uint32_t counter = 0;
+    for (int8_t k = 3; k >= 0; k--) {
+        counter = counter * 255U + (uint8_t)(buf[k] - 1);
+    }
+    return counter;
+}
+
+static uint16_t Test_Build(uint32_t counter, uint8_t *buf)
+{
+    uint16_t len = Test_Length(counter);
+
+    Test_PutCounter(buf, counter);
+    for (uint16_t i = 4; i < len; i++) {
+        buf[i] = Test_Byte(counter, i);
+    }
+    return len;
+}
+
+static void Test_Handler(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    Endpoint_t *e = (proto == &end_a.proto) ? &end_a : &end_b;
+    uint32_t counter;
+
+    if (msg->length < 4) {
+        e->payload_errors++;
+        return;
+    }
+    counter = Test_GetCounter(msg->data);
+
+    if (msg->length != Test_Length(counter)) {
+        e->payload_errors++;
+        return;
+    }
+    for (uint16_t i = 4; i < msg->length; i++) {
+        if (msg->data[i] != Test_Byte(counter, i)) {
+            e->payload_errors++;
+            return;
+        }
+    }
+
+    if (counter <= e->last_rx) {
+        // Entregue antes do reinício, mas o ACK não chegou à outra ponta
+        if (counter >= e->redeliver_from && counter <= e->redeliver_to) {
+            e->redelivered++;
+            return;
+        }
+        e->order_errors++;
+        return;
+    }
+
+    e->missing += counter - e->last_rx - 1;
+    e->last_rx = counter;
+    e->delivered++;
+}
+
+static const UART_Handler_t test_handlers[] = {
+    {TEST_MSG_ID, Test_Handler},
+};
+
+static const UART_ProtocolConfig_t test_config = {
+    .handlers = test_handlers,
+    .handler_count = 1,
+    .poll = NULL,
+};
+
+/* ============================================================================
+   EXECUÇÃO
+   ============================================================================ */
+typedef struct {
+    const char *name;
+    UART_FramingMode_t framing;
+    uint32_t a_to_b;            // Mensagens de A para B
+    uint32_t b_to_a;
+    double loss;                // Nos dois sentidos
+    double corrupt;
+    UART_HandleTypeDef *blackout_from;  // Sentido mudo (NULL = nenhum)
+    uint32_t blackout_start_ms;
+    uint32_t blackout_end_ms;
+    LinkHal_Filter_t filter_a;  // Filtro no sentido A -> B
+    uint8_t expect_drops;       // O cenário precisa esgotar as tentativas
+    UART_HandleTypeDef *reboot; // Ponta reiniciada no meio (NULL = nenhuma)
+    uint32_t reboot_ms;
+} Scenario_t;
+
+static void Endpoint_Reset(Endpoint_t *e, UART_HandleTypeDef *huart, UART_FramingMode_t framing,
+                           uint32_t to_send)
+{
+    e->to_send = to_send;
+    e->next_tx = 1;
+    e->reboot_lost = 0;
+    e->last_rx = 0;
+    e->delivered = 0;
+    e->missing = 0;
+    e->order_errors = 0;
+    e->payload_errors = 0;
+    e->redeliver_from = 0;
+    e->redeliver_to = 0;
+    e->redelivered = 0;
+
+    if (UART_Protocol_Init(&e->proto, huart, &test_config) != HAL_OK) {
+        fprintf(stderr, "UART_Protocol_Init falhou (%s)\n", e->name);
+        exit(1);
+    }
+    UART_SetFramingMode(&e->proto, framing);
+}
+
+static void Endpoint_Send(Endpoint_t *e)
+{
+    static uint8_t buf[UART_LINK_MAX_DATA];
+
+    while (e->next_tx <= e->to_send) {
+        uint16_t len = Test_Build(e->next_tx, buf);
+        if (UART_Link_Send(&e->proto, TEST_MSG_ID, buf, len) != HAL_OK) {
+            return;     // Janela cheia ou ressincronização: tenta no próximo ms
+        }
+        e->next_tx++;
+    }
+}
+
+/**
+ * @brief Contador da mensagem mais antiga que a ponta ainda tem em voo
+ * @return 0 se não houver nenhuma
+ */
+static uint32_t Endpoint_OldestInFlight(const Endpoint_t *e)
+{
+    const UART_LinkState_t *link = &e->proto.link;
+
+    for (uint8_t seq = link->tx_base; seq != link->tx_next; seq++) {
+        const UART_LinkTxSlot_t *slot = &link->tx_window[seq % UART_LINK_WINDOW_SIZE];
+        if (slot->in_use) {
+            return Test_GetCounter(slot->frame->data);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Reinicia uma ponta (como no boot) com as duas no meio da troca
+ * @note O que estava em voo nela se perde. Da outra ponta, frames já
+ *       entregues mas ainda não confirmados podem chegar de novo (entrega
+ *       pelo menos uma vez): do mais antigo em voo até o último recebido
+ */
+static void Endpoint_Reboot(Endpoint_t *e, const Endpoint_t *peer)
+{
+    UART_FramingMode_t framing = e->proto.framing;
+    uint32_t oldest = Endpoint_OldestInFlight(peer);
+
+    e->reboot_lost += UART_Link_GetInFlight(&e->proto) + UART_Link_GetDroppedFrames(&e->proto);
+    if (oldest != 0 && oldest <= e->last_rx) {
+        e->redeliver_from = oldest;
+        e->redeliver_to = e->last_rx;
+    }
+
+    if (UART_Protocol_Init(&e->proto, e->proto.huart, &test_config) != HAL_OK) {
+        fprintf(stderr, "UART_Protocol_Init falhou (%s)\n", e->name);
+        exit(1);
+    }
+    UART_SetFramingMode(&e->proto, framing);
+}
+
+/**
+ * @brief Confere o que B recebeu de A (ou vice-versa)
+ */
+static int Check_Direction(const Endpoint_t *tx, const Endpoint_t *rx, const Scenario_t *s)
+{
+    int ok = 1;
+    uint32_t dropped = UART_Link_GetDroppedFrames(&tx->proto) + tx->reboot_lost;
+    uint32_t sent = tx->next_tx - 1;
+
+    if (sent != tx->to_send) {
+        printf("    %s -> %s: só %u de %u mensagens aceitas pelo enlace\n",
+               tx->name, rx->name, sent, tx->to_send);
+        ok = 0;
+    }
+    if (rx->order_errors > 0 || rx->payload_errors > 0) {
+        printf("    %s -> %s: %u fora de ordem/duplicadas, %u corrompidas\n",
+               tx->name, rx->name, rx->order_errors, rx->payload_errors);
+        ok = 0;
+    }
+    // Só pode faltar o que o transmissor descartou (um descarte pode ter
+    // chegado, se só os ACKs se perderam)
+    if (rx->missing > dropped) {
+        printf("    %s -> %s: faltam %u mensagens, mas só %u foram descartadas\n",
+               tx->name, rx->name, rx->missing, dropped);
+        ok = 0;
+    }
+    // Enlace vivo: a última chega e nada fica em voo
+    if (sent > 0 && rx->last_rx != sent) {
+        printf("    %s -> %s: última recebida %u de %u (enlace parado)\n",
+               tx->name, rx->name, rx->last_rx, sent);
+        ok = 0;
+    }
+    if (UART_Link_GetInFlight(&tx->proto) != 0 || tx->proto.link.sync_pending) {
+        printf("    %s -> %s: %u frames ainda em voo (sync %u)\n", tx->name, rx->name,
+               UART_Link_GetInFlight(&tx->proto), tx->proto.link.sync_pending);
+        ok = 0;
+    }
+    if (s->expect_drops && tx == &end_a && (dropped == 0 || UART_Link_GetResyncs(&tx->proto) == 0)) {
+        printf("    %s -> %s: cenário não esgotou as tentativas (%u descartes, %u MSG_SYNC)\n",
+               tx->name, rx->name, dropped, UART_Link_GetResyncs(&tx->proto));
+        ok = 0;
+    }
+    // Reinício: a outra ponta recomeçou a recepção (MSG_RESET)
+    if (s->reboot == tx->proto.huart && UART_Link_GetPeerResets(&rx->proto) == 0) {
+        printf("    %s -> %s: reinício de %s não chegou à outra ponta\n",
+               tx->name, rx->name, tx->name);
+        ok = 0;
+    }
+
+    return ok;
+}
+
+static int Run(const Scenario_t *s)
+{
+    LinkHal_Reset(&huart8, &huart5, 1);
+    Endpoint_Reset(&end_a, &huart8, s->framing, s->a_to_b);
+    Endpoint_Reset(&end_b, &huart5, s->framing, s->b_to_a);
+
+    LinkHal_Wire_t *wa = LinkHal_Wire(&huart8);
+    LinkHal_Wire_t *wb = LinkHal_Wire(&huart5);
+    wa->loss = wb->loss = s->loss;
+    wa->corrupt = wb->corrupt = s->corrupt;
+    wa->filter = s->filter_a;
+
+    LinkHal_Wire_t *wblack = (s->blackout_from != NULL) ? LinkHal_Wire(s->blackout_from) : NULL;
+    uint32_t idle_since = 0;
+
+    for (uint32_t t = 0; ; t++) {
+        if (wblack != NULL) {
+            wblack->blackout = (t >= s->blackout_start_ms && t < s->blackout_end_ms);
+        }
+        if (s->reboot != NULL && t == s->reboot_ms) {
+            if (s->reboot == &huart8) {
+                Endpoint_Reboot(&end_a, &end_b);
+            } else {
+                Endpoint_Reboot(&end_b, &end_a);
+            }
+        }
+
+        Endpoint_Send(&end_a);
+        Endpoint_Send(&end_b);
+        UART_Protocol_Process();
+        LinkHal_Step();
+
+        // Fim: tudo enviado e confirmado (com folga para ACKs atrasados)
+        uint8_t done = end_a.next_tx > end_a.to_send && end_b.next_tx > end_b.to_send &&
+                       UART_Link_GetInFlight(&end_a.proto) == 0 &&
+                       UART_Link_GetInFlight(&end_b.proto) == 0 &&
+                       !end_a.proto.link.sync_pending && !end_b.proto.link.sync_pending &&
+                       t >= s->blackout_end_ms && t > s->reboot_ms;
+        if (!done) {
+            idle_since = t;
+        } else if (t - idle_since >= 1000) {
+            break;
+        }
+        if (t > 600000) {
+            break;      // 10 min simulados: enlace travado
+        }
+    }
+
+    // Só uma gaveta do pool pode ficar com o parser de cada porta
+    uint32_t held = (end_a.proto.rx_frame != NULL) + (end_b.proto.rx_frame != NULL);
+    int ok = Check_Direction(&end_a, &end_b, s) & Check_Direction(&end_b, &end_a, s);
+
+    if (UART_MsgPool_GetFree() + held != UART_MSG_POOL_SIZE) {
+        printf("    pool: %u livres + %u no parser de %u (buffers presos)\n",
+               UART_MsgPool_GetFree(), held, UART_MSG_POOL_SIZE);
+        ok = 0;
+    }
+
+    printf("%-4s %-46s A->B %4u/%-4u B->A %4u/%-4u retx %3u/%-3u descartes %u/%u sync %u/%u  (%.1f s)\n",
+           ok ? "ok" : "FALHA", s->name,
+           end_b.delivered, end_a.to_send, end_a.delivered, end_b.to_send,
+           UART_Link_GetRetransmissions(&end_a.proto), UART_Link_GetRetransmissions(&end_b.proto),
+           UART_Link_GetDroppedFrames(&end_a.proto), UART_Link_GetDroppedFrames(&end_b.proto),
+           UART_Link_GetResyncs(&end_a.proto), UART_Link_GetResyncs(&end_b.proto),
+           HAL_GetTick() / 1000.0);
+
+    if (verbose) {
+        printf("     fio A->B: %u trechos, %u perdidos, %u corrompidos; B->A: %u, %u, %u\n",
+               wa->chunks, wa->lost, wa->corrupted, wb->chunks, wb->lost, wb->corrupted);
+        printf("     checksum %u/%u, framing %u/%u, pool drops %u/%u, mínimo livre no pool %u\n",
+               end_a.proto.stats.checksum_errors, end_b.proto.stats.checksum_errors,
+               end_a.proto.stats.framing_errors, end_b.proto.stats.framing_errors,
+               end_a.proto.stats.pool_drops, end_b.proto.stats.pool_drops,
+               UART_MsgPool_GetLowWater());
+        printf("     reinícios da outra ponta %u/%u, reentregues após reinício %u/%u\n",
+               UART_Link_GetPeerResets(&end_a.proto), UART_Link_GetPeerResets(&end_b.proto),
+               end_b.redelivered, end_a.redelivered);
+    }
+
+    return ok;
+}
+
+/* ============================================================================
+   FILTROS
+   ============================================================================ */
+/**
+ * @brief Descarta toda transmissão da mensagem 20 (LEGACY: SEQ em [4],
+ *        contador em [5..8]); as seguintes passam e ficam na janela do receptor
+ */
+static int Filter_Message20(const uint8_t *data, uint16_t size)
+{
+    if (size < 10 || data[0] != UART_START_BYTE || data[1] != TEST_MSG_ID) {
+        return 0;
+    }
+    return Test_GetCounter(&data[5]) == 20;
+}
+
+/**
+ * @brief Descarta os 4 primeiros MSG_RESET: a ponta reiniciada fica sem
+ *        enviar e descartando o que chega até o anúncio passar
+ */
+static int Filter_FirstResets(const uint8_t *data, uint16_t size)
+{
+    static uint8_t dropped = 0;
+
+    if (size < 2 || data[0] != UART_START_BYTE || data[1] != MSG_RESET || dropped >= 4) {
+        return 0;
+    }
+    dropped++;
+    return 1;
+}
+
+/* ============================================================================
+   CENÁRIOS
+   ============================================================================ */
+static const Scenario_t scenarios[] = {
+    {.name = "limpo, LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 300, .b_to_a = 300},
+    {.name = "limpo, COBS", .framing = UART_FRAMING_COBS,
+     .a_to_b = 300, .b_to_a = 300},
+    {.name = "10% perdidos + 2% corrompidos, LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 1000, .b_to_a = 1000, .loss = 0.10, .corrupt = 0.02},
+    {.name = "10% perdidos + 2% corrompidos, COBS", .framing = UART_FRAMING_COBS,
+     .a_to_b = 1000, .b_to_a = 1000, .loss = 0.10, .corrupt = 0.02},
+    {.name = "A->B mudo por 20 s (descarte), LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 400, .b_to_a = 0, .blackout_from = &huart8,
+     .blackout_start_ms = 2000, .blackout_end_ms = 22000, .expect_drops = 1},
+    {.name = "A->B mudo por 20 s (descarte), COBS", .framing = UART_FRAMING_COBS,
+     .a_to_b = 400, .b_to_a = 0, .blackout_from = &huart8,
+     .blackout_start_ms = 2000, .blackout_end_ms = 22000, .expect_drops = 1},
+    {.name = "ACKs B->A perdidos por 20 s, LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 400, .b_to_a = 0, .blackout_from = &huart5,
+     .blackout_start_ms = 2000, .blackout_end_ms = 22000, .expect_drops = 1},
+    {.name = "mensagem 20 sempre perdida (lacuna), LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 200, .b_to_a = 0, .filter_a = Filter_Message20, .expect_drops = 1},
+    {.name = "A reinicia no meio da troca, LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 400, .b_to_a = 400, .reboot = &huart8, .reboot_ms = 3000},
+    {.name = "B reinicia no meio da troca, COBS", .framing = UART_FRAMING_COBS,
+     .a_to_b = 400, .b_to_a = 400, .reboot = &huart5, .reboot_ms = 3000},
+    {.name = "A reinicia com 10% perdidos, COBS", .framing = UART_FRAMING_COBS,
+     .a_to_b = 400, .b_to_a = 400, .loss = 0.10, .reboot = &huart8, .reboot_ms = 5000},
+    {.name = "A reinicia, 4 MSG_RESET perdidos, LEGACY", .framing = UART_FRAMING_LEGACY,
+     .a_to_b = 400, .b_to_a = 400, .filter_a = Filter_FirstResets,
+     .reboot = &huart8, .reboot_ms = 3000},
+};
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "v")) != -1) {
+        if (opt == 'v') {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "uso: %s [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (!Run(&scenarios[i])) {
+            failures++;
+        }
+    }
+
+    printf("%s: %d de %zu cenários falharam\n", failures ? "FALHA" : "ok",
+           failures, sizeof(scenarios) / sizeof(scenarios[0]));
+    return failures ? 1 : 0;
+}
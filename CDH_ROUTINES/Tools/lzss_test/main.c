@@ -0,0 +1,538 @@
+/**
+  ******************************************************************************
+  * @file    main.c
+  * @brief   Teste de ida e volta do codec LZSS do firmware (lzss.c) no host
+  *
+  *   lzss_test [-b]
+  *
+  * Sem opção, comprime e descomprime entradas conhecidas e confere:
+  *   - entrada vazia e de 1 byte;
+  *   - bordas da janela (255/256/257 e 511/512/513 bytes, cópia na
+  *     distância máxima, sequência repetida com cópia sobreposta);
+  *   - fluxo byte a byte (Sink de 1 byte, Poll de 1 byte) nos dois lados;
+  *   - LZSS_COMPRESSED_MAX em dados aleatórios de 0 a TEST_MAX_LEN bytes;
+  *   - traços grandes em pedaços de tamanho aleatório.
+  *
+  * Com -b, mede razão de compressão e custo nos quatro traços de referência
+  * (TEST_TRACE_SIZE bytes cada, pedaços de BENCH_CHUNK bytes). Os ciclos
+  * são do host (rdtsc em x86, ns nos outros): servem para comparar versões
+  * do codec, não dizem quanto custa no STM32H743.
+  *
+  * Código de saída: 0 se todas as verificações passaram, 1 se alguma falhou.
+  ******************************************************************************
+  */
+
+#include "lzss.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define TEST_MAX_LEN            1100    // Varredura de LZSS_COMPRESSED_MAX
+#define TEST_TRACE_SIZE         (200U * 1024U)
+#define TEST_EPS_RECORD_SIZE    24
+#define BENCH_CHUNK             64
+#define BENCH_RUNS              5       // Melhor de N para tirar ruído do host
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+static LZSS_Encoder_t enc;
+static LZSS_Decoder_t dec;
+
+static uint8_t trace[TEST_TRACE_SIZE];
+static uint8_t packed[LZSS_COMPRESSED_MAX(TEST_TRACE_SIZE)];
+static uint8_t unpacked[TEST_TRACE_SIZE + 64];  // Folga: bytes a mais são erro
+
+static uint32_t rng_state = 0x12345678U;
+
+static int checks = 0;
+static int failures = 0;
+
+/* ============================================================================
+   FUNÇÕES AUXILIARES
+   ============================================================================ */
+static void Test_Check(int ok, const char *what)
+{
+    checks++;
+    if (!ok) {
+        failures++;
+    }
+    printf("%s %s\n", ok ? "ok   " : "FALHA", what);
+}
+
+/**
+ * @brief xorshift32: sequência reprodutível em qualquer host
+ */
+static uint32_t Test_Random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void Test_FillRandom(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)Test_Random();
+    }
+}
+
+/**
+ * @brief Pedaço de 1..max bytes (max = 0: tamanho aleatório até 300)
+ */
+static size_t Test_Chunk(size_t max)
+{
+    return max ? max : 1 + Test_Random() % 300;
+}
+
+/**
+ * @brief Comprime in como o firmware faz: Sink/Poll em pedaços, Finish
+ * @param in_chunk Bytes por Sink (0 = aleatório)
+ * @param out_chunk Bytes por Poll (0 = aleatório)
+ * @return Tamanho comprimido, ou (size_t)-1 se passou de out_size ou não terminou
+ */
+static size_t Codec_Compress(const uint8_t *in, size_t len, uint8_t *out, size_t out_size,
+                             size_t in_chunk, size_t out_chunk)
+{
+    size_t in_pos = 0;
+    size_t out_len = 0;
+    size_t k;
+
+    LZSS_EncoderReset(&enc);
+
+    while (in_pos < len) {
+        size_t n = Test_Chunk(in_chunk);
+        if (n > len - in_pos) {
+            n = len - in_pos;
+        }
+        in_pos += LZSS_EncoderSink(&enc, &in[in_pos], n);
+
+        do {
+            size_t room = out_size - out_len;
+            size_t want = Test_Chunk(out_chunk);
+            k = LZSS_EncoderPoll(&enc, &out[out_len], (want < room) ? want : room);
+            out_len += k;
+        } while (k > 0);
+
+        if (out_len == out_size) {
+            return (size_t)-1;
+        }
+    }
+
+    LZSS_EncoderFinish(&enc);
+    do {
+        size_t room = out_size - out_len;
+        size_t want = Test_Chunk(out_chunk);
+        k = LZSS_EncoderPoll(&enc, &out[out_len], (want < room) ? want : room);
+        out_len += k;
+    } while (k > 0 && out_len < out_size);
+
+    return LZSS_EncoderIsDone(&enc) ? out_len : (size_t)-1;
+}
+
+/**
+ * @brief Descomprime em pedaços até esgotar a entrada
+ * @return Bytes produzidos (pode passar do original: o chamador confere)
+ */
+static size_t Codec_Decompress(const uint8_t *in, size_t len, uint8_t *out, size_t out_size,
+                               size_t in_chunk, size_t out_chunk)
+{
+    size_t in_pos = 0;
+    size_t out_len = 0;
+    size_t k;
+
+    LZSS_DecoderReset(&dec);
+
+    do {
+        size_t n = Test_Chunk(in_chunk);
+        if (n > len - in_pos) {
+            n = len - in_pos;
+        }
+        in_pos += LZSS_DecoderSink(&dec, &in[in_pos], n);
+
+        do {
+            size_t room = out_size - out_len;
+            size_t want = Test_Chunk(out_chunk);
+            k = LZSS_DecoderPoll(&dec, &out[out_len], (want < room) ? want : room);
+            out_len += k;
+        } while (k > 0 && out_len < out_size);
+    } while (in_pos < len && out_len < out_size);
+
+    return out_len;
+}
+
+/**
+ * @brief Ida e volta completa
+ * @param packed_len Saída opcional: tamanho comprimido
+ * @return 1 se voltou idêntico e dentro de LZSS_COMPRESSED_MAX
+ */
+static int Codec_RoundTrip(const uint8_t *in, size_t len, size_t in_chunk, size_t out_chunk,
+                           size_t *packed_len)
+{
+    size_t n = Codec_Compress(in, len, packed, sizeof(packed), in_chunk, out_chunk);
+    if (packed_len != NULL) {
+        *packed_len = n;
+    }
+    if (n == (size_t)-1 || n > LZSS_COMPRESSED_MAX(len)) {
+        return 0;
+    }
+
+    size_t m = Codec_Decompress(packed, n, unpacked, sizeof(unpacked), in_chunk, out_chunk);
+    return m == len && memcmp(unpacked, in, len) == 0;
+}
+
+/* ============================================================================
+   TRAÇOS DE REFERÊNCIA
+   ============================================================================ */
+/**
+ * @brief Sentenças AIS !AIVDM de 20 navios (prefixo com tipo e MMSI fixo,
+ *        posição e rumo variando) com checksum NMEA
+ */
+static void Trace_Ais(uint8_t *buf, size_t size)
+{
+    static const char armor[] = "0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVW`abcdefghijklmnopqrstuvw";
+    char prefix[20][11];
+    size_t pos = 0;
+
+    for (int v = 0; v < 20; v++) {
+        prefix[v][0] = '1';
+        for (int i = 1; i < 10; i++) {
+            prefix[v][i] = armor[Test_Random() % 64];
+        }
+        prefix[v][10] = '\0';
+    }
+
+    while (pos < size) {
+        char payload[29];
+        char line[96];
+        int v = Test_Random() % 20;
+
+        memcpy(payload, prefix[v], 10);
+        for (int i = 10; i < 28; i++) {
+            // Bits altos da posição mudam pouco entre relatórios
+            payload[i] = armor[(i < 18) ? (uint32_t)(v * 3 + i) % 64 : Test_Random() % 64];
+        }
+        payload[28] = '\0';
+
+        int n = snprintf(line, sizeof(line), "!AIVDM,1,1,,%c,%s,0", (v & 1) ? 'B' : 'A', payload);
+        uint8_t sum = 0;
+        for (int i = 1; i < n; i++) {
+            sum ^= (uint8_t)line[i];
+        }
+        n += snprintf(&line[n], sizeof(line) - n, "*%02X\r\n", sum);
+
+        size_t copy = ((size_t)n < size - pos) ? (size_t)n : size - pos;
+        memcpy(&buf[pos], line, copy);
+        pos += copy;
+    }
+}
+
+/**
+ * @brief Registros binários de telemetria do EPS (TEST_EPS_RECORD_SIZE bytes,
+ *        little-endian): tempo, 4 tensões, 4 correntes, 2 temperaturas, flags
+ */
+static void Trace_Eps(uint8_t *buf, size_t size)
+{
+    uint32_t t = 0;
+    uint16_t v[4] = {7400, 3300, 5000, 12000};
+    int16_t i_ma[4] = {350, 120, 80, -40};
+    size_t pos = 0;
+
+    while (pos < size) {
+        uint8_t rec[TEST_EPS_RECORD_SIZE];
+        uint8_t *p = rec;
+
+        t += 1000;
+        memcpy(p, &t, 4);
+        p += 4;
+        for (int k = 0; k < 4; k++) {
+            uint16_t s = v[k] + (Test_Random() % 5) - 2;
+            memcpy(p, &s, 2);
+            p += 2;
+        }
+        for (int k = 0; k < 4; k++) {
+            int16_t s = i_ma[k] + (int16_t)(Test_Random() % 9) - 4;
+            memcpy(p, &s, 2);
+            p += 2;
+        }
+        *p++ = 25 + Test_Random() % 2;  // Temperaturas em °C
+        *p++ = 31 + Test_Random() % 2;
+        *p++ = 0x05;                    // Flags
+        *p++ = 0x00;
+
+        size_t copy = (sizeof(rec) < size - pos) ? sizeof(rec) : size - pos;
+        memcpy(&buf[pos], rec, copy);
+        pos += copy;
+    }
+}
+
+/**
+ * @brief Log de texto no formato do firmware (tempo, nível, módulo, mensagem)
+ */
+static void Trace_Log(uint8_t *buf, size_t size)
+{
+    static const char *const module[] = {"EPS", "ADCS", "COMM", "PAYLOAD", "CDH"};
+    static const char *const level[] = {"INFO ", "INFO ", "INFO ", "WARN ", "ERROR"};
+    uint32_t t = 0;
+    size_t pos = 0;
+
+    while (pos < size) {
+        char line[128];
+        uint32_t r = Test_Random();
+        int m = r % 5;
+        int n;
+
+        t += 10 + (r >> 8) % 500;
+        switch (m) {
+        case 0:
+            n = snprintf(line, sizeof(line), "[%010lu] %s %s: bateria %u mV, %d mA\n",
+                         (unsigned long)t, level[(r >> 4) % 5], module[m],
+                         7300 + (r >> 12) % 200, 300 + (int)((r >> 20) % 100));
+            break;
+        case 1:
+            n = snprintf(line, sizeof(line), "[%010lu] %s %s: omega %d mrad/s, modo %u\n",
+                         (unsigned long)t, level[(r >> 4) % 5], module[m],
+                         (int)((r >> 12) % 400) - 200, (r >> 24) % 3);
+            break;
+        case 2:
+            n = snprintf(line, sizeof(line), "[%010lu] %s %s: frame %u enviado, fila %u\n",
+                         (unsigned long)t, level[(r >> 4) % 5], module[m],
+                         (r >> 12) % 4096, (r >> 24) % 8);
+            break;
+        case 3:
+            n = snprintf(line, sizeof(line), "[%010lu] %s %s: %u registros AIS recebidos\n",
+                         (unsigned long)t, level[(r >> 4) % 5], module[m], (r >> 12) % 64);
+            break;
+        default:
+            n = snprintf(line, sizeof(line), "[%010lu] %s %s: tarefa concluida em %u ms\n",
+                         (unsigned long)t, level[(r >> 4) % 5], module[m], (r >> 12) % 1000);
+            break;
+        }
+
+        size_t copy = ((size_t)n < size - pos) ? (size_t)n : size - pos;
+        memcpy(&buf[pos], line, copy);
+        pos += copy;
+    }
+}
+
+static void Trace_Random(uint8_t *buf, size_t size)
+{
+    Test_FillRandom(buf, size);
+}
+
+/* ============================================================================
+   VERIFICAÇÕES
+   ============================================================================ */
+static void Test_Small(void)
+{
+    size_t n = 0;
+    uint8_t one = 0xA5;
+
+    Test_Check(Codec_RoundTrip(NULL, 0, 0, 0, &n) && n == 0, "vazio: nenhum byte na saída");
+
+    Test_Check(Codec_RoundTrip(&one, 1, 1, 1, &n) && n == 2, "1 byte: literal de 9 bits em 2 bytes");
+
+    // 7 bits de preenchimento (zeros) não podem virar um símbolo
+    uint8_t extra[2] = {0};
+    size_t m = Codec_Decompress(packed, n, extra, sizeof(extra), 1, 1);
+    Test_Check(m == 1 && extra[0] == one, "1 byte: preenchimento não gera byte a mais");
+}
+
+static void Test_WindowBoundary(void)
+{
+    static const size_t sizes[] = {255, 256, 257, 511, 512, 513};
+    uint8_t buf[600];
+    char what[80];
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t len = sizes[s];
+
+        Test_FillRandom(buf, len);
+        snprintf(what, sizeof(what), "janela: %zu bytes aleatórios", len);
+        Test_Check(Codec_RoundTrip(buf, len, 0, 0, NULL), what);
+
+        // Período de 256: toda repetição está exatamente na distância máxima
+        for (size_t i = 256; i < len; i++) {
+            buf[i] = buf[i - 256];
+        }
+        size_t n = 0;
+        int ok = Codec_RoundTrip(buf, len, 0, 0, &n);
+        snprintf(what, sizeof(what), "janela: %zu bytes com período 256", len);
+        Test_Check(ok && (len <= 256 || n < LZSS_COMPRESSED_MAX(len) - (len - 256) / 2), what);
+    }
+
+    // Período de 257: a repetição cai fora da janela e não pode ser copiada
+    Test_FillRandom(buf, 514);
+    for (size_t i = 257; i < 514; i++) {
+        buf[i] = buf[i - 257];
+    }
+    Test_Check(Codec_RoundTrip(buf, 514, 0, 0, NULL), "janela: período 257 (fora do alcance)");
+
+    // Sequência repetida: cópia de distância 1 sobrepondo a posição atual
+    size_t n = 0;
+    memset(buf, 0, sizeof(buf));
+    Test_Check(Codec_RoundTrip(buf, sizeof(buf), 0, 0, &n) &&
+               n <= 2 + (sizeof(buf) / LZSS_MAX_MATCH + 1) * 2,
+               "zeros: cópias sobrepostas de LZSS_MAX_MATCH bytes");
+}
+
+static void Test_ByteByByte(void)
+{
+    Trace_Log(trace, 4096);
+    Test_Check(Codec_RoundTrip(trace, 4096, 1, 1, NULL), "byte a byte: log de 4 KB (Sink 1, Poll 1)");
+
+    Test_FillRandom(trace, 1000);
+    Test_Check(Codec_RoundTrip(trace, 1000, 1, 1, NULL), "byte a byte: 1000 bytes aleatórios");
+
+    // Cópia interrompida pela saída de 1 byte e retomada no próximo Poll
+    memset(trace, 'x', 300);
+    Test_Check(Codec_RoundTrip(trace, 300, 1, 1, NULL), "byte a byte: cópias longas com Poll de 1 byte");
+}
+
+static void Test_WorstCase(void)
+{
+    size_t worst_len = 0;
+    size_t worst = 0;
+    int ok = 1;
+
+    for (size_t len = 0; len <= TEST_MAX_LEN && ok; len++) {
+        size_t n = 0;
+        Test_FillRandom(trace, len);
+        ok = Codec_RoundTrip(trace, len, 0, 0, &n);
+        if (ok && n > worst) {
+            worst = n;
+            worst_len = len;
+        }
+    }
+
+    char what[96];
+    snprintf(what, sizeof(what), "LZSS_COMPRESSED_MAX: 0..%u bytes aleatórios (maior: %zu -> %zu)",
+             TEST_MAX_LEN, worst_len, worst);
+    Test_Check(ok, what);
+
+    // Só literais: 256 bytes distintos, 9 bits por byte
+    for (size_t i = 0; i < 256; i++) {
+        trace[i] = (uint8_t)(i * 7);
+    }
+    size_t n = Codec_Compress(trace, 256, packed, sizeof(packed), 0, 0);
+    Test_Check(n == (256 * 9) / 8 && n <= LZSS_COMPRESSED_MAX(256),
+               "LZSS_COMPRESSED_MAX: 256 literais em 288 bytes");
+
+    // Saída do tamanho exato do limite basta
+    Test_FillRandom(trace, 777);
+    n = Codec_Compress(trace, 777, packed, LZSS_COMPRESSED_MAX(777), 0, 0);
+    Test_Check(n != (size_t)-1, "LZSS_COMPRESSED_MAX: buffer do tamanho do limite basta");
+}
+
+static void Test_Traces(void)
+{
+    static const struct {
+        const char *name;
+        void (*fill)(uint8_t *buf, size_t size);
+    } traces[] = {
+        {"AIS NMEA", Trace_Ais},
+        {"telemetria EPS", Trace_Eps},
+        {"log de texto", Trace_Log},
+        {"aleatório", Trace_Random},
+    };
+    char what[80];
+
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        traces[t].fill(trace, sizeof(trace));
+        snprintf(what, sizeof(what), "traço %s: %u KB em pedaços aleatórios", traces[t].name,
+                 TEST_TRACE_SIZE / 1024);
+        Test_Check(Codec_RoundTrip(trace, sizeof(trace), 0, 0, NULL), what);
+    }
+}
+
+/* ============================================================================
+   MEDIÇÃO
+   ============================================================================ */
+static uint64_t Bench_Now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int Bench_Run(void)
+{
+    static const struct {
+        const char *name;
+        void (*fill)(uint8_t *buf, size_t size);
+    } traces[] = {
+        {"AIS NMEA", Trace_Ais},
+        {"telemetria EPS (24 B)", Trace_Eps},
+        {"log de texto", Trace_Log},
+        {"aleatório", Trace_Random},
+    };
+#if defined(__x86_64__) || defined(__i386__)
+    const char *unit = "ciclos/B";
+#else
+    const char *unit = "ns/B";
+#endif
+
+    printf("%u KB por traço, pedaços de %u B, melhor de %u (host: %s)\n",
+           TEST_TRACE_SIZE / 1024, BENCH_CHUNK, BENCH_RUNS, unit);
+    printf("%-24s %7s %12s %12s\n", "traço", "razão", "codifica", "decodifica");
+
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        uint64_t best_enc = UINT64_MAX;
+        uint64_t best_dec = UINT64_MAX;
+        size_t n = 0;
+
+        rng_state = 0x12345678U;
+        traces[t].fill(trace, sizeof(trace));
+
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            uint64_t t0 = Bench_Now();
+            n = Codec_Compress(trace, sizeof(trace), packed, sizeof(packed), BENCH_CHUNK, BENCH_CHUNK);
+            uint64_t t1 = Bench_Now();
+            size_t m = Codec_Decompress(packed, n, unpacked, sizeof(unpacked), BENCH_CHUNK, BENCH_CHUNK);
+            uint64_t t2 = Bench_Now();
+
+            if (n == (size_t)-1 || m != sizeof(trace) || memcmp(unpacked, trace, m) != 0) {
+                printf("FALHA %s: ida e volta\n", traces[t].name);
+                return 1;
+            }
+            if (t1 - t0 < best_enc) {
+                best_enc = t1 - t0;
+            }
+            if (t2 - t1 < best_dec) {
+                best_dec = t2 - t1;
+            }
+        }
+
+        printf("%-24s %7.2f %12.0f %12.0f\n", traces[t].name, (double)sizeof(trace) / n,
+               (double)best_enc / sizeof(trace), (double)best_dec / sizeof(trace));
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+        return Bench_Run();
+    }
+
+    Test_Small();
+    Test_WindowBoundary();
+    Test_ByteByByte();
+    Test_WorstCase();
+    Test_Traces();
+
+    printf("%s: %d de %d verificações falharam\n", failures ? "FALHA" : "ok",
+           failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,630 @@
+/**
+  ******************************************************************************
+  * @file    main.c
+  * @brief   Teste das missões do Payload no host: payload_mission.c do
+  *          firmware (UART5) contra um Payload emulado (UART8) no fio com
+  *          perdas do link_test
+  *
+  *   mission_test [-v]      (-v: contadores do fio e do enlace)
+  *
+  * Lotes AIS (UART_SendAISData): 500 registros numerados entram na fila a
+  * cada TEST_AIS_PERIOD_MS e o Payload emulado confere:
+  *   - todos chegam, em ordem e íntegros, com e sem perdas no fio;
+  *   - em MSG_DATA_AIS_BATCH, um frame por UART_AIS_BATCH_MAX registros;
+  *   - sem perdas, a fila nunca recusa registro (HAL_BUSY) nesse ritmo.
+  * Com perdas o enlace para nas retransmissões e a fila de
+  * UART_AIS_QUEUE_SIZE enche: o teste reenvia o registro recusado no
+  * período seguinte e mostra quantas recusas houve (no firmware,
+  * CAN_HandleAISData descartaria esses registros).
+  * O mesmo fluxo registro a registro (MSG_DATA_AIS, como antes dos lotes)
+  * serve de referência para os bytes no fio.
+  *
+  * Pipeline de missões (UART_ProcessMission): o COM pede a Missão 2 por
+  * TEST_PIPELINE_MS e o Payload emulado leva TEST_MISSION_MS em cada
+  * execução, uma por vez, com registros AIS chegando no meio. Confere:
+  *   - UART_MISSION_PIPELINE_DEPTH requisições em voo;
+  *   - o Payload nunca espera comando entre uma execução e a próxima, e
+  *     o intervalo entre resultados fica perto de TEST_MISSION_MS;
+  *   - lotes AIS chegam ao Payload durante o processamento;
+  *   - os resultados chegam ao COM (CAN emulado) em ordem, sem falhas.
+  *
+  * Fila de resultados (result_queue.c): TEST_RESULTS resultados da Missão
+  * 2, um quarto repetindo o anterior, a cada TEST_RESULT_PERIOD_MS. O COM
+  * fica ocupado (não lê o TX FIFO) um terço do tempo e perde 10% dos
+  * CAN_COM_RESULT_ACK. Confere:
+  *   - todos os resultados distintos chegam ao COM em ordem, nenhum é
+  *     descartado por fila cheia e as repetições param na entrada;
+  *   - a fila transborda para a QSPI emulada e volta sem erro de flash;
+  *   - ACK perdido vira reenvio do mesmo seq (o COM descarta o duplicado).
+  *
+  * Código de saída: 0 se todos os cenários passaram, 1 se algum falhou.
+  ******************************************************************************
+  */
+
+#include "link_hal.h"
+#include "mission_stubs.h"
+#include "payload_mission.h"
+#include "result_queue.h"
+#include "uart_protocol.h"
+#include "usart.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_AIS_RECORDS        500
+#define TEST_AIS_PERIOD_MS      2       // Um registro AIS do COM a cada 2 ms
+#define TEST_MISSION_MS         500     // Processamento de uma missão no Payload
+#define TEST_PIPELINE_MS        10000   // Tempo com a Missão 2 pedida pelo COM
+#define TEST_PIPELINE_AIS_MS    20      // Registros AIS durante as missões
+#define TEST_PAYLOAD_QUEUE      8       // Comandos de missão aguardando no Payload
+#define TEST_RESULTS            2000
+#define TEST_RESULT_PERIOD_MS   20
+#define TEST_RESULT_REPEAT      0.25    // Fração igual ao resultado anterior
+#define TEST_COM_BUSY_MS        1000    // COM ocupado 1 s a cada TEST_COM_CYCLE_MS
+#define TEST_COM_CYCLE_MS       3000
+#define TEST_ACK_LOSS           0.10
+#define TEST_IDLE_MS            1000    // Folga no fim para ACKs atrasados
+#define TEST_MAX_MS             600000  // 10 min simulados: enlace travado
+
+/* ============================================================================
+   PAYLOAD EMULADO
+   ============================================================================ */
+typedef struct {
+    UART_Protocol_t proto;
+
+    // Registros AIS recebidos
+    uint32_t ais_frames;        // Mensagens (lotes ou registros avulsos)
+    uint32_t ais_records;
+    uint32_t ais_last;          // Último contador recebido (0 = nenhum)
+    uint32_t ais_order_errors;
+    uint32_t ais_payload_errors;
+    uint32_t ais_frames_busy;   // Chegaram com uma missão em processamento
+
+    // Missões: comandos numa fila, executados um por vez
+    uint8_t cmd_queue[TEST_PAYLOAD_QUEUE];
+    uint8_t cmd_count;
+    uint8_t processing;         // Comando em execução (0 = ocioso)
+    uint32_t done_tick;         // Fim da execução atual
+    uint32_t missions_started;
+    uint32_t missions_done;     // Resultados enviados
+    uint32_t starved_ms;        // Ocioso, sem comando, com missão pedida
+} Payload_t;
+
+// COM emulado: lê o TX FIFO do CAN e confirma cada resultado completo
+typedef struct {
+    uint16_t seq;               // Resultado em recepção
+    uint8_t frames_left;        // Frames de dados que faltam
+    uint32_t mmsi;
+    uint32_t results;           // Resultados completos confirmados
+    uint32_t last_mmsi;         // Último resultado (o Payload numera a partir de 1)
+    uint32_t order_errors;
+    uint16_t last_seq;          // seq do último resultado confirmado
+    uint32_t duplicates;        // Reenvios de resultado já recebido
+    uint32_t lost_acks;
+
+    uint8_t busy;               // 1 = não lê o TX FIFO
+    double ack_loss;
+} Com_t;
+
+static Payload_t payload;
+static Com_t com;
+static Rng_t rng;
+static uint8_t verbose = 0;
+
+// Bytes do CDH para o Payload no fio (inclui retransmissões e perdidos)
+static uint32_t wire_bytes = 0;
+
+/* Registro AIS de teste: [contador(4)][~contador(4)] */
+static void Test_BuildRecord(uint32_t counter, uint8_t *record)
+{
+    uint32_t inverse = ~counter;
+    memcpy(&record[0], &counter, 4);
+    memcpy(&record[4], &inverse, 4);
+}
+
+static void Payload_CheckRecord(const uint8_t *record)
+{
+    uint32_t counter;
+    uint32_t inverse;
+
+    memcpy(&counter, &record[0], 4);
+    memcpy(&inverse, &record[4], 4);
+
+    if (inverse != ~counter) {
+        payload.ais_payload_errors++;
+        return;
+    }
+    if (counter != payload.ais_last + 1) {
+        payload.ais_order_errors++;
+    }
+    payload.ais_last = counter;
+    payload.ais_records++;
+}
+
+static void Payload_HandleAisBatch(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    uint8_t n = msg->data[0];
+
+    payload.ais_frames++;
+    payload.ais_frames_busy += (payload.processing != 0);
+    if (msg->length < 1 || n == 0 || n > UART_AIS_BATCH_MAX ||
+        msg->length != 1 + n * UART_AIS_RECORD_SIZE) {
+        payload.ais_payload_errors++;
+        return;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        Payload_CheckRecord(&msg->data[1 + i * UART_AIS_RECORD_SIZE]);
+    }
+}
+
+static void Payload_HandleAis(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    payload.ais_frames++;
+    if (msg->length != UART_AIS_RECORD_SIZE) {
+        payload.ais_payload_errors++;
+        return;
+    }
+    Payload_CheckRecord(msg->data);
+}
+
+static void Payload_HandleStart(UART_Protocol_t *proto, const UART_Message_t *msg)
+{
+    if (payload.cmd_count >= TEST_PAYLOAD_QUEUE) {
+        return;     // O CDH espera o timeout e tenta de novo
+    }
+    payload.cmd_queue[payload.cmd_count++] = msg->id;
+}
+
+/**
+ * @brief Executa a fila de comandos: TEST_MISSION_MS por missão, resultado
+ *        numerado (MMSI = número da execução) ao terminar
+ */
+static void Payload_Poll(UART_Protocol_t *proto)
+{
+    if (payload.processing && (int32_t)(HAL_GetTick() - payload.done_tick) >= 0) {
+        uint8_t result[12] = {0};
+        uint32_t n = payload.missions_done + 1;
+        uint8_t id = (payload.processing == MSG_CMD_START_M1) ? MSG_RES_M1_OIL : MSG_RES_M2_SHIP;
+
+        if (id == MSG_RES_M1_OIL) {
+            float area = (float)n;
+            result[0] = 1;
+            memcpy(&result[1], &area, 4);
+        } else {
+            result[0] = (n >> 24) & 0xFF;   // MMSI big-endian
+            result[1] = (n >> 16) & 0xFF;
+            result[2] = (n >> 8) & 0xFF;
+            result[3] = n & 0xFF;
+        }
+
+        if (UART_Link_Send(proto, id, result, (id == MSG_RES_M1_OIL) ? 5 : 12) != HAL_OK) {
+            return;     // Janela cheia: tenta na próxima passada
+        }
+        payload.missions_done++;
+        payload.processing = 0;
+    }
+
+    if (!payload.processing && payload.cmd_count > 0) {
+        payload.processing = payload.cmd_queue[0];
+        memmove(&payload.cmd_queue[0], &payload.cmd_queue[1], --payload.cmd_count);
+        payload.done_tick = HAL_GetTick() + TEST_MISSION_MS;
+        payload.missions_started++;
+    }
+}
+
+static const UART_Handler_t payload_handlers[] = {
+    {MSG_DATA_AIS_BATCH, Payload_HandleAisBatch},
+    {MSG_DATA_AIS,       Payload_HandleAis},
+    {MSG_CMD_START_M1,   Payload_HandleStart},
+    {MSG_CMD_START_M2,   Payload_HandleStart},
+};
+
+static const UART_ProtocolConfig_t payload_config = {
+    .handlers = payload_handlers,
+    .handler_count = sizeof(payload_handlers) / sizeof(payload_handlers[0]),
+    .poll = Payload_Poll,
+};
+
+/* ============================================================================
+   COM EMULADO
+   ============================================================================ */
+/**
+ * @brief Lê o frame do TX FIFO do CAN (se houver) e confirma o resultado
+ *        quando todos os frames de dados chegaram
+ * @note Resultado com o seq do último já recebido é reenvio (o ACK se
+ *       perdeu): confirma de novo sem contar
+ */
+static void Com_Step(void)
+{
+    CAN_Message_t msg;
+
+    if (com.busy || !MissionStubs_CanTake(&msg)) {
+        return;
+    }
+
+    if (msg.id == CAN_CDH_RESULT_INFO) {
+        com.seq = ((uint16_t)msg.data[1] << 8) | msg.data[2];
+        com.frames_left = msg.data[7];
+        com.mmsi = 0;
+        return;
+    }
+    if (msg.id != CAN_CDH_TELEMETRY || com.frames_left == 0 ||
+        (((uint16_t)msg.data[6] << 8) | msg.data[7]) != com.seq) {
+        return;
+    }
+
+    if (msg.data[0] == MISSION_2 && msg.data[1] == 1) {
+        com.mmsi = ((uint32_t)msg.data[2] << 24) | ((uint32_t)msg.data[3] << 16) |
+                   ((uint32_t)msg.data[4] << 8) | msg.data[5];
+    }
+    if (--com.frames_left > 0) {
+        return;
+    }
+
+    if (com.results > 0 && com.seq == com.last_seq) {
+        com.duplicates++;
+    } else {
+        if (com.mmsi != com.last_mmsi + 1) {
+            com.order_errors++;
+        }
+        com.last_mmsi = com.mmsi;
+        com.last_seq = com.seq;
+        com.results++;
+    }
+
+    if (Rng_Uniform(&rng) < com.ack_loss) {
+        com.lost_acks++;
+        return;
+    }
+    ResultQueue_HandleAck(com.seq);     // CAN_COM_RESULT_ACK
+}
+
+/* ============================================================================
+   EXECUÇÃO
+   ============================================================================ */
+typedef struct Scenario Scenario_t;
+
+struct Scenario {
+    const char *name;
+    int (*run)(const Scenario_t *s);
+    double loss;                // Nos dois sentidos
+    uint8_t per_record;         // AIS: 1 = MSG_DATA_AIS avulso (referência)
+    uint8_t allow_busy;         // AIS: recusas da fila só são contadas
+    uint8_t com_busy;           // COM ocupado TEST_COM_BUSY_MS a cada TEST_COM_CYCLE_MS
+    double ack_loss;            // ACKs do COM perdidos
+};
+
+/**
+ * @brief Escuta do sentido CDH -> Payload: só conta, nunca descarta
+ */
+static int Test_Tap(const uint8_t *data, uint16_t size)
+{
+    wire_bytes += size;
+    return 0;
+}
+
+static void Test_Reset(const Scenario_t *s)
+{
+    LinkHal_Reset(&huart5, &huart8, 1);
+    MissionStubs_Reset();
+    memset(&payload, 0, sizeof(payload));
+    memset(&com, 0, sizeof(com));
+    com.ack_loss = s->ack_loss;
+    Rng_Seed(&rng, 2);
+    wire_bytes = 0;
+
+    if (Payload_Init(&huart5) != HAL_OK ||
+        UART_Protocol_Init(&payload.proto, &huart8, &payload_config) != HAL_OK) {
+        fprintf(stderr, "UART_Protocol_Init falhou\n");
+        exit(1);
+    }
+
+    LinkHal_Wire_t *to_payload = LinkHal_Wire(&huart5);
+    LinkHal_Wire_t *to_cdh = LinkHal_Wire(&huart8);
+    to_payload->loss = to_cdh->loss = s->loss;
+    to_payload->filter = Test_Tap;
+}
+
+/**
+ * @brief Um ms do sistema: motor do protocolo, downlink CAN, COM e fio
+ */
+static void Test_Step(void)
+{
+    UART_Protocol_Process();
+    ResultQueue_Poll();         // Chamada pelo CAN_Protocol_Process no firmware
+    Com_Step();
+    LinkHal_Step();
+}
+
+static void Test_PrintWires(void)
+{
+    UART_Protocol_t *cdh = Payload_GetLink();
+    LinkHal_Wire_t *to_payload = LinkHal_Wire(&huart5);
+    LinkHal_Wire_t *to_cdh = LinkHal_Wire(&huart8);
+
+    printf("     fio CDH->Payload: %u trechos, %u perdidos; Payload->CDH: %u, %u; "
+           "descartes %u, sync %u\n",
+           to_payload->chunks, to_payload->lost, to_cdh->chunks, to_cdh->lost,
+           UART_Link_GetDroppedFrames(cdh), UART_Link_GetResyncs(cdh));
+}
+
+static int Run_Ais(const Scenario_t *s)
+{
+    UART_Protocol_t *cdh = Payload_GetLink();
+    uint8_t record[UART_AIS_RECORD_SIZE];
+    uint32_t next = 1;
+    uint32_t busy = 0;
+    uint32_t idle_since = 0;
+    int ok = 1;
+
+    Test_Reset(s);
+
+    for (uint32_t t = 0; t < TEST_MAX_MS; t++) {
+        if (next <= TEST_AIS_RECORDS && t % TEST_AIS_PERIOD_MS == 0) {
+            Test_BuildRecord(next, record);
+            HAL_StatusTypeDef status = s->per_record
+                ? UART_Link_Send(cdh, MSG_DATA_AIS, record, sizeof(record))
+                : UART_SendAISData(record);
+            if (status == HAL_OK) {
+                next++;
+            } else {
+                busy++;     // Tenta de novo no próximo período
+            }
+        }
+
+        Test_Step();
+
+        uint8_t done = next > TEST_AIS_RECORDS && UART_GetAISQueued() == 0 &&
+                       UART_Link_GetInFlight(cdh) == 0 && !cdh->link.sync_pending;
+        if (!done) {
+            idle_since = t;
+        } else if (t - idle_since >= TEST_IDLE_MS) {
+            break;
+        }
+    }
+
+    uint32_t frames = s->per_record ? TEST_AIS_RECORDS
+                                    : (TEST_AIS_RECORDS + UART_AIS_BATCH_MAX - 1) / UART_AIS_BATCH_MAX;
+
+    if (payload.ais_records != TEST_AIS_RECORDS || payload.ais_last != TEST_AIS_RECORDS) {
+        printf("    recebidos %u de %u registros (último %u)\n",
+               payload.ais_records, TEST_AIS_RECORDS, payload.ais_last);
+        ok = 0;
+    }
+    if (payload.ais_order_errors > 0 || payload.ais_payload_errors > 0) {
+        printf("    %u fora de ordem/duplicados, %u corrompidos\n",
+               payload.ais_order_errors, payload.ais_payload_errors);
+        ok = 0;
+    }
+    if (payload.ais_frames != frames) {
+        printf("    %u frames, esperados %u\n", payload.ais_frames, frames);
+        ok = 0;
+    }
+    if (!s->per_record && !s->allow_busy && busy > 0) {
+        printf("    fila AIS recusou %u registros\n", busy);
+        ok = 0;
+    }
+
+    printf("%-4s %-44s %3u registros em %3u frames, %5u bytes no fio, retx %3u, recusas %5u  (%.1f s)\n",
+           ok ? "ok" : "FALHA", s->name, payload.ais_records, payload.ais_frames, wire_bytes,
+           UART_Link_GetRetransmissions(cdh), busy, HAL_GetTick() / 1000.0);
+
+    if (verbose) {
+        Test_PrintWires();
+    }
+
+    return ok;
+}
+
+static int Run_Pipeline(const Scenario_t *s)
+{
+    UART_Protocol_t *cdh = Payload_GetLink();
+    uint8_t record[UART_AIS_RECORD_SIZE];
+    uint32_t ais_next = 1;
+    uint32_t completed = 0;
+    uint32_t first_tick = 0;
+    uint32_t last_tick = 0;
+    uint8_t max_in_flight = 0;
+    uint32_t idle_since = 0;
+    int ok = 1;
+
+    Test_Reset(s);
+    MissionStubs_SetMission(MISSION_2);
+
+    for (uint32_t t = 0; t < TEST_MAX_MS; t++) {
+        uint8_t active = (t < TEST_PIPELINE_MS);
+
+        if (t == TEST_PIPELINE_MS) {
+            MissionStubs_SetMission(MISSION_NONE);  // As em voo terminam sozinhas
+        }
+        if (active && t % TEST_PIPELINE_AIS_MS == 0) {
+            Test_BuildRecord(ais_next, record);
+            if (UART_SendAISData(record) == HAL_OK) {
+                ais_next++;
+            }
+        }
+
+        UART_ProcessMission();
+        Test_Step();
+
+        if (UART_GetMissionsInFlight() > max_in_flight) {
+            max_in_flight = UART_GetMissionsInFlight();
+        }
+        if (UART_GetMissionsCompleted() != completed) {
+            completed = UART_GetMissionsCompleted();
+            if (completed == 1) {
+                first_tick = t;
+            }
+            last_tick = t;
+        }
+        if (active && payload.missions_started > 0 && !payload.processing) {
+            payload.starved_ms++;
+        }
+
+        uint8_t done = !active && UART_GetMissionsInFlight() == 0 && ResultQueue_GetCount() == 0 &&
+                       UART_Link_GetInFlight(cdh) == 0 && !cdh->link.sync_pending;
+        if (!done) {
+            idle_since = t;
+        } else if (t - idle_since >= TEST_IDLE_MS) {
+            break;
+        }
+    }
+
+    double interval = (completed > 1) ? (double)(last_tick - first_tick) / (completed - 1) : 0.0;
+
+    if (max_in_flight != UART_MISSION_PIPELINE_DEPTH) {
+        printf("    no máximo %u missões em voo, esperadas %u\n", max_in_flight,
+               UART_MISSION_PIPELINE_DEPTH);
+        ok = 0;
+    }
+    if (completed < TEST_PIPELINE_MS / TEST_MISSION_MS - 1 || UART_GetMissionsFailed() > 0) {
+        printf("    %u missões concluídas, %u falharam\n", completed, UART_GetMissionsFailed());
+        ok = 0;
+    }
+    if (s->loss == 0.0 && (payload.starved_ms > 0 || interval > TEST_MISSION_MS * 1.05)) {
+        printf("    Payload esperou comando por %u ms; intervalo %.0f ms\n",
+               payload.starved_ms, interval);
+        ok = 0;
+    }
+    if (payload.ais_frames_busy == 0 || payload.ais_order_errors > 0 ||
+        payload.ais_payload_errors > 0 || payload.ais_last != ais_next - 1) {
+        printf("    AIS: %u lotes durante missões, %u de %u registros, %u fora de ordem, "
+               "%u corrompidos\n", payload.ais_frames_busy, payload.ais_last, ais_next - 1,
+               payload.ais_order_errors, payload.ais_payload_errors);
+        ok = 0;
+    }
+    if (com.results != completed || com.order_errors > 0 || com.last_mmsi != payload.missions_done) {
+        printf("    COM: %u resultados (último %u) de %u, %u fora de ordem\n",
+               com.results, com.last_mmsi, payload.missions_done, com.order_errors);
+        ok = 0;
+    }
+
+    printf("%-4s %-44s %2u missões, uma a cada %3.0f ms, %u em voo, Payload ocioso %4u ms, "
+           "%2u lotes AIS no meio  (%.1f s)\n",
+           ok ? "ok" : "FALHA", s->name, completed, interval, max_in_flight,
+           payload.starved_ms, payload.ais_frames_busy, HAL_GetTick() / 1000.0);
+
+    if (verbose) {
+        Test_PrintWires();
+    }
+
+    return ok;
+}
+
+static int Run_Results(const Scenario_t *s)
+{
+    uint8_t result[RESULT_QUEUE_MAX_DATA] = {0};
+    uint32_t pushed = 0;
+    uint32_t unique = 0;
+    uint32_t refused = 0;
+    uint32_t max_count = 0;
+    uint32_t idle_since = 0;
+    int ok = 1;
+
+    Test_Reset(s);
+
+    for (uint32_t t = 0; t < TEST_MAX_MS; t++) {
+        if (pushed < TEST_RESULTS && t % TEST_RESULT_PERIOD_MS == 0) {
+            // Repetição: os mesmos bytes do anterior (MMSI = contador)
+            if (unique == 0 || Rng_Uniform(&rng) >= TEST_RESULT_REPEAT) {
+                unique++;
+                result[0] = (unique >> 24) & 0xFF;
+                result[1] = (unique >> 16) & 0xFF;
+                result[2] = (unique >> 8) & 0xFF;
+                result[3] = unique & 0xFF;
+            }
+            if (ResultQueue_Push(MISSION_2, result, 12) != HAL_OK) {
+                refused++;
+            }
+            pushed++;
+        }
+
+        com.busy = s->com_busy && (t % TEST_COM_CYCLE_MS) < TEST_COM_BUSY_MS;
+        Test_Step();
+
+        if (ResultQueue_GetCount() > max_count) {
+            max_count = ResultQueue_GetCount();
+        }
+
+        uint8_t done = pushed == TEST_RESULTS && ResultQueue_GetCount() == 0;
+        if (!done) {
+            idle_since = t;
+        } else if (t - idle_since >= TEST_IDLE_MS) {
+            break;
+        }
+    }
+
+    if (com.results != unique || com.last_mmsi != unique || com.order_errors > 0) {
+        printf("    COM: %u de %u resultados distintos (último %u), %u fora de ordem\n",
+               com.results, unique, com.last_mmsi, com.order_errors);
+        ok = 0;
+    }
+    if (refused > 0 || ResultQueue_GetDropped() > 0 ||
+        ResultQueue_GetSuppressed() != TEST_RESULTS - unique) {
+        printf("    fila: %u recusados, %u descartados, %u repetições suprimidas de %u\n",
+               refused, ResultQueue_GetDropped(), ResultQueue_GetSuppressed(),
+               TEST_RESULTS - unique);
+        ok = 0;
+    }
+    if (max_count <= RESULT_QUEUE_RAM_SIZE || MissionStubs_GetErases() == 0 ||
+        MissionStubs_GetFlashErrors() > 0) {
+        printf("    QSPI: até %u na fila, %u setores apagados, %u erros de flash\n",
+               max_count, MissionStubs_GetErases(), MissionStubs_GetFlashErrors());
+        ok = 0;
+    }
+    if (com.duplicates > com.lost_acks || MissionStubs_GetCanOverruns() > 0) {
+        printf("    %u duplicados para %u ACKs perdidos, %u frames CAN sobrescritos\n",
+               com.duplicates, com.lost_acks, MissionStubs_GetCanOverruns());
+        ok = 0;
+    }
+
+    printf("%-4s %-44s %4u distintos de %u, até %4u na fila, %3u setores apagados, "
+           "%3u ACKs perdidos, %3u reenvios  (%.1f s)\n",
+           ok ? "ok" : "FALHA", s->name, com.results, TEST_RESULTS, max_count,
+           MissionStubs_GetErases(), com.lost_acks, ResultQueue_GetRetransmissions(),
+           HAL_GetTick() / 1000.0);
+
+    return ok;
+}
+
+/* ============================================================================
+   CENÁRIOS
+   ============================================================================ */
+static const Scenario_t scenarios[] = {
+    {.name = "AIS em lotes, limpo", .run = Run_Ais},
+    {.name = "AIS em lotes, 15% perdidos", .run = Run_Ais, .loss = 0.15, .allow_busy = 1},
+    {.name = "AIS registro a registro (antes), limpo", .run = Run_Ais, .per_record = 1},
+    {.name = "AIS registro a registro (antes), 15% perdidos", .run = Run_Ais, .loss = 0.15,
+     .per_record = 1},
+    {.name = "Missão 2 em pipeline, limpo", .run = Run_Pipeline},
+    {.name = "Missão 2 em pipeline, 10% perdidos", .run = Run_Pipeline, .loss = 0.10},
+    {.name = "resultados, COM ocupado 1/3, 10% ACKs perdidos", .run = Run_Results,
+     .com_busy = 1, .ack_loss = TEST_ACK_LOSS},
+};
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "v")) != -1) {
+        if (opt == 'v') {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "uso: %s [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (!scenarios[i].run(&scenarios[i])) {
+            failures++;
+        }
+    }
+
+    printf("%s: %d de %zu cenários falharam\n", failures ? "FALHA" : "ok",
+           failures, sizeof(scenarios) / sizeof(scenarios[0]));
+    return failures ? 1 : 0;
+}
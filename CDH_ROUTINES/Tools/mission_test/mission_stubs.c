@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    mission_stubs.c
+  * @brief   CAN, QSPI, uart_bulk e payload_bridge emulados para o teste das
+  *          missões no host
+  ******************************************************************************
+  */
+
+#include "mission_stubs.h"
+#include "result_queue.h"
+#include "qspi_flash.h"
+#include "uart_bulk.h"
+#include "payload_bridge.h"
+#include <string.h>
+
+/* ============================================================================
+   ESTADO
+   ============================================================================ */
+static MissionType_t mission = MISSION_NONE;
+
+static CAN_Message_t can_fifo;
+static uint8_t can_full = 0;
+static uint32_t can_overruns = 0;
+
+static uint8_t flash[RESULT_QUEUE_QSPI_SIZE];
+static uint32_t erases = 0;
+static uint32_t flash_errors = 0;
+
+/* ============================================================================
+   CONTROLE DO TESTE
+   ============================================================================ */
+void MissionStubs_Reset(void)
+{
+    mission = MISSION_NONE;
+    can_full = 0;
+    can_overruns = 0;
+    memset(flash, 0xFF, sizeof(flash));
+    erases = 0;
+    flash_errors = 0;
+}
+
+void MissionStubs_SetMission(MissionType_t m)
+{
+    mission = m;
+}
+
+uint8_t MissionStubs_CanTake(CAN_Message_t *msg)
+{
+    if (!can_full) {
+        return 0;
+    }
+    *msg = can_fifo;
+    can_full = 0;
+    return 1;
+}
+
+uint32_t MissionStubs_GetCanOverruns(void)
+{
+    return can_overruns;
+}
+
+uint32_t MissionStubs_GetErases(void)
+{
+    return erases;
+}
+
+uint32_t MissionStubs_GetFlashErrors(void)
+{
+    return flash_errors;
+}
+
+/* ============================================================================
+   CAN
+   ============================================================================ */
+MissionType_t CAN_GetMissionType(void)
+{
+    return mission;
+}
+
+uint8_t CAN_TxReady(void)
+{
+    return !can_full;
+}
+
+void CAN_Transmit(CAN_Message_t *msg)
+{
+    if (can_full) {
+        can_overruns++;
+        return;
+    }
+    can_fifo = *msg;
+    can_full = 1;
+}
+
+/* ============================================================================
+   QSPI
+   ============================================================================ */
+/**
+ * @brief Converte o endereço da flash para a região emulada
+ * @return NULL fora da fila de resultados
+ */
+static uint8_t *Flash_Map(uint32_t address, uint32_t length)
+{
+    if (address < RESULT_QUEUE_QSPI_BASE ||
+        address + length > RESULT_QUEUE_QSPI_BASE + RESULT_QUEUE_QSPI_SIZE) {
+        flash_errors++;
+        return NULL;
+    }
+    return &flash[address - RESULT_QUEUE_QSPI_BASE];
+}
+
+HAL_StatusTypeDef QSPI_Flash_EraseSector(uint32_t address)
+{
+    uint8_t *p = Flash_Map(address & ~(uint32_t)(QSPI_FLASH_SECTOR_SIZE - 1), QSPI_FLASH_SECTOR_SIZE);
+    if (p == NULL) {
+        return HAL_ERROR;
+    }
+    memset(p, 0xFF, QSPI_FLASH_SECTOR_SIZE);
+    erases++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef QSPI_Flash_Write(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    uint8_t *p = Flash_Map(address, length);
+    if (p == NULL) {
+        return HAL_ERROR;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        if ((p[i] & data[i]) != data[i]) {
+            flash_errors++;     // Bit em 0 que precisaria voltar a 1: faltou apagar
+        }
+        p[i] &= data[i];
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef QSPI_Flash_Read(uint32_t address, uint8_t *data, uint32_t length)
+{
+    uint8_t *p = Flash_Map(address, length);
+    if (p == NULL) {
+        return HAL_ERROR;
+    }
+    memcpy(data, p, length);
+    return HAL_OK;
+}
+
+/* ============================================================================
+   FORA DO ESCOPO
+   ============================================================================ */
+const UART_BulkSink_t UART_BulkSink_QSPI;
+
+void UART_Bulk_Init(UART_Protocol_t *proto, const UART_BulkSink_t *sink)
+{
+}
+
+void UART_Bulk_HandleMessage(const UART_Message_t *msg)
+{
+}
+
+void UART_Bulk_Poll(void)
+{
+}
+
+void PayloadBridge_Init(void)
+{
+}
+
+void PayloadBridge_Poll(void)
+{
+}
@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    mission_stubs.h
+  * @brief   O que payload_mission.c e result_queue.c usam fora do protocolo
+  *          UART, emulado para o teste no host
+  *
+  * - CAN_GetMissionType: missão escolhida pelo cenário;
+  * - CAN_TxReady/CAN_Transmit: TX FIFO de 1 elemento, esvaziado pelo COM
+  *   emulado (MissionStubs_CanTake);
+  * - QSPI_Flash_*: a região da fila de resultados em RAM, com apagamento
+  *   por setor (bits só vão de 1 para 0 na escrita, como na NOR);
+  * - uart_bulk e payload_bridge: não fazem nada (fora do escopo).
+  ******************************************************************************
+  */
+
+#ifndef __MISSION_STUBS_H
+#define __MISSION_STUBS_H
+
+#include "can_protocol.h"
+#include <stdint.h>
+
+// Apaga a flash emulada, esvazia o FIFO e zera os contadores
+void MissionStubs_Reset(void);
+
+void MissionStubs_SetMission(MissionType_t mission);
+
+// Retira o frame do TX FIFO (0 se vazio)
+uint8_t MissionStubs_CanTake(CAN_Message_t *msg);
+uint32_t MissionStubs_GetCanOverruns(void);     // CAN_Transmit com o FIFO cheio
+
+// Contadores da flash emulada
+uint32_t MissionStubs_GetErases(void);
+uint32_t MissionStubs_GetFlashErrors(void);     // Fora da região ou escrita sem apagar
+
+#endif /* __MISSION_STUBS_H */